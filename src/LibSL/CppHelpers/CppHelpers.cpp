@@ -44,6 +44,17 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include <cstdarg>
 #include <cstdio>
 #include <stack>
+#include <string>
+#include <algorithm>
+
+#if defined(USE_CXX11) || defined(USE_CXX14) || defined(USE_CXX17)
+#define LIBSL_CONSOLE_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#endif
 
 #include <LibSL/System/System.h>
 
@@ -56,7 +67,8 @@ using namespace LibSL::System::Time;
 
 // ------------------------------------------------------
 
-#define TEMP_STR_SIZE 4096
+#define TEMP_STR_SIZE     4096
+#define TEMP_STR_NUM_BUF  4
 
 #ifdef _DEBUG
 void sl_assert_func(bool b, const char *expr, const char *file, int line)
@@ -70,22 +82,34 @@ void sl_assert_func(bool b, const char *expr, const char *file, int line)
 
 // ------------------------------------------------------
 
-static char    s_StrSingle[TEMP_STR_SIZE];
-static wchar_t s_StrUnicode[TEMP_STR_SIZE];
+// Temporary strings are per thread. sprint cycles through a few
+// buffers so that several results can be used in a same expression.
+
+#ifdef LIBSL_CONSOLE_THREADS
+#define LIBSL_TEMP_STR_STORAGE thread_local
+#else
+#define LIBSL_TEMP_STR_STORAGE static
+#endif
+
+LIBSL_TEMP_STR_STORAGE char    s_StrSingle[TEMP_STR_NUM_BUF][TEMP_STR_SIZE];
+LIBSL_TEMP_STR_STORAGE uint    s_StrNext = 0;
+LIBSL_TEMP_STR_STORAGE wchar_t s_StrUnicode[TEMP_STR_SIZE];
 
 // ------------------------------------------------------
 
 const char *NAMESPACE::sprint(const char *msg,...)
 {
+  char *str = s_StrSingle[s_StrNext];
+  s_StrNext = (s_StrNext + 1) % TEMP_STR_NUM_BUF;
   va_list args;
   va_start(args, msg);
 #ifdef _MSC_VER
-	vsprintf_s(s_StrSingle, msg, args);
+  vsnprintf_s(str, TEMP_STR_SIZE, _TRUNCATE, msg, args);
 #else
-	vsprintf(s_StrSingle, msg, args);
+  vsnprintf(str, TEMP_STR_SIZE, msg, args);
 #endif
   va_end(args);
-  return (s_StrSingle);
+  return (str);
 }
 
 // ------------------------------------------------------
@@ -96,8 +120,10 @@ const char *NAMESPACE::sprint(const char *msg,...)
 
 const char    *NAMESPACE::toChar(const wchar_t *wstr)
 {
-  WideCharToMultiByte( CP_ACP, 0, wstr, -1, s_StrSingle, TEMP_STR_SIZE, NULL, NULL );
-  return s_StrSingle;
+  char *str = s_StrSingle[s_StrNext];
+  s_StrNext = (s_StrNext + 1) % TEMP_STR_NUM_BUF;
+  WideCharToMultiByte( CP_ACP, 0, wstr, -1, str, TEMP_STR_SIZE, NULL, NULL );
+  return str;
 }
 
 // ------------------------------------------------------
@@ -139,142 +165,436 @@ NAMESPACE::obinstream& NAMESPACE::operator << (NAMESPACE::obinstream& s,const st
 // ------------------------------------------------------
 // ------------------------------------------------------
 
-#define PROGRESS_BAR_LENGTH 20
+// Progress reporting
+//
+// Update functions only touch a counter (a relaxed atomic
+// increment), so that they can be called from hot loops and
+// from several worker threads at once. A background reporter
+// thread samples the counters and draws the console output.
+// Without C++11 support the sampling is done from the update
+// functions, every few thousand calls.
+
+#define PROGRESS_BAR_LENGTH          20
+#define PROGRESS_INTERVAL_CONSOLE   100
+#define PROGRESS_INTERVAL_MACHINE  1000
+#define PROGRESS_POLL_MASK         4095
+
+namespace {
+
+  enum e_ProgressKind { KindBar = 0, KindText = 1, KindProcessing = 2, NumKinds = 3 };
+
+  const char *c_ProgressKindNames[NumKinds] = { "bar", "text", "processing" };
+
+#ifdef LIBSL_CONSOLE_THREADS
+  typedef std::atomic<uint> t_Counter;
+  inline void counterSet(t_Counter& c,uint v) { c.store(v, std::memory_order_relaxed); }
+  inline uint counterAdd(t_Counter& c,uint n) { return c.fetch_add(n, std::memory_order_relaxed) + n; }
+  inline uint counterGet(const t_Counter& c)  { return c.load(std::memory_order_relaxed); }
+#else
+  typedef uint t_Counter;
+  inline void counterSet(t_Counter& c,uint v) { c = v; }
+  inline uint counterAdd(t_Counter& c,uint n) { return c += n; }
+  inline uint counterGet(const t_Counter& c)  { return c; }
+#endif
+
+  struct ProgressState
+  {
+    t_Counter value;
+    bool      active;
+    uint      max;
+    t_time    timeStart;
+    t_time    timeLast;
+    uint      drawn;       // bar: dots drawn, processing: counter at last draw
+    uint      step;        // processing: spinner step
+    float     percentLast;
+  };
+
+  ProgressState  s_Progress[NumKinds];
+  int            s_ProgressMode  = -1; // resolved on first use
+  FILE          *s_ProgressOut   = NULL;
+
+#if defined(_WIN32) || defined(_WIN64)
+  CONSOLE_SCREEN_BUFFER_INFO s_ProgressTextCursorNfo;
+  CONSOLE_SCREEN_BUFFER_INFO s_ProcessingCursorNfo;
+#endif
+
+#ifdef LIBSL_CONSOLE_THREADS
+  std::mutex     s_ProgressLock;
+  typedef std::unique_lock<std::mutex> t_ProgressLock;
+#endif
+
+  NAMESPACE::Console::e_ProgressMode progressModeLocked()
+  {
+    if (s_ProgressMode < 0) {
+      s_ProgressMode    = NAMESPACE::Console::ProgressConsole;
+      const char *env   = getenv("LIBSL_PROGRESS");
+      if (env != NULL) {
+        std::string m(env);
+        if      (m == "silent")  { s_ProgressMode = NAMESPACE::Console::ProgressSilent;  }
+        else if (m == "machine") { s_ProgressMode = NAMESPACE::Console::ProgressMachine; }
+      }
+    }
+    return NAMESPACE::Console::e_ProgressMode(s_ProgressMode);
+  }
+
+  t_time progressInterval()
+  {
+    return progressModeLocked() == NAMESPACE::Console::ProgressMachine ? PROGRESS_INTERVAL_MACHINE : PROGRESS_INTERVAL_CONSOLE;
+  }
+
+  void formatTime(uint tm,uint& _h,uint& _m,uint& _s)
+  {
+    _h = ( tm/(1000*60*60));
+    _m = ((tm/(1000*60)) % 60);
+    _s = ((tm/1000)      % 60);
+  }
+
+  //! one JSON object per line, for batch jobs
+  void drawMachine(e_ProgressKind k,uint value,t_time now,bool done)
+  {
+    const ProgressState& p = s_Progress[k];
+    FILE *out = (s_ProgressOut != NULL) ? s_ProgressOut : stderr;
+    fprintf(out, "{\"progress\":\"%s\",\"value\":%u,\"max\":%u,\"elapsed_ms\":%lld,\"done\":%s}\n",
+      c_ProgressKindNames[k], value, k == KindProcessing ? 0u : p.max,
+      (long long)(now - p.timeStart), done ? "true" : "false");
+    fflush(out);
+  }
+
+  void drawBar(uint value)
+  {
+    ProgressState& p = s_Progress[KindBar];
+    uint cursor      = uint((unsigned long long)std::min(value,p.max) * PROGRESS_BAR_LENGTH / p.max);
+    while (cursor >= p.drawn) {
+      std::cerr << '.';
+      p.drawn ++;
+    }
+  }
+
+  void drawText(uint value,t_time now)
+  {
+    ProgressState& p = s_Progress[KindText];
+    float percent    = std::min(value,p.max) * 100.0f / float(p.max);
+    if (percent - p.percentLast <= 0.1f) {
+      return;
+    }
+    p.percentLast    = percent;
+    // remaining time, from the average rate since start
+    float left       = percent > 0 ? float(now - p.timeStart) * (100.0f - percent) / percent : 0.0f;
+    uint h, m, s;
+    formatTime(uint(left), h, m, s);
+#if defined(_WIN32) || defined(_WIN64)
+    SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProgressTextCursorNfo.dwCursorPosition);
+    std::cerr << NAMESPACE::sprint("%.2f%%\t (", percent);
+    SetConsoleTextAttribute(GetStdHandle(STD_ERROR_HANDLE), FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+    std::cerr << NAMESPACE::sprint("%02d:%02d:%02d", h, m, s);
+    SetConsoleTextAttribute(GetStdHandle(STD_ERROR_HANDLE), s_ProgressTextCursorNfo.wAttributes);
+    std::cerr << " left)";
+#else // use VT100
+    std::cout << char(27) << "[u";
+    std::cout << char(27) << "[K";
+    std::cout << char(27) << "[s";
+    std::cout << NAMESPACE::sprint("%.2f%%\t (%c[32m%02d:%02d:%02d%c[37m left) ", percent, 27, h, m, s, 27) << std::flush;
+#endif
+  }
+
+  void drawProcessing(uint value)
+  {
+    static const char seq[]={'/','-','\\','|'};
+    ProgressState& p = s_Progress[KindProcessing];
+    if (value == p.drawn) {
+      return; // no update since last sample
+    }
+    p.drawn = value;
+#if defined(_WIN32) || defined(_WIN64)
+    SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProcessingCursorNfo.dwCursorPosition);
+#else
+    std::cerr << char(27) << "[1D";
+#endif
+    p.step ++;
+    std::cerr << seq[p.step&3];
+  }
+
+  //! draws an active progress, called with the lock held
+  void sampleLocked(e_ProgressKind k,t_time now,bool done)
+  {
+    ProgressState& p = s_Progress[k];
+    uint value       = counterGet(p.value);
+    p.timeLast       = now;
+    switch (progressModeLocked()) {
+    case NAMESPACE::Console::ProgressSilent:
+      break;
+    case NAMESPACE::Console::ProgressMachine:
+      drawMachine(k, value, now, done);
+      break;
+    case NAMESPACE::Console::ProgressConsole:
+      switch (k) {
+      case KindBar:        drawBar(value);        break;
+      case KindText:       drawText(value, now);  break;
+      case KindProcessing: drawProcessing(value); break;
+      default: break;
+      }
+      break;
+    }
+  }
+
+  void sampleAllLocked()
+  {
+    t_time now = milliseconds();
+    ForIndex(k, NumKinds) {
+      if (s_Progress[k].active && now - s_Progress[k].timeLast >= progressInterval()) {
+        sampleLocked(e_ProgressKind(k), now, false);
+      }
+    }
+  }
+
+#ifdef LIBSL_CONSOLE_THREADS
+
+  //! samples active progress counters at regular intervals
+  //! started on first use, idles while no progress is active
+  class ProgressReporter
+  {
+  private:
+    std::thread              m_Thread;
+    std::condition_variable  m_Wake;
+    bool                     m_Stop;
+    void run()
+    {
+      t_ProgressLock lock(s_ProgressLock);
+      while (!m_Stop) {
+        bool any = false;
+        ForIndex(k, NumKinds) { any = any || s_Progress[k].active; }
+        if (any) {
+          m_Wake.wait_for(lock, std::chrono::milliseconds(progressInterval()));
+          if (!m_Stop) {
+            sampleAllLocked();
+          }
+        } else {
+          m_Wake.wait(lock);
+        }
+      }
+    }
+  public:
+    ProgressReporter() : m_Stop(false) { }
+    ~ProgressReporter() { stop(); }
+    //! joins the thread, returns true if it was running
+    bool stop()
+    {
+      {
+        t_ProgressLock lock(s_ProgressLock);
+        if (!m_Thread.joinable()) {
+          return false;
+        }
+        m_Stop = true;
+        m_Wake.notify_all();
+      }
+      m_Thread.join();
+      t_ProgressLock lock(s_ProgressLock);
+      m_Thread = std::thread();
+      m_Stop   = false;
+      return true;
+    }
+    //! called with the lock held
+    void wake()
+    {
+      if (!m_Thread.joinable()) {
+        m_Thread = std::thread(&ProgressReporter::run, this);
+      }
+      m_Wake.notify_all();
+    }
+  };
+
+  ProgressReporter s_ProgressReporter;
+
+  inline void pollProgress(uint) { }
+
+#else
+
+  inline void pollProgress(uint value)
+  {
+    if ((value & PROGRESS_POLL_MASK) == 0) {
+      sampleAllLocked();
+    }
+  }
+
+#endif
+
+  //! starts tracking a progress, called with the lock held
+  void beginLocked(e_ProgressKind k,uint max)
+  {
+    ProgressState& p = s_Progress[k];
+    counterSet(p.value, 0);
+    p.max         = std::max(1u, max);
+    p.timeStart   = milliseconds();
+    p.timeLast    = p.timeStart;
+    p.drawn       = 0;
+    p.step        = 0;
+    p.percentLast = 0;
+    p.active      = true;
+#ifdef LIBSL_CONSOLE_THREADS
+    s_ProgressReporter.wake();
+#endif
+  }
+
+  //! stops tracking a progress, called with the lock held, returns elapsed time
+  t_time endLocked(e_ProgressKind k)
+  {
+    ProgressState& p = s_Progress[k];
+    t_time now       = milliseconds();
+    if (p.active && progressModeLocked() == NAMESPACE::Console::ProgressMachine) {
+      sampleLocked(k, now, true);
+    }
+    p.active         = false;
+    return now - p.timeStart;
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void NAMESPACE::Console::progressSetMode(e_ProgressMode mode,FILE *out)
+{
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  s_ProgressMode = mode;
+  s_ProgressOut  = out;
+}
+
+// ------------------------------------------------------
+
+NAMESPACE::Console::e_ProgressMode NAMESPACE::Console::progressMode()
+{
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  return progressModeLocked();
+}
 
-static uint   s_ProgressBarMax         = 1;
-static uint   s_ProgressBarValue       = 0;
-static uint   s_ProgressBarCursorLast  = 0;
-static t_time s_ProgressBarTimeLast    = 0;
+// ------------------------------------------------------
+
+bool NAMESPACE::Console::progressShutdown()
+{
+#ifdef LIBSL_CONSOLE_THREADS
+  return s_ProgressReporter.stop();
+#else
+  return false;
+#endif
+}
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressBarInit(uint max)
 {
-  s_ProgressBarMax         = max;
-  s_ProgressBarValue       = 0;
-  s_ProgressBarCursorLast  = 0;
-  s_ProgressBarTimeLast    = System::Time::milliseconds();
-  std::cerr << '[';
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  beginLocked(KindBar, max);
+  if (progressModeLocked() == ProgressConsole) {
+    std::cerr << '[';
+  }
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressBarUpdate(uint cur)
 {
-  uint cursor    = cur * PROGRESS_BAR_LENGTH / s_ProgressBarMax;
-  while (cursor >= s_ProgressBarCursorLast) {
-    std::cerr << '.';
-    s_ProgressBarCursorLast ++;
-  }
+  counterSet(s_Progress[KindBar].value, cur);
+  pollProgress(cur);
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressBarUpdate()
 {
-  s_ProgressBarValue ++;
-  progressBarUpdate(s_ProgressBarValue);
+  pollProgress(counterAdd(s_Progress[KindBar].value, 1));
 }
 
 // ------------------------------------------------------
 
-void NAMESPACE::Console::progressBarEnd()
+void NAMESPACE::Console::progressBarAdvance(uint n)
 {
-  std::cerr << "]\n";
+  pollProgress(counterAdd(s_Progress[KindBar].value, n));
 }
 
-// ------------------------------------------------------
-// ------------------------------------------------------
 // ------------------------------------------------------
 
-static uint   s_ProgressTextMax         = 1;
-static uint   s_ProgressTextValue       = 0;
-static float  s_ProgressTextPercentLast = 0;
-static t_time s_ProgressTextTimeStart   = 0;
-static t_time s_ProgressTextTimeLast    = 0;
-
-#if defined(_WIN32) || defined(_WIN64)
-CONSOLE_SCREEN_BUFFER_INFO s_ProgressTextCursorNfo;
+void NAMESPACE::Console::progressBarEnd()
+{
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
 #endif
+  if (progressModeLocked() == ProgressConsole) {
+    drawBar(counterGet(s_Progress[KindBar].value));
+    std::cerr << "]\n";
+  }
+  endLocked(KindBar);
+}
 
+// ------------------------------------------------------
+// ------------------------------------------------------
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressTextInit(uint max)
 {
-  s_ProgressTextMax         = max;
-  s_ProgressTextValue       = 0;
-  s_ProgressTextPercentLast = 0;
-  s_ProgressTextTimeLast    = System::Time::milliseconds();
-  s_ProgressTextTimeStart   = System::Time::milliseconds();
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  beginLocked(KindText, max);
+  if (progressModeLocked() == ProgressConsole) {
 #if defined(_WIN32) || defined(_WIN64)
-  GetConsoleScreenBufferInfo(GetStdHandle(STD_ERROR_HANDLE), &s_ProgressTextCursorNfo);
+    GetConsoleScreenBufferInfo(GetStdHandle(STD_ERROR_HANDLE), &s_ProgressTextCursorNfo);
 #else  // use VT100
-  std::cout << char(27) << "[s" << std::flush;;
+    std::cout << char(27) << "[s" << std::flush;
 #endif
+  }
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressTextUpdate(uint cur)
 {
-  float percent  = cur * 100.0f / float(s_ProgressTextMax);
-  float numsteps = percent - s_ProgressTextPercentLast;
-  t_time   now   = System::Time::milliseconds();
-  if (numsteps > 0.1f && now - s_ProgressTextTimeLast > 100) {
-    s_ProgressTextPercentLast = percent;
-    float  msPerStep          = float(now - s_ProgressTextTimeLast) / float(numsteps);
-    float  left               = (100 - percent) * msPerStep;
-    s_ProgressTextTimeLast    = now;
-    uint tm = uint(left);
-    uint h  = ( tm/(1000*60*60));
-    uint m  = ((tm/(1000*60)) % 60);
-    uint s  = ((tm/1000)      % 60);
-    uint ms = tm % 1000;
-#if defined(_WIN32) || defined(_WIN64) 
-    SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProgressTextCursorNfo.dwCursorPosition);
-    std::cerr << sprint("%.2f%%\t (", percent);
-    SetConsoleTextAttribute(GetStdHandle(STD_ERROR_HANDLE), FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-    std::cerr << sprint("%02d:%02d:%02d", h, m, s);
-    SetConsoleTextAttribute(GetStdHandle(STD_ERROR_HANDLE), s_ProgressTextCursorNfo.wAttributes);
-    std::cerr << sprint(" left)");
-#else // use VT100
-    std::cout << char(27) << "[u";
-    std::cout << char(27) << "[K";
-    std::cout << char(27) << "[s";
-    std::cout << sprint("%.2f%%\t (%c[32m%02d:%02d:%02d%c[37m left) ", percent, 27, h, m, s, 27) << std::flush;
-#endif
-  }
+  counterSet(s_Progress[KindText].value, cur);
+  pollProgress(cur);
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressTextUpdate()
 {
-  s_ProgressTextValue ++;
-  progressTextUpdate(s_ProgressTextValue);
+  pollProgress(counterAdd(s_Progress[KindText].value, 1));
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::Console::progressTextAdvance(uint n)
+{
+  pollProgress(counterAdd(s_Progress[KindText].value, n));
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::progressTextEnd()
 {
-  uint tm = uint(System::Time::milliseconds() - s_ProgressTextTimeStart);
-  uint h  = ( tm/(1000*60*60));
-  uint m  = ((tm/(1000*60)) % 60);
-  uint s  = ((tm/1000)      % 60);
-  uint ms = tm % 1000;
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  uint tm = uint(endLocked(KindText));
+  if (progressModeLocked() != ProgressConsole) {
+    return;
+  }
+  uint h, m, s;
+  formatTime(tm, h, m, s);
 #if defined(_WIN32) || defined(_WIN64)
   SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProgressTextCursorNfo.dwCursorPosition);
-  std::cerr << sprint("done in ");
+  std::cerr << "done in ";
   SetConsoleTextAttribute(GetStdHandle(STD_ERROR_HANDLE), FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY);
   std::cerr << sprint("%02d:%02d:%02d", h, m, s);
   SetConsoleTextAttribute(GetStdHandle(STD_ERROR_HANDLE), s_ProgressTextCursorNfo.wAttributes);
-  //std::cerr << sprint(".                     \n");
-  std::cerr << sprint(".                     ");
+  std::cerr << ".                     ";
 #else  // use VT100
   std::cout << char(27) << "[u";
   std::cout << char(27) << "[K";
-  std::cout << sprint("done in\t %c[36m%02d:%02d:%02d%c[37m.\n", 27, h, m, s, 27) << std::flush;;
+  std::cout << sprint("done in\t %c[36m%02d:%02d:%02d%c[37m.\n", 27, h, m, s, 27) << std::flush;
 #endif
 }
 
@@ -344,53 +664,42 @@ void NAMESPACE::Console::cursorGotoPreviousLineStart()
 // ------------------------------------------------------
 // ------------------------------------------------------
 
-static uint   s_Processing       = 0;
-static t_time s_ProcessingTmLast = 0;
-
-#if defined(_WIN32) || defined(_WIN64)
-CONSOLE_SCREEN_BUFFER_INFO s_ProcessingCursorNfo;
-#endif
-
-// ------------------------------------------------------
-
 void NAMESPACE::Console::processingInit()
 {
-  s_Processing       = 0;
-  s_ProcessingTmLast = LibSL::System::Time::milliseconds();
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  beginLocked(KindProcessing, 0);
+  if (progressModeLocked() == ProgressConsole) {
 #if defined(_WIN32) || defined(_WIN64)
-  GetConsoleScreenBufferInfo(GetStdHandle(STD_ERROR_HANDLE),&s_ProcessingCursorNfo);
+    GetConsoleScreenBufferInfo(GetStdHandle(STD_ERROR_HANDLE),&s_ProcessingCursorNfo);
 #endif
-  std::cerr << '.';
+    std::cerr << '.';
+  }
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::processingUpdate()
 {
-  static char seq[]={'/','-','\\','|'};
-  t_time tm      = LibSL::System::Time::milliseconds();
-  t_time elapsed = tm - s_ProcessingTmLast;
-  if (elapsed > 100) {
-    s_Processing ++;
-    s_ProcessingTmLast = tm;
-#if defined(_WIN32) || defined(_WIN64)
-    SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProcessingCursorNfo.dwCursorPosition);
-#else
-    std::cerr << char(27) << "[1D";
-#endif
-    std::cerr << seq[s_Processing&3];
-  }
+  pollProgress(counterAdd(s_Progress[KindProcessing].value, 1));
 }
 
 // ------------------------------------------------------
 
 void NAMESPACE::Console::processingEnd()
 {
+#ifdef LIBSL_CONSOLE_THREADS
+  t_ProgressLock lock(s_ProgressLock);
+#endif
+  endLocked(KindProcessing);
+  if (progressModeLocked() == ProgressConsole) {
 #if defined(_WIN32) || defined(_WIN64)
-  SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProcessingCursorNfo.dwCursorPosition);
+    SetConsoleCursorPosition(GetStdHandle(STD_ERROR_HANDLE), s_ProcessingCursorNfo.dwCursorPosition);
 #else
-  std::cerr << char(27) << "[1D";
+    std::cerr << char(27) << "[1D";
 #endif
+  }
 }
 
 // ------------------------------------------------------
@@ -117,6 +117,7 @@ namespace LibSL {
   namespace CppHelpers {
 
     //! text stream helpers
+    //! returns a per thread temporary string, valid until a few more calls
     LIBSL_DLL const char    *sprint(const char *msg,...);
 
     //! unicode helpers
@@ -124,15 +125,34 @@ namespace LibSL {
     LIBSL_DLL const wchar_t *toUnicode(const char *);
 
     namespace Console {
+      //! progress output
+      //! Update/Advance only increment a counter and may be called from
+      //! several threads; a background thread draws the progress.
+      //! The mode defaults to the LIBSL_PROGRESS environment variable
+      //! ('silent' or 'machine'), console otherwise.
+      enum e_ProgressMode {
+        ProgressConsole, //!< interactive console output
+        ProgressSilent,  //!< no output
+        ProgressMachine  //!< one JSON object per line and per second, e.g.
+                         //!< {"progress":"text","value":12,"max":100,"elapsed_ms":1000,"done":false}
+      };
+      //! out is used by ProgressMachine, stderr when NULL
+      LIBSL_DLL void progressSetMode(e_ProgressMode mode,FILE *out = NULL);
+      LIBSL_DLL e_ProgressMode progressMode();
+      //! stops and joins the reporter thread, which restarts with the next progress
+      //! returns true if it was running; call when no progress is active (done at exit)
+      LIBSL_DLL bool progressShutdown();
       //! progress bar
-      LIBSL_DLL void progressBarInit  (uint max);
-      LIBSL_DLL void progressBarUpdate(uint cur);
-      LIBSL_DLL void progressBarUpdate();
+      LIBSL_DLL void progressBarInit   (uint max);
+      LIBSL_DLL void progressBarUpdate (uint cur);
+      LIBSL_DLL void progressBarUpdate ();
+      LIBSL_DLL void progressBarAdvance(uint n);
       LIBSL_DLL void progressBarEnd();
       //! progress text
-      LIBSL_DLL void progressTextInit  (uint max);
-      LIBSL_DLL void progressTextUpdate(uint cur);
-      LIBSL_DLL void progressTextUpdate();
+      LIBSL_DLL void progressTextInit   (uint max);
+      LIBSL_DLL void progressTextUpdate (uint cur);
+      LIBSL_DLL void progressTextUpdate ();
+      LIBSL_DLL void progressTextAdvance(uint n);
       LIBSL_DLL void progressTextEnd();
       //! processing marker
       LIBSL_DLL void processingInit();
@@ -0,0 +1,205 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::DataStructures::CompactGraph
+// ------------------------------------------------------
+//
+// Frozen, compressed sparse row (CSR) snapshot of a Graph
+//
+// Arcs leaving a node are stored contiguously, together
+// with their cost and the id of the Graph edge they come
+// from. Costs and edge/node filtering are resolved once,
+// at build time, using the same policies as GraphAlgorithms.
+// See GraphAlgorithms::CompactShortestPaths.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/CppHelpers/CppHelpers.h>
+#include <LibSL/Memory/Pointer.h>
+#include <LibSL/Memory/Array.h>
+#include <LibSL/System/Parallel.h>
+
+#include <LibSL/DataStructures/Graph.h>
+#include <LibSL/DataStructures/GraphAlgorithms.h>
+
+#include <algorithm>
+
+namespace LibSL {
+  namespace DataStructures {
+
+    /*!
+
+    \class CompactGraph
+    \brief Read-only CSR graph built from a Graph. Arcs of node u are in [arcBegin(u),arcEnd(u)[.
+
+    Unoriented graphs produce one arc per edge end. Policies are called
+    concurrently from several threads during build and must be thread safe.
+
+    */
+    class CompactGraph
+    {
+    public:
+
+      typedef LibSL::Memory::Pointer::AutoPtr<CompactGraph> t_Pointer;
+
+    private:
+
+      LibSL::Memory::Array::FastArray<int>      m_Offsets;
+      LibSL::Memory::Array::FastArray<t_NodeId> m_Targets;
+      LibSL::Memory::Array::FastArray<float>    m_Costs;
+      LibSL::Memory::Array::FastArray<t_EdgeId> m_EdgeIds;
+
+    public:
+
+      CompactGraph() { }
+
+      LIBSL_DISABLE_COPY(CompactGraph);
+
+      //! Build from a graph - with edge cost, edge and node tester
+      //!   an arc u->v is kept if follow(g,u,e) and accept(g,v), as in ShortestPaths
+      template <class T_Graph,class T_EdgeCost,class T_EdgeTester,class T_NodeTester>
+      void build(
+        const T_Graph&      g,
+        const T_EdgeCost&   cost,
+        const T_EdgeTester& follow,
+        const T_NodeTester& accept)
+      {
+        int num_nodes = int(g.nodes().size());
+        m_Offsets.allocate(num_nodes + 1);
+        m_Offsets[0] = 0;
+        // count arcs
+        LibSL::System::Parallel::forIndex(0,num_nodes,[&](int u) {
+          int num = 0;
+          const typename T_Graph::NodeContainer& nc = g.nodes()[u];
+          if (nc.isValid()) {
+            const std::vector<t_EdgeId>& edges_out = nc.edgeIds();
+            ForIndex(e,edges_out.size()) {
+              t_NodeId to = g.edges()[edges_out[e]].other(u);
+              if (follow(g,u,edges_out[e]) && accept(g,to)) {
+                num ++;
+              }
+            }
+          }
+          m_Offsets[u + 1] = num;
+        },1024);
+        ForIndex(u,num_nodes) {
+          m_Offsets[u + 1] += m_Offsets[u];
+        }
+        // fill arcs
+        m_Targets.allocate(m_Offsets[num_nodes]);
+        m_Costs  .allocate(m_Offsets[num_nodes]);
+        m_EdgeIds.allocate(m_Offsets[num_nodes]);
+        LibSL::System::Parallel::forIndex(0,num_nodes,[&](int u) {
+          const typename T_Graph::NodeContainer& nc = g.nodes()[u];
+          if (!nc.isValid()) {
+            return;
+          }
+          int a = m_Offsets[u];
+          const std::vector<t_EdgeId>& edges_out = nc.edgeIds();
+          ForIndex(e,edges_out.size()) {
+            t_NodeId to = g.edges()[edges_out[e]].other(u);
+            if (follow(g,u,edges_out[e]) && accept(g,to)) {
+              float c = cost(g,u,edges_out[e]);
+              if (!(c >= 0.0f)) {
+                throw LibSL::Errors::Fatal("CompactGraph::build - negative (or NaN) cost on edge %d",edges_out[e]);
+              }
+              m_Targets[a] = to;
+              m_Costs  [a] = c;
+              m_EdgeIds[a] = edges_out[e];
+              a ++;
+            }
+          }
+        },1024);
+      }
+
+      //! Build from a graph - with edge cost
+      template <class T_Graph,class T_EdgeCost>
+      void build(const T_Graph& g,const T_EdgeCost& cost)
+      {
+        build(g,cost,GraphAlgorithms::DefaultEdgeTester<T_Graph>(),GraphAlgorithms::DefaultNodeTester<T_Graph>());
+      }
+
+      //! Build from a graph - unit costs
+      template <class T_Graph>
+      void build(const T_Graph& g)
+      {
+        build(g,GraphAlgorithms::DefaultEdgeCost<T_Graph>());
+      }
+
+      //! Clear the graph
+      void clear()
+      {
+        m_Offsets.erase();
+        m_Targets.erase();
+        m_Costs  .erase();
+        m_EdgeIds.erase();
+      }
+
+      int numNodes() const { return m_Offsets.empty() ? 0 : int(m_Offsets.size()) - 1; }
+      int numArcs()  const { return int(m_Targets.size()); }
+
+      int      arcBegin(t_NodeId u) const { return m_Offsets[u];     }
+      int      arcEnd  (t_NodeId u) const { return m_Offsets[u + 1]; }
+      int      degree  (t_NodeId u) const { return m_Offsets[u + 1] - m_Offsets[u]; }
+
+      t_NodeId arcTarget(int a) const { return m_Targets[a]; }
+      float    arcCost  (int a) const { return m_Costs  [a]; }
+      t_EdgeId arcEdgeId(int a) const { return m_EdgeIds[a]; }
+
+      //! Returns the node an arc leaves from (binary search)
+      t_NodeId arcSource(int a) const
+      {
+        const int *o = std::upper_bound(m_Offsets.begin(),m_Offsets.end(),a);
+        return t_NodeId(o - m_Offsets.begin()) - 1;
+      }
+
+      //! Raw tables, for custom traversals
+      const int      *offsets() const { return m_Offsets.raw(); }
+      const t_NodeId *targets() const { return m_Targets.raw(); }
+      const float    *costs()   const { return m_Costs  .raw(); }
+      const t_EdgeId *edgeIds() const { return m_EdgeIds.raw(); }
+
+    };
+
+  } //namespace LibSL::DataStructures
+} //namespace LibSL
+
+// ------------------------------------------------------
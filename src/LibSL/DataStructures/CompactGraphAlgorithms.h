@@ -0,0 +1,513 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::DataStructures::GraphAlgorithms (CompactGraph)
+// ------------------------------------------------------
+//
+// Shortest paths on CompactGraph
+//  - Dijkstra with a radix heap and reusable buffers
+//  - multithreaded, multi-source delta-stepping
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/CppHelpers/CppHelpers.h>
+#include <LibSL/Memory/Array.h>
+#include <LibSL/Math/Tuple.h>
+#include <LibSL/System/Parallel.h>
+
+#include <LibSL/DataStructures/GraphAlgorithms.h>
+#include <LibSL/DataStructures/CompactGraph.h>
+
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace LibSL {
+  namespace DataStructures {
+    namespace GraphAlgorithms {
+
+      //! Monotone priority queue on 32 bits keys (Ahuja et al. radix heap)
+      //!   keys pushed must be larger or equal to the last key popped
+      class RadixHeap
+      {
+      public:
+        typedef std::pair<uint,int> t_Entry;
+      private:
+        enum { e_NumBuckets = 33 };
+        std::vector<t_Entry> m_Buckets[e_NumBuckets];
+        uint                 m_Last;
+        size_t               m_Size;
+
+        // index of the highest bit differing from last, plus one
+        static int bucketOf(uint key,uint last)
+        {
+          uint x = key ^ last;
+          if (x == 0) {
+            return 0;
+          }
+#if defined(__GNUC__) || defined(__clang__)
+          return 32 - __builtin_clz(x);
+#elif defined(_MSC_VER)
+          unsigned long b;
+          _BitScanReverse(&b,x);
+          return int(b) + 1;
+#else
+          int b = 0;
+          while (x != 0) { b ++; x >>= 1; }
+          return b;
+#endif
+        }
+
+      public:
+
+        RadixHeap() : m_Last(0), m_Size(0) { }
+
+        //! Empties the heap, allocated memory is kept for reuse
+        void clear()
+        {
+          ForIndex(b,e_NumBuckets) { m_Buckets[b].clear(); }
+          m_Last = 0;
+          m_Size = 0;
+        }
+
+        bool   empty() const { return m_Size == 0; }
+        size_t size()  const { return m_Size; }
+
+        void push(uint key,int value)
+        {
+          sl_dbg_assert(key >= m_Last);
+          m_Buckets[bucketOf(key,m_Last)].push_back(t_Entry(key,value));
+          m_Size ++;
+        }
+
+        t_Entry pop()
+        {
+          sl_dbg_assert(m_Size > 0);
+          if (m_Buckets[0].empty()) {
+            // redistribute the first non empty bucket around its minimum
+            int b = 1;
+            while (m_Buckets[b].empty()) { b ++; }
+            std::vector<t_Entry>& bucket = m_Buckets[b];
+            uint new_last = bucket[0].first;
+            ForIndex(i,bucket.size()) { new_last = std::min(new_last,bucket[i].first); }
+            ForIndex(i,bucket.size()) {
+              m_Buckets[bucketOf(bucket[i].first,new_last)].push_back(bucket[i]);
+            }
+            bucket.clear();
+            m_Last = new_last;
+          }
+          t_Entry e = m_Buckets[0].back();
+          m_Buckets[0].pop_back();
+          m_Size --;
+          return e;
+        }
+      };
+
+      // -------------------------------------
+      /// Shortest paths on a CompactGraph
+
+      /*!
+
+      Same interface and results as ShortestPaths, costs and filters being
+      baked in the CompactGraph. Buffers are kept between calls: reuse a
+      single CompactShortestPaths object for repeated queries. An object
+      must not be used by several threads at once.
+
+      */
+      class CompactShortestPaths
+      {
+      private:
+
+        RadixHeap                                   m_Heap;
+        // delta-stepping
+        std::vector<std::atomic<unsigned long long> > m_Best;
+        std::vector<std::vector<t_NodeId> >         m_Buckets;
+        std::vector<std::vector<t_NodeId> >         m_Requests;
+        std::vector<t_NodeId>                       m_Frontier;
+        std::vector<t_NodeId>                       m_Settled;
+        LibSL::Memory::Array::FastArray<int>        m_InBucket;
+        LibSL::Memory::Array::FastArray<int>        m_SettledIn;
+
+        static uint toKey(float d)
+        {
+          uint k;
+          memcpy(&k,&d,sizeof(uint)); // order preserving on positive floats
+          return k;
+        }
+
+        static float fromKey(uint k)
+        {
+          float d;
+          memcpy(&d,&k,sizeof(uint));
+          return d;
+        }
+
+        template< class T_StopCondition >
+        t_NodeId run(
+          const CompactGraph&                            g,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev,
+          const T_StopCondition&                         stop)
+        {
+          bool firstStep = true;
+          while ( ! m_Heap.empty() ) {
+            RadixHeap::t_Entry top = m_Heap.pop();
+            t_NodeId u = top.second;
+            float    d = fromKey(top.first);
+            // lazy deletion
+            if (d > _dist[u]) {
+              continue;
+            }
+            if ( ! stop.forceFirstStep() || ! firstStep ) {
+              if ( stop( g, ShortestPathNodeRecord(u,d) ) ) {
+                return u;
+              }
+              _dist[u] = d;
+            }
+            firstStep = false;
+            const t_NodeId *targets = g.targets();
+            const float    *costs   = g.costs();
+            for (int a = g.arcBegin(u) ; a < g.arcEnd(u) ; a++) {
+              t_NodeId to   = targets[a];
+              float    newd = d + costs[a];
+              if (newd < _dist[to]) {
+                _dist[to]    = newd;
+                _prev[to][0] = u;
+                _prev[to][1] = g.arcEdgeId(a);
+                m_Heap.push(toKey(newd),to);
+              }
+            }
+          }
+          return -1;
+        }
+
+        void allocate(
+          const CompactGraph&                            g,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev)
+        {
+          if (_dist.size() != uint(g.numNodes())) { _dist.allocate( g.numNodes() ); }
+          if (_prev.size() != uint(g.numNodes())) { _prev.allocate( g.numNodes() ); }
+          _dist.fill(Infinity);
+          _prev.fill(LibSL::Math::V2I(-1,-1));
+        }
+
+        // delta-stepping: relaxes the light or heavy arcs leaving a set of nodes
+        void relax(const CompactGraph& g,const std::vector<t_NodeId>& nodes,float delta,bool light)
+        {
+          LibSL::System::Parallel::forChunks(0,int(nodes.size()),[&](int first,int last) {
+            std::vector<t_NodeId>& requests = m_Requests[LibSL::System::Parallel::workerId()];
+            const t_NodeId *targets = g.targets();
+            const float    *costs   = g.costs();
+            for (int i = first ; i < last ; i++) {
+              t_NodeId u = nodes[i];
+              float    d = fromKey(uint(m_Best[u].load(std::memory_order_relaxed) >> 32));
+              for (int a = g.arcBegin(u) ; a < g.arcEnd(u) ; a++) {
+                if ((costs[a] <= delta) != light) {
+                  continue;
+                }
+                // (distance, arc) packed: ties resolved towards the smallest arc
+                unsigned long long key = ((unsigned long long)toKey(d + costs[a]) << 32) | (unsigned long long)(a + 1);
+                std::atomic<unsigned long long>& best = m_Best[targets[a]];
+                unsigned long long cur = best.load(std::memory_order_relaxed);
+                while (key < cur) {
+                  if (best.compare_exchange_weak(cur,key,std::memory_order_relaxed)) {
+                    requests.push_back(targets[a]);
+                    break;
+                  }
+                }
+              }
+            }
+          },64);
+        }
+
+        // delta-stepping: moves updated nodes to their new bucket, returns the number of insertions
+        //   min_bucket guards against rounding sending a node back to an already processed bucket
+        int merge(float delta,int min_bucket)
+        {
+          int num = 0;
+          ForIndex(t,m_Requests.size()) {
+            std::vector<t_NodeId>& requests = m_Requests[t];
+            ForIndex(r,requests.size()) {
+              t_NodeId v = requests[r];
+              int      b = std::max(min_bucket,int(fromKey(uint(m_Best[v].load(std::memory_order_relaxed) >> 32)) / delta));
+              if (m_InBucket[v] != b) {
+                m_InBucket[v] = b;
+                if (b >= int(m_Buckets.size())) {
+                  m_Buckets.resize(b + 1);
+                }
+                m_Buckets[b].push_back(v);
+                num ++;
+              }
+            }
+            requests.clear();
+          }
+          return num;
+        }
+
+      public:
+
+        //! Find shortest path from one node to all others, see ShortestPaths::dijkstra
+        template< class T_StopCondition >
+        t_NodeId dijkstra(
+          const CompactGraph&                            g,
+          t_NodeId                                       source,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev,
+          const T_StopCondition&                         stop = T_StopCondition())
+        {
+          allocate(g,_dist,_prev);
+          return dijkstraUpdate(g,source,_dist,_prev,stop);
+        }
+
+        //! Update shortest paths from a new source, see ShortestPaths::dijkstraUpdate
+        template< class T_StopCondition >
+        t_NodeId dijkstraUpdate(
+          const CompactGraph&                            g,
+          t_NodeId                                       source,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev,
+          const T_StopCondition&                         stop = T_StopCondition())
+        {
+          m_Heap.clear();
+          if ( ! stop.forceFirstStep() ) {
+            _dist[source] = 0;
+          }
+          m_Heap.push(toKey(0.0f),source);
+          return run(g,_dist,_prev,stop);
+        }
+
+        //! Dijkstra without stop condition
+        void dijkstraToAll(
+          const CompactGraph&                            g,
+          t_NodeId                                       source,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev)
+        {
+          DefaultStopCondition<CompactGraph> stop;
+          dijkstra(g,source,_dist,_prev,stop);
+        }
+
+        //! Dijkstra from several sources at once (all at distance zero)
+        void dijkstraFromSources(
+          const CompactGraph&                            g,
+          const std::vector<t_NodeId>&                   sources,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev)
+        {
+          allocate(g,_dist,_prev);
+          m_Heap.clear();
+          ForIndex(s,sources.size()) {
+            _dist[sources[s]] = 0;
+            m_Heap.push(toKey(0.0f),sources[s]);
+          }
+          DefaultStopCondition<CompactGraph> stop;
+          run(g,_dist,_prev,stop);
+        }
+
+        //! Find shortest path between two nodes, see ShortestPaths::dijkstraToTarget
+        //!   returns path cost, -1 if no path exists
+        float dijkstraToTarget(
+          const CompactGraph&                            g,
+          t_NodeId                                       source,
+          t_NodeId                                       target,
+          std::vector<LibSL::Math::v2i>&                _path)
+        {
+          LibSL::Memory::Array::Array<float>            dist;
+          LibSL::Memory::Array::Array<LibSL::Math::v2i> prev;
+          TargetStopCondition<CompactGraph> stop( target );
+          t_NodeId check = dijkstra(g,source,dist,prev,stop);
+          _path.clear();
+          if (target == source) {
+            _path.push_back(LibSL::Math::V2I(source,-1));
+            return dist[target];
+          }
+          if (check != target) {
+            // no path!
+            return -1.0f;
+          }
+          // backtrack path
+          t_NodeId u = target;
+          do {
+            _path.push_back(LibSL::Math::V2I(u,prev[u][1]));
+            u = prev[u][0];
+          } while (u != source);
+          _path.push_back(LibSL::Math::V2I(source,-1));
+          std::reverse(_path.begin(),_path.end());
+          return dist[target];
+        }
+
+        //! Multithreaded delta-stepping (Meyer and Sanders) from several sources
+        //!   fills _dist and _prev as dijkstra does, equal cost paths may be broken differently
+        //!   delta is the bucket width, when <= 0 the average arc cost is used
+        void deltaStepping(
+          const CompactGraph&                            g,
+          const std::vector<t_NodeId>&                   sources,
+          LibSL::Memory::Array::Array<float>&           _dist,
+          LibSL::Memory::Array::Array<LibSL::Math::v2i>& _prev,
+          float                                          delta = 0.0f)
+        {
+          using namespace LibSL::System;
+          int num_nodes = g.numNodes();
+          if (delta <= 0.0f) {
+            double sum = 0.0;
+            ForIndex(a,g.numArcs()) { sum += g.arcCost(a); }
+            delta = g.numArcs() > 0 ? float(sum / g.numArcs()) : 1.0f;
+            if (delta <= 0.0f) { delta = 1.0f; }
+          }
+          // init
+          if (m_Best.size() != size_t(num_nodes)) {
+            std::vector<std::atomic<unsigned long long> > best(num_nodes);
+            m_Best.swap(best);
+          }
+          const unsigned long long none = ((unsigned long long)toKey(Infinity) << 32) | 0xFFFFFFFFull;
+          if (m_InBucket .size() != uint(num_nodes)) { m_InBucket .allocate(num_nodes); }
+          if (m_SettledIn.size() != uint(num_nodes)) { m_SettledIn.allocate(num_nodes); }
+          Parallel::forIndex(0,num_nodes,[&](int n) {
+            m_Best[n].store(none,std::memory_order_relaxed);
+            m_InBucket [n] = -1;
+            m_SettledIn[n] = -1;
+          },4096);
+          m_Requests.resize(Parallel::numThreads());
+          m_Buckets.clear();
+          m_Buckets.resize(1);
+          int pending = 0;
+          ForIndex(s,sources.size()) {
+            if (m_InBucket[sources[s]] == 0) {
+              continue;
+            }
+            m_Best[sources[s]].store(0,std::memory_order_relaxed);
+            m_InBucket[sources[s]] = 0;
+            m_Buckets[0].push_back(sources[s]);
+            pending ++;
+          }
+          // process buckets in order
+          for (int cur = 0 ; pending > 0 ; cur ++) {
+            m_Settled.clear();
+            while (cur < int(m_Buckets.size()) && !m_Buckets[cur].empty()) {
+              // extract current bucket, skipping stale entries
+              m_Frontier.clear();
+              std::vector<t_NodeId>& bucket = m_Buckets[cur];
+              pending -= int(bucket.size());
+              ForIndex(i,bucket.size()) {
+                t_NodeId v = bucket[i];
+                if (m_InBucket[v] == cur) {
+                  m_InBucket[v] = -1;
+                  m_Frontier.push_back(v);
+                  if (m_SettledIn[v] != cur) {
+                    m_SettledIn[v] = cur;
+                    m_Settled.push_back(v);
+                  }
+                }
+              }
+              bucket.clear();
+              // light arcs may reinsert nodes in the current bucket
+              relax(g,m_Frontier,delta,true);
+              pending += merge(delta,cur);
+            }
+            if (cur < int(m_Buckets.size())) {
+              std::vector<t_NodeId>().swap(m_Buckets[cur]);
+            }
+            // heavy arcs always lead to later buckets
+            relax(g,m_Settled,delta,false);
+            pending += merge(delta,cur + 1);
+          }
+          // output
+          if (_dist.size() != uint(num_nodes)) { _dist.allocate( num_nodes ); }
+          if (_prev.size() != uint(num_nodes)) { _prev.allocate( num_nodes ); }
+          Parallel::forIndex(0,num_nodes,[&](int n) {
+            unsigned long long best = m_Best[n].load(std::memory_order_relaxed);
+            uint a = uint(best & 0xFFFFFFFFull);
+            _dist[n] = fromKey(uint(best >> 32));
+            if (a == 0 || a == 0xFFFFFFFFu) {
+              _prev[n] = LibSL::Math::V2I(-1,-1);
+            } else {
+              _prev[n] = LibSL::Math::V2I(g.arcSource(int(a) - 1),g.arcEdgeId(int(a) - 1));
+            }
+          },1024);
+        }
+
+        //! Computes for every node the source it is closest to (-1 if unreachable),
+        //! from the outputs of dijkstraFromSources or deltaStepping
+        static void origins(
+          const LibSL::Memory::Array::Array<float>&            dist,
+          const LibSL::Memory::Array::Array<LibSL::Math::v2i>& prev,
+          LibSL::Memory::Array::Array<int>&                   _origin)
+        {
+          using namespace LibSL::System;
+          int num_nodes = int(prev.size());
+          LibSL::Memory::Array::Array<int> jump(num_nodes);
+          _origin.allocate(num_nodes);
+          Parallel::forIndex(0,num_nodes,[&](int n) {
+            _origin[n] = prev[n][0] == -1 ? n : prev[n][0];
+          },4096);
+          // pointer jumping, log(depth) passes
+          bool changed = true;
+          while (changed) {
+            std::atomic<bool> any(false);
+            Parallel::forIndex(0,num_nodes,[&](int n) {
+              jump[n] = _origin[_origin[n]];
+              if (jump[n] != _origin[n]) {
+                any.store(true,std::memory_order_relaxed);
+              }
+            },4096);
+            Parallel::forIndex(0,num_nodes,[&](int n) { _origin[n] = jump[n]; },4096);
+            changed = any.load();
+          }
+          Parallel::forIndex(0,num_nodes,[&](int n) {
+            if (dist[n] >= Infinity) {
+              _origin[n] = -1;
+            }
+          },4096);
+        }
+
+      }; // CompactShortestPaths
+
+    } //namespace LibSL::DataStructures::GraphAlgorithms
+  } //namespace LibSL::DataStructures
+} //namespace LibSL
+
+// ------------------------------------------------------
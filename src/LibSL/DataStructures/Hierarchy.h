@@ -43,9 +43,6 @@ knowledge of the CeCILL-C license and that you accept its terms.
 //    and optimized either for depth-first or breadth-first
 //    traversal.
 //
-// TODO
-//  - StaticHierarchy
-//
 // ------------------------------------------------------
 // Sylvain Lefebvre - 2006-06-14
 // ------------------------------------------------------
@@ -56,8 +53,12 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include <LibSL/CppHelpers/CppHelpers.h>
 #include <LibSL/Memory/Pointer.h>
 #include <LibSL/Memory/TraceLeaks.h>
+#include <LibSL/Math/Math.h>
+#include <LibSL/System/Parallel.h>
 
 #include <list>
+#include <vector>
+#include <utility>
 
 namespace LibSL {
   namespace DataStructures {
@@ -161,7 +162,7 @@ namespace LibSL {
       //! Add a child to the hierarchy, build around some data
       t_AutoPtr addChild(const T_Data& d)
       {
-        t_AutoPtr child=new Hierarchy(d);
+        t_AutoPtr child(new Hierarchy(d));
         m_Children.push_back(child);
         return (child);
       }
@@ -190,46 +191,373 @@ namespace LibSL {
     \class StaticHierarchy
     \brief Use this class to store a static hierarchy and efficiently traverse it.
     Traversal can be optimized for depth-first or breadth-first.
-    The hierarchy cannot be changed once backed into a StaticHierarchy
+    The hierarchy cannot be changed once baked into a StaticHierarchy
+
+    Nodes are flattened into arrays, the root is node 0 and parents always
+    come before their children. With the DepthFirst layout the subtree of
+    node i is the index range [i,subtreeEnd(i)[. With the BreadthFirst layout
+    each level is contiguous, and so are the children of a node.
+
+    propagate() and reduce() sweep the arrays top-down / bottom-up, typically
+    to turn local transforms into global ones or to gather bounding boxes.
+    Large hierarchies are processed in parallel (see System/Parallel.h): level
+    by level for BreadthFirst, over independent subtrees for DepthFirst.
     */
-    /*
     template <typename T_Data>
-    class StaticDepthFirstHierarchy
+    class StaticHierarchy
     {
+    public:
+
+      typedef Hierarchy<T_Data>               t_Hierarchy;
+      typedef typename t_Hierarchy::t_AutoPtr t_HierarchyPtr;
+
+      enum e_Layout { DepthFirst, BreadthFirst };
+
+      static const uint npos = 0xFFFFFFFFu;
+
+      // Children iterator class
+      class ChildrenIterator
+      {
+      private:
+        const StaticHierarchy *m_Owner;
+        uint                   m_Current;
+      public:
+
+        ChildrenIterator(const StaticHierarchy *h,uint node)
+          : m_Owner(h), m_Current(h->firstChild(node)) { }
+
+        //! Returns true if there are no more children
+        bool end() const     { return (m_Current == npos); }
+        //! Go to the next child
+        void next()          { sl_assert(!end()); m_Current = m_Owner->nextSibling(m_Current); }
+        //! Retrieve current child index
+        uint current() const { return (m_Current); }
+      };
+
     private:
 
-    class Node
-    {
-    public:
-    int    m_ParentPos;
-    T_Data m_Data;
-    Node(const T_Data& d,int p) : m_Data(d), m_ParentPos(p) {}
-    }
+      enum { e_SerialBelow = 16384, e_FrontierSize = 256, e_Grain = 1024 };
+
+      e_Layout            m_Layout;
+      std::vector<T_Data> m_Data;
+      std::vector<uint>   m_Parent;      // npos for the root
+      std::vector<uint>   m_FirstChild;  // npos for leaves
+      std::vector<uint>   m_NextSibling; // npos for last children
+      std::vector<uint>   m_NumChildren;
+      std::vector<uint>   m_Depth;
+      std::vector<uint>   m_SubtreeEnd;  // one past the last descendant (DepthFirst)
+      std::vector<uint>   m_LevelStart;  // first node of each level, then numNodes (BreadthFirst)
+      std::vector<uint>   m_Top;         // nodes down to the frontier depth, in order (DepthFirst)
+      std::vector<uint>   m_Frontier;    // roots of the subtrees processed in parallel (DepthFirst)
+
+      void addNode(const T_Data& d,uint parent,std::vector<uint>& lastChild)
+      {
+        uint id = uint(m_Data.size());
+        m_Data       .push_back(d);
+        m_Parent     .push_back(parent);
+        m_FirstChild .push_back(npos);
+        m_NextSibling.push_back(npos);
+        m_NumChildren.push_back(0);
+        m_Depth      .push_back(parent == npos ? 0 : m_Depth[parent] + 1);
+        lastChild    .push_back(npos);
+        if (parent != npos) {
+          if (lastChild[parent] == npos) {
+            m_FirstChild[parent]             = id;
+          } else {
+            m_NextSibling[lastChild[parent]] = id;
+          }
+          lastChild[parent] = id;
+          m_NumChildren[parent] ++;
+        }
+      }
 
-    std::vector<Node> m_Nodes;
+      void unfoldDepthFirst(t_HierarchyPtr h)
+      {
+        std::vector<uint>                                   lastChild;
+        std::vector<std::pair<t_HierarchyPtr,uint> >        stack;
+        std::vector<t_HierarchyPtr>                         children;
+        stack.push_back(std::make_pair(h,npos));
+        while (!stack.empty()) {
+          t_HierarchyPtr node   = stack.back().first;
+          uint           parent = stack.back().second;
+          stack.pop_back();
+          uint id = uint(m_Data.size());
+          addNode(node->data(),parent,lastChild);
+          // push children in reverse so that the first child is unfolded first
+          children.clear();
+          for (typename t_Hierarchy::ChildrenIterator I = node->children() ; !I.end() ; I.next()) {
+            children.push_back(I.current());
+          }
+          for (size_t c = children.size() ; c > 0 ; c--) {
+            stack.push_back(std::make_pair(children[c - 1],id));
+          }
+        }
+        // subtree ranges, descendants are after their ancestors
+        uint n = numNodes();
+        m_SubtreeEnd.resize(n);
+        for (uint i = n ; i > 0 ; i--) {
+          uint c = i - 1;
+          m_SubtreeEnd[c] = LibSL::Math::max(m_SubtreeEnd[c],c + 1);
+          if (m_Parent[c] != npos) {
+            m_SubtreeEnd[m_Parent[c]] = LibSL::Math::max(m_SubtreeEnd[m_Parent[c]],m_SubtreeEnd[c]);
+          }
+        }
+        // frontier: shallowest depth with enough nodes to balance the work
+        std::vector<uint> perDepth;
+        ForIndex(i,n) {
+          if (m_Depth[i] >= perDepth.size()) {
+            perDepth.resize(m_Depth[i] + 1,0);
+          }
+          perDepth[m_Depth[i]] ++;
+        }
+        uint frontier = 0;
+        ForIndex(d,perDepth.size()) {
+          if (perDepth[d] > perDepth[frontier]) {
+            frontier = d;
+          }
+          if (perDepth[d] >= e_FrontierSize) {
+            frontier = d;
+            break;
+          }
+        }
+        ForIndex(i,n) {
+          if (m_Depth[i] <= frontier) {
+            m_Top.push_back(i);
+          }
+          if (m_Depth[i] == frontier) {
+            m_Frontier.push_back(i);
+          }
+        }
+      }
 
-    void unfoldHierarchyDepthFirst(Hierarchy<T_Data>::t_AutoPtr h,int parent)
-    {
-    Node n(h->data(),parent);
-    m_Nodes.push_back(n);
-    int nodepos = m_Nodes.size();
-    for (Hierarchy<uint>::ChildrenIterator I=h->children();
-    !I.end();I.next()) {
-    unfoldHierarchyDepthFirst(I.current(),nodepos);
-    }
-    }
+      void unfoldBreadthFirst(t_HierarchyPtr h)
+      {
+        std::vector<uint>           lastChild;
+        std::vector<t_HierarchyPtr> queue;
+        queue.push_back(h);
+        addNode(h->data(),npos,lastChild);
+        for (uint head = 0 ; head < queue.size() ; head++) {
+          for (typename t_Hierarchy::ChildrenIterator I = queue[head]->children() ; !I.end() ; I.next()) {
+            queue.push_back(I.current());
+            addNode(I.current()->data(),head,lastChild);
+          }
+          queue[head] = t_HierarchyPtr(); // release early
+        }
+        ForIndex(i,numNodes()) {
+          if (m_Depth[i] == m_LevelStart.size()) {
+            m_LevelStart.push_back(i);
+          }
+        }
+        m_LevelStart.push_back(numNodes());
+      }
 
     public:
 
-    StaticHierarchy(Hierarchy<T_Data>::t_AutoPtr h)
-    {
-    unfoldHierarchyDepthFirst(h,-1);
-    }
+      StaticHierarchy() : m_Layout(DepthFirst) { }
+
+      //! Bake a hierarchy, optimizing the layout for depth-first or breadth-first traversal
+      StaticHierarchy(t_HierarchyPtr h,e_Layout layout = DepthFirst)
+      {
+        build(h,layout);
+      }
 
+      //! Bake a hierarchy, optimizing the layout for depth-first or breadth-first traversal
+      void build(t_HierarchyPtr h,e_Layout layout = DepthFirst)
+      {
+        clear();
+        m_Layout = layout;
+        if (h.isNull()) {
+          return;
+        }
+        if (layout == DepthFirst) {
+          unfoldDepthFirst(h);
+        } else {
+          unfoldBreadthFirst(h);
+        }
+      }
 
+      void clear()
+      {
+        m_Data       .clear();
+        m_Parent     .clear();
+        m_FirstChild .clear();
+        m_NextSibling.clear();
+        m_NumChildren.clear();
+        m_Depth      .clear();
+        m_SubtreeEnd .clear();
+        m_LevelStart .clear();
+        m_Top        .clear();
+        m_Frontier   .clear();
+      }
+
+      e_Layout layout()   const { return (m_Layout); }
+      uint     numNodes() const { return uint(m_Data.size()); }
+      bool     empty()    const { return (m_Data.empty()); }
+      uint     root()     const { return (0); }
+
+      //! Retrieve data at a node (const access)
+      const T_Data& data(uint i) const { return (m_Data[i]); }
+      //! Retrieve data at a node
+      T_Data&       data(uint i)       { return (m_Data[i]); }
+
+      //! Parent of a node, npos for the root
+      uint parent(uint i)      const { return (m_Parent[i]); }
+      //! First child of a node, npos for leaves
+      uint firstChild(uint i)  const { return (m_FirstChild[i]); }
+      //! Next child of the same parent, npos for the last one
+      uint nextSibling(uint i) const { return (m_NextSibling[i]); }
+      uint numChildren(uint i) const { return (m_NumChildren[i]); }
+      bool isLeaf(uint i)      const { return (m_NumChildren[i] == 0); }
+      //! Depth of a node, the root is at depth 0
+      uint depth(uint i)       const { return (m_Depth[i]); }
+
+      //! Returns an iterator on the children of a node (see also StaticHierarchy::ChildrenIterator)
+      ChildrenIterator children(uint i) const
+      {
+        return (ChildrenIterator(this,i));
+      }
+
+      //! Subtree of node i is [i,subtreeEnd(i)[ (DepthFirst layout only)
+      uint subtreeEnd(uint i) const
+      {
+        sl_assert(m_Layout == DepthFirst);
+        return (m_SubtreeEnd[i]);
+      }
+
+      //! Number of nodes in the subtree of node i, including i (DepthFirst layout only)
+      uint subtreeSize(uint i) const
+      {
+        return (subtreeEnd(i) - i);
+      }
+
+      //! Number of levels (BreadthFirst layout only)
+      uint numLevels() const
+      {
+        sl_assert(m_Layout == BreadthFirst);
+        return (m_LevelStart.empty() ? 0 : uint(m_LevelStart.size()) - 1);
+      }
+
+      //! Level l is [levelBegin(l),levelEnd(l)[ (BreadthFirst layout only)
+      uint levelBegin(uint l) const { sl_assert(l < numLevels()); return (m_LevelStart[l]); }
+      uint levelEnd(uint l)   const { sl_assert(l < numLevels()); return (m_LevelStart[l + 1]); }
+
+      //! Raw arrays
+      const std::vector<T_Data>& rawData() const { return (m_Data); }
+      std::vector<T_Data>&       rawData()       { return (m_Data); }
+      const std::vector<uint>&   parents() const { return (m_Parent); }
+
+      //! Top-down propagation, typically local to global transforms:
+      //!   _global[root] = local[root]
+      //!   _global[i]    = combine(_global[parent(i)],local[i])
+      //! Both arrays are indexed by node, they may be the same array.
+      template <typename T_Value,class T_Combine>
+      void propagate(const T_Value *local,T_Value *_global,const T_Combine& combine) const
+      {
+        uint n = numNodes();
+        if (n == 0) {
+          return;
+        }
+        _global[0] = local[0];
+        if (n < e_SerialBelow || LibSL::System::Parallel::numThreads() < 2) {
+          for (uint i = 1 ; i < n ; i++) {
+            _global[i] = combine(_global[m_Parent[i]],local[i]);
+          }
+        } else if (m_Layout == BreadthFirst) {
+          for (uint l = 1 ; l < numLevels() ; l++) {
+            LibSL::System::Parallel::forChunks(int(m_LevelStart[l]),int(m_LevelStart[l + 1]),[&](int first,int last) {
+              for (int i = first ; i < last ; i++) {
+                _global[i] = combine(_global[m_Parent[i]],local[i]);
+              }
+            },e_Grain);
+          }
+        } else {
+          for (uint t = 1 ; t < m_Top.size() ; t++) {
+            uint i     = m_Top[t];
+            _global[i] = combine(_global[m_Parent[i]],local[i]);
+          }
+          LibSL::System::Parallel::forIndex(0,int(m_Frontier.size()),[&](int f) {
+            uint r = m_Frontier[f];
+            for (uint i = r + 1 ; i < m_SubtreeEnd[r] ; i++) {
+              _global[i] = combine(_global[m_Parent[i]],local[i]);
+            }
+          });
+        }
+      }
+
+      //! Top-down propagation, see above (_global is resized)
+      template <typename T_Value,class T_Combine>
+      void propagate(const std::vector<T_Value>& local,std::vector<T_Value>& _global,const T_Combine& combine) const
+      {
+        sl_assert(local.size() == numNodes());
+        _global.resize(local.size());
+        if (!local.empty()) {
+          propagate(&local[0],&_global[0],combine);
+        }
+      }
+
+      //! Top-down propagation of the node data, see above
+      template <class T_Combine>
+      void propagate(std::vector<T_Data>& _global,const T_Combine& combine) const
+      {
+        propagate(m_Data,_global,combine);
+      }
+
+      //! Bottom-up reduction, typically bounding boxes or subtree weights:
+      //!   reduce(_values[parent(i)],_values[i]) is called for all nodes but the root,
+      //!   after all descendants of i were reduced into _values[i].
+      //! The order in which siblings are reduced into their parent is unspecified.
+      template <typename T_Value,class T_Reduce>
+      void reduce(T_Value *_values,const T_Reduce& reduce) const
+      {
+        uint n = numNodes();
+        if (n == 0) {
+          return;
+        }
+        if (n < e_SerialBelow || LibSL::System::Parallel::numThreads() < 2) {
+          for (uint i = n - 1 ; i > 0 ; i--) {
+            reduce(_values[m_Parent[i]],_values[i]);
+          }
+        } else if (m_Layout == BreadthFirst) {
+          for (uint l = numLevels() - 1 ; l > 0 ; l--) {
+            // parents of level l, each gathers its contiguous children
+            LibSL::System::Parallel::forChunks(int(m_LevelStart[l - 1]),int(m_LevelStart[l]),[&](int first,int last) {
+              for (int p = first ; p < last ; p++) {
+                uint c = m_FirstChild[p];
+                ForIndex(k,m_NumChildren[p]) {
+                  reduce(_values[p],_values[c + k]);
+                }
+              }
+            },e_Grain);
+          }
+        } else {
+          LibSL::System::Parallel::forIndex(0,int(m_Frontier.size()),[&](int f) {
+            uint r = m_Frontier[f];
+            for (uint i = m_SubtreeEnd[r] - 1 ; i > r ; i--) {
+              reduce(_values[m_Parent[i]],_values[i]);
+            }
+          });
+          for (size_t t = m_Top.size() - 1 ; t > 0 ; t--) {
+            uint i = m_Top[t];
+            reduce(_values[m_Parent[i]],_values[i]);
+          }
+        }
+      }
+
+      //! Bottom-up reduction, see above
+      template <typename T_Value,class T_Reduce>
+      void reduce(std::vector<T_Value>& _values,const T_Reduce& reduce) const
+      {
+        sl_assert(_values.size() == numNodes());
+        if (!_values.empty()) {
+          this->reduce(&_values[0],reduce);
+        }
+      }
+
+    };
+
+    template <typename T_Data>
+    const uint StaticHierarchy<T_Data>::npos;
 
-    }
-    */
   } // namespace DataStructures
 } //namespace LibSL
 
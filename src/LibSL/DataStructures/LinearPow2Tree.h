@@ -0,0 +1,737 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::DataStructures::LinearPow2Tree
+// ------------------------------------------------------
+//
+// Pointerless variant of Pow2Tree
+//  - Nodes are stored in flat arrays, level by level and
+//    in Morton order within a level: the children of a
+//    node are contiguous and siblings are in slot order
+//  - Nodes are named by locational codes: the Morton code
+//    of the cell within its level, prefixed by a 1 bit.
+//    Parent, child and neighbor codes are O(1) bit tricks,
+//    parent and child indices are stored (O(1) as well)
+//  - Trees are built bottom-up, in bulk, from their leaves
+//  - Typical specializations are LinearQuadTree and
+//    LinearOcTree
+//
+// Child slots follow Pow2Tree::access: bit n of the slot
+// is the position along dimension n.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/CppHelpers/CppHelpers.h>
+#include <LibSL/Math/Tuple.h>
+#include <LibSL/Math/Math.h>
+#include <LibSL/System/System.h>
+#include <LibSL/System/Parallel.h>
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace LibSL {
+  namespace DataStructures {
+
+    //! Morton codes bit interleaving, one coordinate of up to 63/T_NumDim bits per dimension
+    template <uint T_NumDim> class MortonBits;
+
+    template <> class MortonBits<1>
+    {
+    public:
+      static unsigned long long spread (unsigned long long x) { return x; }
+      static unsigned long long compact(unsigned long long x) { return x; }
+    };
+
+    template <> class MortonBits<2>
+    {
+    public:
+      static unsigned long long spread(unsigned long long x)
+      {
+        x &= 0x00000000FFFFFFFFull;
+        x  = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x  = (x | (x <<  8)) & 0x00FF00FF00FF00FFull;
+        x  = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0Full;
+        x  = (x | (x <<  2)) & 0x3333333333333333ull;
+        x  = (x | (x <<  1)) & 0x5555555555555555ull;
+        return x;
+      }
+      static unsigned long long compact(unsigned long long x)
+      {
+        x &= 0x5555555555555555ull;
+        x  = (x | (x >>  1)) & 0x3333333333333333ull;
+        x  = (x | (x >>  2)) & 0x0F0F0F0F0F0F0F0Full;
+        x  = (x | (x >>  4)) & 0x00FF00FF00FF00FFull;
+        x  = (x | (x >>  8)) & 0x0000FFFF0000FFFFull;
+        x  = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+        return x;
+      }
+    };
+
+    template <> class MortonBits<3>
+    {
+    public:
+      static unsigned long long spread(unsigned long long x)
+      {
+        x &= 0x00000000001FFFFFull;
+        x  = (x | (x << 32)) & 0x001F00000000FFFFull;
+        x  = (x | (x << 16)) & 0x001F0000FF0000FFull;
+        x  = (x | (x <<  8)) & 0x100F00F00F00F00Full;
+        x  = (x | (x <<  4)) & 0x10C30C30C30C30C3ull;
+        x  = (x | (x <<  2)) & 0x1249249249249249ull;
+        return x;
+      }
+      static unsigned long long compact(unsigned long long x)
+      {
+        x &= 0x1249249249249249ull;
+        x  = (x | (x >>  2)) & 0x10C30C30C30C30C3ull;
+        x  = (x | (x >>  4)) & 0x100F00F00F00F00Full;
+        x  = (x | (x >>  8)) & 0x001F0000FF0000FFull;
+        x  = (x | (x >> 16)) & 0x001F00000000FFFFull;
+        x  = (x | (x >> 32)) & 0x00000000001FFFFFull;
+        return x;
+      }
+    };
+
+    /*!
+
+    \class LinearPow2Tree
+    \brief Linear (pointerless) binary trees, quadtrees and octrees
+
+    */
+    template <uint T_NumDim,typename T_Data>
+    class LinearPow2Tree
+    {
+    public:
+
+      enum {e_NumDim      = T_NumDim};
+      enum {e_NumChildren = (1 << T_NumDim)};
+      //! deepest level, locational codes fit in 64 bits
+      enum {e_MaxLevel    = 63 / T_NumDim};
+
+      typedef unsigned long long                t_Key;
+      typedef LibSL::Math::Tuple<int,T_NumDim>  t_Access;
+      typedef LibSL::Math::Tuple<uint,T_NumDim> t_Coords;
+
+      //! invalid node index
+      static const uint npos = 0xFFFFFFFFu;
+
+      // Children iterator class
+      class ChildrenIterator
+      {
+      private:
+
+        const LinearPow2Tree *m_Owner;
+        uint                  m_Node;
+        uint                  m_Slot;
+
+      public:
+
+        ChildrenIterator(const LinearPow2Tree *t,uint node)
+        {
+          m_Owner = t;
+          m_Node  = node;
+          m_Slot  = 0;
+          if (!(m_Owner->childMask(m_Node) & 1)) {
+            next();
+          }
+        }
+
+        //! Returns true if there are no more children in the list
+        bool end() const
+        {
+          return (m_Slot >= e_NumChildren);
+        }
+
+        //! Go to the next child in the list
+        void next()
+        {
+          sl_assert(!end());
+          do {
+            m_Slot ++;
+          } while (m_Slot < e_NumChildren && !(m_Owner->childMask(m_Node) & (1u << m_Slot)));
+        }
+
+        //! Index of the current child
+        uint current() const
+        {
+          return (m_Owner->child(m_Node,m_Slot));
+        }
+
+        //! Slot of the current child
+        uint slot() const
+        {
+          return (m_Slot);
+        }
+      };
+
+    private:
+
+      std::vector<t_Key>  m_Keys;
+      std::vector<uint>   m_Parents;
+      std::vector<uint>   m_FirstChild;
+      std::vector<uchar>  m_ChildMask;
+      std::vector<T_Data> m_Data;
+      std::vector<uint>   m_LevelStart;  // numLevels()+1 entries
+
+      static uint bitCount(uint m)
+      {
+        uint n = 0;
+        while (m) { m &= m - 1; n ++; }
+        return (n);
+      }
+
+      static uint highestBit(t_Key k)
+      {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(k);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long b;
+        _BitScanReverse64(&b,k);
+        return uint(b);
+#else
+        uint b = 0;
+        while (k >>= 1) { b ++; }
+        return b;
+#endif
+      }
+
+      static uint access(const t_Access& pos)
+      {
+        uint offset = 0;
+        ForIndex(n,T_NumDim) {
+          sl_assert(pos[n] >= 0 && pos[n] < 2);
+          offset |= uint(pos[n]) << n;
+        }
+        return (offset);
+      }
+
+      // Nodes of one level during the bottom-up build
+      struct Level
+      {
+        std::vector<t_Key> keys;
+        std::vector<uint>  firstChild; // index in the level below, npos for leaves
+        std::vector<uchar> mask;
+        std::vector<uint>  leaf;       // index of the input leaf, npos for inner nodes
+      };
+
+    public:
+
+      LinearPow2Tree()
+      {
+        sl_assert(T_NumDim >= 1 && T_NumDim <= 3);
+      }
+
+      // ---- locational codes
+
+      //! Locational code of the root
+      static t_Key rootKey() { return (1); }
+
+      //! Locational code of cell p at a given level (root is level 0)
+      static t_Key encode(const t_Coords& p,uint level)
+      {
+        sl_assert(level <= e_MaxLevel);
+        t_Key k = 0;
+        ForIndex(n,T_NumDim) {
+          sl_assert(p[n] < (1ull << level));
+          k |= MortonBits<T_NumDim>::spread(p[n]) << n;
+        }
+        return (k | (t_Key(1) << (T_NumDim*level)));
+      }
+
+      //! Cell and level of a locational code
+      static void decode(t_Key k,t_Coords& _p,uint& _level)
+      {
+        sl_assert(k != 0);
+        _level = highestBit(k) / T_NumDim;
+        k     ^= t_Key(1) << (T_NumDim*_level);
+        ForIndex(n,T_NumDim) {
+          _p[n] = uint(MortonBits<T_NumDim>::compact(k >> n));
+        }
+      }
+
+      //! Level of a locational code
+      static uint levelOf(t_Key k)            { sl_assert(k != 0); return (highestBit(k) / T_NumDim); }
+      //! Locational code of the parent (the root has none)
+      static t_Key parentKey(t_Key k)         { sl_assert(k > 1); return (k >> T_NumDim); }
+      //! Locational code of a child
+      static t_Key childKey(t_Key k,uint slot){ sl_assert(slot < e_NumChildren); return ((k << T_NumDim) | slot); }
+      //! Slot of a node within its parent
+      static uint slotOf(t_Key k)             { return (uint(k) & (e_NumChildren-1)); }
+
+      //! Morton order of locational codes at possibly different levels (ancestors first)
+      static bool mortonLess(t_Key a,t_Key b)
+      {
+        uint  la = levelOf(a), lb = levelOf(b), l = LibSL::Math::max(la,lb);
+        t_Key ca = (a ^ (t_Key(1) << (T_NumDim*la))) << alignShift(l,la);
+        t_Key cb = (b ^ (t_Key(1) << (T_NumDim*lb))) << alignShift(l,lb);
+        return (ca < cb || (ca == cb && la < lb));
+      }
+
+      //! Locational code of the neighbor at offset dir within the same level
+      //! returns false if the neighbor falls outside the tree domain
+      static bool neighborKey(t_Key k,const t_Access& dir,t_Key& _n)
+      {
+        t_Coords p;
+        uint     level;
+        decode(k,p,level);
+        long long sz = 1ll << level;
+        ForIndex(n,T_NumDim) {
+          long long c = (long long)p[n] + dir[n];
+          if (c < 0 || c >= sz) {
+            return (false);
+          }
+          p[n] = uint(c);
+        }
+        _n = encode(p,level);
+        return (true);
+      }
+
+      // ---- construction
+
+      //! Builds the tree bottom-up from its leaves
+      //!  - leafKeys are locational codes sorted in Morton order (see mortonLess)
+      //!  - leaves may be at any level but no leaf may contain another
+      //!  - data of inner nodes starts as T_Data() and is combined
+      //!    with every child through reduce(T_Data& parent,const T_Data& child)
+      //! Levels are processed in parallel (see System/Parallel.h)
+      template <class T_Reduce>
+      void build(const std::vector<t_Key>& leafKeys,const std::vector<T_Data>& leafData,const T_Reduce& reduce)
+      {
+        using namespace LibSL::System;
+        if (leafKeys.size() != leafData.size()) {
+          throw LibSL::Errors::Fatal("LinearPow2Tree::build - %d keys but %d data",int(leafKeys.size()),int(leafData.size()));
+        }
+        if (leafKeys.size() >= size_t(npos)) {
+          throw LibSL::Errors::Fatal("LinearPow2Tree::build - too many leaves");
+        }
+        clear();
+        const int n = int(leafKeys.size());
+        if (n == 0) {
+          return;
+        }
+        // deepest level, and ordering check
+        uint maxLevel = 0;
+        ForIndex(i,n) {
+          if (leafKeys[i] == 0) {
+            throw LibSL::Errors::Fatal("LinearPow2Tree::build - invalid key at leaf %d",i);
+          }
+          maxLevel = LibSL::Math::max(maxLevel,levelOf(leafKeys[i]));
+        }
+        std::atomic<int> bad(-1);
+        Parallel::forChunks(1,n,[&](int first,int last) {
+          for (int i = first ; i < last ; i++) {
+            // the next leaf must start after the previous one ends
+            uint  la = levelOf(leafKeys[i-1]), lb = levelOf(leafKeys[i]);
+            t_Key a  = (leafKeys[i-1] ^ (t_Key(1) << (T_NumDim*la))) << alignShift(maxLevel,la);
+            t_Key b  = (leafKeys[i  ] ^ (t_Key(1) << (T_NumDim*lb))) << alignShift(maxLevel,lb);
+            t_Key ea = a + (t_Key(1) << alignShift(maxLevel,la));
+            if (b < ea || ea == 0) {
+              bad = i;
+              return;
+            }
+          }
+        },4096);
+        if (bad >= 0) {
+          throw LibSL::Errors::Fatal("LinearPow2Tree::build - leaves are not sorted in Morton order or overlap (leaf %d)",int(bad));
+        }
+        // bucket leaves by level, order is preserved
+        std::vector<Level> levels(maxLevel+1);
+        ForIndex(i,n) {
+          Level& lv = levels[levelOf(leafKeys[i])];
+          lv.keys      .push_back(leafKeys[i]);
+          lv.leaf      .push_back(uint(i));
+          lv.firstChild.push_back(npos);
+          lv.mask      .push_back(0);
+        }
+        // bottom-up: parents of level l+1, merged with the leaves of level l
+        for (int l = int(maxLevel) - 1 ; l >= 0 ; l--) {
+          const Level& below = levels[l+1];
+          Level        inner;
+          gatherParents(below,inner);
+          Level&       lv = levels[l];
+          Level        merged;
+          size_t       total = inner.keys.size() + lv.keys.size();
+          merged.keys.reserve(total); merged.firstChild.reserve(total); merged.mask.reserve(total); merged.leaf.reserve(total);
+          size_t a = 0, b = 0;
+          while (a < inner.keys.size() || b < lv.keys.size()) {
+            bool takeInner = (b >= lv.keys.size()) || (a < inner.keys.size() && inner.keys[a] < lv.keys[b]);
+            const Level& src = takeInner ? inner : lv;
+            size_t       k   = takeInner ? a ++ : b ++;
+            merged.keys      .push_back(src.keys[k]);
+            merged.firstChild.push_back(src.firstChild[k]);
+            merged.mask      .push_back(src.mask[k]);
+            merged.leaf      .push_back(src.leaf[k]);
+          }
+          std::swap(lv,merged);
+        }
+        sl_assert(levels[0].keys.size() == 1 && levels[0].keys[0] == rootKey());
+        // flatten
+        m_LevelStart.resize(levels.size() + 1);
+        m_LevelStart[0] = 0;
+        ForIndex(l,levels.size()) {
+          m_LevelStart[l+1] = m_LevelStart[l] + uint(levels[l].keys.size());
+        }
+        uint numNodes = m_LevelStart.back();
+        m_Keys      .resize(numNodes);
+        m_Parents   .resize(numNodes);
+        m_FirstChild.resize(numNodes);
+        m_ChildMask .resize(numNodes);
+        m_Data      .assign(numNodes,T_Data());
+        m_Parents[0] = npos;
+        ForIndex(l,levels.size()) {
+          const Level& lv   = levels[l];
+          uint         base = m_LevelStart[l];
+          uint         next = (l+1 < int(levels.size())) ? m_LevelStart[l+1] : 0;
+          Parallel::forIndex(0,int(lv.keys.size()),[&](int i) {
+            uint g          = base + i;
+            m_Keys     [g]  = lv.keys[i];
+            m_ChildMask[g]  = lv.mask[i];
+            m_FirstChild[g] = (lv.firstChild[i] == npos) ? npos : next + lv.firstChild[i];
+            if (lv.leaf[i] != npos) {
+              m_Data[g] = leafData[lv.leaf[i]];
+            }
+            uint nc = bitCount(lv.mask[i]);
+            ForIndex(c,nc) {
+              m_Parents[m_FirstChild[g] + c] = g;
+            }
+          },1024);
+        }
+        // reduce data upwards
+        for (int l = int(levels.size()) - 2 ; l >= 0 ; l--) {
+          Parallel::forIndex(int(m_LevelStart[l]),int(m_LevelStart[l+1]),[&](int g) {
+            uint nc = bitCount(m_ChildMask[g]);
+            ForIndex(c,nc) {
+              reduce(m_Data[g],m_Data[m_FirstChild[g] + c]);
+            }
+          },1024);
+        }
+      }
+
+      //! Builds the tree bottom-up from its leaves, inner nodes data is T_Data()
+      void build(const std::vector<t_Key>& leafKeys,const std::vector<T_Data>& leafData)
+      {
+        build(leafKeys,leafData,[](T_Data&,const T_Data&) { });
+      }
+
+      //! Empties the tree
+      void clear()
+      {
+        m_Keys.clear(); m_Parents.clear(); m_FirstChild.clear();
+        m_ChildMask.clear(); m_Data.clear(); m_LevelStart.clear();
+      }
+
+      // ---- nodes
+
+      //! Returns number of nodes
+      uint numNodes()  const { return (uint(m_Keys.size())); }
+      //! Returns number of levels (0 for an empty tree)
+      uint numLevels() const { return (m_LevelStart.empty() ? 0 : uint(m_LevelStart.size()) - 1); }
+      //! Returns tree height
+      uint height()    const { return (numLevels() > 0 ? numLevels() - 1 : 0); }
+      //! Nodes of a level are in [levelBegin(l),levelEnd(l)[
+      uint levelBegin(uint l) const { return (m_LevelStart[l]); }
+      uint levelEnd  (uint l) const { return (m_LevelStart[l+1]); }
+
+      //! Index of the root
+      uint root() const { sl_assert(!m_Keys.empty()); return (0); }
+
+      //! Retrieve data at a node
+      const T_Data& data(uint i) const { return (m_Data[i]); }
+      T_Data&       data(uint i)       { return (m_Data[i]); }
+
+      //! Locational code of a node
+      t_Key key(uint i)     const { return (m_Keys[i]); }
+      //! Level of a node
+      uint  level(uint i)   const { return (levelOf(m_Keys[i])); }
+      //! Cell covered by a node, at its level
+      void  cell(uint i,t_Coords& _p,uint& _level) const { decode(m_Keys[i],_p,_level); }
+
+      //! Parent of a node, npos for the root
+      uint  parent(uint i)     const { return (m_Parents[i]); }
+      //! Bit mask of existing children
+      uint  childMask(uint i)  const { return (m_ChildMask[i]); }
+      //! Returns true if the node is a leaf
+      bool  isLeaf(uint i)     const { return (m_ChildMask[i] == 0); }
+      //! Returns the number of children of a node
+      uint  numChildren(uint i) const { return (bitCount(m_ChildMask[i])); }
+      //! Index of the first child (children are contiguous), npos for leaves
+      uint  firstChild(uint i) const { return (m_FirstChild[i]); }
+
+      //! Index of the child in a given slot, npos if there is none
+      uint child(uint i,uint slot) const
+      {
+        sl_assert(slot < e_NumChildren);
+        uint m = m_ChildMask[i];
+        if (!(m & (1u << slot))) {
+          return (npos);
+        }
+        return (m_FirstChild[i] + bitCount(m & ((1u << slot) - 1)));
+      }
+
+      //! Index of a child, npos if there is none
+      uint childAt(uint i,const t_Access& pos) const
+      {
+        return (child(i,access(pos)));
+      }
+
+      //! Returns an iterator on the children of a node
+      ChildrenIterator children(uint i) const
+      {
+        return (ChildrenIterator(this,i));
+      }
+
+      //! Returns number of leaves
+      uint numLeaves() const
+      {
+        uint n = 0;
+        ForIndex(i,m_ChildMask.size()) {
+          if (m_ChildMask[i] == 0) n ++;
+        }
+        return (n);
+      }
+
+      //! Index of the node with a given locational code, npos if absent (binary search within the level)
+      uint find(t_Key k) const
+      {
+        uint l = levelOf(k);
+        if (l >= numLevels()) {
+          return (npos);
+        }
+        typename std::vector<t_Key>::const_iterator b = m_Keys.begin() + m_LevelStart[l];
+        typename std::vector<t_Key>::const_iterator e = m_Keys.begin() + m_LevelStart[l+1];
+        typename std::vector<t_Key>::const_iterator I = std::lower_bound(b,e,k);
+        if (I == e || *I != k) {
+          return (npos);
+        }
+        return (uint(I - m_Keys.begin()));
+      }
+
+      //! Index of the neighbor at offset dir within the same level, npos if absent
+      uint neighbor(uint i,const t_Access& dir) const
+      {
+        t_Key n;
+        if (!neighborKey(m_Keys[i],dir,n)) {
+          return (npos);
+        }
+        return (find(n));
+      }
+
+      //! Deepest node containing cell p of a given level
+      uint locate(const t_Coords& p,uint level) const
+      {
+        if (m_Keys.empty()) {
+          return (npos);
+        }
+        t_Key k   = encode(p,level);
+        uint  cur = 0;
+        ForRange(l,1,int(level)) {
+          uint c = child(cur,slotOf(k >> (T_NumDim*(level - l))));
+          if (c == npos) {
+            break;
+          }
+          cur = c;
+        }
+        return (cur);
+      }
+
+      // ---- raw access
+
+      const t_Key  *keys()     const { return (m_Keys.empty() ? NULL : &m_Keys[0]); }
+      const uint   *parents()  const { return (m_Parents.empty() ? NULL : &m_Parents[0]); }
+      const T_Data *rawData()  const { return (m_Data.empty() ? NULL : &m_Data[0]); }
+      T_Data       *rawData()        { return (m_Data.empty() ? NULL : &m_Data[0]); }
+
+      // ---- serialization
+
+      //! Saves the tree in a flat binary file (T_Data must be a plain old data type)
+      void save(const char *fname) const
+      {
+        FILE *f = NULL;
+        fopen_s(&f,fname,"wb");
+        if (f == NULL) {
+          throw LibSL::Errors::Fatal("LinearPow2Tree::save - cannot open '%s'",fname);
+        }
+        uint header[6] = { e_Magic, e_Version, T_NumDim, uint(sizeof(T_Data)), numNodes(), numLevels() };
+        bool ok = (fwrite(header,sizeof(header),1,f) == 1);
+        ok = ok && writeArray(f,m_LevelStart);
+        ok = ok && writeArray(f,m_Keys);
+        ok = ok && writeArray(f,m_Parents);
+        ok = ok && writeArray(f,m_FirstChild);
+        ok = ok && writeArray(f,m_ChildMask);
+        ok = ok && writeArray(f,m_Data);
+        fclose(f);
+        if (!ok) {
+          throw LibSL::Errors::Fatal("LinearPow2Tree::save - write error ('%s')",fname);
+        }
+      }
+
+      //! Loads a tree saved with save()
+      void load(const char *fname)
+      {
+        FILE *f = NULL;
+        fopen_s(&f,fname,"rb");
+        if (f == NULL) {
+          throw LibSL::Errors::Fatal("LinearPow2Tree::load - cannot open '%s'",fname);
+        }
+        clear();
+        uint header[6];
+        if (fread(header,sizeof(header),1,f) != 1
+          || header[0] != e_Magic || header[1] != e_Version
+          || header[2] != T_NumDim || header[3] != sizeof(T_Data)) {
+          fclose(f);
+          throw LibSL::Errors::Fatal("LinearPow2Tree::load - '%s' is not a compatible tree file",fname);
+        }
+        uint numNodes = header[4], numLevels = header[5];
+        bool ok = readArray(f,m_LevelStart,numNodes > 0 ? numLevels + 1 : 0);
+        ok = ok && readArray(f,m_Keys,numNodes);
+        ok = ok && readArray(f,m_Parents,numNodes);
+        ok = ok && readArray(f,m_FirstChild,numNodes);
+        ok = ok && readArray(f,m_ChildMask,numNodes);
+        ok = ok && readArray(f,m_Data,numNodes);
+        fclose(f);
+        if (!ok || (numNodes > 0 && m_LevelStart.back() != numNodes)) {
+          clear();
+          throw LibSL::Errors::Fatal("LinearPow2Tree::load - truncated or corrupted file '%s'",fname);
+        }
+      }
+
+    private:
+
+      enum {e_Magic = 0x5432504C}; // 'LP2T'
+      enum {e_Version = 1};
+
+      static uint alignShift(uint maxLevel,uint level)
+      {
+        return (T_NumDim * (maxLevel - level));
+      }
+
+      // Unique parents of a sorted level, with their first child and children mask
+      static void gatherParents(const Level& below,Level& _parents)
+      {
+        using namespace LibSL::System;
+        const int n = int(below.keys.size());
+        // chunk boundaries are fixed so that counts and writes agree
+        const int grain     = 4096;
+        const int numChunks = (n + grain - 1) / grain;
+        std::vector<uint> counts(numChunks + 1,0);
+        Parallel::forIndex(0,numChunks,[&](int c) {
+          int first = c * grain, last = LibSL::Math::min(n,first + grain);
+          uint cnt = 0;
+          for (int i = first ; i < last ; i++) {
+            if (i == 0 || (below.keys[i] >> T_NumDim) != (below.keys[i-1] >> T_NumDim)) cnt ++;
+          }
+          counts[c+1] = cnt;
+        });
+        ForIndex(c,numChunks) {
+          counts[c+1] += counts[c];
+        }
+        uint np = counts[numChunks];
+        _parents.keys      .resize(np);
+        _parents.firstChild.resize(np);
+        _parents.mask      .resize(np);
+        _parents.leaf      .assign(np,npos);
+        Parallel::forIndex(0,numChunks,[&](int c) {
+          int  first = c * grain, last = LibSL::Math::min(n,first + grain);
+          uint p     = counts[c];
+          for (int i = first ; i < last ; i++) {
+            t_Key pk = below.keys[i] >> T_NumDim;
+            if (i == 0 || pk != (below.keys[i-1] >> T_NumDim)) {
+              uchar m = 0;
+              for (int j = i ; j < n && (below.keys[j] >> T_NumDim) == pk ; j++) {
+                m |= uchar(1u << slotOf(below.keys[j]));
+              }
+              _parents.keys      [p] = pk;
+              _parents.firstChild[p] = uint(i);
+              _parents.mask      [p] = m;
+              p ++;
+            }
+          }
+        });
+      }
+
+      template <typename T>
+      static bool writeArray(FILE *f,const std::vector<T>& a)
+      {
+        return (a.empty() || fwrite(&a[0],sizeof(T),a.size(),f) == a.size());
+      }
+
+      template <typename T>
+      static bool readArray(FILE *f,std::vector<T>& _a,size_t n)
+      {
+        _a.resize(n);
+        return (n == 0 || fread(&_a[0],sizeof(T),n,f) == n);
+      }
+
+    };
+
+    template <uint T_NumDim,typename T_Data>
+    const uint LinearPow2Tree<T_NumDim,T_Data>::npos;
+
+    //! LinearBinaryTree
+    template <class T_Data>
+    class LinearBinaryTree : public LinearPow2Tree<1,T_Data>
+    {
+    };
+
+    //! LinearQuadTree
+    template <class T_Data>
+    class LinearQuadTree : public LinearPow2Tree<2,T_Data>
+    {
+    };
+
+    //! LinearOcTree
+    template <class T_Data>
+    class LinearOcTree : public LinearPow2Tree<3,T_Data>
+    {
+    };
+
+  } //namespace LibSL::DataStructures
+} //namespace LibSL
+
+// ------------------------------------------------------
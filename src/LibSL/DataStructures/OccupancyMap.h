@@ -1,6 +1,23 @@
 // Sylvain Lefebvre - 2008-04-11
 #pragma once
 
+// ------------------------------------------------------
+//
+// Occupancy maps register elements in the cells of a regular grid
+// covered by a sphere (pos,radius), and answer proximity queries.
+//
+//  - StaticOccupancyMap, built once from a set of elements with a
+//    two-pass counting sort: each cell is a range of a flat array (CSR)
+//  - HashedOccupancyMap, dynamic and sparse: only occupied cells are
+//    stored, in a sharded open-addressing hash table
+//  - OccupancyMap, a HashedOccupancyMap clamped to a fixed grid size
+//
+// Queries return ranges of elements (one per cell) rather than
+// filling sets. An element spanning several cells appears in each.
+// Elements must be comparable (operator <). Dynamic maps keep the
+// set semantics of the former std::set cells: a cell holds an
+// element at most once.
+//
 // ------------------------------------------------------
 
 #include <LibSL/Errors/Errors.h>
@@ -10,132 +27,661 @@
 #include <LibSL/Memory/Array.h>
 #include <LibSL/Math/Tuple.h>
 #include <LibSL/Math/Math.h>
+#include <LibSL/System/Parallel.h>
+
+#include <set>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 
 // ------------------------------------------------------
 
 namespace LibSL {
 namespace DataStructures {
 
+// ------------------------------------------------------
+
+//! Range of elements registered in a cell
 template <typename T_Element>
-class OccupancyMap
+class OccupancyRange
 {
-protected:
+private:
+  const T_Element *m_Begin;
+  const T_Element *m_End;
+public:
+  OccupancyRange() : m_Begin(NULL), m_End(NULL) { }
+  OccupancyRange(const T_Element *b,const T_Element *e) : m_Begin(b), m_End(e) { }
+  const T_Element *begin() const { return (m_Begin); }
+  const T_Element *end()   const { return (m_End); }
+  uint             size()  const { return uint(m_End - m_Begin); }
+  bool             empty() const { return (m_Begin == m_End); }
+  const T_Element& operator[](uint i) const { return (m_Begin[i]); }
+};
 
-  Array3D<std::set<T_Element> >      m_Map;
-  v3f                                m_MapScale;
+// ------------------------------------------------------
 
-public:
+//! Grid mapping shared by all occupancy maps
+class OccupancyMapGrid
+{
+protected:
 
-  typedef T_Element t_Element;
+  v3f           m_MapScale;
+  v3i           m_Size;     // (0,0,0) for an unbounded grid
+  bool          m_Bounded;
 
-  v3i           minCorner(const v3f& pos)
+  v3i           clampCell(const v3i& cell) const
+  {
+    if (!m_Bounded) {
+      return (cell);
+    }
+    return tupleMax(tupleMin(cell,m_Size - V3I(1,1,1)),V3I(0,0,0));
+  }
+
+  v3i           minCorner(const v3f& pos) const
   {
     v3i cell = 0;
     ForIndex(c,3) {
       cell[c] = int( floor(pos[c]*m_MapScale[c]) );
     }
-    uint sx  = m_Map.xsize()-1;
-    uint sy  = m_Map.ysize()-1;
-    uint sz  = m_Map.zsize()-1;
-    return tupleMax(tupleMin(cell,V3I(sx,sy,sz)),V3I(0,0,0));
+    return clampCell(cell);
   }
 
-  v3i           maxCorner(const v3f& pos)
+  v3i           maxCorner(const v3f& pos) const
   {
     v3i cell = 0;
     ForIndex(c,3) {
       cell[c] = int( ceil(pos[c]*m_MapScale[c]) );
     }
-    uint sx  = m_Map.xsize()-1;
-    uint sy  = m_Map.ysize()-1;
-    uint sz  = m_Map.zsize()-1;
-    return tupleMax(tupleMin(cell,V3I(sx,sy,sz)),V3I(0,0,0));
+    return clampCell(cell);
+  }
+
+public:
+
+  OccupancyMapGrid(const v3f& scale)
+    : m_MapScale(scale), m_Size(V3I(0,0,0)), m_Bounded(false) { }
+
+  OccupancyMapGrid(const v3i& size,const v3f& scale)
+    : m_MapScale(scale), m_Size(size), m_Bounded(true)
+  {
+    sl_assert(size[0] > 0 && size[1] > 0 && size[2] > 0);
   }
 
-  v3i           pos2Map(const v3f& pos)
+  v3i           pos2Map(const v3f& pos) const
   {
     v3i cell = 0;
     ForIndex(c,3) {
-      cell[c] = int( round(pos[c]*m_MapScale[c]) );
+      cell[c] = int( LibSL::Math::round(pos[c]*m_MapScale[c]) );
     }
-    uint sx  = m_Map.xsize()-1;
-    uint sy  = m_Map.ysize()-1;
-    uint sz  = m_Map.zsize()-1;
-    return tupleMax(tupleMin(cell,V3I(sx,sy,sz)),V3I(0,0,0));
+    return clampCell(cell);
   }
 
-  v3f           map2Pos(const v3i& m)
+  v3f           map2Pos(const v3i& m) const
   {
     return ( v3f(m) + v3f(0.5f) ) / m_MapScale;
   }
 
-  Tuple<v3i,2>  occupancyBox(const v3f& pos,float radius)
+  //! Inclusive box of cells covered by a sphere
+  Tuple<v3i,2>  occupancyBox(const v3f& pos,float radius) const
   {
     v3i bmin = minCorner(pos - v3f(1.0f)*radius);
     v3i bmax = maxCorner(pos + v3f(1.0f)*radius);
     return Pair(bmin,bmax);
   }
 
+  v3f           scale()   const { return m_MapScale; }
+  v3i           size()    const { return m_Size; }
+  bool          bounded() const { return m_Bounded; }
+};
+
+// ------------------------------------------------------
+
+/*!
+
+\class StaticOccupancyMap
+\brief Occupancy of a static set of elements over a bounded grid.
+Cells are ranges [start[c],start[c+1][ of a single element array,
+sorted within each cell. The build is parallel (see System/Parallel.h).
+
+*/
+template <typename T_Element>
+class StaticOccupancyMap : public OccupancyMapGrid
+{
 public:
 
-  OccupancyMap(const v3i& size,const v3f& scale)
+  typedef T_Element                 t_Element;
+  typedef OccupancyRange<T_Element> t_Range;
+
+protected:
+
+  std::vector<uint>       m_Start;  // numCells()+1 entries
+  std::vector<T_Element>  m_Items;
+
+  uint          cellIndex(int x,int y,int z) const
   {
-    m_MapScale = scale;
-    m_Map.allocate(size[0],size[1],size[2]);
+    return uint(x + m_Size[0] * (y + m_Size[1] * z));
   }
 
-  void          insert(const v3f& pos,float radius,const T_Element& key)
+public:
+
+  StaticOccupancyMap(const v3i& size,const v3f& scale) : OccupancyMapGrid(size,scale)
+  {
+    m_Start.assign(numCells() + 1,0);
+  }
+
+  uint          numCells() const { return uint(m_Size[0]) * uint(m_Size[1]) * uint(m_Size[2]); }
+  //! Total number of (cell,element) entries
+  uint          numItems() const { return uint(m_Items.size()); }
+
+  //! Register n elements, element i covering the sphere (pos[i],radius[i])
+  //! Replaces any previous content.
+  void          build(uint n,const v3f *pos,const float *radius,const T_Element *keys)
+  {
+    uint nc = numCells();
+    // visit elements in the order of their first cell, so that
+    // consecutive writes of pass 2 land close to each other
+    std::vector<uint> first(n);
+    std::vector<uint> order(n);
+    std::vector<uint> firstStart(nc + 1,0);
+    LibSL::System::Parallel::forChunks(0,int(n),[&](int b,int e) {
+      for (int i = b ; i < e ; i++) {
+        v3i c    = minCorner(pos[i] - v3f(1.0f)*radius[i]);
+        first[i] = cellIndex(c[0],c[1],c[2]);
+      }
+    },4096);
+    ForIndex(i,n) {
+      firstStart[first[i] + 1] ++;
+    }
+    ForIndex(c,nc) {
+      firstStart[c + 1] += firstStart[c];
+    }
+    ForIndex(i,n) {
+      order[firstStart[first[i]] ++] = i;
+    }
+    // pass 1: count entries per cell
+    std::vector<std::atomic<uint> > counts(nc + 1);
+    LibSL::System::Parallel::forChunks(0,int(n),[&](int b,int e) {
+      for (int o = b ; o < e ; o++) {
+        uint i = order[o];
+        Tuple<v3i,2> minmax = occupancyBox(pos[i],radius[i]);
+        ForRange(z,minmax[0][2],minmax[1][2]) {
+          ForRange(y,minmax[0][1],minmax[1][1]) {
+            ForRange(x,minmax[0][0],minmax[1][0]) {
+              counts[cellIndex(x,y,z)].fetch_add(1,std::memory_order_relaxed);
+            }
+          }
+        }
+      }
+    },256);
+    // prefix sum
+    m_Start.resize(nc + 1);
+    uint total = 0;
+    ForIndex(c,nc) {
+      m_Start[c] = total;
+      total     += counts[c].load(std::memory_order_relaxed);
+      counts[c].store(m_Start[c],std::memory_order_relaxed);
+    }
+    m_Start[nc] = total;
+    // pass 2: scatter, counts now act as write cursors
+    m_Items.resize(total);
+    LibSL::System::Parallel::forChunks(0,int(n),[&](int b,int e) {
+      for (int o = b ; o < e ; o++) {
+        uint i = order[o];
+        Tuple<v3i,2> minmax = occupancyBox(pos[i],radius[i]);
+        ForRange(z,minmax[0][2],minmax[1][2]) {
+          ForRange(y,minmax[0][1],minmax[1][1]) {
+            ForRange(x,minmax[0][0],minmax[1][0]) {
+              uint at     = counts[cellIndex(x,y,z)].fetch_add(1,std::memory_order_relaxed);
+              m_Items[at] = keys[i];
+            }
+          }
+        }
+      }
+    },256);
+    // sort cells so that the result does not depend on scheduling
+    LibSL::System::Parallel::forChunks(0,int(nc),[&](int first,int last) {
+      for (int c = first ; c < last ; c++) {
+        if (m_Start[c + 1] - m_Start[c] > 1) {
+          std::sort(m_Items.begin() + m_Start[c],m_Items.begin() + m_Start[c + 1]);
+        }
+      }
+    },4096);
+  }
+
+  //! Register elements, see above
+  void          build(const std::vector<v3f>& pos,const std::vector<float>& radius,const std::vector<T_Element>& keys)
+  {
+    sl_assert(pos.size() == radius.size() && pos.size() == keys.size());
+    if (keys.empty()) {
+      clear();
+    } else {
+      build(uint(keys.size()),&pos[0],&radius[0],&keys[0]);
+    }
+  }
+
+  void          clear()
+  {
+    m_Items.clear();
+    m_Start.assign(numCells() + 1,0);
+  }
+
+  //! Elements registered in a cell
+  t_Range       cell(const v3i& c) const
+  {
+    uint id = cellIndex(c[0],c[1],c[2]);
+    if (m_Items.empty()) {
+      return t_Range();
+    }
+    return t_Range(&m_Items[0] + m_Start[id],&m_Items[0] + m_Start[id + 1]);
+  }
+
+  //! Calls f(const t_Range&) on every cell overlapping the sphere
+  template <class T_Func>
+  void          forEachCell(const v3f& pos,float radius,const T_Func& f) const
   {
     Tuple<v3i,2> minmax = occupancyBox(pos,radius);
-    ForRange(x,minmax[0][0],minmax[1][0]) {
+    ForRange(z,minmax[0][2],minmax[1][2]) {
       ForRange(y,minmax[0][1],minmax[1][1]) {
-        ForRange(z,minmax[0][2],minmax[1][2]) {
-          m_Map.at(x,y,z).insert(key);
+        ForRange(x,minmax[0][0],minmax[1][0]) {
+          t_Range r = cell(V3I(x,y,z));
+          if (!r.empty()) {
+            f(r);
+          }
+        }
+      }
+    }
+  }
+
+  //! Get all items within radius around pos, sorted and unique.
+  //! Clears _items.
+  void          getProximity(const v3f& pos,float radius,std::vector<T_Element>& _items) const
+  {
+    _items.clear();
+    forEachCell(pos,radius,[&_items](const t_Range& r) { _items.insert(_items.end(),r.begin(),r.end()); });
+    std::sort(_items.begin(),_items.end());
+    _items.erase(std::unique(_items.begin(),_items.end()),_items.end());
+  }
+
+  const std::vector<uint>&      starts() const { return (m_Start); }
+  const std::vector<T_Element>& items()  const { return (m_Items); }
+};
+
+// ------------------------------------------------------
+
+/*!
+
+\class HashedOccupancyMap
+\brief Dynamic occupancy map only storing occupied cells.
+Cells are found in a hash table split into shards, so that bulk
+insertions proceed in parallel, one shard per task.
+Cells are sorted vectors with set semantics: inserting an element
+twice in a cell keeps one copy, remove takes it out.
+Coordinates of unbounded grids are limited to [-2^20,2^20[.
+
+*/
+template <typename T_Element>
+class HashedOccupancyMap : public OccupancyMapGrid
+{
+public:
+
+  typedef T_Element                 t_Element;
+  typedef OccupancyRange<T_Element> t_Range;
+  typedef unsigned long long        t_CellKey;
+
+protected:
+
+  enum { e_ShardBits = 6, e_NumShards = 1 << e_ShardBits };
+
+  static const t_CellKey c_Empty = ~t_CellKey(0);
+
+  class Shard
+  {
+  public:
+    std::vector<t_CellKey>               keys;   // open addressing, c_Empty for free slots
+    std::vector<uint>                    slots;  // index in cells
+    std::vector<std::vector<T_Element> > cells;
+
+    Shard() { keys.assign(16,c_Empty); slots.resize(16); }
+
+    uint find(t_CellKey key,t_CellKey h) const
+    {
+      uint mask = uint(keys.size()) - 1;
+      uint i    = uint(h) & mask;
+      while (keys[i] != c_Empty) {
+        if (keys[i] == key) {
+          return (slots[i]);
+        }
+        i = (i + 1) & mask;
+      }
+      return (0xFFFFFFFFu);
+    }
+
+    void grow()
+    {
+      std::vector<t_CellKey> okeys;
+      std::vector<uint>      oslots;
+      okeys .swap(keys);
+      oslots.swap(slots);
+      keys .assign(okeys.size() * 2,c_Empty);
+      slots.resize(okeys.size() * 2);
+      uint mask = uint(keys.size()) - 1;
+      ForIndex(o,okeys.size()) {
+        if (okeys[o] != c_Empty) {
+          uint i = uint(hash(okeys[o])) & mask;
+          while (keys[i] != c_Empty) {
+            i = (i + 1) & mask;
+          }
+          keys[i]  = okeys[o];
+          slots[i] = oslots[o];
+        }
+      }
+    }
+
+    std::vector<T_Element>& findOrCreate(t_CellKey key,t_CellKey h)
+    {
+      // keep the load factor below 1/2
+      if ((cells.size() + 1) * 2 > keys.size()) {
+        grow();
+      }
+      uint mask = uint(keys.size()) - 1;
+      uint i    = uint(h) & mask;
+      while (keys[i] != c_Empty) {
+        if (keys[i] == key) {
+          return (cells[slots[i]]);
         }
+        i = (i + 1) & mask;
       }
+      keys[i]  = key;
+      slots[i] = uint(cells.size());
+      cells.push_back(std::vector<T_Element>());
+      return (cells.back());
     }
+
+    //! Insert in a sorted cell, unless already there
+    static void addTo(std::vector<T_Element>& c,const T_Element& key)
+    {
+      typename std::vector<T_Element>::iterator I = std::lower_bound(c.begin(),c.end(),key);
+      if (I == c.end() || key < *I) {
+        c.insert(I,key);
+      }
+    }
+  };
+
+  std::vector<Shard> m_Shards;
+
+  static t_CellKey cellKey(int x,int y,int z)
+  {
+    sl_assert(x >= -(1<<20) && x < (1<<20) && y >= -(1<<20) && y < (1<<20) && z >= -(1<<20) && z < (1<<20));
+    return (t_CellKey(x + (1<<20)) | (t_CellKey(y + (1<<20)) << 21) | (t_CellKey(z + (1<<20)) << 42));
+  }
+
+  static t_CellKey hash(t_CellKey k)
+  {
+    // splitmix64 finalizer
+    k ^= k >> 30; k *= 0xbf58476d1ce4e5b9ull;
+    k ^= k >> 27; k *= 0x94d049bb133111ebull;
+    k ^= k >> 31;
+    return (k);
+  }
+
+  static uint shardOf(t_CellKey h) { return uint(h >> (64 - e_ShardBits)); }
+
+  template <class T_Func>
+  void          forEachCellKey(const v3f& pos,float radius,const T_Func& f) const
+  {
+    Tuple<v3i,2> minmax = occupancyBox(pos,radius);
+    ForRange(z,minmax[0][2],minmax[1][2]) {
+      ForRange(y,minmax[0][1],minmax[1][1]) {
+        ForRange(x,minmax[0][0],minmax[1][0]) {
+          f(cellKey(x,y,z));
+        }
+      }
+    }
+  }
+
+public:
+
+  //! Unbounded grid
+  HashedOccupancyMap(const v3f& scale) : OccupancyMapGrid(scale), m_Shards(e_NumShards) { }
+
+  //! Grid clamped to size
+  HashedOccupancyMap(const v3i& size,const v3f& scale) : OccupancyMapGrid(size,scale), m_Shards(e_NumShards) { }
+
+  void          clear()
+  {
+    m_Shards.clear();
+    m_Shards.resize(e_NumShards);
   }
 
+  //! Number of cells stored (including cells emptied by remove)
+  uint          numCells() const
+  {
+    uint n = 0;
+    ForIndex(s,m_Shards.size()) {
+      n += uint(m_Shards[s].cells.size());
+    }
+    return (n);
+  }
+
+  void          insert(const v3f& pos,float radius,const T_Element& key)
+  {
+    forEachCellKey(pos,radius,[this,&key](t_CellKey k) {
+      t_CellKey h = hash(k);
+      Shard::addTo(m_Shards[shardOf(h)].findOrCreate(k,h),key);
+    });
+  }
+
+  //! Insert n elements in parallel, element i covering the sphere (pos[i],radius[i])
+  void          insert(uint n,const v3f *pos,const float *radius,const T_Element *keys)
+  {
+    // generate (cell,element) entries and bucket them per shard
+    std::vector<std::atomic<uint> > counts(e_NumShards + 1);
+    std::vector<t_CellKey>          entryKeys;
+    std::vector<uint>               entryOffset(n + 1,0);
+    LibSL::System::Parallel::forChunks(0,int(n),[&](int first,int last) {
+      for (int i = first ; i < last ; i++) {
+        Tuple<v3i,2> minmax = occupancyBox(pos[i],radius[i]);
+        entryOffset[i + 1] = uint(minmax[1][0] - minmax[0][0] + 1) * uint(minmax[1][1] - minmax[0][1] + 1) * uint(minmax[1][2] - minmax[0][2] + 1);
+      }
+    },256);
+    ForIndex(i,n) {
+      entryOffset[i + 1] += entryOffset[i];
+    }
+    entryKeys.resize(entryOffset[n]);
+    std::vector<uint> entryItem(entryOffset[n]);
+    LibSL::System::Parallel::forChunks(0,int(n),[&](int first,int last) {
+      for (int i = first ; i < last ; i++) {
+        uint at = entryOffset[i];
+        forEachCellKey(pos[i],radius[i],[&](t_CellKey k) {
+          entryItem[at]    = i;
+          entryKeys[at ++] = k;
+          counts[shardOf(hash(k))].fetch_add(1,std::memory_order_relaxed);
+        });
+      }
+    },256);
+    std::vector<uint> shardStart(e_NumShards + 1,0);
+    ForIndex(s,e_NumShards) {
+      shardStart[s + 1] = shardStart[s] + counts[s].load(std::memory_order_relaxed);
+      counts[s].store(shardStart[s],std::memory_order_relaxed);
+    }
+    std::vector<uint> entries(entryOffset[n]); // entry indices, grouped by shard
+    LibSL::System::Parallel::forChunks(0,int(entries.size()),[&](int first,int last) {
+      for (int e = first ; e < last ; e++) {
+        entries[counts[shardOf(hash(entryKeys[e]))].fetch_add(1,std::memory_order_relaxed)] = e;
+      }
+    },4096);
+    // insert, one shard per task; entries are sorted so that cells are created in a fixed order
+    LibSL::System::Parallel::forIndex(0,int(e_NumShards),[&](int s) {
+      std::sort(entries.begin() + shardStart[s],entries.begin() + shardStart[s + 1]);
+      for (uint e = shardStart[s] ; e < shardStart[s + 1] ; e++) {
+        uint entry = entries[e];
+        t_CellKey k = entryKeys[entry];
+        t_CellKey h = hash(k);
+        Shard::addTo(m_Shards[s].findOrCreate(k,h),keys[entryItem[entry]]);
+      }
+    });
+  }
+
+  //! Insert elements in parallel, see above
+  void          insert(const std::vector<v3f>& pos,const std::vector<float>& radius,const std::vector<T_Element>& keys)
+  {
+    sl_assert(pos.size() == radius.size() && pos.size() == keys.size());
+    if (!keys.empty()) {
+      insert(uint(keys.size()),&pos[0],&radius[0],&keys[0]);
+    }
+  }
+
+  //! Remove key from every cell overlapping the sphere
   void          remove(const v3f& pos,float radius,const T_Element& key)
+  {
+    forEachCellKey(pos,radius,[this,&key](t_CellKey k) {
+      t_CellKey h    = hash(k);
+      Shard&    sh   = m_Shards[shardOf(h)];
+      uint      slot = sh.find(k,h);
+      if (slot != 0xFFFFFFFFu) {
+        std::vector<T_Element>& c = sh.cells[slot];
+        typename std::vector<T_Element>::iterator I = std::lower_bound(c.begin(),c.end(),key);
+        if (I != c.end() && !(key < *I)) {
+          c.erase(I);
+        }
+      }
+    });
+  }
+
+  //! Elements registered in a cell, sorted; invalidated by insert
+  t_Range       cell(const v3i& c) const
+  {
+    t_CellKey k    = cellKey(c[0],c[1],c[2]);
+    t_CellKey h    = hash(k);
+    const Shard& sh = m_Shards[shardOf(h)];
+    uint      slot = sh.find(k,h);
+    if (slot == 0xFFFFFFFFu || sh.cells[slot].empty()) {
+      return t_Range();
+    }
+    const std::vector<T_Element>& v = sh.cells[slot];
+    return t_Range(&v[0],&v[0] + v.size());
+  }
+
+  //! Calls f(const t_Range&) on every non empty cell overlapping the sphere
+  template <class T_Func>
+  void          forEachCell(const v3f& pos,float radius,const T_Func& f) const
   {
     Tuple<v3i,2> minmax = occupancyBox(pos,radius);
-    ForRange(x,minmax[0][0],minmax[1][0]) {
+    ForRange(z,minmax[0][2],minmax[1][2]) {
       ForRange(y,minmax[0][1],minmax[1][1]) {
-        ForRange(z,minmax[0][2],minmax[1][2]) {
-          m_Map.at(x,y,z).erase(key);
+        ForRange(x,minmax[0][0],minmax[1][0]) {
+          t_Range r = cell(V3I(x,y,z));
+          if (!r.empty()) {
+            f(r);
+          }
         }
       }
     }
   }
 
+  //! Get all items within radius around pos, sorted and unique.
+  //! Clears _items.
+  void          getProximity(const v3f& pos,float radius,std::vector<T_Element>& _items) const
+  {
+    _items.clear();
+    forEachCell(pos,radius,[&_items](const t_Range& r) { _items.insert(_items.end(),r.begin(),r.end()); });
+    std::sort(_items.begin(),_items.end());
+    _items.erase(std::unique(_items.begin(),_items.end()),_items.end());
+  }
+
   //! Get all items within radius around pos.
   //! Does *not* clear set
   void          getProximitySet(
     const v3f&           pos,
     float                radius,
-    std::set<T_Element>& _set)
+    std::set<T_Element>& _set) const
   {
-    Tuple<v3i,2> minmax = occupancyBox(pos,radius);
-    //std::cerr << "[PROXIM] " << minmax << ' ';
-    ForRange(x,minmax[0][0],minmax[1][0]) {
-      ForRange(y,minmax[0][1],minmax[1][1]) {
-        ForRange(z,minmax[0][2],minmax[1][2]) {
-          //std::cerr << sprint(" [%d,%d,%d] ",x,y,z);
-          ForIterator_typename(std::set<T_Element>,m_Map.at(x,y,z),I) {
-            //std::cerr << (*I) << ' ';
-            _set.insert((*I));
-          }
+    forEachCell(pos,radius,[&_set](const t_Range& r) { _set.insert(r.begin(),r.end()); });
+  }
+};
+
+template <typename T_Element>
+const typename HashedOccupancyMap<T_Element>::t_CellKey HashedOccupancyMap<T_Element>::c_Empty;
+
+// ------------------------------------------------------
+
+/*!
+
+\class OccupancyMap
+\brief Dynamic occupancy map over a grid of fixed size, positions
+outside are clamped to the border cells.
+
+*/
+template <typename T_Element>
+class OccupancyMap : public HashedOccupancyMap<T_Element>
+{
+protected:
+
+  typedef HashedOccupancyMap<T_Element> t_Base;
+
+  mutable Array3D<std::set<T_Element> > m_Snapshot;
+  mutable bool                          m_SnapshotValid;
+
+public:
+
+  OccupancyMap(const v3i& size,const v3f& scale) : HashedOccupancyMap<T_Element>(size,scale), m_SnapshotValid(false) { }
+
+  // modifications invalidate the snapshot returned by map()
+
+  void          clear()
+  {
+    t_Base::clear();
+    m_SnapshotValid = false;
+  }
+
+  void          insert(const v3f& pos,float radius,const T_Element& key)
+  {
+    t_Base::insert(pos,radius,key);
+    m_SnapshotValid = false;
+  }
+
+  void          insert(uint n,const v3f *pos,const float *radius,const T_Element *keys)
+  {
+    t_Base::insert(n,pos,radius,keys);
+    m_SnapshotValid = false;
+  }
+
+  void          insert(const std::vector<v3f>& pos,const std::vector<float>& radius,const std::vector<T_Element>& keys)
+  {
+    t_Base::insert(pos,radius,keys);
+    m_SnapshotValid = false;
+  }
+
+  void          remove(const v3f& pos,float radius,const T_Element& key)
+  {
+    t_Base::remove(pos,radius,key);
+    m_SnapshotValid = false;
+  }
+
+  //! Copy of the map as a dense grid of sets, as previously stored.
+  //! Built on the first call after a modification (costly), then cached:
+  //! valid until the next modification. Not thread safe.
+  const Array3D<std::set<T_Element> >& map() const
+  {
+    if (m_SnapshotValid) {
+      return (m_Snapshot);
+    }
+    v3i sz = this->size();
+    m_Snapshot.erase();
+    m_Snapshot.allocate(sz[0],sz[1],sz[2]);
+    ForIndex(z,sz[2]) {
+      ForIndex(y,sz[1]) {
+        ForIndex(x,sz[0]) {
+          typename HashedOccupancyMap<T_Element>::t_Range r = this->cell(V3I(x,y,z));
+          m_Snapshot.at(x,y,z).insert(r.begin(),r.end());
         }
       }
     }
-    //std::cerr << std::endl;
+    m_SnapshotValid = true;
+    return (m_Snapshot);
   }
 
-  v3f                                  scale() const { return m_MapScale; }
-  const Array3D<std::set<T_Element> >& map()   const { return (m_Map); }
 };
 
-
 // ------------------------------------------------------
 
 } // DataStructures
@@ -42,6 +42,8 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include "Profiler.h"
 #include "GPUHelpers.h"
 
+#include <LibSL/System/Profiling.h>
+
 // ---------------------------------------------------------------
 
 #define NAMESPACE LibSL::GPUHelpers
@@ -169,7 +171,8 @@ void NAMESPACE::ProfilerVarData::stopRecord()
 
 void   NAMESPACE::ProfilerTimer::start() 
 {
-  m_Start = System::Time::milliseconds();
+  m_Start      = System::Time::milliseconds();
+  m_TraceStart = System::Profiling::now();
 }
 
 // ---------------------------------------------------------------
@@ -177,6 +180,8 @@ void   NAMESPACE::ProfilerTimer::start()
 void   NAMESPACE::ProfilerTimer::stop()  
 {
   m_Accum += (System::Time::milliseconds() - m_Start);
+  // also reported to the headless profiler
+  System::Profiling::record(m_Zone, m_TraceStart, System::Profiling::now());
 }
 
 // ---------------------------------------------------------------
@@ -58,6 +58,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include <LibSL/Errors/Errors.h>
 #include <LibSL/System/Types.h>
+#include <LibSL/System/Profiling.h>
 #include <LibSL/Memory/Pointer.h>
 #include <LibSL/Math/Tuple.h>
 #include <LibSL/Math/Matrix4x4.h>
@@ -162,11 +163,13 @@ namespace LibSL {
     class LIBSL_DLL ProfilerTimer : public ProfilerVarData
     {
     protected:
-      time_t m_Accum;
-      time_t m_Start;
+      time_t                      m_Accum;
+      time_t                      m_Start;
+      System::Profiling::t_Zone   m_Zone;
+      long long                   m_TraceStart;
     public:
       ProfilerTimer(std::string name,e_Color clr,int period)
-        : ProfilerVarData(name,clr,period,false) { m_Accum = 0 ; m_Start = 0; }
+        : ProfilerVarData(name,clr,period,false) { m_Accum = 0 ; m_Start = 0; m_TraceStart = 0; m_Zone = System::Profiling::zone(name.c_str()); }
       virtual ~ProfilerTimer() {}
 
       void   start();
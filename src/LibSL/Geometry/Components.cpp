@@ -38,6 +38,12 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include "Components.h"
 
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
 using namespace std;
 
 // ------------------------------------------------------
@@ -52,55 +58,364 @@ void NAMESPACE::findComponents(
   Array2D<int>&       _comps,
   set<int>&           _compids)
 {
-  std::vector<int> compids;
-  compids.reserve(256);
-  _comps.fill(-1);
-  ForRange(j, 0, a.ysize() - 1) {
-    ForRange(i, 0, a.xsize() - 1) {
-      if (test(a.at(i, j))) {
-        int comp_im1 = -1;
-        if (i > 0) {
-          comp_im1 = _comps.at(i - 1, j);
+  Array2D<uchar> mask(a.xsize(), a.ysize());
+  LibSL::System::Parallel::forIndex(0, a.ysize(), [&](int j) {
+    ForIndex(i, a.xsize()) {
+      mask.at(i, j) = test(a.at(i, j)) ? 1 : 0;
+    }
+  });
+  if (_comps.xsize() != mask.xsize() || _comps.ysize() != mask.ysize()) {
+    _comps.allocate(mask.xsize(), mask.ysize());
+  }
+  int num = labelComponents(mask, Connect4, _comps);
+  ForIndex(c, num) {
+    _compids.insert(c);
+  }
+}
+
+// ---------------------------------------------------
+
+namespace {
+
+  using LibSL::Math::v3i;
+  using LibSL::Math::V3I;
+
+  // Union-find with path compression, the smallest label is the root
+  class UnionFind
+  {
+  public:
+    int *m_Parent;
+    UnionFind(int *parent) : m_Parent(parent) {}
+    int find(int l)
+    {
+      int r = l;
+      while (m_Parent[r] != r) { r = m_Parent[r]; }
+      while (m_Parent[l] != r) { int n = m_Parent[l]; m_Parent[l] = r; l = n; }
+      return r;
+    }
+    int merge(int a, int b)
+    {
+      a = find(a);
+      b = find(b);
+      if (a < b) { m_Parent[b] = a; return a; }
+      else       { m_Parent[a] = b; return b; }
+    }
+  };
+
+  // Statistics accumulator
+  struct Accum
+  {
+    long long area;
+    v3i       bmin, bmax;
+    double    sum[3];
+    void init()
+    {
+      area = 0;
+      bmin = V3I(INT_MAX, INT_MAX, INT_MAX);
+      bmax = V3I(INT_MIN, INT_MIN, INT_MIN);
+      sum[0] = sum[1] = sum[2] = 0.0;
+    }
+    void add(int x, int y, int z)
+    {
+      area++;
+      bmin[0] = min(bmin[0], x); bmax[0] = max(bmax[0], x);
+      bmin[1] = min(bmin[1], y); bmax[1] = max(bmax[1], y);
+      bmin[2] = min(bmin[2], z); bmax[2] = max(bmax[2], z);
+      sum[0] += x; sum[1] += y; sum[2] += z;
+    }
+    void add(const Accum& o)
+    {
+      area += o.area;
+      ForIndex(i, 3) {
+        bmin[i] = min(bmin[i], o.bmin[i]);
+        bmax[i] = max(bmax[i], o.bmax[i]);
+        sum[i] += o.sum[i];
+      }
+    }
+  };
+
+  // A slab of consecutive z planes, labeled independently
+  struct Slab
+  {
+    int                z0, z1;
+    int                offset; // first global label
+    std::vector<int>   parent;
+    std::vector<Accum> accums;
+  };
+
+  // Labels a (xs,ys,zs) grid; neighbors are the already visited cells at offsets preds
+  int labelGrid(
+    const uchar              *mask,
+    int                       xs,
+    int                       ys,
+    int                       zs,
+    const std::vector<v3i>&   preds,
+    int                      *labels,
+    std::vector<NAMESPACE::ComponentInfo> *_infos)
+  {
+    using namespace LibSL::System;
+    if (xs <= 0 || ys <= 0 || zs <= 0) {
+      if (_infos) _infos->clear();
+      return 0;
+    }
+    if ((long long)xs * (long long)ys * (long long)zs >= (1ll << 31)) {
+      throw LibSL::Errors::Fatal("Components::labelComponents - grid too large (%d x %d x %d)", xs, ys, zs);
+    }
+    const int plane = xs * ys;
+    // neighbor offsets, split between same plane and previous plane
+    std::vector<v3i> inPlane, prevPlane;
+    ForIndex(p, preds.size()) {
+      if ((xs == 1 && preds[p][0] != 0) || (ys == 1 && preds[p][1] != 0)) continue;
+      if (preds[p][2] == 0) inPlane.push_back(preds[p]);
+      else                  prevPlane.push_back(preds[p]);
+    }
+    // plain tables for the inner loop: offsets, and bounds to check near the border
+    std::vector<v3i> all(inPlane);
+    all.insert(all.end(), prevPlane.begin(), prevPlane.end());
+    const int numNeighbors = (int)all.size();
+    int dx[26], dy[26], dz[26], offsets[26];
+    int lox = 0, loy = 0, loz = 0, hix = 0, hiy = 0;
+    ForIndex(p, numNeighbors) {
+      dx[p] = all[p][0]; dy[p] = all[p][1]; dz[p] = all[p][2];
+      offsets[p] = dx[p] + dy[p] * xs + dz[p] * plane;
+      lox = min(lox, dx[p]); hix = max(hix, dx[p]);
+      loy = min(loy, dy[p]); hiy = max(hiy, dy[p]);
+      loz = min(loz, dz[p]);
+    }
+    // slabs
+    int numSlabs = min(zs, (int)Parallel::numThreads() * 4);
+    std::vector<Slab> slabs(numSlabs);
+    ForIndex(s, numSlabs) {
+      slabs[s].z0 = (int)((long long)zs *  s      / numSlabs);
+      slabs[s].z1 = (int)((long long)zs * (s + 1) / numSlabs);
+    }
+    // 1. label each slab independently
+    Parallel::forIndex(0, numSlabs, [&](int s) {
+      Slab&            slab   = slabs[s];
+      std::vector<int>& parent = slab.parent;
+      parent.clear();
+      UnionFind uf(NULL);
+      for (int z = slab.z0; z < slab.z1; z++) {
+        ForIndex(y, ys) {
+          ForIndex(x, xs) {
+            int idx = x + y * xs + z * plane;
+            if (mask[idx] == 0) {
+              labels[idx] = -1;
+              continue;
+            }
+            bool inside = x + lox >= 0 && x + hix < xs
+                       && y + loy >= 0 && y + hiy < ys
+                       && z + loz >= slab.z0;
+            int l = -1;
+            ForIndex(p, numNeighbors) {
+              if (!inside) {
+                int nx = x + dx[p], ny = y + dy[p], nz = z + dz[p];
+                if (nx < 0 || nx >= xs || ny < 0 || ny >= ys || nz < slab.z0) {
+                  continue;
+                }
+              }
+              int nl = labels[idx + offsets[p]];
+              if (nl < 0) {
+                continue;
+              }
+              if (l < 0) {
+                l = nl;
+              } else if (nl != l) {
+                uf.m_Parent = &parent[0];
+                l = uf.merge(l, nl);
+              }
+            }
+            if (l < 0) {
+              l = (int)parent.size();
+              parent.push_back(l);
+            }
+            labels[idx] = l;
+          }
         }
-        int comp_jm1 = -1;
-        if (j > 0) {
-          comp_jm1 = _comps.at(i, j - 1);
+      }
+      // compact local labels
+      int num = 0;
+      ForIndex(l, parent.size()) {
+        if (parent[l] == l) {
+          parent[l] = num++;
+        } else {
+          // roots are smaller, hence already renumbered
+          parent[l] = parent[parent[l]];
         }
-        int comp = -1;
-        if (comp_im1 > -1) {
-          if (comp_jm1 > -1) {
-            // merge
-            comp = min(compids[comp_im1], compids[comp_jm1]);
-            compids[comp_im1] = comp;
-            compids[comp_jm1] = comp;
-            // set here
-          } else {
-            comp = comp_im1;
+      }
+      // relabel and gather statistics
+      slab.accums.resize(num);
+      ForIndex(c, num) {
+        slab.accums[c].init();
+      }
+      for (int z = slab.z0; z < slab.z1; z++) {
+        ForIndex(y, ys) {
+          ForIndex(x, xs) {
+            int idx = x + y * xs + z * plane;
+            if (labels[idx] > -1) {
+              int c = parent[labels[idx]];
+              labels[idx] = c;
+              slab.accums[c].add(x, y, z);
+            }
           }
-        } else {
-          if (comp_jm1 > -1) {
-            comp = comp_jm1;
+        }
+      }
+      parent.clear();
+    }, 1);
+    // 2. global labels
+    int total = 0;
+    ForIndex(s, numSlabs) {
+      slabs[s].offset = total;
+      total += (int)slabs[s].accums.size();
+    }
+    std::vector<int> global(total);
+    ForIndex(l, total) {
+      global[l] = l;
+    }
+    // 3. merge along slab borders, by pairs of groups of increasing size:
+    //    merges of a same round touch disjoint label ranges
+    for (int step = 1; step < numSlabs; step *= 2) {
+      Parallel::forIndex(0, numSlabs - 1, [&](int b) {
+        if ((b + 1) % (2 * step) != step) {
+          return;
+        }
+        UnionFind uf(&global[0]);
+        const Slab& below = slabs[b];
+        const Slab& above = slabs[b + 1];
+        int z = above.z0;
+        ForIndex(y, ys) {
+          ForIndex(x, xs) {
+            int la = labels[x + y * xs + z * plane];
+            if (la < 0) {
+              continue;
+            }
+            ForIndex(p, prevPlane.size()) {
+              const v3i& d = prevPlane[p];
+              int nx = x + d[0], ny = y + d[1];
+              if (nx < 0 || nx >= xs || ny < 0 || ny >= ys) {
+                continue;
+              }
+              int lb = labels[nx + ny * xs + (z - 1) * plane];
+              if (lb > -1) {
+                uf.merge(below.offset + lb, above.offset + la);
+              }
+            }
           }
         }
-        if (comp == -1) {
-          comp = (int)compids.size();
-          compids.push_back(comp);
+      }, 1);
+    }
+    // 4. final numbering, in order of first cell
+    int num = 0;
+    ForIndex(l, total) {
+      if (global[l] == l) {
+        global[l] = num++;
+      } else {
+        // parents are smaller, hence already renumbered
+        global[l] = global[global[l]];
+      }
+    }
+    // 5. relabel and merge statistics
+    Parallel::forIndex(0, numSlabs, [&](int s) {
+      const Slab& slab = slabs[s];
+      int begin = slab.z0 * plane;
+      int end   = slab.z1 * plane;
+      for (int idx = begin; idx < end; idx++) {
+        if (labels[idx] > -1) {
+          labels[idx] = global[slab.offset + labels[idx]];
+        }
+      }
+    }, 1);
+    if (_infos != NULL) {
+      std::vector<Accum> accums(num);
+      ForIndex(c, num) {
+        accums[c].init();
+      }
+      ForIndex(s, numSlabs) {
+        ForIndex(c, slabs[s].accums.size()) {
+          accums[global[slabs[s].offset + c]].add(slabs[s].accums[c]);
+        }
+      }
+      _infos->resize(num);
+      ForIndex(c, num) {
+        NAMESPACE::ComponentInfo& nfo = (*_infos)[c];
+        nfo.area     = accums[c].area;
+        nfo.bboxMin  = accums[c].bmin;
+        nfo.bboxMax  = accums[c].bmax;
+        nfo.centroid = LibSL::Math::V3D(accums[c].sum[0], accums[c].sum[1], accums[c].sum[2]) / double(accums[c].area);
+      }
+    }
+    return num;
+  }
+
+  // Already visited neighbors for a given connectivity
+  std::vector<v3i> predecessors(int connectivity)
+  {
+    std::vector<v3i> preds;
+    for (int dz = -1; dz <= 0; dz++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          // visited before in scanline order?
+          if (dz == 0 && (dy > 0 || (dy == 0 && dx >= 0))) {
+            continue;
+          }
+          int n = abs(dx) + abs(dy) + abs(dz);
+          if ((connectivity == 6  && n > 1)
+            || (connectivity == 18 && n > 2)) {
+            continue;
+          }
+          preds.push_back(V3I(dx, dy, dz));
         }
-        _comps.at(i, j) = comp;
       }
     }
+    return preds;
+  }
+
+} // namespace
+
+// ---------------------------------------------------
+
+int NAMESPACE::labelComponents(
+  const Array2D<uchar>&        mask,
+  e_Connectivity               connectivity,
+  Array2D<int>&               _labels,
+  std::vector<ComponentInfo> *_infos)
+{
+  if (connectivity != Connect4 && connectivity != Connect8) {
+    throw LibSL::Errors::Fatal("Components::labelComponents - 2D connectivity is 4 or 8");
   }
-  // rewrite from unions
-  ForArray2D(_comps, i, j) {
-    int comp = _comps.at(i, j);
-    if (comp > -1) {
-      do {
-        comp = compids[comp];
-      } while (comp != compids[comp]);
-      _comps.at(i, j) = comp;
-      _compids.insert(comp);
+  if (_labels.xsize() != mask.xsize() || _labels.ysize() != mask.ysize()) {
+    _labels.allocate(mask.xsize(), mask.ysize());
+  }
+  // a 2D grid is a (x,1,y) volume: 4/8-connectivity become 6/26
+  int num = labelGrid(mask.raw(), mask.xsize(), 1, mask.ysize(),
+    predecessors(connectivity == Connect4 ? 6 : 26), _labels.raw(), _infos);
+  if (_infos != NULL) {
+    ForIndex(c, num) {
+      ComponentInfo& nfo = (*_infos)[c];
+      std::swap(nfo.bboxMin[1],  nfo.bboxMin[2]);
+      std::swap(nfo.bboxMax[1],  nfo.bboxMax[2]);
+      std::swap(nfo.centroid[1], nfo.centroid[2]);
     }
   }
+  return num;
+}
+
+// ---------------------------------------------------
+
+int NAMESPACE::labelComponents(
+  const Array3D<uchar>&        mask,
+  e_Connectivity               connectivity,
+  Array3D<int>&               _labels,
+  std::vector<ComponentInfo> *_infos)
+{
+  if (connectivity != Connect6 && connectivity != Connect18 && connectivity != Connect26) {
+    throw LibSL::Errors::Fatal("Components::labelComponents - 3D connectivity is 6, 18 or 26");
+  }
+  if (_labels.xsize() != mask.xsize() || _labels.ysize() != mask.ysize() || _labels.zsize() != mask.zsize()) {
+    _labels.allocate(mask.xsize(), mask.ysize(), mask.zsize());
+  }
+  return labelGrid(mask.raw(), mask.xsize(), mask.ysize(), mask.zsize(),
+    predecessors(connectivity), _labels.raw(), _infos);
 }
 
 // ---------------------------------------------------
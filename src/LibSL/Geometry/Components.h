@@ -39,6 +39,10 @@ knowledge of the CeCILL-C license and that you accept its terms.
 //
 // Extract connected components in tables
 //
+// labelComponents is a block-parallel union-find labeler:
+// slabs are labeled independently, then merged along their
+// borders. Per-component statistics are gathered on the way.
+//
 // ------------------------------------------------------
 // Sylvain Lefebvre - 2014-07-25
 // ------------------------------------------------------
@@ -46,10 +50,13 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #pragma once
 
 #include <set>
+#include <vector>
 #include <LibSL/Errors/Errors.h>
 #include <LibSL/Memory/Array.h>
 #include <LibSL/Memory/Array2D.h>
+#include <LibSL/Memory/Array3D.h>
 #include <LibSL/Memory/ArrayRemap.h>
+#include <LibSL/Math/Vertex.h>
 
 // ------------------------------------------------------
 
@@ -61,6 +68,7 @@ namespace LibSL {
       using LibSL::Math::Tuple;
       using LibSL::Memory::Array::Array2D;
       using LibSL::Memory::Array::Array2DRemap;
+      using LibSL::Memory::Array::Array3D;
 
       class OccupancyTest {
       public:
@@ -68,11 +76,44 @@ namespace LibSL {
       };
 
       // Compute connected components, linear in number of pixels
+      // (4-connectivity, ids are those of labelComponents)
       void findComponents(const Array2DRemap&  a,
                           const OccupancyTest& test,
                           Array2D<int>&       _comps,
                           std::set<int>&      _compids);
 
+      // Neighborhoods: 4/8 in 2D, 6/18/26 in 3D
+      enum e_Connectivity {
+        Connect4  = 4,
+        Connect8  = 8,
+        Connect6  = 6,
+        Connect18 = 18,
+        Connect26 = 26
+      };
+
+      // Statistics of a component (in 2D, z is always 0)
+      struct ComponentInfo
+      {
+        long long         area;     // number of cells
+        LibSL::Math::v3i  bboxMin;  // inclusive
+        LibSL::Math::v3i  bboxMax;  // inclusive
+        LibSL::Math::v3d  centroid;
+      };
+
+      // Label the connected components of non-zero cells
+      // Components are numbered 0..N-1 by order of their first cell in memory, empty cells are -1
+      // Returns N, fills _infos (indexed by component) if not NULL
+      // Grids are limited to 2^31 cells
+      int labelComponents(const Array2D<uchar>&        mask,
+                          e_Connectivity               connectivity,
+                          Array2D<int>&               _labels,
+                          std::vector<ComponentInfo> *_infos = NULL);
+
+      int labelComponents(const Array3D<uchar>&        mask,
+                          e_Connectivity               connectivity,
+                          Array3D<int>&               _labels,
+                          std::vector<ComponentInfo> *_infos = NULL);
+
     }
   }
 };
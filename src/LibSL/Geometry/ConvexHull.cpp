@@ -18,11 +18,7 @@
 #include <iterator>
 #endif
 
-#if defined(USE_CXX11) || defined(USE_CXX14) || defined(USE_CXX17)
-#include <mutex>
-#else
-#pragma message ("Convex hull compiled without multithread support")
-#endif
+#include <LibSL/System/Parallel.h>
 
 extern "C" {
 #include <qhull_ra.h>
@@ -53,65 +49,75 @@ namespace {
 
 // -----------------------------------------------------------------------------
 
-#ifdef USE_CXX11
-std::mutex g_QhullLock;
-#endif
+namespace {
+  // Owns a reentrant qhull context: all qhull state lives in the qhT
+  // structure, so independent contexts can run concurrently.
+  class QhullContext {
+    public:
+      qhT qh;
+      QhullContext()  { qh_zero(&qh, stderr); }
+      ~QhullContext() {
+        int curlong, totlong;
+        qh_freeqhull(&qh, !qh_ALL);
+        qh_memfreeshort(&qh, &curlong, &totlong);
+      }
+  };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 template<int Dim>
 void ConvexHullEngine<Dim>::run(
     const std::vector<VectorXd>& points)
 {
-  const size_t dim = Dim;
-  const size_t num_points = points.size();
-  char flags[64];
-	sprintf_s(flags, 64, "qhull Qt");
-  coordT* data = new coordT[num_points * dim];
-  if (num_points != 0) {
-    const double* rawPtr = &points[0][0];
-#ifdef _MSC_VER
-		std::copy(rawPtr, rawPtr + num_points * dim, stdext::checked_array_iterator<double*>(data, num_points * dim));
-#else
-    std::copy(rawPtr, rawPtr + num_points * dim, data);
-#endif
-  }
-
-#ifdef USE_CXX11
-  g_QhullLock.lock();
-#endif
-
-  qhT qh;
-  qh_zero(&qh,stderr);
-
-  m_Context = (void*)&qh;
-
-  int err = qh_new_qhull(&qh,(int)dim, (int)num_points, data, false, flags, NULL, stderr);
-
-  if (!err) {
-      extractHull(points);
+  if (points.empty()) {
+    run(NULL, 0);
+  } else if (sizeof(VectorXd) == Dim * sizeof(double)) {
+    // tuples are tightly packed, hand the points to qhull as is
+    run(&points[0][0], points.size());
   } else {
-      throw LibSL::Errors::Fatal("Qhull error: ");
+    std::vector<double> data(points.size() * Dim);
+    for (size_t i = 0; i < points.size(); i++) {
+      for (int c = 0; c < Dim; c++) {
+        data[i * Dim + c] = points[i][c];
+      }
+    }
+    run(&data[0], points.size());
   }
+}
 
-  qh_freeqhull(&qh,!qh_ALL);
+////////////////////////////////////////////////////////////////////////////////
+template<int Dim>
+void ConvexHullEngine<Dim>::run(
+    const double *coords, size_t num_points)
+{
+  char flags[] = "qhull Qt";
+
+  m_Vertices.clear();
+  m_Faces.clear();
+  m_IndexMap.clear();
+
+  QhullContext ctx;
+  // qhull does not modify the input points with these flags (no scaling,
+  // no projection), and does not take ownership since ismalloc is false
+  int err = qh_new_qhull(&ctx.qh, Dim, (int)num_points, const_cast<coordT*>(coords), false, flags, NULL, stderr);
+  if (err) {
+    throw LibSL::Errors::Fatal("Qhull error: %d", err);
+  }
 
+  m_Context = (void*)&ctx.qh;
+  extractHull(num_points);
   m_Context = NULL;
 
-#ifdef USE_CXX11
-  g_QhullLock.unlock();
-#endif
-  delete [] data;
   reorientFaces();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 template<int Dim>
 void ConvexHullEngine<Dim>::extractHull(
-    const std::vector<VectorXd>& points)
+    size_t num_input_points)
 {
   qhT *qh = (qhT*)m_Context;
   const size_t dim = Dim;
-  const size_t num_input_points = points.size();
   const size_t num_faces = qh->num_facets;
   const size_t num_vertices = qh->num_vertices;
 
@@ -187,6 +193,31 @@ void ConvexHullEngine<3>::reorientFaces() {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+template<int Dim>
+int computeHulls(
+    const std::vector< std::vector< LibSL::Math::Tuple<double, Dim> > >& batch,
+    std::vector< ConvexHullEngine<Dim> >& _hulls)
+{
+  _hulls.clear();
+  _hulls.resize(batch.size());
+  std::vector<char> failed(batch.size(), 0);
+  // parts are usually small: several per task amortizes the scheduling
+  LibSL::System::Parallel::forIndex(0, (int)batch.size(), [&](int i) {
+    try {
+      _hulls[i].run(batch[i]);
+    } catch (LibSL::Errors::Fatal&) {
+      // degenerate part (flat, too few points): leave its hull empty
+      failed[i] = 1;
+    }
+  }, 8);
+  int num_failed = 0;
+  for (size_t i = 0; i < failed.size(); i++) {
+    num_failed += failed[i];
+  }
+  return num_failed;
+}
+
 // -----------------------------------------------------------------------------
 
 } // namespace LibSL::Geometry
@@ -198,3 +229,10 @@ void ConvexHullEngine<3>::reorientFaces() {
 
 template class LibSL::Geometry::ConvexHullEngine<2>;
 template class LibSL::Geometry::ConvexHullEngine<3>;
+
+template int LibSL::Geometry::computeHulls<2>(
+    const std::vector< std::vector< LibSL::Math::Tuple<double, 2> > >&,
+    std::vector< LibSL::Geometry::ConvexHullEngine<2> >&);
+template int LibSL::Geometry::computeHulls<3>(
+    const std::vector< std::vector< LibSL::Math::Tuple<double, 3> > >&,
+    std::vector< LibSL::Geometry::ConvexHullEngine<3> >&);
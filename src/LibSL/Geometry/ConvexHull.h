@@ -19,6 +19,9 @@ namespace LibSL {
      * pointing away from the center.  In addition, the algorithm also returns an
      * index for each convex hull vertex that specifies the corresponding input
      * point.
+     *
+     * Each call to run uses its own reentrant qhull context: distinct engines
+     * can compute hulls concurrently from different threads.
      */
     template<int Dim>
     class ConvexHullEngine {
@@ -31,13 +34,15 @@ namespace LibSL {
 
       public:
         void run(const std::vector<VectorXd>& points);
+        // Same, from num_points * Dim contiguous coordinates (no copy is made)
+        void run(const double *coords, size_t num_points);
 
         const std::vector<VectorXd>& getVertices() const { return m_Vertices; }
         const std::vector<VectorXi>& getFaces()    const { return m_Faces; }
         const std::vector<int>&      getIndexMap() const { return m_IndexMap; }
 
       protected:
-        void extractHull(const std::vector<VectorXd>& points);
+        void extractHull(size_t num_input_points);
         void reorientFaces();
 
       protected:
@@ -51,5 +56,16 @@ namespace LibSL {
     class ConvexHull2d : public ConvexHullEngine<2> {};
     class ConvexHull3d : public ConvexHullEngine<3> {};
 
+    /**
+     * Computes the hulls of many point sets in parallel (e.g. the parts of a
+     * convex decomposition). _hulls[i] receives the hull of batch[i]; sets that
+     * qhull rejects (degenerate or too few points) are left empty.
+     * Returns the number of such rejected sets.
+     */
+    template<int Dim>
+    int computeHulls(
+      const std::vector< std::vector< LibSL::Math::Tuple<double, Dim> > >& batch,
+      std::vector< ConvexHullEngine<Dim> >& _hulls);
+
   } // namespace LibSL::Geometry
 } // namespace LibSL
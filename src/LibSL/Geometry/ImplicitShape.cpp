@@ -38,115 +38,311 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include "ImplicitShape.h"
 
+#include <LibSL/Mesh/MeshNormals.h>
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <unordered_map>
+
 #define NAMESPACE LibSL::Geometry
 
 // ------------------------------------------------------
 
-NAMESPACE::ImplicitShape::~ImplicitShape()
+void NAMESPACE::ImplicitShape::ImplicitFunction::evaluate(const v3f *points,int n,float *_values) const
 {
-  if (!m_MC.isNull()) {
-    m_MC->clean_temps();
-    m_MC->clean_all();
+  ForIndex(i,n) {
+    _values[i] = (*this)(points[i]);
   }
 }
 
 // ------------------------------------------------------
 
-void NAMESPACE::ImplicitShape::initGrid()
+NAMESPACE::ImplicitShape::~ImplicitShape()
 {
-  float x,y,z;
-  float sx,sy,sz;
-//  float tx,ty,tz;
+}
 
-  sx     = (float)m_MC->size_x();
-  sy     = (float)m_MC->size_y();
-  sz     = (float)m_MC->size_z();
-  std::cerr << "Sampling function ... ";
-  Console::progressTextInit(m_MC->size_z());
-  ForIndex(k,m_MC->size_z()) {
-    Console::progressTextUpdate();
-    z = ( (float) k ) / (sz-1) ;
-    z = m_Box.minCorner()[2] + z * (m_Box.maxCorner()[2] - m_Box.minCorner()[2]);
-    ForIndex(j,m_MC->size_y()) {
-      y = ( (float) j ) / (sy-1) ;
-      y = m_Box.minCorner()[1] + y * (m_Box.maxCorner()[1] - m_Box.minCorner()[1]);
-      ForIndex(i,m_MC->size_x()) {
-        x = ( (float) i ) / (sx-1) ;
-        x = m_Box.minCorner()[0] + x * (m_Box.maxCorner()[0] - m_Box.minCorner()[0]);
-        m_MC->set_data( m_Implicit(V3F(x,y,z)), i,j,k );
+// ------------------------------------------------------
+
+float NAMESPACE::ImplicitShape::gridToWorld(int g,int axis) const
+{
+  float t = ( (float) g ) / (float)(m_Resolution-1);
+  return m_Box.minCorner()[axis] + t * (m_Box.maxCorner()[axis] - m_Box.minCorner()[axis]);
+}
+
+// ------------------------------------------------------
+
+// loop grain, a single chunk runs serially on the caller
+int NAMESPACE::ImplicitShape::grain(int num,int g) const
+{
+  return m_Implicit.threadSafe() ? g : max(num, 1);
+}
+
+// ------------------------------------------------------
+
+// number of samples of a block along each axis (last blocks may be partial)
+v3i NAMESPACE::ImplicitShape::blockSize(const v3i& b) const
+{
+  v3i sz;
+  ForIndex(a,3) {
+    sz[a] = min(int(e_BlockCells), m_Resolution - 1 - b[a] * int(e_BlockCells)) + 1;
+  }
+  return sz;
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::ImplicitShape::sampleBlock(const v3i& b,std::vector<float>& _samples) const
+{
+  v3i sz = blockSize(b);
+  v3i g0 = b * int(e_BlockCells);
+  std::vector<v3f> pts(sz[0] * sz[1] * sz[2]);
+  int n = 0;
+  ForIndex(k,sz[2]) {
+    float z = gridToWorld(g0[2] + k, 2);
+    ForIndex(j,sz[1]) {
+      float y = gridToWorld(g0[1] + j, 1);
+      ForIndex(i,sz[0]) {
+        pts[n++] = V3F(gridToWorld(g0[0] + i, 0), y, z);
       }
     }
   }
-  Console::progressTextEnd();
-  std::cerr << std::endl;
+  _samples.resize(pts.size());
+  m_Implicit.evaluate(&pts[0], n, &_samples[0]);
 }
 
 // ------------------------------------------------------
 
-void NAMESPACE::ImplicitShape::init()
+// Top-down traversal of an octree over the blocks, a node is
+// discarded when the function bounds exclude the iso value
+void NAMESPACE::ImplicitShape::candidateBlocks(float iso,std::vector<v3i>& _blocks) const
 {
-  m_MC = AutoPtr<NAMESPACE::MarchingCubes::MarchingCubes>(new NAMESPACE::MarchingCubes::MarchingCubes());
-  m_MC->set_resolution( m_Resolution,m_Resolution,m_Resolution );
-  m_MC->init_all();
-  initGrid();
+  typedef struct { v3i b; int s; } t_Node;
+  const float lip = m_Implicit.lipschitz();
+  int root = 1;
+  while (root < m_NumBlocks) root <<= 1;
+  std::vector<t_Node> frontier(1), next;
+  frontier[0].b = 0;
+  frontier[0].s = root;
+  _blocks.clear();
+  while (!frontier.empty()) {
+    std::vector<char> keep(frontier.size(), 0);
+    LibSL::System::Parallel::forIndex(0, (int)frontier.size(), [&](int n) {
+      const t_Node& nd = frontier[n];
+      v3f lo, hi;
+      ForIndex(a,3) {
+        if (nd.b[a] >= m_NumBlocks) return; // outside of the grid
+        lo[a] = gridToWorld(nd.b[a] * int(e_BlockCells), a);
+        hi[a] = gridToWorld(min((nd.b[a] + nd.s) * int(e_BlockCells), m_Resolution - 1), a);
+      }
+      float vmin = -FLT_MAX, vmax = FLT_MAX;
+      float rmin, rmax;
+      if (m_Implicit.range(AAB<3>(lo, hi), rmin, rmax)) {
+        vmin = rmin;
+        vmax = rmax;
+      }
+      if (lip > 0.0f) {
+        float c = m_Implicit((lo + hi) * 0.5f);
+        float r = lip * length(hi - lo) * 0.5f;
+        vmin = max(vmin, c - r);
+        vmax = min(vmax, c + r);
+      }
+      keep[n] = (iso >= vmin && iso <= vmax);
+    }, grain((int)frontier.size(), 16));
+    next.clear();
+    ForIndex(n,frontier.size()) {
+      if (!keep[n]) continue;
+      const t_Node& nd = frontier[n];
+      if (nd.s == 1) {
+        _blocks.push_back(nd.b);
+        continue;
+      }
+      int h = nd.s / 2;
+      ForIndex(c,8) {
+        t_Node ch;
+        ch.b = nd.b + V3I(c & 1, (c >> 1) & 1, (c >> 2) & 1) * h;
+        ch.s = h;
+        next.push_back(ch);
+      }
+    }
+    std::swap(frontier, next);
+  }
+}
+
+// ------------------------------------------------------
+
+namespace {
+
+  // exact position key, vertices on shared block faces are computed identically
+  struct PosKey
+  {
+    uint v[3];
+    bool operator==(const PosKey& k) const { return v[0] == k.v[0] && v[1] == k.v[1] && v[2] == k.v[2]; }
+  };
+
+  struct PosKeyHash
+  {
+    size_t operator()(const PosKey& k) const { return size_t(k.v[0] * 73856093u ^ k.v[1] * 19349663u ^ k.v[2] * 83492791u); }
+  };
+
+  // triangles of one block, vertices in grid coordinates
+  typedef struct
+  {
+    bool               sampled;
+    float              vmin;
+    float              vmax;
+    std::vector<float> samples;
+    std::vector<v3f>   verts;
+    std::vector<v3u>   tris;
+    std::vector<char>  onFace;
+  } t_BlockOutput;
+
 }
 
 // ------------------------------------------------------
 
 NAMESPACE::ImplicitShape::t_Mesh *NAMESPACE::ImplicitShape::generateShape(float iso)
 {
-  if (m_MC.isNull()) {
-    init();
+  std::vector<v3i> blocks;
+  candidateBlocks(iso, blocks);
+
+  // one marching cubes per worker and block size
+  std::vector< std::map<int, MarchingCubes::MarchingCubes*> > mcs(LibSL::System::Parallel::numThreads());
+  std::vector<t_BlockOutput> outputs(blocks.size());
+
+  std::cerr << "Sampling function ... ";
+  Console::progressTextInit((uint)blocks.size());
+  LibSL::System::Parallel::forIndex(0, (int)blocks.size(), [&](int n) {
+    Console::progressTextUpdate();
+    const v3i&     b   = blocks[n];
+    t_BlockOutput& out = outputs[n];
+    long long key = b[0] + (long long)m_NumBlocks * (b[1] + (long long)m_NumBlocks * b[2]);
+    std::map<long long, t_Block>::const_iterator B = m_Blocks.find(key);
+    const std::vector<float> *samples = NULL;
+    out.sampled = false;
+    if (B != m_Blocks.end()) {
+      // range is known, samples may be cached
+      if (iso < B->second.vmin || iso > B->second.vmax) return;
+      if (!B->second.samples.empty()) samples = &B->second.samples;
+    }
+    if (samples == NULL) {
+      sampleBlock(b, out.samples);
+      out.sampled = true;
+      out.vmin    = *std::min_element(out.samples.begin(), out.samples.end());
+      out.vmax    = *std::max_element(out.samples.begin(), out.samples.end());
+      if (iso < out.vmin || iso > out.vmax) return;
+      samples = &out.samples;
+    }
+    // polygonize
+    v3i sz = blockSize(b);
+    int id = sz[0] + 32 * (sz[1] + 32 * sz[2]);
+    std::map<int, MarchingCubes::MarchingCubes*>& wmcs = mcs[LibSL::System::Parallel::workerId()];
+    MarchingCubes::MarchingCubes *mc;
+    if (wmcs.find(id) == wmcs.end()) {
+      mc = new MarchingCubes::MarchingCubes();
+      mc->set_resolution(sz[0], sz[1], sz[2]);
+      mc->set_ext_data(const_cast<float*>(&(*samples)[0]));
+      mc->init_all();
+      wmcs[id] = mc;
+    } else {
+      mc = wmcs[id];
+      mc->set_ext_data(const_cast<float*>(&(*samples)[0]));
+      mc->restart();
+    }
+    mc->run(iso);
+    v3f g0 = v3f(b * int(e_BlockCells));
+    out.verts .resize(mc->nverts());
+    out.onFace.resize(mc->nverts());
+    ForIndex(i,mc->nverts()) {
+      const MarchingCubes::Vertex& v = mc->vertices()[i];
+      v3f l = V3F(v.x, v.y, v.z);
+      out.verts [i] = l + g0;
+      out.onFace[i] = (l[0] == 0.0f || l[0] == float(sz[0] - 1)
+                    || l[1] == 0.0f || l[1] == float(sz[1] - 1)
+                    || l[2] == 0.0f || l[2] == float(sz[2] - 1));
+    }
+    out.tris.resize(mc->ntrigs());
+    ForIndex(i,mc->ntrigs()) {
+      const MarchingCubes::Triangle& t = mc->triangles()[i];
+      out.tris[i] = V3U(t.v1, t.v2, t.v3);
+    }
+  }, grain((int)blocks.size(), 1));
+  Console::progressTextEnd();
+  std::cerr << std::endl;
+
+  ForIndex(w,mcs.size()) {
+    for (std::map<int, MarchingCubes::MarchingCubes*>::iterator M = mcs[w].begin(); M != mcs[w].end(); M++) {
+      delete (M->second); // samples are external, not freed
+    }
   }
 
-  m_MC->restart();
+  // record ranges, keep samples within budget
+  ForIndex(n,outputs.size()) {
+    t_BlockOutput& out = outputs[n];
+    if (!out.sampled) continue;
+    const v3i& b = blocks[n];
+    long long key = b[0] + (long long)m_NumBlocks * (b[1] + (long long)m_NumBlocks * b[2]);
+    t_Block& blk = m_Blocks[key];
+    blk.vmin = out.vmin;
+    blk.vmax = out.vmax;
+    size_t bytes = out.samples.size() * sizeof(float);
+    if (m_CacheBytes + bytes <= m_CacheBudget) {
+      blk.samples.swap(out.samples);
+      m_CacheBytes += bytes;
+    }
+    std::vector<float>().swap(out.samples);
+  }
 
-  m_MC->run(iso);
+  // stitch blocks: weld vertices lying on block faces
+  std::vector<v3f> verts;
+  std::vector<v3u> tris;
+  std::unordered_map<PosKey, uint, PosKeyHash> faceVerts;
+  std::vector<uint> remap;
+  ForIndex(n,outputs.size()) {
+    const t_BlockOutput& out = outputs[n];
+    remap.resize(out.verts.size());
+    ForIndex(i,out.verts.size()) {
+      if (out.onFace[i]) {
+        PosKey k;
+        memcpy(k.v, &out.verts[i][0], sizeof(k.v));
+        std::pair<std::unordered_map<PosKey, uint, PosKeyHash>::iterator, bool> ins = faceVerts.insert(std::make_pair(k, (uint)verts.size()));
+        if (!ins.second) {
+          remap[i] = ins.first->second;
+          continue;
+        }
+      }
+      remap[i] = (uint)verts.size();
+      verts.push_back(out.verts[i]);
+    }
+    ForIndex(t,out.tris.size()) {
+      v3u tri = V3U(remap[out.tris[t][0]], remap[out.tris[t][1]], remap[out.tris[t][2]]);
+      // vertices collapsed onto a grid corner
+      if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) continue;
+      tris.push_back(tri);
+    }
+  }
 
-  if (m_MC->nverts() == 0 || m_MC->ntrigs() == 0) {
+  if (verts.empty() || tris.empty()) {
     return NULL;
   }
 
-  t_Mesh *mesh = new t_Mesh( m_MC->nverts(),m_MC->ntrigs() );
-  
-  float sx    = (float)m_MC->size_x();
-  float sy    = (float)m_MC->size_y();
-  float sz    = (float)m_MC->size_z();
-  ForIndex(i,m_MC->nverts()) {
-		float x = m_MC->vertices()[i].x;
-		float y = m_MC->vertices()[i].y;
-		float z = m_MC->vertices()[i].z;
-    mesh->vertexAt(i).pos = V3F(x,y,z) * (m_Box.maxCorner() - m_Box.minCorner()) / V3F(sx-1,sy-1,sz-1) + m_Box.minCorner();
+  t_Mesh *mesh = new t_Mesh( (uint)verts.size(), (uint)tris.size(), 0, AutoPtr<MVF>(MVF::make<t_VertexFormat>()) );
+
+  float sx    = (float)m_Resolution;
+  float sy    = (float)m_Resolution;
+  float sz    = (float)m_Resolution;
+  ForIndex(i,verts.size()) {
+    mesh->vertexAt(i).pos = verts[i] * (m_Box.maxCorner() - m_Box.minCorner()) / V3F(sx-1,sy-1,sz-1) + m_Box.minCorner();
     mesh->vertexAt(i).nrm = 0;
     mesh->vertexAt(i).uv  = 0;
-	}
-
-  ForIndex(i,m_MC->ntrigs()) {
-		v3u tri;
-    tri[0] = m_MC->triangles()[i].v1;
-		tri[1] = m_MC->triangles()[i].v2;
-		tri[2] = m_MC->triangles()[i].v3;
-	  mesh->triangleAt(i) = tri;
   }
 
-  // compute normals
-  FastArray<v3f> nrms(mesh->numVertices());
-  nrms.fill(0);
-  ForIndex(t,mesh->numTriangles()) {
-    int vids[3];
-    v3f pts[3];
-    ForIndex(i,3) {
-      vids[i] = mesh->triangleAt(t)[i];
-      pts[i]  = mesh->vertexAt(vids[i]).pos;
-    }
-    v3f n = normalize_safe( cross(pts[1]-pts[0],pts[2]-pts[0]) );
-    ForIndex(i,3) {
-      nrms[vids[i]] += n;
-    }
-  }
-  ForIndex(v,mesh->numVertices()) {
-    mesh->vertexAt(v).nrm = normalize_safe(nrms[v]);
+  ForIndex(i,tris.size()) {
+    mesh->triangleAt(i) = tris[i];
   }
+  // compute normals
+  MeshNormals::computeNormals(mesh,MeshNormals::Uniform);
 
   return mesh;
 }
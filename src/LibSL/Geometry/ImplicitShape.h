@@ -40,6 +40,12 @@ knowledge of the CeCILL-C license and that you accept its terms.
 //  Produce a mesh from an implicit function
 //    the function must be defined in [0..1]^3
 //
+//  The grid is sampled by blocks. An octree over the blocks
+//  discards the ones the function bounds (Lipschitz constant
+//  or interval range) prove to be away from the iso value;
+//  the remaining blocks are sampled and polygonized in
+//  parallel, then stitched along their shared faces.
+//
 // ------------------------------------------------------
 // Sylvain Lefebvre - 2009-01-11
 // ------------------------------------------------------
@@ -60,6 +66,9 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include <LibSL/Geometry/MarchingCubes.h>
 
+#include <map>
+#include <vector>
+
 namespace LibSL {
   namespace Geometry {
 
@@ -78,26 +87,61 @@ namespace LibSL {
       typedef MVF3(LibSL::Mesh::mvf_position_3f,LibSL::Mesh::mvf_normal_3f,LibSL::Mesh::mvf_texcoord0_2f) t_VertexFormat;
       typedef LibSL::Mesh::TriangleMesh_generic<t_VertexData>                                             t_Mesh;
 
+      /**
+      The function is evaluated from several threads at once
+      only if threadSafe() returns true, serially otherwise.
+      */
       class ImplicitFunction
       {
       public:
+        virtual ~ImplicitFunction() { }
         virtual float operator()(const LibSL::Math::v3f& p) const = 0;
+        /**
+        Evaluates n points at once, override to vectorize.
+        */
+        virtual void  evaluate(const LibSL::Math::v3f *points,int n,float *_values) const;
+        /**
+        Conservative range of the function over a box (e.g. interval
+        arithmetic). Returns false when unknown (default).
+        */
+        virtual bool  range(const LibSL::Geometry::AAB<3>& /*box*/,float& /*_min*/,float& /*_max*/) const { return false; }
+        /**
+        Lipschitz constant of the function (1 for a distance field),
+        0 when unknown (default).
+        */
+        virtual float lipschitz() const { return 0.0f; }
+        /**
+        True when operator() and evaluate may be called concurrently
+        from several threads, false by default.
+        */
+        virtual bool  threadSafe() const { return false; }
       };
 
     protected:
 
+      enum { e_BlockCells = 16 };
+
+      // sampled block: range of its samples, samples if cached
+      typedef struct
+      {
+        float              vmin;
+        float              vmax;
+        std::vector<float> samples;
+      } t_Block;
+
       const ImplicitFunction&                        m_Implicit;
-      LibSL::Memory::Pointer::AutoPtr<MarchingCubes::MarchingCubes> m_MC;
       int                                            m_Resolution;
       LibSL::Geometry::AAB<3>                        m_Box;
+      int                                            m_NumBlocks;
+      std::map<long long,t_Block>                    m_Blocks;
+      size_t                                         m_CacheBytes;
+      size_t                                         m_CacheBudget;
 
-      void                           initGrid();
-      void                           initMarchingCube();
-
-      /**
-      Computes the distance field (slow)
-      */
-      void            init();
+      float                          gridToWorld(int g,int axis) const;
+      int                            grain(int num,int g) const;
+      LibSL::Math::v3i               blockSize(const LibSL::Math::v3i& b) const;
+      void                           sampleBlock(const LibSL::Math::v3i& b,std::vector<float>& _samples) const;
+      void                           candidateBlocks(float iso,std::vector<LibSL::Math::v3i>& _blocks) const;
 
     public:
       
@@ -105,7 +149,8 @@ namespace LibSL {
         const ImplicitFunction& f,
         int           resolution,
         const LibSL::Geometry::AAB<3>& box = LibSL::Geometry::AAB<3>(0.0f,1.0f) )
-        : m_Implicit(f), m_Resolution(resolution), m_Box(box) { }
+        : m_Implicit(f), m_Resolution(resolution), m_Box(box),
+          m_NumBlocks((resolution - 2) / e_BlockCells + 1), m_CacheBytes(0), m_CacheBudget(256u << 20) { }
       ~ImplicitShape();
 
       /**
@@ -113,12 +158,18 @@ namespace LibSL {
       
         - First call is slow since it evaluates the function.
         - Subsequent calls are faster: the function may be called several times 
-          for fast isovalue exploration.
+          for fast isovalue exploration. The sample range of every visited
+          block is kept, samples are kept up to the cache budget.
         - Mesh is embbeded within box given as parameter to the constructor
         - Returns NULL if there is no intersection with the isosurface.
       */
       t_Mesh *generateShape(float iso = 0.5f);
 
+      /**
+      Memory kept for samples between calls to generateShape (default 256 MB)
+      */
+      void    setCacheBudget(size_t bytes) { m_CacheBudget = bytes; }
+
     };
 
   } //namespace LibSL::Geometry
@@ -37,6 +37,10 @@ knowledge of the CeCILL-C license and that you accept its terms.
 // ------------------------------------------------------
 
 #include "Morpho.h"
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <atomic>
 
 using namespace std;
 
@@ -171,77 +175,10 @@ void NAMESPACE::Morpho::hit_and_miss(Array2D<bool>& _array, int8_t kernel[3][3])
 
 void NAMESPACE::Morpho::thinning(Array2D<bool>& _array)
 {
-  int8_t k1_b[3][3] =
-  {{ 0, 0, 0},
-   {-1, 1,-1},
-   { 1, 1, 1}};
-  int8_t k1_c[3][3] =
-  { { 1,-1, 0 },
-    { 1, 1, 0 },
-    { 1,-1, 0 } };
-  int8_t k1_a[3][3] =
-  { { 1, 1, 1 },
-    {-1, 1,-1 },
-    { 0, 0, 0 } };
-  int8_t k1_d[3][3] =
-  { { 0,-1, 1 },
-    { 0, 1, 1 },
-    { 0,-1, 1 } };
-  int8_t k2_d[3][3] =
-  { {-1, 0, 0 },
-    { 1, 1, 0 },
-    {-1, 1,-1 } };
-  int8_t k2_a[3][3] =
-  { {-1, 1,-1 },
-    { 1, 1, 0 },
-    {-1, 0, 0 } };
-  int8_t k2_b[3][3] =
-  { {-1, 1,-1 },
-    { 0, 1, 1 },
-    { 0, 0,-1 } };
-  int8_t k2_c[3][3] =
-  { { 0, 0,-1 },
-    { 0, 1, 1 },
-    {-1, 1,-1 } };
-  bool changed = true;
-  Array2D<bool> map = _array;
-  Array2D<bool> tmp;
-  while (changed) {
-    changed = false;
-    tmp = map;
-    hit_and_miss(tmp, k1_a);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k1_b);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k1_c);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k1_d);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k2_a);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k2_b);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k2_c);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-    tmp = map;
-    hit_and_miss(tmp, k2_d);
-    ForArray2D(tmp, i, j) { bool r = (map.at(i, j) && !tmp.at(i, j)); changed |= r ^ map.at(i, j); map.at(i, j) = r; }
-#if 0
-    static int cnt = 0;
-    ImageRGB img(_array.xsize(), _array.ysize());
-    ForImage((&img), i, j) {
-      img.pixel(i, j) = map.at(i, j) ? v3b(255) : v3b(0);
-    }
-    saveImage(sprint("dump\\%04d.thinmap.tga", cnt++), &img);
-#endif
-  }
-  _array = map;
+  // the kernels are applied on the bit-packed mask, see thinning(BitMask&)
+  BitMask mask(_array);
+  thinning(mask);
+  mask.toArray(_array);
 }
 
 // ---------------------------------------------------
@@ -281,3 +218,415 @@ void NAMESPACE::Morpho::Intersection(const Array2D<bool>& a, const Array2D<bool>
 }
 
 // ---------------------------------------------------
+
+// ---------------------------------------------------
+// Bit-packed masks
+// ---------------------------------------------------
+
+typedef NAMESPACE::BitMask::t_Word t_Word;
+
+// ---------------------------------------------------
+
+void NAMESPACE::BitMask::allocate(int xs, int ys)
+{
+  if (xs < 0 || ys < 0) {
+    throw LibSL::Errors::Fatal("BitMask::allocate - invalid size (%d x %d)", xs, ys);
+  }
+  m_XSize       = xs;
+  m_YSize       = ys;
+  m_WordsPerRow = (xs + e_WordBits - 1) / e_WordBits;
+  m_Words.assign((size_t)m_WordsPerRow * (size_t)ys, t_Word(0));
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::BitMask::erase()
+{
+  m_XSize = m_YSize = m_WordsPerRow = 0;
+  std::vector<t_Word>().swap(m_Words);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::BitMask::fill(bool b)
+{
+  std::fill(m_Words.begin(), m_Words.end(), b ? ~t_Word(0) : t_Word(0));
+  if (b && m_WordsPerRow > 0) {
+    t_Word last = lastWordMask();
+    ForIndex(j, m_YSize) { row(j)[m_WordsPerRow - 1] &= last; }
+  }
+}
+
+// ---------------------------------------------------
+
+static inline int popCount(t_Word w)
+{
+#if defined(_MSC_VER)
+  w = w - ((w >> 1) & 0x5555555555555555ull);
+  w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+  w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return (int)((w * 0x0101010101010101ull) >> 56);
+#else
+  return __builtin_popcountll(w);
+#endif
+}
+
+long long NAMESPACE::BitMask::count() const
+{
+  long long n = 0;
+  for (size_t w = 0; w < m_Words.size(); w++) {
+    n += popCount(m_Words[w]);
+  }
+  return n;
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::BitMask::fromArray(const Array2D<bool>& a)
+{
+  allocate(a.xsize(), a.ysize());
+  LibSL::System::Parallel::forIndex(0, m_YSize, [&](int j) {
+    t_Word *r = row(j);
+    ForIndex(i, m_XSize) {
+      if (a.at(i, j)) r[i >> 6] |= t_Word(1) << (i & 63);
+    }
+  }, 16);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::BitMask::toArray(Array2D<bool>& _a) const
+{
+  if (int(_a.xsize()) != m_XSize || int(_a.ysize()) != m_YSize) {
+    _a.erase();
+    _a.allocate(m_XSize, m_YSize);
+  }
+  LibSL::System::Parallel::forIndex(0, m_YSize, [&](int j) {
+    const t_Word *r = row(j);
+    ForIndex(i, m_XSize) {
+      _a.at(i, j) = ((r[i >> 6] >> (i & 63)) & 1) != 0;
+    }
+  }, 16);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::BitMask::swap(BitMask& m)
+{
+  std::swap(m_XSize, m.m_XSize);
+  std::swap(m_YSize, m.m_YSize);
+  std::swap(m_WordsPerRow, m.m_WordsPerRow);
+  m_Words.swap(m.m_Words);
+}
+
+// ---------------------------------------------------
+
+// Word w of the row shifted so that bit x holds pixel x+s, pixels outside the row are zero
+static inline t_Word shiftedWord(const t_Word *src, int nw, int w, int s)
+{
+  if (s >= 0) {
+    int q = w + (s >> 6), o = s & 63;
+    t_Word r = (q < nw) ? (src[q] >> o) : 0;
+    if (o != 0 && q + 1 < nw) r |= src[q + 1] << (64 - o);
+    return r;
+  } else {
+    int t = -s;
+    int q = w - (t >> 6), o = t & 63;
+    t_Word r = (q >= 0) ? (src[q] << o) : 0;
+    if (o != 0 && q - 1 >= 0) r |= src[q - 1] >> (64 - o);
+    return r;
+  }
+}
+
+// Horizontal dilation of a row by the segment [-w,w]
+// The covered segment is grown by doubling: [-a,a] -> [-(a+s),a+s] with s <= 2a+1
+static void dilateRow(const t_Word *src, t_Word *dst, t_Word *tmp, int nw, int w, t_Word lastMask)
+{
+  std::copy(src, src + nw, dst);
+  int a = 0;
+  while (a < w) {
+    int s = std::min(2 * a + 1, w - a);
+    std::copy(dst, dst + nw, tmp);
+    ForIndex(k, nw) {
+      dst[k] = tmp[k] | shiftedWord(tmp, nw, k, s) | shiftedWord(tmp, nw, k, -s);
+    }
+    a += s;
+  }
+  dst[nw - 1] &= lastMask;
+}
+
+// ---------------------------------------------------
+
+// Dilation by a union of rectangles [-w,w]x[-h,h], rects[r] = (w,h)
+// Each band of rows is processed independently: rows are dilated horizontally
+// into a scratch buffer, then vertically by doubling over the buffer rows.
+static void dilateByRectangles(NAMESPACE::BitMask& _mask, const std::vector<std::pair<int, int> >& rects)
+{
+  if (_mask.empty() || rects.empty()) return;
+  const int xs = _mask.xsize(), ys = _mask.ysize(), nw = _mask.wordsPerRow();
+  const t_Word lastMask = _mask.lastWordMask();
+  int maxh = 0;
+  for (size_t r = 0; r < rects.size(); r++) maxh = std::max(maxh, rects[r].second);
+  NAMESPACE::BitMask result(xs, ys);
+  const NAMESPACE::BitMask& src = _mask;
+  // bands large enough to amortize the 2*h rows of overlap
+  int band = std::max(64, 2 * maxh);
+  LibSL::System::Parallel::forChunks(0, ys, [&](int j0, int j1) {
+    int r0 = std::max(0, j0 - maxh), r1 = std::min(ys, j1 + maxh);
+    std::vector<t_Word> cur((size_t)(r1 - r0) * nw), nxt((size_t)(r1 - r0) * nw), tmp(nw);
+    for (size_t r = 0; r < rects.size(); r++) {
+      int w = rects[r].first, h = rects[r].second;
+      int b0 = std::max(0, j0 - h), b1 = std::min(ys, j1 + h);
+      // horizontal pass
+      ForRange(j, b0, b1 - 1) {
+        dilateRow(src.row(j), &cur[(size_t)(j - b0) * nw], &tmp[0], nw, w, lastMask);
+      }
+      // vertical pass, same doubling scheme as dilateRow
+      int a = 0;
+      while (a < h) {
+        int s = std::min(2 * a + 1, h - a);
+        ForRange(j, b0, b1 - 1) {
+          t_Word       *d = &nxt[(size_t)(j - b0) * nw];
+          const t_Word *c = &cur[(size_t)(j - b0) * nw];
+          const t_Word *u = (j - s >= b0) ? &cur[(size_t)(j - s - b0) * nw] : NULL;
+          const t_Word *v = (j + s <  b1) ? &cur[(size_t)(j + s - b0) * nw] : NULL;
+          ForIndex(k, nw) {
+            d[k] = c[k] | (u ? u[k] : 0) | (v ? v[k] : 0);
+          }
+        }
+        cur.swap(nxt);
+        a += s;
+      }
+      ForRange(j, j0, j1 - 1) {
+        t_Word       *d = result.row(j);
+        const t_Word *c = &cur[(size_t)(j - b0) * nw];
+        ForIndex(k, nw) { d[k] |= c[k]; }
+      }
+    }
+  }, band);
+  _mask.swap(result);
+}
+
+// ---------------------------------------------------
+
+// Decomposes the disc { (dx,dy) : dx^2+dy^2 < radius^2 } into rectangles
+static void discRectangles(float radius, std::vector<std::pair<int, int> >& _rects)
+{
+  _rects.clear();
+  if (!(radius > 0.0f)) return;
+  double r2 = double(radius) * double(radius);
+  int hmax = 0;
+  while (double(hmax + 1) * double(hmax + 1) < r2) hmax++;
+  int prevw = -1;
+  for (int dy = hmax; dy >= 0; dy--) {
+    int w = 0;
+    while (double(w + 1) * double(w + 1) + double(dy) * double(dy) < r2) w++;
+    // the rectangle of half height dy is only needed where the disc gets wider
+    if (w != prevw) {
+      _rects.push_back(std::make_pair(w, dy));
+      prevw = w;
+    }
+  }
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::dilate(BitMask& _mask, float radius)
+{
+  std::vector<std::pair<int, int> > rects;
+  discRectangles(radius, rects);
+  dilateByRectangles(_mask, rects);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::erode(BitMask& _mask, float radius)
+{
+  negate(_mask);
+  dilate(_mask, radius);
+  negate(_mask);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::close(BitMask& _mask, float radius)
+{
+  dilate(_mask, radius);
+  erode(_mask, radius);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::open(BitMask& _mask, float radius)
+{
+  erode(_mask, radius);
+  dilate(_mask, radius);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::dilateSquare(BitMask& _mask, int halfSize)
+{
+  if (halfSize <= 0) return;
+  std::vector<std::pair<int, int> > rects(1, std::make_pair(halfSize, halfSize));
+  dilateByRectangles(_mask, rects);
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::erodeSquare(BitMask& _mask, int halfSize)
+{
+  negate(_mask);
+  dilateSquare(_mask, halfSize);
+  negate(_mask);
+}
+
+// ---------------------------------------------------
+
+// Word w of the row shifted by s = -1, 0 or 1, wrapping around the row
+static inline t_Word wrappedWord(const t_Word *src, int nw, int xs, int w, int s)
+{
+  if (s == 0) return src[w];
+  t_Word r = shiftedWord(src, nw, w, s);
+  if (s > 0) {
+    if (w == nw - 1) { // pixel xs-1 sees pixel 0
+      int b = (xs - 1) & 63;
+      r = (r & ~(t_Word(1) << b)) | ((src[0] & 1) << b);
+    }
+  } else {
+    if (w == 0) {      // pixel 0 sees pixel xs-1
+      r = (r & ~t_Word(1)) | ((src[nw - 1] >> ((xs - 1) & 63)) & 1);
+    }
+  }
+  return r;
+}
+
+// Computes for row j the word mask of pixels matching the kernel
+// (kernel[ni+1][nj+1] applies to the neighbor at offset (ni,nj), as in the Array2D<bool> version)
+static inline void hitRow(const NAMESPACE::BitMask& m, int j, int8_t kernel[3][3], t_Word *_hit)
+{
+  const int xs = m.xsize(), ys = m.ysize(), nw = m.wordsPerRow();
+  const t_Word *rows[3] = { m.row((j + ys - 1) % ys), m.row(j), m.row((j + 1) % ys) };
+  ForIndex(k, nw) {
+    t_Word h = ~t_Word(0);
+    ForRange(nj, -1, 1) {
+      ForRange(ni, -1, 1) {
+        int8_t c = kernel[ni + 1][nj + 1];
+        if (c == 0) {
+          h &= ~wrappedWord(rows[nj + 1], nw, xs, k, ni);
+        } else if (c == 1) {
+          h &= wrappedWord(rows[nj + 1], nw, xs, k, ni);
+        }
+      }
+    }
+    _hit[k] = h;
+  }
+  _hit[nw - 1] &= m.lastWordMask();
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::hit_and_miss(BitMask& _mask, int8_t kernel[3][3])
+{
+  if (_mask.empty()) return;
+  BitMask result(_mask.xsize(), _mask.ysize());
+  LibSL::System::Parallel::forIndex(0, _mask.ysize(), [&](int j) {
+    hitRow(_mask, j, kernel, result.row(j));
+  }, 16);
+  _mask.swap(result);
+}
+
+// ---------------------------------------------------
+
+// Kernels of the thinning, shared by the Array2D<bool> and BitMask versions
+static int8_t s_ThinningKernels[8][3][3] = {
+  { { 1, 1, 1 },{-1, 1,-1 },{ 0, 0, 0 } }, // k1_a
+  { { 0, 0, 0 },{-1, 1,-1 },{ 1, 1, 1 } }, // k1_b
+  { { 1,-1, 0 },{ 1, 1, 0 },{ 1,-1, 0 } }, // k1_c
+  { { 0,-1, 1 },{ 0, 1, 1 },{ 0,-1, 1 } }, // k1_d
+  { {-1, 1,-1 },{ 1, 1, 0 },{-1, 0, 0 } }, // k2_a
+  { {-1, 1,-1 },{ 0, 1, 1 },{ 0, 0,-1 } }, // k2_b
+  { { 0, 0,-1 },{ 0, 1, 1 },{-1, 1,-1 } }, // k2_c
+  { {-1, 0, 0 },{ 1, 1, 0 },{-1, 1,-1 } }, // k2_d
+};
+
+void NAMESPACE::Morpho::thinning(BitMask& _mask)
+{
+  if (_mask.empty()) return;
+  const int nw = _mask.wordsPerRow();
+  BitMask next(_mask.xsize(), _mask.ysize());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    ForIndex(k, 8) {
+      std::atomic<bool> any(false);
+      LibSL::System::Parallel::forChunks(0, _mask.ysize(), [&](int j0, int j1) {
+        std::vector<t_Word> hit(nw);
+        bool local = false;
+        ForRange(j, j0, j1 - 1) {
+          hitRow(_mask, j, s_ThinningKernels[k], &hit[0]);
+          const t_Word *s = _mask.row(j);
+          t_Word       *d = next.row(j);
+          ForIndex(w, nw) {
+            d[w] = s[w] & ~hit[w];
+            local = local || (d[w] != s[w]);
+          }
+        }
+        if (local) any = true;
+      }, 16);
+      _mask.swap(next);
+      changed = changed || any;
+    }
+  }
+}
+
+// ---------------------------------------------------
+
+void NAMESPACE::Morpho::negate(BitMask& _mask)
+{
+  if (_mask.empty()) return;
+  const int nw = _mask.wordsPerRow();
+  const t_Word last = _mask.lastWordMask();
+  LibSL::System::Parallel::forIndex(0, _mask.ysize(), [&](int j) {
+    t_Word *r = _mask.row(j);
+    ForIndex(k, nw) { r[k] = ~r[k]; }
+    r[nw - 1] &= last;
+  }, 64);
+}
+
+// ---------------------------------------------------
+
+template <class T_Op>
+static void combineMasks(const NAMESPACE::BitMask& a, const NAMESPACE::BitMask& b, NAMESPACE::BitMask& _result, const T_Op& op)
+{
+  if (!a.sameSize(b)) {
+    throw LibSL::Errors::Fatal("Morpho - masks have different sizes (%d x %d) != (%d x %d)", a.xsize(), a.ysize(), b.xsize(), b.ysize());
+  }
+  if (!_result.sameSize(a)) {
+    _result.allocate(a.xsize(), a.ysize());
+  }
+  const int nw = a.wordsPerRow();
+  LibSL::System::Parallel::forIndex(0, a.ysize(), [&](int j) {
+    const t_Word *ra = a.row(j);
+    const t_Word *rb = b.row(j);
+    t_Word       *rr = _result.row(j);
+    ForIndex(k, nw) { rr[k] = op(ra[k], rb[k]); }
+  }, 64);
+}
+
+void NAMESPACE::Morpho::Union(const BitMask& a, const BitMask& b, BitMask& _result)
+{
+  combineMasks(a, b, _result, [](t_Word x, t_Word y) { return x | y; });
+}
+
+void NAMESPACE::Morpho::Difference(const BitMask& a, const BitMask& b, BitMask& _result)
+{
+  combineMasks(a, b, _result, [](t_Word x, t_Word y) { return x & ~y; });
+}
+
+void NAMESPACE::Morpho::Intersection(const BitMask& a, const BitMask& b, BitMask& _result)
+{
+  combineMasks(a, b, _result, [](t_Word x, t_Word y) { return x & y; });
+}
+
+// ---------------------------------------------------
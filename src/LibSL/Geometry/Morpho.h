@@ -52,6 +52,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include <LibSL/Geometry/AAB.h>
 #include <LibSL/Mesh/Mesh.h>
 #include <climits>
+#include <vector>
 
 // ------------------------------------------------------
 
@@ -63,6 +64,65 @@ namespace LibSL {
       using LibSL::Math::Tuple;
       using LibSL::Memory::Array::Array2D;
 
+      //! Bit-packed 2D binary mask
+      //! 64 pixels per word, pixel x of a row is bit (x & 63) of word (x >> 6)
+      //! rows are padded to a whole number of words, padding bits are always zero
+      class BitMask
+      {
+      public:
+        typedef unsigned long long t_Word;
+        enum { e_WordBits = 64 };
+      private:
+        int                 m_XSize;
+        int                 m_YSize;
+        int                 m_WordsPerRow;
+        std::vector<t_Word> m_Words;
+      public:
+        BitMask() : m_XSize(0), m_YSize(0), m_WordsPerRow(0) { }
+        BitMask(int xs, int ys) : m_XSize(0), m_YSize(0), m_WordsPerRow(0) { allocate(xs, ys); }
+        explicit BitMask(const Array2D<bool>& a) : m_XSize(0), m_YSize(0), m_WordsPerRow(0) { fromArray(a); }
+
+        //! allocates a cleared mask
+        void allocate(int xs, int ys);
+        void erase();
+        void fill(bool b);
+
+        int  xsize()       const { return m_XSize; }
+        int  ysize()       const { return m_YSize; }
+        bool empty()       const { return m_Words.empty(); }
+        int  wordsPerRow() const { return m_WordsPerRow; }
+        //! mask of the valid bits in the last word of a row
+        t_Word lastWordMask() const { return (m_XSize & 63) ? ((t_Word(1) << (m_XSize & 63)) - 1) : ~t_Word(0); }
+
+        bool get(int i, int j) const
+        {
+          sl_assert(i >= 0 && i < m_XSize && j >= 0 && j < m_YSize);
+          return ((m_Words[(size_t)j*m_WordsPerRow + (i >> 6)] >> (i & 63)) & 1) != 0;
+        }
+        void set(int i, int j, bool b)
+        {
+          sl_assert(i >= 0 && i < m_XSize && j >= 0 && j < m_YSize);
+          t_Word& w = m_Words[(size_t)j*m_WordsPerRow + (i >> 6)];
+          t_Word  m = t_Word(1) << (i & 63);
+          w = b ? (w | m) : (w & ~m);
+        }
+
+        t_Word       *row(int j)       { sl_assert(j >= 0 && j < m_YSize); return &m_Words[(size_t)j*m_WordsPerRow]; }
+        const t_Word *row(int j) const { sl_assert(j >= 0 && j < m_YSize); return &m_Words[(size_t)j*m_WordsPerRow]; }
+
+        //! number of set pixels
+        long long count() const;
+
+        void fromArray(const Array2D<bool>& a);
+        void toArray(Array2D<bool>& _a) const;
+
+        bool sameSize(const BitMask& m) const { return m_XSize == m.m_XSize && m_YSize == m.m_YSize; }
+        bool operator==(const BitMask& m) const { return sameSize(m) && m_Words == m.m_Words; }
+        bool operator!=(const BitMask& m) const { return !(*this == m); }
+
+        void swap(BitMask& m);
+      };
+
       class Morpho
       {
       private:
@@ -70,7 +130,7 @@ namespace LibSL {
         void prepare(const Array2D<bool>& _array);
       public:
 
-        void hit_and_miss(Array2D<bool>& _array, signed char kernel[3][3]);
+        void hit_and_miss(Array2D<bool>& _array, int8_t kernel[3][3]);
 
         void dilate(Array2D<bool>& _array, float radius);
         void erode(Array2D<bool>& _array, float radius);
@@ -83,6 +143,28 @@ namespace LibSL {
         void Union(const Array2D<bool>& a, const Array2D<bool>& b, Array2D<bool>& _result);
         void Difference(const Array2D<bool>& a, const Array2D<bool>& b, Array2D<bool>& _result);
         void Intersection(const Array2D<bool>& a, const Array2D<bool>& b, Array2D<bool>& _result);
+
+        // Bit-packed variants, word parallel and multithreaded over row bands.
+        // The disc of dilate/erode contains the offsets strictly closer than radius,
+        // pixels outside the mask are empty for dilate and full for erode.
+        // hit_and_miss and thinning wrap around borders like their Array2D<bool> versions.
+
+        void hit_and_miss(BitMask& _mask, int8_t kernel[3][3]);
+
+        void dilate(BitMask& _mask, float radius);
+        void erode(BitMask& _mask, float radius);
+        void close(BitMask& _mask, float radius);
+        void open(BitMask& _mask, float radius);
+        //! dilate by the (2*halfSize+1)^2 square
+        void dilateSquare(BitMask& _mask, int halfSize);
+        //! erode by the (2*halfSize+1)^2 square
+        void erodeSquare(BitMask& _mask, int halfSize);
+        void thinning(BitMask& _mask);
+        void negate(BitMask& _mask);
+
+        void Union(const BitMask& a, const BitMask& b, BitMask& _result);
+        void Difference(const BitMask& a, const BitMask& b, BitMask& _result);
+        void Intersection(const BitMask& a, const BitMask& b, BitMask& _result);
       };
 
     }
@@ -0,0 +1,802 @@
+// ------------------------------------------------------
+// The ear clipping below is a C++ port of earcut,
+// https://github.com/mapbox/earcut, distributed under
+// the following license:
+//
+// ISC License
+//
+// Copyright (c) 2016, Mapbox
+//
+// Permission to use, copy, modify, and/or distribute this software for any purpose
+// with or without fee is hereby granted, provided that the above copyright notice
+// and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND ISC DISCLAIMS ALL WARRANTIES WITH REGARD TO
+// THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+// IN NO EVENT SHALL ISC BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+// CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA
+// OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+//
+// LibSL changes (batch and path grouping entry points,
+// integration) are under the CeCILL-C license below.
+// ------------------------------------------------------
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Geometry::Triangulation
+// ------------------------------------------------------
+// Ear clipping ported from earcut (Mapbox, ISC license, see above)
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include "Triangulation.h"
+
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+using namespace std;
+using namespace LibSL::Math;
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Geometry::Triangulation
+
+// ------------------------------------------------------
+
+namespace {
+
+  // Vertex of a ring, doubly linked along the ring and along the z-order curve
+  struct Node
+  {
+    uint   i;
+    double x, y;
+    uint   z;
+    bool   steiner;
+    Node  *prev, *next;
+    Node  *prevZ, *nextZ;
+    Node(uint i_, double x_, double y_)
+      : i(i_), x(x_), y(y_), z(0), steiner(false), prev(NULL), next(NULL), prevZ(NULL), nextZ(NULL) { }
+  };
+
+  class EarClipper
+  {
+  protected:
+
+    std::deque<Node>  m_Nodes; // stable addresses
+    std::vector<v3u>& m_Tris;
+    double            m_MinX, m_MinY, m_InvSize;
+
+    Node *newNode(uint i, double x, double y)
+    {
+      m_Nodes.push_back(Node(i, x, y));
+      return &m_Nodes.back();
+    }
+
+    // twice the signed area of pqr, positive when clockwise (reflex for a ccw ring)
+    static double area(const Node *p, const Node *q, const Node *r)
+    {
+      return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+    }
+
+    static bool equals(const Node *a, const Node *b)
+    {
+      return a->x == b->x && a->y == b->y;
+    }
+
+    static int sign(double v)
+    {
+      return (v > 0.0) - (v < 0.0);
+    }
+
+    static bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+    {
+      return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+          && (ax - px) * (by - py) >= (bx - px) * (ay - py)
+          && (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    // q lies on segment pr, knowing that p, q, r are collinear
+    static bool onSegment(const Node *p, const Node *q, const Node *r)
+    {
+      return q->x <= max(p->x, r->x) && q->x >= min(p->x, r->x)
+          && q->y <= max(p->y, r->y) && q->y >= min(p->y, r->y);
+    }
+
+    static bool intersects(const Node *p1, const Node *q1, const Node *p2, const Node *q2)
+    {
+      int o1 = sign(area(p1, q1, p2));
+      int o2 = sign(area(p1, q1, q2));
+      int o3 = sign(area(p2, q2, p1));
+      int o4 = sign(area(p2, q2, q1));
+      if (o1 != o2 && o3 != o4)                 return true;
+      if (o1 == 0 && onSegment(p1, p2, q1))     return true;
+      if (o2 == 0 && onSegment(p1, q2, q1))     return true;
+      if (o3 == 0 && onSegment(p2, p1, q2))     return true;
+      if (o4 == 0 && onSegment(p2, q1, q2))     return true;
+      return false;
+    }
+
+    // does diagonal ab intersect any edge of the ring?
+    static bool intersectsPolygon(const Node *a, const Node *b)
+    {
+      const Node *p = a;
+      do {
+        if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i
+          && intersects(p, p->next, a, b)) {
+          return true;
+        }
+        p = p->next;
+      } while (p != a);
+      return false;
+    }
+
+    // is diagonal ab locally inside the polygon around a?
+    static bool locallyInside(const Node *a, const Node *b)
+    {
+      return area(a->prev, a, a->next) < 0
+        ? area(a, b, a->next) >= 0 && area(a, a->prev, b) >= 0
+        : area(a, b, a->prev) <  0 || area(a, a->next, b) <  0;
+    }
+
+    // is the middle of diagonal ab inside the polygon?
+    static bool middleInside(const Node *a, const Node *b)
+    {
+      const Node *p = a;
+      bool inside = false;
+      double px = (a->x + b->x) * 0.5, py = (a->y + b->y) * 0.5;
+      do {
+        if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y
+          && (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+          inside = !inside;
+        }
+        p = p->next;
+      } while (p != a);
+      return inside;
+    }
+
+    static bool isValidDiagonal(const Node *a, const Node *b)
+    {
+      return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b)
+        && ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+             && (area(a->prev, a, b->prev) != 0 || area(a, b->prev, b) != 0))
+          || (equals(a, b) && area(a->prev, a, a->next) > 0 && area(b->prev, b, b->next) > 0));
+    }
+
+    static void removeNode(Node *p)
+    {
+      p->next->prev = p->prev;
+      p->prev->next = p->next;
+      if (p->prevZ) p->prevZ->nextZ = p->nextZ;
+      if (p->nextZ) p->nextZ->prevZ = p->prevZ;
+    }
+
+    Node *insertNode(uint i, double x, double y, Node *last)
+    {
+      Node *p = newNode(i, x, y);
+      if (last == NULL) {
+        p->prev = p;
+        p->next = p;
+      } else {
+        p->next = last->next;
+        p->prev = last;
+        last->next->prev = p;
+        last->next = p;
+      }
+      return p;
+    }
+
+    // links a to b with a bridge; if a and b are in the same ring this splits it in
+    // two, otherwise it merges the two rings; returns the copy of b
+    Node *splitPolygon(Node *a, Node *b)
+    {
+      Node *a2 = newNode(a->i, a->x, a->y);
+      Node *b2 = newNode(b->i, b->x, b->y);
+      Node *an = a->next;
+      Node *bp = b->prev;
+      a->next  = b;  b->prev  = a;
+      a2->next = an; an->prev = a2;
+      b2->next = a2; a2->prev = b2;
+      bp->next = b2; b2->prev = bp;
+      return b2;
+    }
+
+    // removes duplicate and collinear points
+    Node *filterPoints(Node *start, Node *end = NULL)
+    {
+      if (start == NULL) return start;
+      if (end == NULL) end = start;
+      Node *p = start;
+      bool again;
+      do {
+        again = false;
+        if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0)) {
+          removeNode(p);
+          p = end = p->prev;
+          if (p == p->next) break;
+          again = true;
+        } else {
+          p = p->next;
+        }
+      } while (again || p != end);
+      return end;
+    }
+
+    uint zOrder(double px, double py) const
+    {
+      uint x = uint((px - m_MinX) * m_InvSize);
+      uint y = uint((py - m_MinY) * m_InvSize);
+      x = (x | (x << 8)) & 0x00FF00FF;
+      x = (x | (x << 4)) & 0x0F0F0F0F;
+      x = (x | (x << 2)) & 0x33333333;
+      x = (x | (x << 1)) & 0x55555555;
+      y = (y | (y << 8)) & 0x00FF00FF;
+      y = (y | (y << 4)) & 0x0F0F0F0F;
+      y = (y | (y << 2)) & 0x33333333;
+      y = (y | (y << 1)) & 0x55555555;
+      return x | (y << 1);
+    }
+
+    // bottom-up merge sort of the z-order list
+    static Node *sortLinked(Node *list)
+    {
+      int inSize = 1, numMerges;
+      do {
+        Node *p = list, *tail = NULL;
+        list = NULL;
+        numMerges = 0;
+        while (p) {
+          numMerges++;
+          Node *q = p;
+          int pSize = 0;
+          for (int i = 0; i < inSize; i++) {
+            pSize++;
+            q = q->nextZ;
+            if (!q) break;
+          }
+          int qSize = inSize;
+          while (pSize > 0 || (qSize > 0 && q)) {
+            Node *e;
+            if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z)) {
+              e = p; p = p->nextZ; pSize--;
+            } else {
+              e = q; q = q->nextZ; qSize--;
+            }
+            if (tail) tail->nextZ = e;
+            else      list = e;
+            e->prevZ = tail;
+            tail = e;
+          }
+          p = q;
+        }
+        tail->nextZ = NULL;
+        inSize *= 2;
+      } while (numMerges > 1);
+      return list;
+    }
+
+    void indexCurve(Node *start)
+    {
+      Node *p = start;
+      do {
+        if (p->z == 0) p->z = zOrder(p->x, p->y);
+        p->prevZ = p->prev;
+        p->nextZ = p->next;
+        p = p->next;
+      } while (p != start);
+      p->prevZ->nextZ = NULL;
+      p->prevZ = NULL;
+      sortLinked(p);
+    }
+
+    static bool isEar(const Node *ear)
+    {
+      const Node *a = ear->prev, *b = ear, *c = ear->next;
+      if (area(a, b, c) >= 0) return false; // reflex
+      const Node *p = ear->next->next;
+      while (p != ear->prev) {
+        if (pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+          && area(p->prev, p, p->next) >= 0) {
+          return false;
+        }
+        p = p->next;
+      }
+      return true;
+    }
+
+    // same as isEar, only visiting the points with z-order codes in the ear bounding box
+    bool isEarHashed(const Node *ear) const
+    {
+      const Node *a = ear->prev, *b = ear, *c = ear->next;
+      if (area(a, b, c) >= 0) return false; // reflex
+      double x0 = min(a->x, min(b->x, c->x)), y0 = min(a->y, min(b->y, c->y));
+      double x1 = max(a->x, max(b->x, c->x)), y1 = max(a->y, max(b->y, c->y));
+      uint minZ = zOrder(x0, y0);
+      uint maxZ = zOrder(x1, y1);
+      const Node *p = ear->prevZ, *n = ear->nextZ;
+#define LIBSL_EAR_BLOCKS(q) \
+      ((q)->x >= x0 && (q)->x <= x1 && (q)->y >= y0 && (q)->y <= y1 && (q) != a && (q) != c \
+        && pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, (q)->x, (q)->y) \
+        && area((q)->prev, (q), (q)->next) >= 0)
+      // look both ways along the z-order curve
+      while (p && p->z >= minZ && n && n->z <= maxZ) {
+        if (LIBSL_EAR_BLOCKS(p)) return false;
+        p = p->prevZ;
+        if (LIBSL_EAR_BLOCKS(n)) return false;
+        n = n->nextZ;
+      }
+      while (p && p->z >= minZ) {
+        if (LIBSL_EAR_BLOCKS(p)) return false;
+        p = p->prevZ;
+      }
+      while (n && n->z <= maxZ) {
+        if (LIBSL_EAR_BLOCKS(n)) return false;
+        n = n->nextZ;
+      }
+#undef LIBSL_EAR_BLOCKS
+      return true;
+    }
+
+    // clips small self-intersections, a-p-p.next-b becomes a-b
+    Node *cureLocalIntersections(Node *start)
+    {
+      Node *p = start;
+      do {
+        Node *a = p->prev, *b = p->next->next;
+        if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+          m_Tris.push_back(V3U(a->i, p->i, b->i));
+          removeNode(p);
+          removeNode(p->next);
+          p = start = b;
+        }
+        p = p->next;
+      } while (p != start);
+      return filterPoints(p);
+    }
+
+    // last resort: split the polygon along a valid diagonal and clip both halves
+    void splitEarcut(Node *start)
+    {
+      Node *a = start;
+      do {
+        Node *b = a->next->next;
+        while (b != a->prev) {
+          if (a->i != b->i && isValidDiagonal(a, b)) {
+            Node *c = splitPolygon(a, b);
+            a = filterPoints(a, a->next);
+            c = filterPoints(c, c->next);
+            earcutLinked(a, 0);
+            earcutLinked(c, 0);
+            return;
+          }
+          b = b->next;
+        }
+        a = a->next;
+      } while (a != start);
+    }
+
+    void earcutLinked(Node *ear, int pass)
+    {
+      if (ear == NULL) return;
+      if (pass == 0 && m_InvSize != 0) {
+        indexCurve(ear);
+      }
+      Node *stop = ear;
+      while (ear->prev != ear->next) {
+        Node *prev = ear->prev;
+        Node *next = ear->next;
+        if (m_InvSize != 0 ? isEarHashed(ear) : isEar(ear)) {
+          m_Tris.push_back(V3U(prev->i, ear->i, next->i));
+          removeNode(ear);
+          // skipping the next vertex leads to less sliver triangles
+          ear  = next->next;
+          stop = next->next;
+          continue;
+        }
+        ear = next;
+        if (ear == stop) {
+          // went around without finding an ear
+          if (pass == 0) {
+            earcutLinked(filterPoints(ear), 1);
+          } else if (pass == 1) {
+            earcutLinked(cureLocalIntersections(filterPoints(ear)), 2);
+          } else {
+            splitEarcut(ear);
+          }
+          break;
+        }
+      }
+    }
+
+    static double signedArea(const double *xy, uint n)
+    {
+      double sum = 0;
+      for (uint i = 0, j = n - 1; i < n; j = i++) {
+        sum += (xy[j * 2] - xy[i * 2]) * (xy[i * 2 + 1] + xy[j * 2 + 1]);
+      }
+      return sum;
+    }
+
+    // builds a ring with the requested orientation
+    Node *linkedList(const double *xy, uint first, uint n, bool clockwise)
+    {
+      Node *last = NULL;
+      if (n == 0) return NULL;
+      if (clockwise == (signedArea(xy + first * 2, n) > 0)) {
+        for (uint k = 0; k < n; k++) {
+          last = insertNode(first + k, xy[(first + k) * 2], xy[(first + k) * 2 + 1], last);
+        }
+      } else {
+        for (int k = int(n) - 1; k >= 0; k--) {
+          last = insertNode(first + k, xy[(first + k) * 2], xy[(first + k) * 2 + 1], last);
+        }
+      }
+      if (last && equals(last, last->next)) {
+        Node *nx = last->next;
+        removeNode(last);
+        last = nx;
+      }
+      return last;
+    }
+
+    static Node *getLeftmost(Node *start)
+    {
+      Node *p = start, *leftmost = start;
+      do {
+        if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) {
+          leftmost = p;
+        }
+        p = p->next;
+      } while (p != start);
+      return leftmost;
+    }
+
+    static bool sectorContainsSector(const Node *m, const Node *p)
+    {
+      return area(m->prev, m, p->prev) < 0 && area(p->next, m, m->next) < 0;
+    }
+
+    // David Eberly's algorithm to find an outer vertex visible from the hole's leftmost vertex
+    static Node *findHoleBridge(Node *hole, Node *outerNode)
+    {
+      Node *p = outerNode, *m = NULL;
+      double hx = hole->x, hy = hole->y;
+      double qx = -numeric_limits<double>::infinity();
+      // the segment from the hole towards -x hits the outer ring at (qx,hy)
+      do {
+        if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+          double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+          if (x <= hx && x > qx) {
+            qx = x;
+            m  = p->x < p->next->x ? p : p->next;
+            if (x == hx) return m; // the hole touches the outer ring
+          }
+        }
+        p = p->next;
+      } while (p != outerNode);
+      if (m == NULL) return NULL;
+      // look for points inside the triangle (hole point, hit point, m),
+      // the one with the smallest angle to the ray is the bridge
+      Node *stop = m;
+      double mx = m->x, my = m->y;
+      double tanMin = numeric_limits<double>::infinity();
+      p = m;
+      do {
+        if (hx >= p->x && p->x >= mx && hx != p->x
+          && pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+          double tan = fabs(hy - p->y) / (hx - p->x);
+          if (locallyInside(p, hole)
+            && (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p)))))) {
+            m = p;
+            tanMin = tan;
+          }
+        }
+        p = p->next;
+      } while (p != stop);
+      return m;
+    }
+
+    static bool compareX(const Node *a, const Node *b)
+    {
+      return a->x < b->x;
+    }
+
+    Node *eliminateHoles(const double *xy, const std::vector<uint>& starts, uint total, Node *outerNode)
+    {
+      std::vector<Node*> queue;
+      for (size_t h = 1; h < starts.size(); h++) {
+        uint first = starts[h];
+        uint last  = (h + 1 < starts.size()) ? starts[h + 1] : total;
+        Node *list = linkedList(xy, first, last - first, false);
+        if (list == NULL) continue;
+        if (list == list->next) list->steiner = true;
+        queue.push_back(getLeftmost(list));
+      }
+      std::sort(queue.begin(), queue.end(), compareX);
+      // bridge holes from left to right
+      for (size_t h = 0; h < queue.size(); h++) {
+        Node *bridge = findHoleBridge(queue[h], outerNode);
+        if (bridge == NULL) continue;
+        Node *bridgeReverse = splitPolygon(bridge, queue[h]);
+        filterPoints(bridgeReverse, bridgeReverse->next);
+        outerNode = filterPoints(bridge, bridge->next);
+      }
+      return outerNode;
+    }
+
+  public:
+
+    EarClipper(std::vector<v3u>& tris) : m_Tris(tris), m_MinX(0), m_MinY(0), m_InvSize(0) { }
+
+    // xy holds interleaved coordinates, starts the first vertex of each ring
+    void run(const double *xy, const std::vector<uint>& starts, uint total)
+    {
+      if (starts.empty() || total < 3) return;
+      uint outerLen = starts.size() > 1 ? starts[1] : total;
+      Node *outerNode = linkedList(xy, 0, outerLen, true);
+      if (outerNode == NULL || outerNode->next == outerNode->prev) return;
+      if (starts.size() > 1) {
+        outerNode = eliminateHoles(xy, starts, total, outerNode);
+      }
+      // z-order hashing only pays off on larger polygons
+      if (total > 80) {
+        double minX = xy[0], minY = xy[1], maxX = xy[0], maxY = xy[1];
+        for (uint k = 1; k < outerLen; k++) {
+          minX = min(minX, xy[k * 2]); maxX = max(maxX, xy[k * 2]);
+          minY = min(minY, xy[k * 2 + 1]); maxY = max(maxY, xy[k * 2 + 1]);
+        }
+        double size = max(maxX - minX, maxY - minY);
+        m_MinX    = minX;
+        m_MinY    = minY;
+        m_InvSize = size != 0 ? 32767.0 / size : 0;
+      }
+      earcutLinked(outerNode, 0);
+    }
+  };
+
+  template <typename T_Point>
+  double pathArea(const std::vector<T_Point>& path)
+  {
+    double a = 0;
+    size_t n = path.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+      a += (double(path[j][0]) * double(path[i][1]) - double(path[i][0]) * double(path[j][1]));
+    }
+    return a * 0.5;
+  }
+
+  template <typename T_Point>
+  bool insidePath(const std::vector<T_Point>& path, double px, double py)
+  {
+    bool inside = false;
+    size_t n = path.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+      double xi = double(path[i][0]), yi = double(path[i][1]);
+      double xj = double(path[j][0]), yj = double(path[j][1]);
+      if (((yi > py) != (yj > py)) && (px < (xj - xi) * (py - yi) / (yj - yi) + xi)) {
+        inside = !inside;
+      }
+    }
+    return inside;
+  }
+
+  template <typename T_Point>
+  void triangulateRings(const std::vector<const std::vector<T_Point>*>& rings, std::vector<v3u>& _tris)
+  {
+    std::vector<double> xy;
+    std::vector<uint>   starts;
+    uint total   = 0;
+    bool dropped = false;
+    for (size_t r = 0; r < rings.size(); r++) {
+      const std::vector<T_Point>& ring = *rings[r];
+      size_t n = ring.size();
+      // drop an explicit closing vertex
+      if (n > 1 && ring[0] == ring[n - 1]) {
+        n--;
+        dropped = true;
+      }
+      starts.push_back(total);
+      for (size_t k = 0; k < n; k++) {
+        xy.push_back(double(ring[k][0]));
+        xy.push_back(double(ring[k][1]));
+      }
+      total += uint(n);
+    }
+    _tris.clear();
+    if (total < 3) return;
+    EarClipper clipper(_tris);
+    clipper.run(&xy[0], starts, total);
+    // indices skip the dropped closing vertices, map them back
+    if (dropped) {
+      std::vector<uint> remap(total);
+      uint k = 0, first = 0;
+      for (size_t r = 0; r < rings.size(); r++) {
+        uint n = (r + 1 < starts.size() ? starts[r + 1] : total) - starts[r];
+        for (uint v = 0; v < n; v++) remap[k++] = first + v;
+        first += uint(rings[r]->size());
+      }
+      for (size_t t = 0; t < _tris.size(); t++) {
+        ForIndex(c, 3) { _tris[t][c] = remap[_tris[t][c]]; }
+      }
+    }
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+template <typename T_Point>
+void NAMESPACE::triangulate(
+  const std::vector<std::vector<T_Point> >& rings,
+  std::vector<v3u>&                        _tris)
+{
+  std::vector<const std::vector<T_Point>*> ptrs(rings.size());
+  ForIndex(r, rings.size()) {
+    ptrs[r] = &rings[r];
+  }
+  triangulateRings(ptrs, _tris);
+}
+
+// ------------------------------------------------------
+
+template <typename T_Point>
+void NAMESPACE::triangulate(
+  const std::vector<std::vector<std::vector<T_Point> > >& polygons,
+  std::vector<std::vector<v3u> >&                        _tris)
+{
+  _tris.resize(polygons.size());
+  LibSL::System::Parallel::forIndex(0, int(polygons.size()), [&](int p) {
+    triangulate(polygons[p], _tris[p]);
+  });
+}
+
+// ------------------------------------------------------
+
+template <typename T_Point>
+void NAMESPACE::groupPaths(
+  const std::vector<std::vector<T_Point> >& paths,
+  std::vector<std::vector<int> >&          _polygons,
+  int                                       winding)
+{
+  _polygons.clear();
+  std::vector<double> areas(paths.size());
+  std::vector<v4d>    boxes(paths.size()); // xmin,ymin,xmax,ymax
+  std::vector<int>    outers, holes;
+  ForIndex(p, paths.size()) {
+    areas[p] = pathArea(paths[p]) * (winding > 0 ? 1.0 : -1.0);
+    if (areas[p] == 0) continue;
+    v4d bx(numeric_limits<double>::max(), numeric_limits<double>::max(), -numeric_limits<double>::max(), -numeric_limits<double>::max());
+    ForIndex(k, paths[p].size()) {
+      bx[0] = min(bx[0], double(paths[p][k][0])); bx[2] = max(bx[2], double(paths[p][k][0]));
+      bx[1] = min(bx[1], double(paths[p][k][1])); bx[3] = max(bx[3], double(paths[p][k][1]));
+    }
+    boxes[p] = bx;
+    if (areas[p] > 0) outers.push_back(p);
+    else              holes .push_back(p);
+  }
+  std::vector<int> polyOf(paths.size(), -1);
+  ForIndex(o, outers.size()) {
+    polyOf[outers[o]] = int(_polygons.size());
+    _polygons.push_back(std::vector<int>(1, outers[o]));
+  }
+  // the owner of a hole is the smallest outer boundary containing it
+  std::vector<int> owner(holes.size(), -1);
+  LibSL::System::Parallel::forIndex(0, int(holes.size()), [&](int h) {
+    int    hp   = holes[h];
+    double best = numeric_limits<double>::max();
+    ForIndex(o, outers.size()) {
+      int op = outers[o];
+      if (areas[op] >= best)                                           continue;
+      if (boxes[hp][0] < boxes[op][0] || boxes[hp][2] > boxes[op][2]) continue;
+      if (boxes[hp][1] < boxes[op][1] || boxes[hp][3] > boxes[op][3]) continue;
+      // test an edge midpoint: pixel corner paths share vertices with their outer boundary
+      double px = 0.5 * (double(paths[hp][0][0]) + double(paths[hp][1 % paths[hp].size()][0]));
+      double py = 0.5 * (double(paths[hp][0][1]) + double(paths[hp][1 % paths[hp].size()][1]));
+      if (insidePath(paths[op], px, py)) {
+        best     = areas[op];
+        owner[h] = op;
+      }
+    }
+  });
+  ForIndex(h, holes.size()) {
+    if (owner[h] >= 0) {
+      _polygons[polyOf[owner[h]]].push_back(holes[h]);
+    }
+  }
+}
+
+// ------------------------------------------------------
+
+template <typename T_Point>
+void NAMESPACE::triangulatePaths(
+  const std::vector<std::vector<T_Point> >& paths,
+  std::vector<v3u>&                        _tris,
+  int                                       winding)
+{
+  std::vector<std::vector<int> > polygons;
+  groupPaths(paths, polygons, winding);
+  // index of the first vertex of each path in the concatenation
+  std::vector<uint> first(paths.size() + 1, 0);
+  ForIndex(p, paths.size()) {
+    first[p + 1] = first[p] + uint(paths[p].size());
+  }
+  std::vector<std::vector<v3u> > tris(polygons.size());
+  LibSL::System::Parallel::forIndex(0, int(polygons.size()), [&](int g) {
+    const std::vector<int>& poly = polygons[g];
+    std::vector<const std::vector<T_Point>*> rings(poly.size());
+    ForIndex(r, poly.size()) {
+      rings[r] = &paths[poly[r]];
+    }
+    triangulateRings(rings, tris[g]);
+    // local ring indices to global path indices
+    std::vector<uint> local(poly.size() + 1, 0);
+    ForIndex(r, poly.size()) {
+      local[r + 1] = local[r] + uint(paths[poly[r]].size());
+    }
+    ForIndex(t, tris[g].size()) {
+      ForIndex(c, 3) {
+        uint v = tris[g][t][c];
+        uint r = uint(std::upper_bound(local.begin(), local.end(), v) - local.begin()) - 1;
+        tris[g][t][c] = first[poly[r]] + (v - local[r]);
+      }
+    }
+  });
+  _tris.clear();
+  ForIndex(g, tris.size()) {
+    _tris.insert(_tris.end(), tris[g].begin(), tris[g].end());
+  }
+}
+
+// ------------------------------------------------------
+
+#define LIBSL_TRIANGULATION_INSTANTIATE(T) \
+  template void NAMESPACE::triangulate<T>(const std::vector<std::vector<T> >&, std::vector<v3u>&); \
+  template void NAMESPACE::triangulate<T>(const std::vector<std::vector<std::vector<T> > >&, std::vector<std::vector<v3u> >&); \
+  template void NAMESPACE::groupPaths<T>(const std::vector<std::vector<T> >&, std::vector<std::vector<int> >&, int); \
+  template void NAMESPACE::triangulatePaths<T>(const std::vector<std::vector<T> >&, std::vector<v3u>&, int);
+
+LIBSL_TRIANGULATION_INSTANTIATE(v2i)
+LIBSL_TRIANGULATION_INSTANTIATE(v2f)
+LIBSL_TRIANGULATION_INSTANTIATE(v2d)
+
+// ------------------------------------------------------
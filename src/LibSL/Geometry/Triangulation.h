@@ -0,0 +1,112 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Geometry::Triangulation
+// ------------------------------------------------------
+//
+// Triangulation of simple polygons with holes, without GL
+//
+// Holes are bridged to the outer boundary, then ears are
+// clipped; ear tests only visit the vertices whose z-order
+// code falls in the ear bounding box. A polygon that cannot
+// be clipped as is (self-touching) is cured locally or split
+// along a valid diagonal.
+//
+// The algorithm is a port of earcut by Mapbox (ISC license,
+// see Triangulation.cpp).
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include <LibSL/LibSL.common.h>
+#include <LibSL/Math/Tuple.h>
+#include <LibSL/Math/Vertex.h>
+
+// ------------------------------------------------------
+
+namespace LibSL {
+  namespace Geometry {
+
+    namespace Triangulation
+    {
+
+      //! Triangulates a polygon with holes: rings[0] is the outer boundary, the
+      //! other rings are holes. Rings need not be explicitly closed and may have
+      //! any orientation. Triangle indices refer to the concatenation of all rings,
+      //! in order, and triangles are counter-clockwise (x right, y up).
+      //! T_Point is v2i, v2f or v2d.
+      template <typename T_Point>
+      LIBSL_DLL void triangulate(
+        const std::vector<std::vector<T_Point> >& rings,
+        std::vector<LibSL::Math::v3u>&           _tris);
+
+      //! Triangulates many polygons in parallel, _tris[p] receives the triangles of polygons[p]
+      template <typename T_Point>
+      LIBSL_DLL void triangulate(
+        const std::vector<std::vector<std::vector<T_Point> > >& polygons,
+        std::vector<std::vector<LibSL::Math::v3u> >&           _tris);
+
+      //! Groups closed paths into polygons with holes. With winding > 0, counter-clockwise
+      //! paths are outer boundaries and clockwise paths are holes (the opposite for winding < 0).
+      //! Each hole goes to the smallest outer boundary containing it. _polygons[p] lists path
+      //! indices, outer boundary first. Paths with a null area are ignored.
+      template <typename T_Point>
+      LIBSL_DLL void groupPaths(
+        const std::vector<std::vector<T_Point> >& paths,
+        std::vector<std::vector<int> >&          _polygons,
+        int                                       winding = 1);
+
+      //! Triangulates all paths extracted from an image (see Contour::extract and
+      //! Contour::convertContourIntoPixelCornerPath), in parallel. Holes are grouped
+      //! as in groupPaths. Indices refer to the concatenation of all paths, in order.
+      //! Takes the same paths and winding as GLHelpers::triangulate, without a GL
+      //! context, but returns indices rather than a t_triangulate_nfo.
+      template <typename T_Point>
+      LIBSL_DLL void triangulatePaths(
+        const std::vector<std::vector<T_Point> >& paths,
+        std::vector<LibSL::Math::v3u>&           _tris,
+        int                                       winding = 1);
+
+    }
+
+  }
+}
+
+// ------------------------------------------------------
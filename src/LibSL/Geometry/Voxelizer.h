@@ -51,6 +51,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include <LibSL/Math/Math.h>
 #include <LibSL/Geometry/AAB.h>
 #include <LibSL/Mesh/Mesh.h>
+#include <LibSL/Geometry/Intersections/Intersection_Polygon_AABox.h>
 
 #include <map>
 #include <vector>
@@ -63,6 +64,7 @@ namespace LibSL {
     using namespace Math;
     using namespace CppHelpers;
     using namespace Memory::Array;
+    using namespace Intersections;
 
     /// A single voxel
     //  This is an interface from which to derive to specify your own voxel class
@@ -0,0 +1,566 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include <LibSL/Image/BCn.h>
+#include <LibSL/System/Parallel.h>
+#include <LibSL/CppHelpers/CppHelpers.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BCN_SSE2
+#include <emmintrin.h>
+#endif
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Image
+
+using namespace LibSL::Errors;
+
+// ------------------------------------------------------
+
+namespace {
+
+  // ----------------- palettes
+
+  inline void unpack565(uint c,int _rgb[3])
+  {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    _rgb[0] = (r << 3) | (r >> 2);
+    _rgb[1] = (g << 2) | (g >> 4);
+    _rgb[2] = (b << 3) | (b >> 2);
+  }
+
+  inline uint pack565(const float rgb[3])
+  {
+    int r = std::min(31,std::max(0,int(rgb[0] * 31.0f / 255.0f + 0.5f)));
+    int g = std::min(63,std::max(0,int(rgb[1] * 63.0f / 255.0f + 0.5f)));
+    int b = std::min(31,std::max(0,int(rgb[2] * 31.0f / 255.0f + 0.5f)));
+    return uint((r << 11) | (g << 5) | b);
+  }
+
+  void colorPalette(uint c0,uint c1,bool fourColors,int _pal[4][3])
+  {
+    unpack565(c0,_pal[0]);
+    unpack565(c1,_pal[1]);
+    ForIndex(k,3) {
+      if (fourColors) {
+        _pal[2][k] = (2 * _pal[0][k] + _pal[1][k]) / 3;
+        _pal[3][k] = (_pal[0][k] + 2 * _pal[1][k]) / 3;
+      } else {
+        _pal[2][k] = (_pal[0][k] + _pal[1][k]) / 2;
+        _pal[3][k] = 0;
+      }
+    }
+  }
+
+  void singlePalette(int a0,int a1,int _pal[8])
+  {
+    _pal[0] = a0;
+    _pal[1] = a1;
+    if (a0 > a1) {
+      for (int i = 2 ; i < 8 ; i++) {
+        _pal[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+      }
+    } else {
+      for (int i = 2 ; i < 6 ; i++) {
+        _pal[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+      }
+      _pal[6] = 0;
+      _pal[7] = 255;
+    }
+  }
+
+  // ----------------- decoding
+
+  // _rgba is 16 pixels, 4 bytes each
+  void decodeColorBlock(const uchar *b,bool alwaysFour,uchar _rgba[16][4])
+  {
+    uint c0   = uint(b[0]) | (uint(b[1]) << 8);
+    uint c1   = uint(b[2]) | (uint(b[3]) << 8);
+    bool four = alwaysFour || c0 > c1;
+    int  pal[4][3];
+    colorPalette(c0,c1,four,pal);
+    uint bits = uint(b[4]) | (uint(b[5]) << 8) | (uint(b[6]) << 16) | (uint(b[7]) << 24);
+    ForIndex(p,16) {
+      uint i = (bits >> (2 * p)) & 3;
+      ForIndex(k,3) {
+        _rgba[p][k] = uchar(pal[i][k]);
+      }
+      _rgba[p][3] = (!four && i == 3) ? 0 : 255;
+    }
+  }
+
+  void decodeSingleBlock(const uchar *b,uchar _v[16])
+  {
+    int pal[8];
+    singlePalette(b[0],b[1],pal);
+    unsigned long long bits = 0;
+    ForIndex(k,6) {
+      bits |= (unsigned long long)(b[2 + k]) << (8 * k);
+    }
+    ForIndex(p,16) {
+      _v[p] = uchar(pal[(bits >> (3 * p)) & 7]);
+    }
+  }
+
+  // ----------------- single channel encoding
+
+  uint singleIndices(const int pal[8],const uchar v[16],uchar _idx[16])
+  {
+    uint err = 0;
+    ForIndex(p,16) {
+      int best = 1 << 30, bestI = 0;
+      ForIndex(i,8) {
+        int d = (int(v[p]) - pal[i]) * (int(v[p]) - pal[i]);
+        if (d < best) {
+          best  = d;
+          bestI = i;
+        }
+      }
+      _idx[p] = uchar(bestI);
+      err    += uint(best);
+    }
+    return err;
+  }
+
+  uint trySingle(int a0,int a1,const uchar v[16],int& _a0,int& _a1,uchar _idx[16],uint bestErr)
+  {
+    int   pal[8];
+    uchar idx[16];
+    singlePalette(a0,a1,pal);
+    uint  err = singleIndices(pal,v,idx);
+    if (err < bestErr) {
+      _a0 = a0;
+      _a1 = a1;
+      memcpy(_idx,idx,16);
+      return err;
+    }
+    return bestErr;
+  }
+
+  void encodeSingleBlock(const uchar v[16],e_BCnQuality quality,uchar *_out)
+  {
+    int mn = 255, mx = 0;
+    int mn6 = 255, mx6 = 0;
+    ForIndex(p,16) {
+      mn = std::min(mn,int(v[p]));
+      mx = std::max(mx,int(v[p]));
+      if (v[p] != 0 && v[p] != 255) {
+        mn6 = std::min(mn6,int(v[p]));
+        mx6 = std::max(mx6,int(v[p]));
+      }
+    }
+    int   a0 = mx, a1 = mn;
+    uchar idx[16];
+    uint  err = trySingle(mx,mn,v,a0,a1,idx,~0u);
+    if (quality != BCnFast && err > 0) {
+      // six values mode, 0 and 255 are exact
+      if (mn6 <= mx6) {
+        err = trySingle(mn6,mx6,v,a0,a1,idx,err);
+      }
+    }
+    if (quality == BCnHigh && err > 0 && mx > mn) {
+      // search around the extremes
+      for (int d0 = -2 ; d0 <= 2 ; d0++) {
+        for (int d1 = -2 ; d1 <= 2 ; d1++) {
+          int e0 = std::min(255,std::max(0,mx + d0));
+          int e1 = std::min(255,std::max(0,mn + d1));
+          if (e0 > e1) {
+            err = trySingle(e0,e1,v,a0,a1,idx,err);
+          }
+        }
+      }
+    }
+    _out[0] = uchar(a0);
+    _out[1] = uchar(a1);
+    unsigned long long bits = 0;
+    ForIndex(p,16) {
+      bits |= (unsigned long long)(idx[p]) << (3 * p);
+    }
+    ForIndex(k,6) {
+      _out[2 + k] = uchar(bits >> (8 * k));
+    }
+  }
+
+  // ----------------- color encoding
+
+#ifdef BCN_SSE2
+
+  // nearest palette entry of 16 RGBx pixels, returns the squared error
+  uint colorIndices(const uchar px[16][4],const int pal[4][3],uchar _idx[16])
+  {
+    const __m128i zero    = _mm_setzero_si128();
+    const __m128i rgbMask = _mm_set_epi16(0,-1,-1,-1,0,-1,-1,-1);
+    __m128i palv[4];
+    ForIndex(k,4) {
+      palv[k] = _mm_set_epi16(0,short(pal[k][2]),short(pal[k][1]),short(pal[k][0]),
+                              0,short(pal[k][2]),short(pal[k][1]),short(pal[k][0]));
+    }
+    uint err = 0;
+    ForIndex(g,4) {
+      __m128i p       = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px[4 * g]));
+      __m128i lo      = _mm_and_si128(_mm_unpacklo_epi8(p,zero),rgbMask);
+      __m128i hi      = _mm_and_si128(_mm_unpackhi_epi8(p,zero),rgbMask);
+      __m128i best    = _mm_set1_epi32(0x7fffffff);
+      __m128i bestIdx = zero;
+      ForIndex(k,4) {
+        __m128i dl = _mm_sub_epi16(lo,palv[k]);
+        __m128i dh = _mm_sub_epi16(hi,palv[k]);
+        dl         = _mm_madd_epi16(dl,dl);  // r2+g2 , b2 , r2+g2 , b2
+        dh         = _mm_madd_epi16(dh,dh);
+        dl         = _mm_add_epi32(dl,_mm_shuffle_epi32(dl,_MM_SHUFFLE(2,3,0,1)));
+        dh         = _mm_add_epi32(dh,_mm_shuffle_epi32(dh,_MM_SHUFFLE(2,3,0,1)));
+        __m128i d  = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(dl),_mm_castsi128_ps(dh),_MM_SHUFFLE(2,0,2,0)));
+        __m128i lt = _mm_cmplt_epi32(d,best);
+        best       = _mm_or_si128(_mm_and_si128(lt,d),_mm_andnot_si128(lt,best));
+        bestIdx    = _mm_or_si128(_mm_and_si128(lt,_mm_set1_epi32(k)),_mm_andnot_si128(lt,bestIdx));
+      }
+      int b[4], i[4];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(b),best);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(i),bestIdx);
+      ForIndex(n,4) {
+        _idx[4 * g + n] = uchar(i[n]);
+        err            += uint(b[n]);
+      }
+    }
+    return err;
+  }
+
+#else
+
+  uint colorIndices(const uchar px[16][4],const int pal[4][3],uchar _idx[16])
+  {
+    uint err = 0;
+    ForIndex(p,16) {
+      int best = 1 << 30, bestI = 0;
+      ForIndex(k,4) {
+        int d = 0;
+        ForIndex(c,3) {
+          d += (int(px[p][c]) - pal[k][c]) * (int(px[p][c]) - pal[k][c]);
+        }
+        if (d < best) {
+          best  = d;
+          bestI = k;
+        }
+      }
+      _idx[p] = uchar(bestI);
+      err    += uint(best);
+    }
+    return err;
+  }
+
+#endif
+
+  void endpointsBBox(const uchar px[16][4],float _e0[3],float _e1[3])
+  {
+    ForIndex(c,3) {
+      int mn = 255, mx = 0;
+      ForIndex(p,16) {
+        mn = std::min(mn,int(px[p][c]));
+        mx = std::max(mx,int(px[p][c]));
+      }
+      float inset = float(mx - mn) / 16.0f;
+      _e0[c] = float(mx) - inset;
+      _e1[c] = float(mn) + inset;
+    }
+  }
+
+  void endpointsPCA(const uchar px[16][4],float _e0[3],float _e1[3])
+  {
+    float mean[3] = {0,0,0};
+    ForIndex(p,16) { ForIndex(c,3) { mean[c] += float(px[p][c]); } }
+    ForIndex(c,3) { mean[c] /= 16.0f; }
+    float cov[6] = {0,0,0,0,0,0}; // xx xy xz yy yz zz
+    ForIndex(p,16) {
+      float d[3];
+      ForIndex(c,3) { d[c] = float(px[p][c]) - mean[c]; }
+      cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+      cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+    // power iteration from the bounding box diagonal
+    float bb0[3], bb1[3];
+    endpointsBBox(px,bb0,bb1);
+    float axis[3] = { bb0[0] - bb1[0], bb0[1] - bb1[1], bb0[2] - bb1[2] };
+    ForIndex(it,8) {
+      float a[3] = {
+        cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+        cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+        cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2] };
+      float len = std::max(std::max(fabs(a[0]),fabs(a[1])),fabs(a[2]));
+      if (len < 1e-6f) {
+        break;
+      }
+      ForIndex(c,3) { axis[c] = a[c] / len; }
+    }
+    float norm2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    if (norm2 < 1e-12f) {
+      ForIndex(c,3) { _e0[c] = _e1[c] = mean[c]; }
+      return;
+    }
+    float tmin = 1e30f, tmax = -1e30f;
+    ForIndex(p,16) {
+      float t = 0;
+      ForIndex(c,3) { t += (float(px[p][c]) - mean[c]) * axis[c]; }
+      tmin = std::min(tmin,t);
+      tmax = std::max(tmax,t);
+    }
+    float inset = (tmax - tmin) / 32.0f;
+    tmin += inset;
+    tmax -= inset;
+    ForIndex(c,3) {
+      _e0[c] = mean[c] + axis[c] * tmax / norm2;
+      _e1[c] = mean[c] + axis[c] * tmin / norm2;
+    }
+  }
+
+  // least squares endpoints for the current (four colors) indices
+  bool refineEndpoints(const uchar px[16][4],const uchar idx[16],float _e0[3],float _e1[3])
+  {
+    static const float w0[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    float aa = 0, bb = 0, ab = 0;
+    float ax[3] = {0,0,0}, bx[3] = {0,0,0};
+    ForIndex(p,16) {
+      float a = w0[idx[p]];
+      float b = 1.0f - a;
+      aa += a * a; bb += b * b; ab += a * b;
+      ForIndex(c,3) {
+        ax[c] += a * float(px[p][c]);
+        bx[c] += b * float(px[p][c]);
+      }
+    }
+    float det = aa * bb - ab * ab;
+    if (fabs(det) < 1e-6f) {
+      return false;
+    }
+    ForIndex(c,3) {
+      _e0[c] = std::min(255.0f,std::max(0.0f,(ax[c] * bb - bx[c] * ab) / det));
+      _e1[c] = std::min(255.0f,std::max(0.0f,(bx[c] * aa - ax[c] * ab) / det));
+    }
+    return true;
+  }
+
+  // quantizes endpoints and computes indices, returns the error
+  uint fitColor(const uchar px[16][4],const float e0[3],const float e1[3],uint& _c0,uint& _c1,uchar _idx[16])
+  {
+    uint c0 = pack565(e0);
+    uint c1 = pack565(e1);
+    if (c0 < c1) {
+      std::swap(c0,c1);
+    }
+    _c0 = c0;
+    _c1 = c1;
+    int pal[4][3];
+    if (c0 == c1) {
+      // single color, index 0 in three colors mode
+      colorPalette(c0,c1,true,pal);
+      uint err = 0;
+      ForIndex(p,16) {
+        _idx[p] = 0;
+        ForIndex(c,3) {
+          err += uint((int(px[p][c]) - pal[0][c]) * (int(px[p][c]) - pal[0][c]));
+        }
+      }
+      return err;
+    }
+    colorPalette(c0,c1,true,pal);
+    return colorIndices(px,pal,_idx);
+  }
+
+  void encodeColorBlock(const uchar px[16][4],e_BCnQuality quality,uchar *_out)
+  {
+    float e0[3], e1[3];
+    if (quality == BCnFast) {
+      endpointsBBox(px,e0,e1);
+    } else {
+      endpointsPCA(px,e0,e1);
+    }
+    uint  c0, c1;
+    uchar idx[16];
+    uint  err = fitColor(px,e0,e1,c0,c1,idx);
+    int   iterations = (quality == BCnFast ? 0 : (quality == BCnNormal ? 1 : 4));
+    ForIndex(it,iterations) {
+      if (err == 0 || c0 == c1) {
+        break;
+      }
+      if (!refineEndpoints(px,idx,e0,e1)) {
+        break;
+      }
+      uint  n0, n1;
+      uchar nidx[16];
+      uint  nerr = fitColor(px,e0,e1,n0,n1,nidx);
+      if (nerr >= err) {
+        break;
+      }
+      err = nerr; c0 = n0; c1 = n1;
+      memcpy(idx,nidx,16);
+    }
+    _out[0] = uchar(c0 & 255); _out[1] = uchar(c0 >> 8);
+    _out[2] = uchar(c1 & 255); _out[3] = uchar(c1 >> 8);
+    uint bits = 0;
+    ForIndex(p,16) {
+      bits |= uint(idx[p]) << (2 * p);
+    }
+    ForIndex(k,4) {
+      _out[4 + k] = uchar(bits >> (8 * k));
+    }
+  }
+
+  // ----------------- surfaces
+
+  template <class T_Func>
+  void forBlockRows(uint h,const T_Func& f)
+  {
+    int bh = int((h + 3) / 4);
+    LibSL::System::Parallel::forIndex(0,bh,[&](int by) { f(uint(by)); });
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+uint NAMESPACE::bcnNumComp(e_BCnFormat fmt)
+{
+  switch (fmt) {
+  case BC1: return 4;
+  case BC3: return 4;
+  case BC4: return 1;
+  case BC5: return 2;
+  }
+  return 0;
+}
+
+uint NAMESPACE::bcnBlockBytes(e_BCnFormat fmt)
+{
+  return (fmt == BC1 || fmt == BC4) ? 8 : 16;
+}
+
+size_t NAMESPACE::bcnSurfaceBytes(e_BCnFormat fmt,uint w,uint h)
+{
+  return size_t((w + 3) / 4) * size_t((h + 3) / 4) * bcnBlockBytes(fmt);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::decodeBCn(e_BCnFormat fmt,const uchar *blocks,uint w,uint h,uchar *_pixels)
+{
+  uint nc = bcnNumComp(fmt);
+  uint bw = (w + 3) / 4;
+  uint bs = bcnBlockBytes(fmt);
+  forBlockRows(h,[&](uint by) {
+    for (uint bx = 0 ; bx < bw ; bx++) {
+      const uchar *b = blocks + (size_t(by) * bw + bx) * bs;
+      uchar rgba[16][4];
+      uchar v[2][16];
+      switch (fmt) {
+      case BC1: decodeColorBlock(b,false,rgba); break;
+      case BC3:
+        decodeSingleBlock(b,v[0]);
+        decodeColorBlock(b + 8,true,rgba);
+        ForIndex(p,16) { rgba[p][3] = v[0][p]; }
+        break;
+      case BC4: decodeSingleBlock(b,v[0]); break;
+      case BC5: decodeSingleBlock(b,v[0]); decodeSingleBlock(b + 8,v[1]); break;
+      }
+      ForIndex(y,4) {
+        uint j = by * 4 + y;
+        if (j >= h) break;
+        ForIndex(x,4) {
+          uint i = bx * 4 + x;
+          if (i >= w) break;
+          uchar *dst = _pixels + (size_t(j) * w + i) * nc;
+          int    p   = x + y * 4;
+          if (nc == 4) {
+            ForIndex(c,4) { dst[c] = rgba[p][c]; }
+          } else {
+            ForIndex(c,nc) { dst[c] = v[c][p]; }
+          }
+        }
+      }
+    }
+  });
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::encodeBCn(e_BCnFormat fmt,const uchar *pixels,uint w,uint h,uchar *_blocks,e_BCnQuality quality)
+{
+  if (w == 0 || h == 0) {
+    return;
+  }
+  uint nc = bcnNumComp(fmt);
+  uint bw = (w + 3) / 4;
+  uint bs = bcnBlockBytes(fmt);
+  forBlockRows(h,[&](uint by) {
+    for (uint bx = 0 ; bx < bw ; bx++) {
+      uchar *b = _blocks + (size_t(by) * bw + bx) * bs;
+      // gather, replicating the last row / column
+      uchar rgba[16][4];
+      uchar v[2][16];
+      ForIndex(y,4) {
+        uint j = std::min(by * 4 + y,h - 1);
+        ForIndex(x,4) {
+          uint         i   = std::min(bx * 4 + x,w - 1);
+          const uchar *src = pixels + (size_t(j) * w + i) * nc;
+          int          p   = x + y * 4;
+          if (nc == 4) {
+            ForIndex(c,4) { rgba[p][c] = src[c]; }
+          } else {
+            ForIndex(c,nc) { v[c][p] = src[c]; }
+          }
+        }
+      }
+      switch (fmt) {
+      case BC1: encodeColorBlock(rgba,quality,b); break;
+      case BC3:
+        ForIndex(p,16) { v[0][p] = rgba[p][3]; }
+        encodeSingleBlock(v[0],quality,b);
+        encodeColorBlock(rgba,quality,b + 8);
+        break;
+      case BC4: encodeSingleBlock(v[0],quality,b); break;
+      case BC5: encodeSingleBlock(v[0],quality,b); encodeSingleBlock(v[1],quality,b + 8); break;
+      }
+    }
+  });
+}
+
+// ------------------------------------------------------
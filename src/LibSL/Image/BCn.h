@@ -0,0 +1,101 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Image::BCn
+// ------------------------------------------------------
+//
+// CPU codec for block compressed textures
+//
+//  BC1 (DXT1) : RGB,  8 bytes per 4x4 block
+//  BC3 (DXT5) : RGBA, 16 bytes, BC4 alpha + BC1 color
+//  BC4 (ATI1) : R,    8 bytes
+//  BC5 (ATI2) : RG,   16 bytes, two BC4 blocks
+//
+// Pixels are 8 bit, interleaved, with bcnNumComp(format)
+// components. Surfaces need not be multiples of 4: edge
+// blocks replicate the last row / column when encoding
+// and are cropped when decoding.
+//
+// Blocks rows are processed in parallel (see System/Parallel.h).
+// The color index search uses SSE2 when available.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/LibSL.common.h>
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/System/Types.h>
+
+#include <cstddef>
+
+namespace LibSL {
+  namespace Image {
+
+    //! Block compressed formats
+    enum e_BCnFormat {
+      BC1,  //!< DXT1, opaque RGB
+      BC3,  //!< DXT5, RGBA
+      BC4,  //!< single channel
+      BC5   //!< two channels
+    };
+
+    //! Encoder quality / speed trade-off
+    enum e_BCnQuality {
+      BCnFast,    //!< bounding box endpoints
+      BCnNormal,  //!< principal axis endpoints, one least-squares refinement
+      BCnHigh     //!< several refinements, endpoint search for single channels
+    };
+
+    //! number of components of uncompressed pixels
+    LIBSL_DLL uint   bcnNumComp(e_BCnFormat fmt);
+    //! bytes per 4x4 block
+    LIBSL_DLL uint   bcnBlockBytes(e_BCnFormat fmt);
+    //! bytes of a w x h surface
+    LIBSL_DLL size_t bcnSurfaceBytes(e_BCnFormat fmt,uint w,uint h);
+
+    //! decode a w x h surface, _pixels receives w*h*bcnNumComp(fmt) bytes
+    LIBSL_DLL void   decodeBCn(e_BCnFormat fmt,const uchar *blocks,uint w,uint h,uchar *_pixels);
+    //! encode a w x h surface, _blocks receives bcnSurfaceBytes(fmt,w,h) bytes
+    LIBSL_DLL void   encodeBCn(e_BCnFormat fmt,const uchar *pixels,uint w,uint h,uchar *_blocks,
+                               e_BCnQuality quality = BCnNormal);
+
+  } //namespace LibSL::Image
+} //namespace LibSL
+
+// ------------------------------------------------------
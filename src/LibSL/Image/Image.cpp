@@ -48,7 +48,11 @@ using namespace LibSL::Memory::Pointer;
 #include <LibSL/CppHelpers/CppHelpers.h>
 using namespace LibSL::CppHelpers;
 
+#include <LibSL/Image/Resize.h>
+#include <LibSL/System/Parallel.h>
+
 #include <algorithm>
+#include <exception>
 
 //---------------------------------------------------------------------------
 
@@ -123,6 +127,98 @@ NAMESPACE::Image *NAMESPACE::loadImage(const char *fname)
 
 //---------------------------------------------------------------------------
 
+// Box filtered copy of an image of type T_Image, NULL if img is of another type
+template <class T_Image>
+static NAMESPACE::Image *scaledCopy(const NAMESPACE::Image *img,uint scaleDenom)
+{
+  const T_Image *typed = dynamic_cast<const T_Image *>(img);
+  if (typed == NULL) {
+    return NULL;
+  }
+  uint w = (typed->w() + scaleDenom - 1) / scaleDenom;
+  uint h = (typed->h() + scaleDenom - 1) / scaleDenom;
+  return NAMESPACE::resize(typed,w,h,NAMESPACE::ResizeBox);
+}
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_plugin::loadScaled(const char *fname,uint scaleDenom) const
+{
+  if (scaleDenom != 1 && scaleDenom != 2 && scaleDenom != 4 && scaleDenom != 8) {
+    throw Fatal("Image - scale must be 1, 2, 4 or 8 (%d, '%s')",scaleDenom,fname);
+  }
+  Image *img = load(fname);
+  if (scaleDenom == 1) {
+    return img;
+  }
+  Image *scaled = NULL;
+  try {
+    if (scaled == NULL) scaled = scaledCopy<ImageRGB    >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageRGBA   >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageL8     >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageUV8    >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageFloat1 >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageFloat2 >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageFloat3 >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageFloat4 >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageL16F   >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageRGB16F >(img,scaleDenom);
+    if (scaled == NULL) scaled = scaledCopy<ImageRGBA16F>(img,scaleDenom);
+  } catch (...) {
+    delete (img);
+    throw;
+  }
+  delete (img);
+  if (scaled == NULL) {
+    LIBSL_FATAL_ERROR_WITH_ARGS("Image - cannot scale this image type ('%s')",fname);
+  }
+  return (scaled);
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::loadImage(const char *fname,uint scaleDenom)
+{
+  NAMESPACE::ImageFormatManager&
+    manager=(*NAMESPACE::ImageFormatManager::getUniqueInstance());
+  const char *pos=strrchr(fname,'.');
+  if (pos == NULL) {
+    LIBSL_FATAL_ERROR_WITH_ARGS("Image - Cannot determine file type ('%s')",fname);
+  }
+  return (manager.getPlugin(pos+1)->loadScaled(fname,scaleDenom));
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::loadImages(
+  const std::vector<std::string>& fnames,
+  std::vector<NAMESPACE::Image*>& _images,
+  uint                            scaleDenom,
+  std::vector<std::string>       *_errors)
+{
+  _images.assign(fnames.size(),(NAMESPACE::Image*)NULL);
+  if (_errors != NULL) {
+    _errors->assign(fnames.size(),std::string());
+  }
+  // one file per task, decoding times vary a lot between files
+  // nothing escapes a task: the images already loaded are returned to the caller
+  LibSL::System::Parallel::forIndex(0,int(fnames.size()),[&](int i) {
+    std::string err;
+    try {
+      _images[i] = loadImage(fnames[i].c_str(),scaleDenom);
+    } catch (Fatal& e) {
+      err = e.message();
+    } catch (std::exception& e) {
+      err = e.what();
+    } catch (...) {
+      err = "unknown error";
+    }
+    if (_errors != NULL && !err.empty()) {
+      (*_errors)[i] = err;
+    }
+  });
+}
+
+//---------------------------------------------------------------------------
+
 void NAMESPACE::saveImage(const char *fname,const NAMESPACE::Image *img)
 {
   NAMESPACE::ImageFormatManager&
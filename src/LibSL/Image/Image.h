@@ -66,6 +66,11 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include <LibSL/Memory/TraceLeaks.h>
 #include <LibSL/Memory/Pointer.h>
 #include <LibSL/System/Types.h>
+#include <LibSL/System/HalfConvert.h>
+
+#include <map>
+#include <string>
+#include <vector>
 
 #define ForPixels(IMG,I,J)   for (uint J=0;J<IMG->h();J++) for (uint I=0;I<IMG->w();I++)
 #define ForImage(IMG,I,J)    ForPixels(IMG,I,J)
@@ -107,6 +112,9 @@ namespace LibSL {
       virtual void        save(const char *,const Image *) const =0;
       virtual Image      *load(const char *)               const =0;
       virtual const char *signature()                      const =0;
+      //! loads at 1/scaleDenom resolution (scaleDenom in 1,2,4,8), the result is ceil(w/scaleDenom) x ceil(h/scaleDenom)
+      //! by default the full image is loaded then box filtered, formats able to decode at lower resolution override it
+      virtual Image      *loadScaled(const char *,uint scaleDenom) const;
       virtual ~ImageFormat_plugin() {}
     };
 
@@ -131,6 +139,17 @@ namespace LibSL {
 
     };
 
+    /// Component conversions used by Image_generic::cast
+    template <typename T_Src,typename T_Dst>
+    void castComponents(const T_Src *src,T_Dst *_dst,size_t n)
+    {
+      for (size_t i = 0 ; i < n ; i++) {
+        _dst[i] = (T_Dst)src[i];
+      }
+    }
+    inline void castComponents(const half *src,float *_dst,size_t n)  { LibSL::System::halfToFloat(src,_dst,n); }
+    inline void castComponents(const float *src,half *_dst,size_t n)  { LibSL::System::floatToHalf(src,_dst,n); }
+
     /// Generic Image class
     template <typename T_Type,unsigned int T_NumComp>
     class Image_generic : public Image
@@ -490,6 +509,13 @@ namespace LibSL {
       template <class T_Image> T_Image *cast() const
       {
         T_Image *nimg = new T_Image(w(),h());
+        if (int(e_NumComp) == int(T_Image::e_NumComp)) {
+          // same layout, convert all components at once
+          castComponents(reinterpret_cast<const t_Component*>(raw()),
+                         reinterpret_cast<typename T_Image::t_Component*>(nimg->raw()),
+                         size_t(w()) * size_t(h()) * size_t(e_NumComp));
+          return (nimg);
+        }
         ForImage(nimg,i,j) {
           ForIndex(c,Math::min(int(e_NumComp),int(T_Image::e_NumComp))) {
             nimg->pixel(i,j)[c]=(typename T_Image::t_Component)pixel(i,j)[c];
@@ -513,6 +539,12 @@ namespace LibSL {
     /// Load and save global methods
 
     LIBSL_DLL Image    *loadImage(const char *);
+    //! load at 1/scaleDenom resolution, see ImageFormat_plugin::loadScaled
+    LIBSL_DLL Image    *loadImage(const char *,uint scaleDenom);
+    //! load images concurrently on the worker pool (see System/Parallel.h)
+    //! _images[i] is NULL when fnames[i] failed to load, the error message is then in (*_errors)[i]
+    LIBSL_DLL void      loadImages(const std::vector<std::string>& fnames,std::vector<Image*>& _images,
+                                   uint scaleDenom = 1,std::vector<std::string> *_errors = NULL);
     LIBSL_DLL void      saveImage(const char *,const Image_Ptr&);
     LIBSL_DLL void      saveImage(const char *,const Image *);
 
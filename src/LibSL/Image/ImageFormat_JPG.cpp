@@ -41,6 +41,7 @@ extern "C" {
 }
 //#endif
 #include <setjmp.h>
+#include <cstring>
 
 //---------------------------------------------------------------------------
 
@@ -83,66 +84,147 @@ NAMESPACE::ImageFormat_JPG::ImageFormat_JPG()
 
 //---------------------------------------------------------------------------
 
-NAMESPACE::Image *NAMESPACE::ImageFormat_JPG::load(const char *name) const
+namespace {
+
+  // Error manager jumping back to the decoder instead of exiting
+  struct JPGErrorManager
+  {
+    struct jpeg_error_mgr pub;
+    jmp_buf               jump;
+    char                  message[JMSG_LENGTH_MAX];
+  };
+
+  void jpgErrorExit(j_common_ptr cinfo)
+  {
+    JPGErrorManager *err = (JPGErrorManager *)cinfo->err;
+    (*cinfo->err->format_message)(cinfo, err->message);
+    longjmp(err->jump, 1);
+  }
+
+}
+
+// Decodes the image at 1/scaleDenom resolution (DCT scaling), restricted to
+// the region [x,x+w[ x [y,y+h[ of the scaled image when w > 0
+// Rows are decoded straight into the image buffer when no region is given.
+static NAMESPACE::Image *decodeJPG(const char *name, uint scaleDenom, uint rx, uint ry, uint rw, uint rh)
 {
+  // modified after setjmp, must not live in registers
+  uint volatile x = rx, y = ry, w = rw, h = rh;
+  if (scaleDenom != 1 && scaleDenom != 2 && scaleDenom != 4 && scaleDenom != 8) {
+    throw Fatal("ImageFormat_JPG::load - scale must be 1, 2, 4 or 8 (%d, %s)", scaleDenom, name);
+  }
+
   FILE *infile;
-	fopen_s(&infile, name, "rb");
+  fopen_s(&infile, name, "rb");
   if (infile == NULL)
     throw Fatal("ImageFormat_JPG::load - cannot open %s",name);
 
   struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr         jerr;
-  JSAMPARRAY     buffer;     // output row buffer
-  int            row_stride; // physical row width in output buffer
-  int            i,line = 0;
-  unsigned int   width  = 0;
-  unsigned int   height = 0;
-
-  cinfo.err = jpeg_std_error(&jerr);
+  JPGErrorManager               jerr;
+  NAMESPACE::Image * volatile   img   = NULL;
+  const char       * volatile   error = NULL;
+
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = jpgErrorExit;
+  if (setjmp(jerr.jump)) {
+    // libjpeg error, or error raised below
+    jpeg_destroy_decompress(&cinfo);
+    fclose(infile);
+    delete img;
+    if (error != NULL) {
+      throw Fatal("ImageFormat_JPG::load - %s (%s)", error, name);
+    }
+    throw Fatal("ImageFormat_JPG::load - %s (%s)", jerr.message, name);
+  }
   jpeg_create_decompress(&cinfo);
   jpeg_stdio_src(&cinfo, infile);
   jpeg_read_header(&cinfo, TRUE);
+  cinfo.scale_num   = 1;
+  cinfo.scale_denom = scaleDenom;
   jpeg_start_decompress(&cinfo);
 
-  width      = cinfo.output_width;
-  height     = cinfo.output_height;
-  row_stride = cinfo.output_width * cinfo.output_components;
-  //row_stride;
-  buffer = (*cinfo.mem->alloc_sarray)
-    ((j_common_ptr) &cinfo, JPOOL_IMAGE, row_stride, 1);
-
-  if (cinfo.output_components == 3) {
-    ImageRGB *img = new ImageRGB(width,height);
-    line=0;
-    while (cinfo.output_scanline < cinfo.output_height)  {
-      (void) jpeg_read_scanlines(&cinfo, buffer, 1);
-      for (i=0;i<row_stride/3;i++) {
-        img->pixel(i,line)[0] = buffer[0][i*3  ];
-        img->pixel(i,line)[1] = buffer[0][i*3+1];
-        img->pixel(i,line)[2] = buffer[0][i*3+2];
+  uint width  = cinfo.output_width;
+  uint height = cinfo.output_height;
+  uint ncomp  = cinfo.output_components;
+  if (ncomp != 1 && ncomp != 3) {
+    error = "unsupported number of components";
+    longjmp(jerr.jump, 1);
+  }
+  bool region = (w > 0);
+  if (region) {
+    if (x >= width || y >= height || h == 0) {
+      error = "region outside of image";
+      longjmp(jerr.jump, 1);
+    }
+    w = LibSL::Math::min(uint(w), width  - x);
+    h = LibSL::Math::min(uint(h), height - y);
+  } else {
+    x = y = 0;
+    w = width;
+    h = height;
+  }
+  if (ncomp == 3) {
+    img = new ImageRGB(w, h);
+  } else {
+    img = new ImageL8(w, h);
+  }
+  uchar *raw = img->raw();
+
+  if (!region) {
+    // decode directly into the pixel array
+    const uint maxRows = 8;
+    JSAMPROW   rows[maxRows];
+    while (cinfo.output_scanline < height) {
+      uint n = LibSL::Math::min(maxRows, height - cinfo.output_scanline);
+      ForIndex(r, n) {
+        rows[r] = raw + (size_t)(cinfo.output_scanline + r) * width * ncomp;
       }
-      line++;
+      jpeg_read_scanlines(&cinfo, rows, n);
     }
     jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
-    fclose(infile);
-    return (img);
-  } else if (cinfo.output_components == 1) {
-    ImageL8 *img=new ImageL8(width,height);
-    line=0;
-    while (cinfo.output_scanline < cinfo.output_height)  {
-      (void) jpeg_read_scanlines(&cinfo, buffer, 1);
-      for (i=0;i<row_stride;i++) {
-        img->pixel(i,line)[0] = buffer[0][i];
+  } else {
+    JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, width * ncomp, 1);
+    while (cinfo.output_scanline < y + h) {
+      uint line = cinfo.output_scanline;
+      jpeg_read_scanlines(&cinfo, buffer, 1);
+      if (line >= y) {
+        memcpy(raw + (size_t)(line - y) * w * ncomp, buffer[0] + x * ncomp, w * ncomp);
       }
-      line++;
     }
-    jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
-    fclose(infile);    
-    return (img);
-  } else
-    throw Fatal("ImageFormat_JPG::load - unsupported number of components (%d, %s)",cinfo.output_components,name);
+    // rows below the region are never decoded
+    if (cinfo.output_scanline < height) {
+      jpeg_abort_decompress(&cinfo);
+    } else {
+      jpeg_finish_decompress(&cinfo);
+    }
+  }
+  jpeg_destroy_decompress(&cinfo);
+  fclose(infile);
+  return (img);
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_JPG::load(const char *name) const
+{
+  return decodeJPG(name, 1, 0, 0, 0, 0);
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_JPG::loadScaled(const char *name, uint scaleDenom) const
+{
+  return decodeJPG(name, scaleDenom, 0, 0, 0, 0);
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_JPG::loadRegion(const char *name, uint x, uint y, uint w, uint h, uint scaleDenom) const
+{
+  if (w == 0 || h == 0) {
+    throw Fatal("ImageFormat_JPG::loadRegion - empty region (%s)", name);
+  }
+  return decodeJPG(name, scaleDenom, x, y, w, h);
 }
 
 //---------------------------------------------------------------------------
@@ -59,6 +59,12 @@ namespace LibSL {
       void        save(const char *,const Image *)  const;
       Image      *load(const char *)                const;
       const char *signature()                       const {return "jpg";}
+
+      //! decodes at 1/2, 1/4 or 1/8 resolution directly from the DCT coefficients
+      Image      *loadScaled(const char *,uint scaleDenom) const;
+      //! decodes the region [x,x+w[ x [y,y+h[ of the image scaled by 1/scaleDenom
+      //! the region is clipped to the image, rows below it are not decoded
+      Image      *loadRegion(const char *,uint x,uint y,uint w,uint h,uint scaleDenom = 1) const;
     };
 
   } //namespace LibSL::Image
@@ -52,6 +52,7 @@ using namespace LibSL::Memory::Pointer;
 extern "C" {
 #include "png.h"
 }
+#include <cstring>
 
 //---------------------------------------------------------------------------
 
@@ -78,8 +79,12 @@ NAMESPACE::ImageFormat_PNG::ImageFormat_PNG()
 
 //---------------------------------------------------------------------------
 
-NAMESPACE::Image *NAMESPACE::ImageFormat_PNG::load(const char *name, std::map<std::string, std::string>& _key_value_text) const
+// Decodes the region [x,x+w[ x [y,y+h[ of the image, whole image if w == 0
+// Rows are decoded straight into the image buffer when no region is given.
+static NAMESPACE::Image *decodePNG(const char *name, uint rx, uint ry, uint rw, uint rh, std::map<std::string, std::string> *_key_value_text)
 {
+  // modified after setjmp, must not live in registers
+  uint volatile x = rx, y = ry, w = rw, h = rh;
   FILE *file;
 	fopen_s(&file, name, "rb");
 
@@ -94,64 +99,133 @@ NAMESPACE::Image *NAMESPACE::ImageFormat_PNG::load(const char *name, std::map<st
     0  // user_warning_fn
     );
 
-  png_infop info_ptr = png_create_info_struct(png_ptr);
-  png_infop end_info = png_create_info_struct(png_ptr);
+  png_infop   info_ptr = png_create_info_struct(png_ptr);
+  png_infop   end_info = png_create_info_struct(png_ptr);
+  NAMESPACE::Image * volatile img   = NULL;
+  uchar            * volatile tmp   = NULL;
+  png_bytep        * volatile rows  = NULL;
+  const char       * volatile error = NULL;
+  int              volatile   ncomp = 0;
+  if (setjmp(png_jmpbuf(png_ptr))) {
+    // libpng error, or error raised below
+    png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+    fclose(file);
+    delete img;
+    delete [] tmp;
+    delete [] rows;
+    if (error == NULL) {
+      throw Fatal("ImageFormat_PNG::load - corrupted PNG file (%s)",name);
+    } else if (ncomp != 0) {
+      throw Fatal("ImageFormat_PNG::load - %s (%d in %s)",error,ncomp,name);
+    } else {
+      throw Fatal("ImageFormat_PNG::load - %s (%s)",error,name);
+    }
+  }
   png_init_io(png_ptr, file);
   png_read_info(png_ptr, info_ptr);
-  uint w         = png_get_image_width(png_ptr,info_ptr);
-  uint h         = png_get_image_height(png_ptr,info_ptr);
-  int ncomp      = png_get_channels(png_ptr,info_ptr);
+  uint width     = png_get_image_width(png_ptr,info_ptr);
+  uint height    = png_get_image_height(png_ptr,info_ptr);
   int bit_depth  = png_get_bit_depth(png_ptr,info_ptr);
   int color_type = png_get_color_type(png_ptr,info_ptr);
-  if (w <= 0 || h <=0)
-    throw Fatal("ImageFormat_PNG::load - corrupted PNG file (%s)",name);
-  if (bit_depth !=8 )
-    throw Fatal("ImageFormat_PNG::load - unsupported bit depth (%d bit in %s)",ncomp,name);
-  if (color_type == PNG_COLOR_TYPE_PALETTE)
-    throw Fatal("ImageFormat_PNG::load - palette not supported (%s)",name);
+  if (width <= 0 || height <= 0) {
+    longjmp(png_jmpbuf(png_ptr), 1);
+  }
+  if (bit_depth != 8) {
+    error = "unsupported bit depth"; ncomp = bit_depth;
+    longjmp(png_jmpbuf(png_ptr), 1);
+  }
+  if (color_type == PNG_COLOR_TYPE_PALETTE) {
+    error = "palette not supported";
+    longjmp(png_jmpbuf(png_ptr), 1);
+  }
+  int nc = png_get_channels(png_ptr,info_ptr);
+  if (nc != 1 && nc != 3 && nc != 4) {
+    error = "unsupported number of components"; ncomp = nc;
+    longjmp(png_jmpbuf(png_ptr), 1);
+  }
   //  if (color_type == PNG_COLOR_TYPE_GRAY)
   //    png_set_gray_to_rgb(png_ptr);
-  png_text* text = nullptr;
-  int       num_text = 0;
-  png_get_text(png_ptr, info_ptr, &text, &num_text);
-  if (num_text > 0) {
+  if (_key_value_text != NULL) {
+    png_text* text = nullptr;
+    int       num_text = 0;
+    png_get_text(png_ptr, info_ptr, &text, &num_text);
     ForIndex(t, num_text) {
-      _key_value_text.insert(std::make_pair(std::string(text[t].key), std::string(text[t].text)));
+      _key_value_text->insert(std::make_pair(std::string(text[t].key), std::string(text[t].text)));
     }
   }
-  Array<unsigned char> tmp;
-  tmp.allocate(h*w*ncomp);
-  Array<png_bytep> rowptrs;
-  rowptrs.allocate(h);
-  for (uint j=0;j<h;j++) {
-    rowptrs[j]=(png_bytep)&(tmp[(j*w)*ncomp]);
+  bool region = (w > 0);
+  if (region) {
+    if (x >= width || y >= height || h == 0) {
+      error = "region outside of image";
+      longjmp(png_jmpbuf(png_ptr), 1);
+    }
+    w = LibSL::Math::min(uint(w), width  - x);
+    h = LibSL::Math::min(uint(h), height - y);
+  } else {
+    x = y = 0;
+    w = width;
+    h = height;
   }
-  png_read_image(png_ptr, rowptrs.raw());
-  png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
-  fclose(file);
-
-  if (ncomp == 3) {
-    ImageRGB *rgb=new ImageRGB(w,h);
-    ForPixels(rgb,i,j) {
-      for (uint c=0;c<3;c++)
-        rgb->pixel(i,j)[c]=tmp[(i+j*w)*ncomp+c];
+  if (nc == 3) {
+    img = new ImageRGB(w, h);
+  } else if (nc == 4) {
+    img = new ImageRGBA(w, h);
+  } else {
+    img = new ImageL8(w, h);
+  }
+  uchar *raw = img->raw();
+  int passes = png_set_interlace_handling(png_ptr);
+  png_read_update_info(png_ptr, info_ptr);
+  if (!region) {
+    // decode directly into the pixel array
+    rows = new png_bytep[height];
+    ForIndex(j, height) {
+      rows[j] = (png_bytep)(raw + (size_t)j * width * nc);
+    }
+    png_read_image(png_ptr, rows);
+  } else if (passes > 1) {
+    // interlaced, every row is needed
+    tmp  = new uchar[(size_t)width * height * nc];
+    rows = new png_bytep[height];
+    ForIndex(j, height) {
+      rows[j] = (png_bytep)(tmp + (size_t)j * width * nc);
     }
-    return (rgb);
-  } else if (ncomp == 4) {
-    ImageRGBA *rgba=new ImageRGBA(w,h);
-    ForPixels(rgba,i,j) {
-      for (uint c=0;c<4;c++)
-        rgba->pixel(i,j)[c]=tmp[(i+j*w)*ncomp+c];
+    png_read_image(png_ptr, rows);
+    ForIndex(j, h) {
+      memcpy(raw + (size_t)j * w * nc, tmp + ((size_t)(y + j) * width + x) * nc, w * nc);
     }
-    return (rgba);
-  } else if (ncomp == 1) {
-    ImageL8 *l8=new ImageL8(w,h);
-    ForPixels(l8,i,j) {
-      l8->pixel(i,j)[0]=tmp[(i+j*w)*ncomp];
+  } else {
+    // rows below the region are never decoded
+    tmp = new uchar[(size_t)width * nc];
+    ForIndex(j, y + h) {
+      png_read_row(png_ptr, (png_bytep)tmp, NULL);
+      if (uint(j) >= y) {
+        memcpy(raw + (size_t)(j - y) * w * nc, tmp + (size_t)x * nc, w * nc);
+      }
     }
-    return (l8);
-  } else
-    throw Fatal("ImageFormat_PNG::load - unsupported number of components (%d components in %s)",ncomp,name);
+  }
+  png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+  fclose(file);
+  delete [] tmp;
+  delete [] rows;
+  return (img);
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_PNG::load(const char *name, std::map<std::string, std::string>& _key_value_text) const
+{
+  return decodePNG(name, 0, 0, 0, 0, &_key_value_text);
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_PNG::loadRegion(const char *name, uint x, uint y, uint w, uint h) const
+{
+  if (w == 0 || h == 0) {
+    throw Fatal("ImageFormat_PNG::loadRegion - empty region (%s)", name);
+  }
+  return decodePNG(name, x, y, w, h, NULL);
 }
 
 //---------------------------------------------------------------------------
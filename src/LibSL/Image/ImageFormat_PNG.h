@@ -64,6 +64,10 @@ namespace LibSL {
       void        save(const char*, const Image*, const std::map<std::string,std::string>& key_value_text) const;
       Image*      load(const char*, std::map<std::string, std::string>& _key_value_text)                   const;
 
+      //! decodes the region [x,x+w[ x [y,y+h[ of the image
+      //! the region is clipped to the image, rows below it are not decoded (but for interlaced files)
+      Image*      loadRegion(const char*, uint x, uint y, uint w, uint h) const;
+
       #ifndef EMSCRIPTEN // SL 2025-04-17 hotfix as this result in Emscripten compilation error
       // NS 2023-01-12: new interface to save in streams
       template<typename TChar>
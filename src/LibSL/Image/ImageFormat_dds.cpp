@@ -48,11 +48,13 @@ using namespace LibSL::Memory::Array;
 using namespace LibSL::Memory::Pointer;
 #include <LibSL/Math/Tuple.h>
 using namespace LibSL::Math;
-#include <LibSL/D3DHelpers/D3DHelpers.h>
+#include <LibSL/Image/Resize.h>
+#include <LibSL/System/System.h>
 
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstring>
 #include <cassert>
 using namespace std;
 
@@ -69,6 +71,284 @@ namespace {
 
 //---------------------------------------------------------------------------
 
+namespace {
+
+  typedef unsigned int t_u32;
+
+  // file layout, all little endian
+
+  struct DDS_PIXELFORMAT
+  {
+    t_u32 size;
+    t_u32 flags;
+    t_u32 fourCC;
+    t_u32 RGBBitCount;
+    t_u32 RBitMask;
+    t_u32 GBitMask;
+    t_u32 BBitMask;
+    t_u32 ABitMask;
+  };
+
+  struct DDS_HEADER
+  {
+    t_u32           size;
+    t_u32           flags;
+    t_u32           height;
+    t_u32           width;
+    t_u32           pitchOrLinearSize;
+    t_u32           depth;
+    t_u32           mipMapCount;
+    t_u32           reserved1[11];
+    DDS_PIXELFORMAT ddspf;
+    t_u32           caps;
+    t_u32           caps2;
+    t_u32           caps3;
+    t_u32           caps4;
+    t_u32           reserved2;
+  };
+
+  struct DDS_HEADER_DXT10
+  {
+    t_u32 dxgiFormat;
+    t_u32 resourceDimension;
+    t_u32 miscFlag;
+    t_u32 arraySize;
+    t_u32 miscFlags2;
+  };
+
+  static_assert(sizeof(DDS_HEADER) == 124,"unexpected DDS header size");
+
+  const t_u32 DDS_MAGIC             = 0x20534444; // "DDS "
+  const t_u32 DDSD_CAPS             = 0x1;
+  const t_u32 DDSD_HEIGHT           = 0x2;
+  const t_u32 DDSD_WIDTH            = 0x4;
+  const t_u32 DDSD_PITCH            = 0x8;
+  const t_u32 DDSD_PIXELFORMAT      = 0x1000;
+  const t_u32 DDSD_MIPMAPCOUNT      = 0x20000;
+  const t_u32 DDSD_LINEARSIZE       = 0x80000;
+  const t_u32 DDSD_DEPTH            = 0x800000;
+  const t_u32 DDPF_ALPHAPIXELS      = 0x1;
+  const t_u32 DDPF_ALPHA            = 0x2;
+  const t_u32 DDPF_FOURCC           = 0x4;
+  const t_u32 DDPF_RGB              = 0x40;
+  const t_u32 DDPF_LUMINANCE        = 0x20000;
+  const t_u32 DDSCAPS_COMPLEX       = 0x8;
+  const t_u32 DDSCAPS_TEXTURE       = 0x1000;
+  const t_u32 DDSCAPS_MIPMAP        = 0x400000;
+  const t_u32 DDSCAPS2_CUBEMAP      = 0x200;
+  const t_u32 DDSCAPS2_ALLFACES     = 0xFC00;
+  const t_u32 DDSCAPS2_VOLUME       = 0x200000;
+  const t_u32 DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+  const t_u32 DDS_DIMENSION_TEXTURE2D       = 3;
+
+  inline t_u32 fourCC(char a,char b,char c,char d)
+  {
+    return t_u32(uchar(a)) | (t_u32(uchar(b)) << 8) | (t_u32(uchar(c)) << 16) | (t_u32(uchar(d)) << 24);
+  }
+
+  // uncompressed layouts are described by channel masks
+  struct ChannelMasks
+  {
+    uint  bytesPerPixel;
+    uint  numComp;
+    t_u32 mask[4];
+  };
+
+  uint maskShift(t_u32 m) { uint s = 0; while (m != 0 && !(m & 1)) { m >>= 1; s++; } return s; }
+  uint maskBits (t_u32 m) { uint b = 0; m >>= maskShift(m); while (m & 1) { m >>= 1; b++; } return b; }
+
+  // expand masked pixels to 8 bit channels
+  void unpackMasked(const uchar *src,uint n,const ChannelMasks& cm,uchar *_dst)
+  {
+    uint shift[4], bits[4];
+    ForIndex(c,4) {
+      shift[c] = maskShift(cm.mask[c]);
+      bits [c] = maskBits (cm.mask[c]);
+    }
+    for (uint i = 0 ; i < n ; i++) {
+      t_u32 v = 0;
+      ForIndex(b,cm.bytesPerPixel) {
+        v |= t_u32(src[i * cm.bytesPerPixel + b]) << (8 * b);
+      }
+      ForIndex(c,cm.numComp) {
+        t_u32 x = (v & cm.mask[c]) >> shift[c];
+        if (bits[c] == 0) {
+          x = 255;
+        } else if (bits[c] < 8) {
+          x = (x * 255 + ((1u << bits[c]) - 1) / 2) / ((1u << bits[c]) - 1);
+        } else if (bits[c] > 8) {
+          x >>= (bits[c] - 8);
+        }
+        _dst[i * cm.numComp + c] = uchar(x);
+      }
+    }
+  }
+
+  size_t surfaceBytes(const DDSTexture& tex,uint w,uint h)
+  {
+    if (tex.compressed) {
+      return bcnSurfaceBytes(tex.bcFormat,w,h);
+    } else {
+      return size_t(w) * size_t(h) * tex.numComp;
+    }
+  }
+
+  bool dxgiToFormat(t_u32 dxgi,DDSTexture& _tex,ChannelMasks& _cm)
+  {
+    _tex.compressed = true;
+    switch (dxgi) {
+    case 71: case 72: _tex.bcFormat = BC1; return true;   // BC1_UNORM(_SRGB)
+    case 77: case 78: _tex.bcFormat = BC3; return true;   // BC3_UNORM(_SRGB)
+    case 80:          _tex.bcFormat = BC4; return true;   // BC4_UNORM
+    case 83:          _tex.bcFormat = BC5; return true;   // BC5_UNORM
+    }
+    _tex.compressed = false;
+    memset(&_cm,0,sizeof(ChannelMasks));
+    switch (dxgi) {
+    case 28: case 29: // R8G8B8A8_UNORM(_SRGB)
+      _cm.bytesPerPixel = 4; _cm.numComp = 4;
+      _cm.mask[0] = 0xff; _cm.mask[1] = 0xff00; _cm.mask[2] = 0xff0000; _cm.mask[3] = 0xff000000;
+      return true;
+    case 87: case 91: // B8G8R8A8_UNORM(_SRGB)
+      _cm.bytesPerPixel = 4; _cm.numComp = 4;
+      _cm.mask[0] = 0xff0000; _cm.mask[1] = 0xff00; _cm.mask[2] = 0xff; _cm.mask[3] = 0xff000000;
+      return true;
+    case 49:          // R8G8_UNORM
+      _cm.bytesPerPixel = 2; _cm.numComp = 2;
+      _cm.mask[0] = 0xff; _cm.mask[1] = 0xff00;
+      return true;
+    case 61:          // R8_UNORM
+      _cm.bytesPerPixel = 1; _cm.numComp = 1;
+      _cm.mask[0] = 0xff;
+      return true;
+    }
+    return false;
+  }
+
+  // converts an 8 bit image to the interleaved components expected by the texture
+  void imageComponents(const Image *img,uint numComp,std::vector<uchar>& _pixels)
+  {
+    if (img->sizeOfComp() != 1) {
+      throw Fatal("DDSTexture - only 8 bit images can be stored (%d bytes per component)",img->sizeOfComp());
+    }
+    uint         n   = img->w() * img->h();
+    uint         inc = img->numComp();
+    const uchar *src = img->raw();
+    _pixels.resize(size_t(n) * numComp);
+    ForIndex(i,n) {
+      const uchar *s = src + size_t(i) * inc;
+      uchar       *d = &_pixels[size_t(i) * numComp];
+      ForIndex(c,numComp) {
+        if (numComp >= 3 && c < 3) {
+          d[c] = (inc >= 3) ? s[c] : s[0];               // RGB from gray
+        } else if (c == 3) {
+          d[c] = (inc == 4) ? s[3] : (inc == 2 ? s[1] : 255);
+        } else {
+          d[c] = s[std::min(uint(c),inc - 1)];
+        }
+      }
+    }
+  }
+
+} // namespace
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::DDSTexture::DDSTexture()
+{
+  create(BC1);
+}
+
+void NAMESPACE::DDSTexture::create(e_BCnFormat fmt,bool isCubemap)
+{
+  compressed = true;
+  bcFormat   = fmt;
+  numComp    = bcnNumComp(fmt);
+  cubemap    = isCubemap;
+  width      = 0;
+  height     = 0;
+  numMips    = 0;
+  numFaces   = 0;
+  surfaces.clear();
+}
+
+void NAMESPACE::DDSTexture::createUncompressed(uint numComponents,bool isCubemap)
+{
+  sl_assert(numComponents >= 1 && numComponents <= 4);
+  create(BC1,isCubemap);
+  compressed = false;
+  numComp    = numComponents;
+}
+
+uint NAMESPACE::DDSTexture::decodedNumComp() const
+{
+  return compressed ? bcnNumComp(bcFormat) : numComp;
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::DDSTexture::addFace(const Image *img,bool mipmaps,e_BCnQuality quality)
+{
+  if (numFaces == 0) {
+    width   = img->w();
+    height  = img->h();
+    numMips = 1;
+    if (mipmaps) {
+      while ((width >> numMips) > 0 || (height >> numMips) > 0) {
+        numMips ++;
+      }
+    }
+  } else if (img->w() != width || img->h() != height) {
+    throw Fatal("DDSTexture::addFace - all faces must have the same size (%dx%d)",width,height);
+  }
+  uint nc = decodedNumComp();
+  std::vector<uchar> level;
+  imageComponents(img,nc,level);
+  ForIndex(l,numMips) {
+    uint w = mipWidth(l), h = mipHeight(l);
+    if (l > 0) {
+      std::vector<uchar> next(size_t(w) * h * nc);
+      resizeRaw(&level[0],mipWidth(l - 1),mipHeight(l - 1),&next[0],w,h,nc,ResizeBox);
+      level.swap(next);
+    }
+    surfaces.push_back(std::vector<uchar>());
+    std::vector<uchar>& s = surfaces.back();
+    if (compressed) {
+      s.resize(bcnSurfaceBytes(bcFormat,w,h));
+      encodeBCn(bcFormat,&level[0],w,h,&s[0],quality);
+    } else {
+      s = level;
+    }
+  }
+  numFaces ++;
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::DDSTexture::decode(uint face,uint mip) const
+{
+  sl_assert(face < numFaces && mip < numMips);
+  uint   w   = mipWidth(mip);
+  uint   h   = mipHeight(mip);
+  uint   nc  = decodedNumComp();
+  Image *img = NULL;
+  switch (nc) {
+  case 1: img = new ImageL8  (w,h); break;
+  case 2: img = new ImageUV8 (w,h); break;
+  case 3: img = new ImageRGB (w,h); break;
+  case 4: img = new ImageRGBA(w,h); break;
+  }
+  const std::vector<uchar>& s = surface(face,mip);
+  if (compressed) {
+    decodeBCn(bcFormat,&s[0],w,h,img->raw());
+  } else {
+    memcpy(img->raw(),&s[0],size_t(w) * h * nc);
+  }
+  return (img);
+}
+
+//---------------------------------------------------------------------------
+
 NAMESPACE::ImageFormat_dds::ImageFormat_dds()
 {
   try {
@@ -81,64 +361,230 @@ NAMESPACE::ImageFormat_dds::ImageFormat_dds()
 
 //---------------------------------------------------------------------------
 
-NAMESPACE::Image *NAMESPACE::ImageFormat_dds::load(const char *name) const
+void NAMESPACE::ImageFormat_dds::loadTexture(const char *name,DDSTexture& _tex)
+{
+  FILE *f = NULL;
+  fopen_s(&f,name,"rb");
+  if (f == NULL) {
+    throw Fatal("ImageFormat_dds::load - Sorry, cannot open file '%s'",name);
+  }
+  std::vector<uchar> data;
+  fseek(f,0,SEEK_END);
+  long fsize = ftell(f);
+  fseek(f,0,SEEK_SET);
+  if (fsize > 0) {
+    data.resize(size_t(fsize));
+    if (fread(&data[0],1,data.size(),f) != data.size()) {
+      data.clear();
+    }
+  }
+  fclose(f);
+  // header
+  size_t     offset = 4 + sizeof(DDS_HEADER);
+  t_u32      magic  = 0;
+  DDS_HEADER hdr;
+  if (data.size() < offset) {
+    throw Fatal("ImageFormat_dds::load - '%s' is truncated",name);
+  }
+  memcpy(&magic,&data[0],4);
+  memcpy(&hdr  ,&data[4],sizeof(DDS_HEADER));
+  if (magic != DDS_MAGIC || hdr.size != sizeof(DDS_HEADER)) {
+    throw Fatal("ImageFormat_dds::load - '%s' is not a DDS file",name);
+  }
+  if ((hdr.flags & DDSD_DEPTH) || (hdr.caps2 & DDSCAPS2_VOLUME)) {
+    throw Fatal("ImageFormat_dds::load - volume textures are not supported ('%s')",name);
+  }
+  ChannelMasks cm;
+  memset(&cm,0,sizeof(ChannelMasks));
+  uint numSlices = 1;
+  bool cube      = (hdr.caps2 & DDSCAPS2_CUBEMAP) != 0;
+  _tex.create(BC1);
+  const DDS_PIXELFORMAT& pf = hdr.ddspf;
+  if ((pf.flags & DDPF_FOURCC) && pf.fourCC == fourCC('D','X','1','0')) {
+    DDS_HEADER_DXT10 ext;
+    if (data.size() < offset + sizeof(DDS_HEADER_DXT10)) {
+      throw Fatal("ImageFormat_dds::load - '%s' is truncated",name);
+    }
+    memcpy(&ext,&data[offset],sizeof(DDS_HEADER_DXT10));
+    offset += sizeof(DDS_HEADER_DXT10);
+    if (ext.resourceDimension != DDS_DIMENSION_TEXTURE2D) {
+      throw Fatal("ImageFormat_dds::load - only 2D textures are supported ('%s')",name);
+    }
+    if (!dxgiToFormat(ext.dxgiFormat,_tex,cm)) {
+      throw Fatal("ImageFormat_dds::load - unsupported DXGI format %d ('%s')",ext.dxgiFormat,name);
+    }
+    cube      = (ext.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) != 0;
+    numSlices = std::max(1u,ext.arraySize);
+  } else if (pf.flags & DDPF_FOURCC) {
+    if      (pf.fourCC == fourCC('D','X','T','1')) { _tex.bcFormat = BC1; }
+    else if (pf.fourCC == fourCC('D','X','T','5')) { _tex.bcFormat = BC3; }
+    else if (pf.fourCC == fourCC('A','T','I','1')
+          || pf.fourCC == fourCC('B','C','4','U')) { _tex.bcFormat = BC4; }
+    else if (pf.fourCC == fourCC('A','T','I','2')
+          || pf.fourCC == fourCC('B','C','5','U')) { _tex.bcFormat = BC5; }
+    else {
+      throw Fatal("ImageFormat_dds::load - unsupported FourCC '%c%c%c%c' ('%s')",
+        char(pf.fourCC),char(pf.fourCC >> 8),char(pf.fourCC >> 16),char(pf.fourCC >> 24),name);
+    }
+  } else {
+    _tex.compressed  = false;
+    cm.bytesPerPixel = pf.RGBBitCount / 8;
+    if (cm.bytesPerPixel < 1 || cm.bytesPerPixel > 4 || (pf.RGBBitCount % 8) != 0) {
+      throw Fatal("ImageFormat_dds::load - unsupported pixel size (%d bits, '%s')",pf.RGBBitCount,name);
+    }
+    if (pf.flags & DDPF_RGB) {
+      cm.numComp = 3;
+      cm.mask[0] = pf.RBitMask; cm.mask[1] = pf.GBitMask; cm.mask[2] = pf.BBitMask;
+      if (pf.flags & DDPF_ALPHAPIXELS) {
+        cm.numComp = 4;
+        cm.mask[3] = pf.ABitMask;
+      }
+    } else if (pf.flags & DDPF_LUMINANCE) {
+      cm.numComp = 1;
+      cm.mask[0] = pf.RBitMask;
+      if (pf.flags & DDPF_ALPHAPIXELS) {
+        cm.numComp = 2;
+        cm.mask[1] = pf.ABitMask;
+      }
+    } else if (pf.flags & DDPF_ALPHA) {
+      cm.numComp = 1;
+      cm.mask[0] = pf.ABitMask;
+    } else {
+      throw Fatal("ImageFormat_dds::load - unsupported pixel format ('%s')",name);
+    }
+  }
+  if (!_tex.compressed) {
+    _tex.numComp = cm.numComp;
+  }
+  // surfaces
+  _tex.cubemap  = cube;
+  _tex.width    = hdr.width;
+  _tex.height   = hdr.height;
+  _tex.numMips  = ((hdr.flags & DDSD_MIPMAPCOUNT) && hdr.mipMapCount > 0) ? hdr.mipMapCount : 1;
+  if (cube) {
+    uint faces = 0;
+    ForIndex(b,6) {
+      if (hdr.caps2 & (0x400u << b)) {
+        faces ++;
+      }
+    }
+    _tex.numFaces = numSlices * (faces == 0 ? 6 : faces);
+  } else {
+    _tex.numFaces = numSlices;
+  }
+  if (_tex.width == 0 || _tex.height == 0 || _tex.numMips > 32) {
+    throw Fatal("ImageFormat_dds::load - invalid header in '%s'",name);
+  }
+  ForIndex(face,_tex.numFaces) {
+    ForIndex(mip,_tex.numMips) {
+      uint   w     = _tex.mipWidth(mip);
+      uint   h     = _tex.mipHeight(mip);
+      size_t bytes = _tex.compressed ? surfaceBytes(_tex,w,h) : size_t(w) * h * cm.bytesPerPixel;
+      if (offset + bytes > data.size()) {
+        throw Fatal("ImageFormat_dds::load - '%s' is truncated",name);
+      }
+      _tex.surfaces.push_back(std::vector<uchar>());
+      std::vector<uchar>& s = _tex.surfaces.back();
+      if (_tex.compressed) {
+        s.assign(data.begin() + offset,data.begin() + offset + bytes);
+      } else {
+        s.resize(size_t(w) * h * cm.numComp);
+        unpackMasked(&data[offset],w * h,cm,&s[0]);
+      }
+      offset += bytes;
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::ImageFormat_dds::saveTexture(const char *name,const DDSTexture& tex)
 {
-#ifdef DIRECT3D
-  // create sysmem surface
-  LPDIRECT3DDEVICE9  d3d    = LIBSL_D3D_DEVICE;
-  LPDIRECT3DTEXTURE9 tmp    = NULL;
-  LPDIRECT3DSURFACE9 tmpsrf = NULL;
-  
-  D3DXIMAGE_INFO info;
-  LIBSL_D3D_CHECK_ERROR( D3DXGetImageInfoFromFileA(name,&info) );
-
-  LIBSL_D3D_CHECK_ERROR( d3d->CreateTexture(
-    info.Width,
-    info.Height,
-    1,0,
-    D3DFMT_A8R8G8B8,
-    D3DPOOL_SYSTEMMEM,
-    &tmp,NULL));
-  LIBSL_D3D_CHECK_ERROR( tmp->GetSurfaceLevel(0,&tmpsrf) );
-
-  LIBSL_D3D_CHECK_ERROR( D3DXLoadSurfaceFromFileA(
-    tmpsrf,
-    NULL,
-    NULL,
-    name,
-    NULL,
-    D3DX_DEFAULT,
-    0,
-    NULL) );
-
-  // read image data
-  ImageRGBA *img = new ImageRGBA(info.Width,info.Height);
-  D3DLOCKED_RECT rect;
-  tmp->LockRect(0,&rect,NULL,D3DLOCK_READONLY);
-  uint   stride     = rect.Pitch;
-  const uchar *data = (const uchar *)rect.pBits;
-  ForImage(img,i,j) {
-    ForIndex(c,3) {
-      img->pixel(i,j)[c] = data[i*4 + j*stride + 2 - c];
-    }
-    img->pixel(i,j)[3] = data[i*4 + j*stride + 3];
-  }
-  tmp->UnlockRect(0);
-  LIBSL_D3D_SAFE_RELEASE(tmpsrf);
-  LIBSL_D3D_SAFE_RELEASE(tmp);
+  if (tex.numFaces == 0 || tex.surfaces.size() != size_t(tex.numFaces) * tex.numMips) {
+    throw Fatal("ImageFormat_dds::save - empty or incomplete texture ('%s')",name);
+  }
+  if (tex.cubemap && tex.numFaces != 6) {
+    throw Fatal("ImageFormat_dds::save - cube maps must have 6 faces ('%s')",name);
+  }
+  DDS_HEADER hdr;
+  memset(&hdr,0,sizeof(DDS_HEADER));
+  hdr.size        = sizeof(DDS_HEADER);
+  hdr.flags       = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+  hdr.height      = tex.height;
+  hdr.width       = tex.width;
+  hdr.mipMapCount = tex.numMips;
+  hdr.caps        = DDSCAPS_TEXTURE;
+  if (tex.numMips > 1) {
+    hdr.flags |= DDSD_MIPMAPCOUNT;
+    hdr.caps  |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+  }
+  if (tex.cubemap) {
+    hdr.caps  |= DDSCAPS_COMPLEX;
+    hdr.caps2  = DDSCAPS2_CUBEMAP | DDSCAPS2_ALLFACES;
+  } else if (tex.numFaces > 1) {
+    throw Fatal("ImageFormat_dds::save - texture arrays are not supported ('%s')",name);
+  }
+  DDS_PIXELFORMAT& pf = hdr.ddspf;
+  pf.size = sizeof(DDS_PIXELFORMAT);
+  if (tex.compressed) {
+    hdr.flags            |= DDSD_LINEARSIZE;
+    hdr.pitchOrLinearSize = t_u32(bcnSurfaceBytes(tex.bcFormat,tex.width,tex.height));
+    pf.flags              = DDPF_FOURCC;
+    switch (tex.bcFormat) {
+    case BC1: pf.fourCC = fourCC('D','X','T','1'); break;
+    case BC3: pf.fourCC = fourCC('D','X','T','5'); break;
+    case BC4: pf.fourCC = fourCC('A','T','I','1'); break;
+    case BC5: pf.fourCC = fourCC('A','T','I','2'); break;
+    }
+  } else {
+    hdr.flags            |= DDSD_PITCH;
+    hdr.pitchOrLinearSize = tex.width * tex.numComp;
+    pf.RGBBitCount        = 8 * tex.numComp;
+    switch (tex.numComp) {
+    case 1: pf.flags = DDPF_LUMINANCE;                    pf.RBitMask = 0xff; break;
+    case 2: pf.flags = DDPF_LUMINANCE | DDPF_ALPHAPIXELS; pf.RBitMask = 0xff; pf.ABitMask = 0xff00; break;
+    case 3: pf.flags = DDPF_RGB;
+            pf.RBitMask = 0xff; pf.GBitMask = 0xff00; pf.BBitMask = 0xff0000; break;
+    case 4: pf.flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+            pf.RBitMask = 0xff; pf.GBitMask = 0xff00; pf.BBitMask = 0xff0000; pf.ABitMask = 0xff000000; break;
+    }
+  }
+  FILE *f = NULL;
+  fopen_s(&f,name,"wb");
+  if (f == NULL) {
+    throw Fatal("ImageFormat_dds::save - Sorry, cannot open file '%s'",name);
+  }
+  fwrite(&DDS_MAGIC,4,1,f);
+  fwrite(&hdr,sizeof(DDS_HEADER),1,f);
+  ForIndex(s,tex.surfaces.size()) {
+    if (!tex.surfaces[s].empty()) {
+      fwrite(&tex.surfaces[s][0],tex.surfaces[s].size(),1,f);
+    }
+  }
+  fclose(f);
+}
 
-  return (img);
-#else
-  sl_assert(false);
-  return NULL;
-#endif
+//---------------------------------------------------------------------------
+
+NAMESPACE::Image *NAMESPACE::ImageFormat_dds::load(const char *name) const
+{
+  DDSTexture tex;
+  loadTexture(name,tex);
+  return tex.decode(0,0);
 }
 
 //---------------------------------------------------------------------------
 
 void NAMESPACE::ImageFormat_dds::save(const char *name,const NAMESPACE::Image *img) const
 {
-  throw Fatal("ImageFormat_dds::save - Sorry, not yet implemented");
+  static const e_BCnFormat formats[4] = { BC4, BC5, BC1, BC3 };
+  if (img->numComp() < 1 || img->numComp() > 4) {
+    throw Fatal("ImageFormat_dds::save - unsupported number of components (%d)",img->numComp());
+  }
+  DDSTexture tex;
+  tex.create(formats[img->numComp() - 1]);
+  tex.addFace(img);
+  saveTexture(name,tex);
 }
 
 //---------------------------------------------------------------------------
@@ -34,19 +34,20 @@ The fact that you are presently reading this means that you have had
 knowledge of the CeCILL-C license and that you accept its terms.
 -------------------------------------------------------------------- */
 // ------------------------------------------------------
-// LibSL::Image::ImageFormat_float
+// LibSL::Image::ImageFormat_dds
 // ------------------------------------------------------
 //
-// Load raw floating point file
-// 
+// DirectDraw Surface files, without Direct3D
 //
-// Header:
-//   width  :  uint
-//   height :  uint
-//   numcomp:  uchar
+// Reads 2D textures, mip chains, cube maps and texture
+// arrays (DX10 header), stored as BC1 (DXT1), BC3 (DXT5),
+// BC4 (ATI1), BC5 (ATI2) or uncompressed 8 bit channels.
+// See BCn.h for the block codec.
 //
-// Data in row major order: 
-//   sizeof(float)*width*height*numcomp bytes
+// load() decodes the first mip level of the first face,
+// save() writes BC4 / BC5 / BC1 / BC3 for 1 / 2 / 3 / 4
+// components 8 bit images, with a full mip chain.
+// DDSTexture gives access to all surfaces.
 //
 // ------------------------------------------------------
 // Sylvain Lefebvre - 2007-01-02
@@ -55,10 +56,49 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #pragma once
 
 #include <LibSL/Image/Image.h>
+#include <LibSL/Image/BCn.h>
+
+#include <vector>
+#include <algorithm>
 
 namespace LibSL {
   namespace Image {
 
+    /// Content of a DDS file: faces (or array slices) x mip levels
+    class LIBSL_DLL DDSTexture
+    {
+    public:
+
+      bool         compressed;
+      e_BCnFormat  bcFormat;   //!< when compressed
+      uint         numComp;    //!< when uncompressed, 8 bit RGBA ordered channels
+      bool         cubemap;
+      uint         width;
+      uint         height;
+      uint         numMips;
+      uint         numFaces;
+      //! surface data, surfaces[face*numMips + mip]
+      std::vector<std::vector<uchar> > surfaces;
+
+      DDSTexture();
+
+      //! reset to an empty compressed texture
+      void   create(e_BCnFormat fmt,bool isCubemap = false);
+      //! reset to an empty uncompressed texture
+      void   createUncompressed(uint numComponents,bool isCubemap = false);
+      //! append a face (or array slice) from an 8 bit image, mip levels are box filtered
+      //! all faces must have the same size
+      void   addFace(const Image *img,bool mipmaps = true,e_BCnQuality quality = BCnNormal);
+
+      uint   mipWidth (uint mip) const { return std::max(1u,width  >> mip); }
+      uint   mipHeight(uint mip) const { return std::max(1u,height >> mip); }
+      //! number of 8 bit components of decoded surfaces
+      uint   decodedNumComp() const;
+      const std::vector<uchar>& surface(uint face,uint mip) const { return surfaces[face*numMips + mip]; }
+      //! decode a surface into an 8 bit image (ImageL8, ImageUV8, ImageRGB or ImageRGBA)
+      Image *decode(uint face = 0,uint mip = 0) const;
+    };
+
     class ImageFormat_dds : public ImageFormat_plugin
     {
     public:
@@ -66,6 +106,9 @@ namespace LibSL {
       void        save(const char *,const Image *)  const;
       Image      *load(const char *)                const;
       const char *signature()                       const {return "dds";}
+
+      static void loadTexture(const char *,DDSTexture& _tex);
+      static void saveTexture(const char *,const DDSTexture& tex);
     };
 
   } //namespace LibSL::Image
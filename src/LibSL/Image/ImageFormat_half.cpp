@@ -48,11 +48,14 @@ using namespace LibSL::Memory::Array;
 using namespace LibSL::Memory::Pointer;
 #include <LibSL/Math/Tuple.h>
 using namespace LibSL::Math;
+#include <LibSL/System/HalfConvert.h>
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 //---------------------------------------------------------------------------
@@ -126,7 +129,28 @@ void NAMESPACE::ImageFormat_half::save(const char *name,const NAMESPACE::Image *
   fwrite(&h   ,sizeof(uint) ,1,f);
   fwrite(&numc,sizeof(uchar),1,f);
   // save data
-  fwrite(img->raw(),w*h*numc*sizeof(half),1,f);
+  bool isFloat = dynamic_cast<const Image_generic<float,1>*>(img) != NULL
+              || dynamic_cast<const Image_generic<float,2>*>(img) != NULL
+              || dynamic_cast<const Image_generic<float,3>*>(img) != NULL
+              || dynamic_cast<const Image_generic<float,4>*>(img) != NULL;
+  if (isFloat) {
+    // convert float images by blocks
+    const float  *src   = reinterpret_cast<const float*>(img->raw());
+    size_t        n     = size_t(w)*size_t(h)*size_t(numc);
+    const size_t  block = 1 << 20;
+    vector<half>  tmp(std::min(n,block));
+    for (size_t b = 0 ; b < n ; b += block) {
+      size_t num = std::min(block,n - b);
+      LibSL::System::floatToHalf(src + b,&tmp[0],num);
+      fwrite(&tmp[0],num*sizeof(half),1,f);
+    }
+  } else {
+    if (img->sizeOfComp() != sizeof(half)) {
+      fclose(f);
+      throw Fatal("ImageFormat_half::save - image components must be half or float ('%s')",name);
+    }
+    fwrite(img->raw(),w*h*numc*sizeof(half),1,f);
+  }
   // done
   fclose(f);
 }
@@ -48,6 +48,8 @@ knowledge of the CeCILL-C license and that you accept its terms.
 // Data in row major order: 
 //   sizeof(half)*width*height*numcomp bytes
 //
+// Float images are converted to half when saved.
+//
 // ------------------------------------------------------
 // Sylvain Lefebvre - 2007-01-02
 // ------------------------------------------------------
@@ -112,7 +112,7 @@ NAMESPACE::Image *NAMESPACE::ImageFormat_pfm::load(const char *name) const
   uint  w    = 0;
   uint  h    = 0;
   uchar numc = 0;
-  static char str[1024];
+  char  str[1024];
   // identifier
   nr = fread(str,3,1,f);
   if (str[0] != 'P') {
@@ -0,0 +1,414 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Image::Resize
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "LibSL.precompiled.h"
+
+#include "Resize.h"
+
+#include <LibSL/Math/Math.h>
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RESIZE_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Image
+
+// ------------------------------------------------------
+
+static double filterSupport(NAMESPACE::e_ResizeFilter filter)
+{
+  switch (filter) {
+  case NAMESPACE::ResizeBox:      return 0.5;
+  case NAMESPACE::ResizeTriangle: return 1.0;
+  case NAMESPACE::ResizeMitchell: return 2.0;
+  case NAMESPACE::ResizeLanczos3: return 3.0;
+  }
+  return 1.0;
+}
+
+static double sinc(double x)
+{
+  if (fabs(x) < 1e-9) return 1.0;
+  x *= M_PI;
+  return sin(x) / x;
+}
+
+static double filterValue(NAMESPACE::e_ResizeFilter filter, double x)
+{
+  x = fabs(x);
+  switch (filter) {
+  case NAMESPACE::ResizeBox:
+    return x <= 0.5 ? 1.0 : 0.0;
+  case NAMESPACE::ResizeTriangle:
+    return x < 1.0 ? 1.0 - x : 0.0;
+  case NAMESPACE::ResizeMitchell: {
+    const double B = 1.0 / 3.0, C = 1.0 / 3.0;
+    if (x < 1.0) {
+      return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) / 6.0;
+    } else if (x < 2.0) {
+      return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x + (8 * B + 24 * C)) / 6.0;
+    }
+    return 0.0;
+  }
+  case NAMESPACE::ResizeLanczos3:
+    return x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+  }
+  return 0.0;
+}
+
+// ------------------------------------------------------
+
+NAMESPACE::ResizeWeights::ResizeWeights(uint srcSize, uint dstSize, e_ResizeFilter filter)
+{
+  if (srcSize == 0 || dstSize == 0) {
+    throw LibSL::Errors::Fatal("ResizeWeights - invalid size (%d -> %d)", srcSize, dstSize);
+  }
+  double scale   = double(dstSize) / double(srcSize);
+  // when downscaling, the filter covers the footprint of an output sample
+  double stretch = scale < 1.0 ? 1.0 / scale : 1.0;
+  double support = filterSupport(filter) * stretch;
+  // gather the (clamped) contributions of every output sample
+  std::vector<std::vector<double> > contribs(dstSize);
+  std::vector<int>                  firsts(dstSize);
+  uint maxTaps = 1;
+  ForIndex(i, dstSize) {
+    double center = (i + 0.5) / scale - 0.5;
+    int    j0     = int(ceil(center - support));
+    int    j1     = int(floor(center + support));
+    int    lo     = max(0, min(j0, int(srcSize) - 1));
+    int    hi     = max(0, min(j1, int(srcSize) - 1));
+    std::vector<double>& c = contribs[i];
+    c.assign(hi - lo + 1, 0.0);
+    double total = 0.0;
+    for (int j = j0; j <= j1; j++) {
+      double w = filterValue(filter, (j - center) / stretch);
+      int    k = max(0, min(j, int(srcSize) - 1));
+      c[k - lo] += w;
+      total     += w;
+    }
+    if (fabs(total) < 1e-12) {
+      // degenerate footprint (box filter falling between samples): nearest sample
+      std::fill(c.begin(), c.end(), 0.0);
+      int k = max(lo, min(hi, int(floor(center + 0.5))));
+      c[k - lo] = 1.0;
+      total     = 1.0;
+    }
+    ForIndex(k, c.size()) { c[k] /= total; }
+    // trim zero weights on both ends
+    int b = 0, e = int(c.size()) - 1;
+    while (b < e && c[b] == 0.0) b++;
+    while (e > b && c[e] == 0.0) e--;
+    c = std::vector<double>(c.begin() + b, c.begin() + e + 1);
+    firsts[i] = lo + b;
+    maxTaps   = max(maxTaps, uint(c.size()));
+  }
+  // fixed number of taps per output sample, windows kept inside the source
+  m_NumTaps = maxTaps;
+  m_First.resize(dstSize);
+  m_Weights.assign((size_t)dstSize * m_NumTaps, 0.0f);
+  ForIndex(i, dstSize) {
+    int first = min(firsts[i], int(srcSize) - int(m_NumTaps));
+    m_First[i] = first;
+    float *w = &m_Weights[(size_t)i * m_NumTaps];
+    ForIndex(k, contribs[i].size()) {
+      w[firsts[i] - first + k] = float(contribs[i][k]);
+    }
+  }
+}
+
+// ------------------------------------------------------
+// sRGB transfer functions
+// ------------------------------------------------------
+
+static inline float srgbToLinear(float v)
+{
+  return v <= 0.04045f ? v / 12.92f : pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+static inline float linearToSrgb(float v)
+{
+  return v <= 0.0031308f ? v * 12.92f : 1.055f * pow(v, 1.0f / 2.4f) - 0.055f;
+}
+
+// Lookup tables for 8 bits components
+class ResizeTables
+{
+public:
+  enum { e_EncodeSize = 1 << 16 };
+  float              toFloat[256];      // identity, as float
+  float              srgbToLinear[256]; // sRGB -> linear, in [0,255]
+  std::vector<uchar> linearToSrgb;      // linear in [0,255], quantized on 16 bits -> sRGB
+  ResizeTables()
+  {
+    ForIndex(v, 256) {
+      toFloat[v]      = float(v);
+      srgbToLinear[v] = ::srgbToLinear(v / 255.0f) * 255.0f;
+    }
+    linearToSrgb.resize(e_EncodeSize);
+    ForIndex(n, e_EncodeSize) {
+      float s = ::linearToSrgb(n / float(e_EncodeSize - 1)) * 255.0f + 0.5f;
+      linearToSrgb[n] = uchar(max(0.0f, min(255.0f, s)));
+    }
+  }
+  static const ResizeTables& get()
+  {
+    static ResizeTables tables;
+    return tables;
+  }
+};
+
+// ------------------------------------------------------
+// Kernels
+// ------------------------------------------------------
+
+// Horizontal pass: dst[x*nc+c] = sum_t w(x,t) src[(first(x)+t)*nc+c]
+static void resampleRow(const float *src, float *dst, uint nc, const NAMESPACE::ResizeWeights& wx)
+{
+  const uint taps = wx.numTaps();
+  const uint dw   = wx.dstSize();
+#ifdef RESIZE_SSE2
+  if (nc == 4) {
+    ForIndex(x, dw) {
+      const float *w = wx.weights(x);
+      const float *s = src + (size_t)wx.first(x) * 4;
+      __m128 acc = _mm_setzero_ps();
+      ForIndex(t, taps) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[t]), _mm_loadu_ps(s + t * 4)));
+      }
+      _mm_storeu_ps(dst + (size_t)x * 4, acc);
+    }
+    return;
+  }
+#endif
+  ForIndex(x, dw) {
+    const float *w = wx.weights(x);
+    const float *s = src + (size_t)wx.first(x) * nc;
+    float       *d = dst + (size_t)x * nc;
+    ForIndex(c, nc) { d[c] = 0.0f; }
+    ForIndex(t, taps) {
+      ForIndex(c, nc) { d[c] += w[t] * s[t * nc + c]; }
+    }
+  }
+}
+
+// Vertical pass: dst[k] = sum_t w[t] rows[t][k], for k < n
+static void blendRows(const float * const *rows, const float *w, uint taps, float *dst, size_t n)
+{
+  size_t k = 0;
+#ifdef RESIZE_SSE2
+  for (; k + 8 <= n; k += 8) {
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    ForIndex(t, taps) {
+      __m128 wt = _mm_set1_ps(w[t]);
+      a0 = _mm_add_ps(a0, _mm_mul_ps(wt, _mm_loadu_ps(rows[t] + k)));
+      a1 = _mm_add_ps(a1, _mm_mul_ps(wt, _mm_loadu_ps(rows[t] + k + 4)));
+    }
+    _mm_storeu_ps(dst + k, a0);
+    _mm_storeu_ps(dst + k + 4, a1);
+  }
+#endif
+  for (; k < n; k++) {
+    float a = 0.0f;
+    ForIndex(t, taps) { a += w[t] * rows[t][k]; }
+    dst[k] = a;
+  }
+}
+
+// Rounds and clamps n floats to [0,255]
+static void storeBytes(const float *src, uchar *dst, size_t n)
+{
+  size_t k = 0;
+#ifdef RESIZE_SSE2
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (; k + 16 <= n; k += 16) {
+    __m128i i0 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(src + k     ), half));
+    __m128i i1 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(src + k +  4), half));
+    __m128i i2 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(src + k +  8), half));
+    __m128i i3 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(src + k + 12), half));
+    // saturating packs clamp to [0,255] (values below -0.5 truncate to negative and saturate to 0)
+    __m128i s  = _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + k), s);
+  }
+#endif
+  for (; k < n; k++) {
+    float v = src[k] + 0.5f;
+    dst[k]  = v <= 0.0f ? 0 : (v >= 255.0f ? 255 : uchar(v));
+  }
+}
+
+// Which components are gamma encoded in srgb mode
+static inline bool isColorComponent(uint c, uint nc)
+{
+  return !((nc == 2 || nc == 4) && c == nc - 1);
+}
+
+// ------------------------------------------------------
+
+// Generic two pass resampling, T_Load loads a source row as floats
+// and T_Store writes a resampled row of floats to the destination
+template <class T_Load, class T_Store>
+static void resampleImage(uint sw, uint sh, uint dw, uint dh, uint nc, NAMESPACE::e_ResizeFilter filter,
+                          const T_Load& load, const T_Store& store)
+{
+  using namespace LibSL::System;
+  NAMESPACE::ResizeWeights wx(sw, dw, filter);
+  NAMESPACE::ResizeWeights wy(sh, dh, filter);
+  const size_t srcRow = (size_t)sw * nc;
+  const size_t dstRow = (size_t)dw * nc;
+  // horizontal pass on all source rows
+  std::vector<float> tmp((size_t)sh * dstRow);
+  Parallel::forChunks(0, int(sh), [&](int j0, int j1) {
+    std::vector<float> row(srcRow);
+    ForRange(j, j0, j1 - 1) {
+      load(uint(j), &row[0]);
+      resampleRow(&row[0], &tmp[(size_t)j * dstRow], nc, wx);
+    }
+  }, 8);
+  // vertical pass
+  const uint taps = wy.numTaps();
+  Parallel::forChunks(0, int(dh), [&](int j0, int j1) {
+    std::vector<float>         out(dstRow);
+    std::vector<const float *> rows(taps);
+    ForRange(j, j0, j1 - 1) {
+      ForIndex(t, taps) { rows[t] = &tmp[(size_t)(wy.first(j) + t) * dstRow]; }
+      blendRows(&rows[0], wy.weights(j), taps, &out[0], dstRow);
+      store(uint(j), &out[0]);
+    }
+  }, 8);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::resizeRaw(const uchar *src, uint sw, uint sh, uchar *dst, uint dw, uint dh,
+                          uint numComp, e_ResizeFilter filter, bool srgb)
+{
+  if (sw == 0 || sh == 0 || dw == 0 || dh == 0 || numComp == 0) {
+    throw LibSL::Errors::Fatal("resizeRaw - invalid size (%d x %d x %d) -> (%d x %d)", sw, sh, numComp, dw, dh);
+  }
+  const ResizeTables& tables = ResizeTables::get();
+  const uint nc = numComp;
+  if (!srgb) {
+    resampleImage(sw, sh, dw, dh, nc, filter,
+      [&](uint j, float *row) {
+        const uchar *s = src + (size_t)j * sw * nc;
+        ForIndex(k, (size_t)sw * nc) { row[k] = tables.toFloat[s[k]]; }
+      },
+      [&](uint j, const float *row) {
+        storeBytes(row, dst + (size_t)j * dw * nc, (size_t)dw * nc);
+      });
+  } else {
+    const float encodeScale = float(ResizeTables::e_EncodeSize - 1) / 255.0f;
+    resampleImage(sw, sh, dw, dh, nc, filter,
+      [&](uint j, float *row) {
+        const uchar *s = src + (size_t)j * sw * nc;
+        ForIndex(x, sw) {
+          ForIndex(c, nc) {
+            uchar v = s[x * nc + c];
+            row[x * nc + c] = isColorComponent(c, nc) ? tables.srgbToLinear[v] : tables.toFloat[v];
+          }
+        }
+      },
+      [&](uint j, const float *row) {
+        uchar *d = dst + (size_t)j * dw * nc;
+        ForIndex(x, dw) {
+          ForIndex(c, nc) {
+            float v = row[x * nc + c];
+            if (isColorComponent(c, nc)) {
+              int q = int(v * encodeScale + 0.5f);
+              d[x * nc + c] = tables.linearToSrgb[max(0, min(int(ResizeTables::e_EncodeSize) - 1, q))];
+            } else {
+              v += 0.5f;
+              d[x * nc + c] = v <= 0.0f ? 0 : (v >= 255.0f ? 255 : uchar(v));
+            }
+          }
+        }
+      });
+  }
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::resizeRaw(const float *src, uint sw, uint sh, float *dst, uint dw, uint dh,
+                          uint numComp, e_ResizeFilter filter, bool srgb)
+{
+  if (sw == 0 || sh == 0 || dw == 0 || dh == 0 || numComp == 0) {
+    throw LibSL::Errors::Fatal("resizeRaw - invalid size (%d x %d x %d) -> (%d x %d)", sw, sh, numComp, dw, dh);
+  }
+  const uint nc = numComp;
+  resampleImage(sw, sh, dw, dh, nc, filter,
+    [&](uint j, float *row) {
+      const float *s = src + (size_t)j * sw * nc;
+      if (srgb) {
+        ForIndex(x, sw) {
+          ForIndex(c, nc) {
+            float v = s[x * nc + c];
+            row[x * nc + c] = isColorComponent(c, nc) ? srgbToLinear(v) : v;
+          }
+        }
+      } else {
+        std::copy(s, s + (size_t)sw * nc, row);
+      }
+    },
+    [&](uint j, const float *row) {
+      float *d = dst + (size_t)j * dw * nc;
+      if (srgb) {
+        ForIndex(x, dw) {
+          ForIndex(c, nc) {
+            float v = row[x * nc + c];
+            d[x * nc + c] = isColorComponent(c, nc) ? linearToSrgb(max(0.0f, v)) : v;
+          }
+        }
+      } else {
+        std::copy(row, row + (size_t)dw * nc, d);
+      }
+    });
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,153 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Image::Resize
+// ------------------------------------------------------
+//
+// Separable image resampling
+//
+// Arbitrary scale factors along each axis. Every axis uses
+// a table of weights with a fixed number of taps per output
+// sample, built once and shared by all rows (or columns).
+// When downscaling the filter is stretched to the source
+// footprint of an output sample. Borders are clamped.
+//
+// uchar and float components have dedicated SSE kernels,
+// other component types are resampled through floats.
+// Rows are processed in parallel (see System/Parallel.h).
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/LibSL.common.h>
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/Image/Image.h>
+#include <LibSL/System/Types.h>
+
+#include <vector>
+#include <limits>
+#include <cmath>
+
+namespace LibSL {
+  namespace Image {
+
+    //! Reconstruction filters
+    enum e_ResizeFilter {
+      ResizeBox,       //!< box, support 0.5
+      ResizeTriangle,  //!< tent, support 1
+      ResizeMitchell,  //!< Mitchell-Netravali B=C=1/3, support 2
+      ResizeLanczos3   //!< windowed sinc, support 3
+    };
+
+    //! Weights of a 1D resampling from srcSize to dstSize samples
+    //! output sample i = sum_t weight(i,t) * input[first(i)+t], t < numTaps()
+    //! first(i)+numTaps() never exceeds srcSize, weights of a sample sum to one
+    class LIBSL_DLL ResizeWeights
+    {
+    private:
+      uint               m_NumTaps;
+      std::vector<int>   m_First;
+      std::vector<float> m_Weights;
+    public:
+      ResizeWeights(uint srcSize, uint dstSize, e_ResizeFilter filter);
+
+      uint         numTaps()        const { return m_NumTaps; }
+      uint         dstSize()        const { return (uint)m_First.size(); }
+      int          first(uint i)    const { return m_First[i]; }
+      const float *weights(uint i)  const { return &m_Weights[(size_t)i * m_NumTaps]; }
+    };
+
+    //! Resizes an image of sw x sh pixels with numComp components into dw x dh
+    //! srgb:  components are sRGB encoded and filtered in linear space (alpha excepted:
+    //!        the last component of 2 and 4 components images is left linear)
+    LIBSL_DLL void resizeRaw(const uchar *src, uint sw, uint sh, uchar *dst, uint dw, uint dh,
+                             uint numComp, e_ResizeFilter filter = ResizeLanczos3, bool srgb = false);
+    LIBSL_DLL void resizeRaw(const float *src, uint sw, uint sh, float *dst, uint dw, uint dh,
+                             uint numComp, e_ResizeFilter filter = ResizeLanczos3, bool srgb = false);
+
+    //! Converts a filtered value back to a component, integral types are rounded and clamped
+    //! (filters with negative lobes overshoot the input range)
+    template <typename T_Type, bool T_Integer = std::numeric_limits<T_Type>::is_integer>
+    struct ResizeStore
+    {
+      static T_Type convert(float f) { return T_Type(f); }
+    };
+
+    template <typename T_Type>
+    struct ResizeStore<T_Type, true>
+    {
+      static T_Type convert(float f)
+      {
+        double r = floor(double(f) + 0.5);
+        if (r < double(std::numeric_limits<T_Type>::min())) return std::numeric_limits<T_Type>::min();
+        if (r > double(std::numeric_limits<T_Type>::max())) return std::numeric_limits<T_Type>::max();
+        return T_Type(r);
+      }
+    };
+
+    //! Other component types go through floats
+    template <typename T_Type>
+    void resizeRaw(const T_Type *src, uint sw, uint sh, T_Type *dst, uint dw, uint dh,
+                   uint numComp, e_ResizeFilter filter = ResizeLanczos3, bool srgb = false)
+    {
+      std::vector<float> fsrc((size_t)sw * sh * numComp), fdst((size_t)dw * dh * numComp);
+      for (size_t n = 0; n < fsrc.size(); n++) { fsrc[n] = float(src[n]); }
+      resizeRaw(fsrc.empty() ? NULL : &fsrc[0], sw, sh, fdst.empty() ? NULL : &fdst[0], dw, dh, numComp, filter, srgb);
+      for (size_t n = 0; n < fdst.size(); n++) { dst[n] = ResizeStore<T_Type>::convert(fdst[n]); }
+    }
+
+    //! Returns a new image of size w x h
+    template <class T_Image>
+    T_Image *resize(const T_Image *img, uint w, uint h, e_ResizeFilter filter = ResizeLanczos3, bool srgb = false)
+    {
+      sl_assert(img != NULL);
+      if (w == 0 || h == 0 || img->w() == 0 || img->h() == 0) {
+        throw LibSL::Errors::Fatal("resize - invalid size (%d x %d) -> (%d x %d)", img->w(), img->h(), w, h);
+      }
+      T_Image *res = new T_Image(w, h);
+      resizeRaw(reinterpret_cast<const typename T_Image::t_Component *>(img->pixels().raw()), img->w(), img->h(),
+                reinterpret_cast<typename T_Image::t_Component *>(res->pixels().raw()), w, h,
+                T_Image::e_NumComp, filter, srgb);
+      return res;
+    }
+
+  } //namespace LibSL::Image
+} //namespace LibSL
+
+// ------------------------------------------------------
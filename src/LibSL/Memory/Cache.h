@@ -57,6 +57,7 @@ using namespace LibSL::System::Types;
 
 #include <list>
 #include <map>
+#include <iostream>
 
 // ------------------------------------------------------
 
@@ -109,7 +110,7 @@ namespace LibSL  {
           m_NumMiss ++; 
           return (false); 
         }
-        t_CacheData::iterator C = m_CacheData.find(a);
+        typename t_CacheData::iterator C = m_CacheData.find(a);
         if (C == m_CacheData.end()) {
           // miss
           m_NumMiss ++;
@@ -118,7 +119,7 @@ namespace LibSL  {
           // get value
           _value                = &((*C).second.m_Value);
           // update pos in LRU
-          t_LRU::iterator li    = (*C).second.m_LRUPos;
+          typename t_LRU::iterator li = (*C).second.m_LRUPos;
           m_LRU.splice(m_LRU.begin(), m_LRU, li);
           return (true);
         }
@@ -134,7 +135,7 @@ namespace LibSL  {
         Cached c;
         c.m_Value      = d;
         c.m_LRUPos     = m_LRU.begin();
-        m_CacheData    .insert(make_pair(a,c));
+        m_CacheData    .insert(std::make_pair(a,c));
         if (m_CacheData.size() > m_Size) {
           // supress oldest one
           m_NumDel ++;
@@ -166,9 +167,9 @@ namespace LibSL  {
       void printStats() 
       {
         if (m_Enabled) {
-          cout << sprint("(size: %d nodes): %d requests, %d misses, %d deletions \n",m_Size,m_NumReq,m_NumMiss,m_NumDel);
+          std::cout << LibSL::CppHelpers::sprint("(size: %d nodes): %d requests, %d misses, %d deletions \n",m_Size,m_NumReq,m_NumMiss,m_NumDel);
         } else {
-          cout << sprint("!!DISABLED!! Cache stats (size: %d nodes): (%d requests)\n",m_Size,m_NumReq);
+          std::cout << LibSL::CppHelpers::sprint("!!DISABLED!! Cache stats (size: %d nodes): (%d requests)\n",m_Size,m_NumReq);
         }
       }
 
@@ -51,6 +51,8 @@ using namespace LibSL::CppHelpers;
 using namespace LibSL::StlHelpers;
 #include <LibSL/DataStructures/OccupancyMap.h>
 using namespace LibSL::DataStructures;
+#include <LibSL/System/Parallel.h>
+using namespace LibSL::System;
 
 //---------------------------------------------------------------------------
 
@@ -58,6 +60,11 @@ using namespace LibSL::DataStructures;
 #include <cfloat>
 #include <set>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESH_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 //---------------------------------------------------------------------------
@@ -159,28 +166,209 @@ void NAMESPACE::saveTriangleMesh(const char *fname,const NAMESPACE::TriangleMesh
   manager.getPlugin(pos+1)->save(fname,mesh);
 }
 
+//---------------------------------------------------------------------------
+
+NAMESPACE::TriangleSoupReader *NAMESPACE::openTriangleSoup(const char *fname)
+{
+  NAMESPACE::TriangleMeshFormatManager&
+    manager=(*NAMESPACE::TriangleMeshFormatManager::getUniqueInstance());
+  const char *pos=strrchr(fname,'.');
+  if (pos == NULL) {
+    LIBSL_FATAL_ERROR_WITH_ARGS("TriangleMesh - Cannot determine file type ('%s')",fname);
+  }
+  return (manager.getPlugin(pos+1)->openSoup(fname));
+}
+
+//---------------------------------------------------------------------------
+
+uint NAMESPACE::TriangleSoupReader_mesh::read(std::vector<v3f>& _corners,uint maxTriangles)
+{
+  uint n = Math::min(maxTriangles,m_Mesh->numTriangles() - m_Next);
+  _corners.resize(size_t(n) * 3);
+  ForIndex(t,n) {
+    const TriangleMesh::t_Triangle& tri = m_Mesh->triangleAt(m_Next + t);
+    ForIndex(c,3) {
+      _corners[t * 3 + c] = m_Mesh->posAt(tri[c]);
+    }
+  }
+  m_Next += n;
+  return n;
+}
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
-AABox NAMESPACE::TriangleMesh::computeBBox()
+namespace {
+
+  // vertices per parallel block in position kernels
+  const uint c_PositionBlock = 1u << 14;
+
+#ifdef MESH_SSE2
+  // loads / stores a v3f as (x,y,z,0) without touching the next float
+  inline __m128 loadPos(const uchar *p)
+  {
+    return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(),(const __m64*)p),_mm_load_ss((const float*)p + 2));
+  }
+  inline void storePos(uchar *p,__m128 v)
+  {
+    _mm_storel_pi((__m64*)p,v);
+    _mm_store_ss ((float*)p + 2,_mm_movehl_ps(v,v));
+  }
+#endif
+
+  // grows [_mn,_mx] with n positions, stride bytes apart (NaN are ignored)
+  void bboxKernel(const uchar *p,uint stride,uint n,v3f& _mn,v3f& _mx)
+  {
+#ifdef MESH_SSE2
+    __m128 mn = _mm_setr_ps(_mn[0],_mn[1],_mn[2],0.0f);
+    __m128 mx = _mm_setr_ps(_mx[0],_mx[1],_mx[2],0.0f);
+    for (uint i = 0 ; i < n ; i++, p += stride) {
+      __m128 v = loadPos(p);
+      mn = _mm_min_ps(v,mn);
+      mx = _mm_max_ps(v,mx);
+    }
+    float r[4];
+    _mm_storeu_ps(r,mn); ForIndex(c,3) { _mn[c] = r[c]; }
+    _mm_storeu_ps(r,mx); ForIndex(c,3) { _mx[c] = r[c]; }
+#else
+    for (uint i = 0 ; i < n ; i++, p += stride) {
+      const float *v = (const float*)p;
+      ForIndex(c,3) {
+        if (v[c] < _mn[c]) _mn[c] = v[c];
+        if (v[c] > _mx[c]) _mx[c] = v[c];
+      }
+    }
+#endif
+  }
+
+  // p = trsf.mulPoint(p) on n positions, stride bytes apart
+  void transformKernel(uchar *p,uint stride,uint n,const m4x4f& trsf)
+  {
+#ifdef MESH_SSE2
+    __m128 c0 = _mm_setr_ps(trsf.at(0,0),trsf.at(0,1),trsf.at(0,2),0.0f);
+    __m128 c1 = _mm_setr_ps(trsf.at(1,0),trsf.at(1,1),trsf.at(1,2),0.0f);
+    __m128 c2 = _mm_setr_ps(trsf.at(2,0),trsf.at(2,1),trsf.at(2,2),0.0f);
+    __m128 c3 = _mm_setr_ps(trsf.at(3,0),trsf.at(3,1),trsf.at(3,2),0.0f);
+    for (uint i = 0 ; i < n ; i++, p += stride) {
+      __m128 v = loadPos(p);
+      __m128 r =            _mm_mul_ps(c0,_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,0)));
+      r        = _mm_add_ps(r,_mm_mul_ps(c1,_mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,1,1))));
+      r        = _mm_add_ps(r,_mm_mul_ps(c2,_mm_shuffle_ps(v,v,_MM_SHUFFLE(2,2,2,2))));
+      r        = _mm_add_ps(r,c3);
+      storePos(p,r);
+    }
+#else
+    for (uint i = 0 ; i < n ; i++, p += stride) {
+      v3f& v = *(v3f*)p;
+      v      = trsf.mulPoint(v);
+    }
+#endif
+  }
+
+  // calls f(block,first,num) on blocks of c_PositionBlock vertices, in parallel
+  template <typename T_Func>
+  void forPositionBlocks(uint numv,const T_Func& f)
+  {
+    int nb = int((numv + c_PositionBlock - 1) / c_PositionBlock);
+    Parallel::forIndex(0,nb,[&](int b) {
+      uint first = uint(b) * c_PositionBlock;
+      f(b,first,LibSL::Math::min(c_PositionBlock,numv - first));
+    });
+  }
+
+  // tri[c] = f(tri[c]) on all triangles
+  template <typename T_Func>
+  void remapIndices(NAMESPACE::TriangleMesh *mesh,const T_Func& f)
+  {
+    uint                          numv = mesh->numVertices();
+    NAMESPACE::TriangleMesh::t_Triangle *tris = mesh->indexBuffer();
+    ForIndex(t,mesh->numTriangles()) {
+      NAMESPACE::TriangleMesh::t_Triangle& tri = tris != NULL ? tris[t] : mesh->triangleAt(t);
+      ForIndex(c,3) {
+        tri[c] = f(tri[c]);
+        sl_assert(tri[c] < numv);
+      }
+    }
+  }
+
+  // copies positions in a plain array
+  void gatherPositions(const NAMESPACE::TriangleMesh *mesh,std::vector<v3f>& _pos)
+  {
+    _pos.resize(mesh->numVertices());
+    StridedView<const v3f> pos = mesh->positions();
+    if (!pos.empty()) {
+      ForIndex(v,pos.size()) { _pos[v] = pos[v]; }
+    } else {
+      ForIndex(v,_pos.size()) { _pos[v] = mesh->posAt(v); }
+    }
+  }
+
+} // namespace
+
+//---------------------------------------------------------------------------
+
+StridedView<TriangleMesh::v3> NAMESPACE::TriangleMesh::positions()
 {
-  float minx=1e20f,maxx=-1e20f;
-  float miny=1e20f,maxy=-1e20f;
-  float minz=1e20f,maxz=-1e20f;
+  StridedView<uchar> block = vertexBlock();
+  if (block.empty()) {
+    return StridedView<v3>();
+  }
+  return block.member<v3>(uint((uchar*)&posAt(0) - &block[0]));
+}
 
-  ForIndex(p,numVertices()) {
-    float x = posAt(p)[0];
-    float y = posAt(p)[1];
-    float z = posAt(p)[2];
-    if (x > maxx) maxx = x;
-    if (x < minx) minx = x;
-    if (y > maxy) maxy = y;
-    if (y < miny) miny = y;
-    if (z > maxz) maxz = z;
-    if (z < minz) minz = z;
-  }
-  AAB<3> bx(V3F(minx,miny,minz),V3F(maxx,maxy,maxz));
+StridedView<const TriangleMesh::v3> NAMESPACE::TriangleMesh::positions() const
+{
+  StridedView<const uchar> block = vertexBlock();
+  if (block.empty()) {
+    return StridedView<const v3>();
+  }
+  return block.member<const v3>(uint((const uchar*)&posAt(0) - &block[0]));
+}
+
+//---------------------------------------------------------------------------
+
+int NAMESPACE::TriangleMesh::attributeOffset(MVF::e_Binding binding,uint sizeOf) const
+{
+  if (mvf().isNull()) {
+    return -1;
+  }
+  const MVF::Attribute *a = mvf()->findAttributeByBinding(binding);
+  if (a == NULL) {
+    return -1;
+  }
+  if (uint(a->size_of) != sizeOf) {
+    throw Fatal("TriangleMesh::attribute - attribute size (%d) does not match view type size (%d)",a->size_of,sizeOf);
+  }
+  return a->offset;
+}
+
+//---------------------------------------------------------------------------
+
+AABox NAMESPACE::TriangleMesh::computeBBox()
+{
+  v3f mn = v3f( 1e20f);
+  v3f mx = v3f(-1e20f);
+
+  StridedView<const v3> pos = static_cast<const TriangleMesh*>(this)->positions();
+  if (!pos.empty()) {
+    uint nb = (pos.size() + c_PositionBlock - 1) / c_PositionBlock;
+    std::vector<v3f> bmn(nb,mn),bmx(nb,mx);
+    forPositionBlocks(pos.size(),[&](int b,uint first,uint num) {
+      bboxKernel((const uchar*)&pos[first],pos.stride(),num,bmn[b],bmx[b]);
+    });
+    ForIndex(b,nb) {
+      ForIndex(c,3) {
+        mn[c] = Math::min(mn[c],bmn[b][c]);
+        mx[c] = Math::max(mx[c],bmx[b][c]);
+      }
+    }
+  } else {
+    ForIndex(p,numVertices()) {
+      bboxKernel((const uchar*)&posAt(p),0,1,mn,mx);
+    }
+  }
+  AAB<3> bx(mn,mx);
   m_BBox         = bx;
   m_BBoxComputed = true;
   return (bx);
@@ -210,8 +398,15 @@ void NAMESPACE::TriangleMesh::scaleToUnitCube(float scale,bool center)
 
 void NAMESPACE::TriangleMesh::applyTransform(const m4x4f& trsf)
 {
-  ForIndex(p,numVertices()) {
-    posAt(p) = trsf.mulPoint( posAt(p) );
+  StridedView<v3> pos = positions();
+  if (!pos.empty()) {
+    forPositionBlocks(pos.size(),[&](int,uint first,uint num) {
+      transformKernel((uchar*)&pos[first],pos.stride(),num,trsf);
+    });
+  } else {
+    ForIndex(p,numVertices()) {
+      transformKernel((uchar*)&posAt(p),0,1,trsf);
+    }
   }
   m_BBoxComputed = false;
 }
@@ -251,9 +446,12 @@ void NAMESPACE::TriangleMesh::mergeVertices(float radius,uint gridsz)
   if (ex[0] == M) dM = V3F(1,0,0);
   if (ex[1] == M) dM = V3F(0,1,0);
   if (ex[2] == M) dM = V3F(0,0,1);
+  std::vector<v3f> pos;
+  gatherPositions(this,pos);
   vector< pair<float,int> > allverts;
+  allverts.reserve(numv);
   ForIndex(v,numv) {
-    allverts.push_back( make_pair( dot(posAt(v),dM) , v ) );
+    allverts.push_back( make_pair( dot(pos[v],dM) , v ) );
   }
   sort(allverts.begin(),allverts.end());
 
@@ -270,13 +468,13 @@ void NAMESPACE::TriangleMesh::mergeVertices(float radius,uint gridsz)
   ForIndex(v,numv) {
     Console::progressTextUpdate();
     int pA    = allverts[v].second;
-    v3  posA  = posAt(merged[pA]);
+    v3  posA  = pos[merged[pA]];
     // advance left of comparison window
-    while (left < numv-1 && dot(posAt( allverts[left].second ),dM) < dot(posA,dM)-radius) {
+    while (left < numv-1 && dot(pos[ allverts[left].second ],dM) < dot(posA,dM)-radius) {
       left ++;
     }
-    // advance right of comparison window
-    while (right< numv-1 && dot(posAt( allverts[right].second ),dM) < dot(posA,dM)+radius) {
+    // advance right of comparison window (past equal values: radius may be below float precision)
+    while (right< numv-1 && dot(pos[ allverts[right].second ],dM) <= dot(posA,dM)+radius) {
       right ++;
     }
     avg_wnd_sz += (right - left) + 1;
@@ -285,8 +483,8 @@ void NAMESPACE::TriangleMesh::mergeVertices(float radius,uint gridsz)
     // for each within window, test
     ForRange(i,left,right) {
       int idx = allverts[i].second;
-      float dist = sqLength(posA - posAt(merged[idx]));
-      if (dist < radius*radius) {
+      float dist = sqLength(posA - pos[merged[idx]]);
+      if (dist <= radius*radius) { // radius 0 welds exact duplicates
         // always keep the first vertex found (hence the min)
         merged[idx] = Math::min(pA,merged[idx]);
       }
@@ -313,13 +511,7 @@ void NAMESPACE::TriangleMesh::mergeVertices(float radius,uint gridsz)
   reorderVerticesAndTruncate(order);
 
   // update triangles
-  ForIndex(t,numTriangles()) {
-    t_Triangle& tri = triangleAt(t);
-    ForIndex(c,3) {
-      tri[c]  = rank[merged[tri[c]]];
-      sl_assert(tri[c] < numVertices());
-    }
-  }
+  remapIndices(this,[&](uint v) { return rank[merged[v]]; });
 
 }
 
@@ -330,9 +522,12 @@ void NAMESPACE::TriangleMesh::mergeVerticesExact()
   int        numv = (int)numVertices();
 
   // sort along longest bbox direction
+  std::vector<v3f> pos;
+  gatherPositions(this, pos);
   vector< pair<v3f, int> > allverts;
+  allverts.reserve(numv);
   ForIndex(v, numv) {
-    allverts.push_back(make_pair(posAt(v), v));
+    allverts.push_back(make_pair(pos[v], v));
   }
   sort(allverts.begin(), allverts.end());
 
@@ -359,13 +554,7 @@ void NAMESPACE::TriangleMesh::mergeVerticesExact()
   cerr << "before: " << numv << " after: " << i+1 << endl;
 
   // update triangles
-  ForIndex(t, numTriangles()) {
-    t_Triangle& tri = triangleAt(t);
-    ForIndex(c, 3) {
-      tri[c] = newindex[tri[c]];
-      sl_assert(tri[c] < numVertices());
-    }
-  }
+  remapIndices(this, [&](uint v) { return newindex[v]; });
 
 }
 
@@ -373,25 +562,39 @@ void NAMESPACE::TriangleMesh::mergeVerticesExact()
 
 void NAMESPACE::TriangleMesh::swapAxes(const char swizzle[3])
 {
-  ForIndex(n,numVertices()) {
-    v3f p = posAt(n);
+  int dest[3];
+  int sign[3];
+  ForIndex(a,3) {
+    dest[a] = 0;
+    sign[a] = 1;
+    if (swizzle[a] >= 'X' && swizzle[a] <= 'Z') {
+      sign[a] = -1;
+      dest[a] = swizzle[a] - 'X';
+    } else if (swizzle[a] >= 'x' && swizzle[a] <= 'z') {
+      sign[a] = 1;
+      dest[a] = swizzle[a] - 'x';
+    } else {
+      sl_assert(false); // swizzle error
+    }
+  }
+  auto swizzlePos = [&](v3f& p) {
     v3f s = 0;
     ForIndex(a,3) {
-      int dest = 0;
-      int sign = 1;
-      if (swizzle[a] >= 'X' && swizzle[a] <= 'Z') {
-        sign = -1;
-        dest = swizzle[a] - 'X';
-      } else if (swizzle[a] >= 'x' && swizzle[a] <= 'z') {
-        sign = 1;
-        dest = swizzle[a] - 'x';
-      } else {
-        sl_assert(false); // swizzle error
-      }
-      s[dest] = sign * p[a];
+      s[dest[a]] = sign[a] * p[a];
+    }
+    p = s;
+  };
+  StridedView<v3> pos = positions();
+  if (!pos.empty()) {
+    forPositionBlocks(pos.size(),[&](int,uint first,uint num) {
+      ForRange(n,first,first + num - 1) { swizzlePos(pos[n]); }
+    });
+  } else {
+    ForIndex(n,numVertices()) {
+      swizzlePos(posAt(n));
     }
-    posAt(n) = s;
   }
+  m_BBoxComputed = false;
 }
 
 //---------------------------------------------------------------------------
@@ -399,12 +602,33 @@ void NAMESPACE::TriangleMesh::swapAxes(const char swizzle[3])
 TriangleMesh *NAMESPACE::TriangleMesh::clone() const
 {
   TriangleMesh *newmesh = newInstance();
-  newmesh->allocate(numVertices(),numTriangles());
-  ForIndex(v,numVertices()) {
-    memcpy(newmesh->vertexDataAt(v),vertexDataAt(v),sizeOfVertexData());
+  if (!mvf().isNull()) {
+    newmesh->setMvf(mvf());
   }
-  ForIndex(t,numTriangles()) {
-    newmesh->triangleAt(t) = triangleAt(t);
+  newmesh->allocate(numVertices(),numTriangles(),numSurfaces());
+  // vertices, as a single block when both sides are stored contiguously
+  StridedView<const uchar> src = vertexBlock();
+  StridedView<uchar>       dst = newmesh->vertexBlock();
+  uint                     szv = sizeOfVertexData();
+  if (!src.empty() && !dst.empty() && src.stride() == szv && dst.stride() == szv) {
+    memcpy(&dst[0],&src[0],size_t(numVertices()) * szv);
+  } else {
+    ForIndex(v,numVertices()) {
+      memcpy(newmesh->vertexDataAt(v),vertexDataAt(v),szv);
+    }
+  }
+  // triangles
+  const t_Triangle *srct = indexBuffer();
+  t_Triangle       *dstt = newmesh->indexBuffer();
+  if (srct != NULL && dstt != NULL) {
+    std::copy(srct,srct + numTriangles(),dstt);
+  } else {
+    ForIndex(t,numTriangles()) {
+      newmesh->triangleAt(t) = triangleAt(t);
+    }
+  }
+  ForIndex(s,numSurfaces()) {
+    newmesh->surfaceAt(s) = surfaceAt(s);
   }
   return (newmesh);
 }
@@ -513,3 +737,407 @@ void NAMESPACE::TriangleMesh::reorientTriangles()
 }
 
 //---------------------------------------------------------------------------
+
+namespace {
+
+  const uint c_MaxCacheSize     = 64;
+  const uint c_MaxValenceScore  = 32;
+  const uint c_FetchLineSize    = 64;
+  const uint c_FetchCacheLines  = 64;
+
+  // FIFO cache simulation, returns true on a miss
+  class FifoCache
+  {
+  public:
+    std::vector<uint> m_Time;   // per entry, time it entered the cache (0: never)
+    uint              m_Size;
+    uint              m_Now;
+    FifoCache(uint n,uint size) : m_Time(n,0), m_Size(size), m_Now(size + 1) { }
+    void reset()        { m_Now += m_Size + 1; }
+    bool access(uint v)
+    {
+      if (m_Now - m_Time[v] <= m_Size) {
+        return false;
+      }
+      m_Time[v] = ++m_Now;
+      return true;
+    }
+  };
+
+  // triangles of the mesh grouped by surface, leftovers last
+  void groupBySurface(const NAMESPACE::TriangleMesh *mesh,vector<vector<uint> >& _groups)
+  {
+    Array<bool> assigned(mesh->numTriangles());
+    assigned.fill(false);
+    _groups.clear();
+    ForIndex(s,mesh->numSurfaces()) {
+      _groups.push_back(vector<uint>());
+      ForIndex(i,mesh->surfaceNumTriangles(s)) {
+        uint t = mesh->surfaceTriangleIdAt(s,i);
+        if (!assigned[t]) {
+          assigned[t] = true;
+          _groups.back().push_back(t);
+        }
+      }
+    }
+    _groups.push_back(vector<uint>());
+    ForIndex(t,mesh->numTriangles()) {
+      if (!assigned[t]) {
+        _groups.back().push_back(t);
+      }
+    }
+  }
+
+  // applies a new triangle order (order[n] = old index of triangle n), updates surfaces
+  void reorderTriangles(NAMESPACE::TriangleMesh *mesh,const vector<uint>& order)
+  {
+    sl_assert(order.size() == mesh->numTriangles());
+    vector<NAMESPACE::TriangleMesh::t_Triangle> tris(order.size());
+    Array<uint>                                 rank(uint(order.size()));
+    ForIndex(n,order.size()) {
+      tris[n]         = mesh->triangleAt(order[n]);
+      rank[order[n]]  = n;
+    }
+    ForIndex(n,order.size()) {
+      mesh->triangleAt(n) = tris[n];
+    }
+    ForIndex(s,mesh->numSurfaces()) {
+      Array<uint>& ids = mesh->surfaceAt(s).triangleIds;
+      ForArray(ids,i) {
+        ids[i] = rank[ids[i]];
+      }
+      sort(ids.begin(),ids.end());
+    }
+  }
+
+  // Forsyth's linear-speed vertex cache optimization on a group of triangles
+  class ForsythOptimizer
+  {
+  public:
+
+    const NAMESPACE::TriangleMesh *m_Mesh;
+    uint                           m_CacheSize;
+    float                          m_CacheScore  [c_MaxCacheSize + 3];
+    float                          m_ValenceScore[c_MaxValenceScore];
+    // per vertex (global)
+    vector<uint>                   m_First;     // vertex -> triangles (CSR)
+    vector<uint>                   m_List;
+    vector<uint>                   m_Remaining; // triangles left to emit in the current group
+    vector<int>                    m_CachePos;
+    vector<float>                  m_Score;
+    // per triangle (global)
+    vector<uint>                   m_Group;
+    vector<char>                   m_Emitted;
+    vector<float>                  m_TriScore;
+
+    ForsythOptimizer(const NAMESPACE::TriangleMesh *mesh,uint cacheSize,const vector<vector<uint> >& groups)
+      : m_Mesh(mesh), m_CacheSize(LibSL::Math::clamp(cacheSize,4u,c_MaxCacheSize))
+    {
+      ForIndex(p,m_CacheSize + 3) {
+        if (p < 3) {
+          m_CacheScore[p] = 0.75f;
+        } else if (uint(p) < m_CacheSize) {
+          m_CacheScore[p] = powf(1.0f - float(p - 3) / float(m_CacheSize - 3),1.5f);
+        } else {
+          m_CacheScore[p] = 0.0f;
+        }
+      }
+      ForIndex(r,c_MaxValenceScore) {
+        m_ValenceScore[r] = r == 0 ? 0.0f : 2.0f / sqrtf(float(r));
+      }
+      uint nv = mesh->numVertices();
+      uint nt = mesh->numTriangles();
+      m_First.assign(nv + 1,0);
+      ForIndex(t,nt) { ForIndex(c,3) { m_First[mesh->triangleAt(t)[c] + 1] ++; } }
+      ForIndex(v,nv) { m_First[v + 1] += m_First[v]; }
+      m_List.resize(m_First[nv]);
+      vector<uint> fill(m_First.begin(),m_First.end() - 1);
+      ForIndex(t,nt) { ForIndex(c,3) { m_List[fill[mesh->triangleAt(t)[c]] ++] = t; } }
+      m_Remaining.assign(nv,0);
+      m_CachePos .assign(nv,-1);
+      m_Score    .assign(nv,0.0f);
+      m_Group    .assign(nt,0);
+      m_Emitted  .assign(nt,0);
+      m_TriScore .assign(nt,0.0f);
+      ForIndex(g,groups.size()) {
+        ForIndex(i,groups[g].size()) {
+          m_Group[groups[g][i]] = g;
+        }
+      }
+    }
+
+    float vertexScore(uint v) const
+    {
+      if (m_Remaining[v] == 0) {
+        return -1.0f;
+      }
+      float s = m_CachePos[v] < 0 ? 0.0f : m_CacheScore[m_CachePos[v]];
+      return s + m_ValenceScore[min(m_Remaining[v],c_MaxValenceScore - 1)];
+    }
+
+    void optimize(uint g,const vector<uint>& tris,vector<uint>& _order)
+    {
+      if (tris.empty()) {
+        return;
+      }
+      ForIndex(i,tris.size()) {
+        ForIndex(c,3) { m_Remaining[m_Mesh->triangleAt(tris[i])[c]] ++; }
+      }
+      ForIndex(i,tris.size()) {
+        ForIndex(c,3) {
+          uint v = m_Mesh->triangleAt(tris[i])[c];
+          m_Score[v] = vertexScore(v);
+        }
+      }
+      // start from the best scored triangle
+      uint  best      = tris[0];
+      float bestScore = -1.0f;
+      ForIndex(i,tris.size()) {
+        const NAMESPACE::TriangleMesh::t_Triangle& tri = m_Mesh->triangleAt(tris[i]);
+        m_TriScore[tris[i]] = m_Score[tri[0]] + m_Score[tri[1]] + m_Score[tri[2]];
+        if (m_TriScore[tris[i]] > bestScore) {
+          bestScore = m_TriScore[tris[i]];
+          best      = tris[i];
+        }
+      }
+      vector<uint> cache,next;
+      uint cursor = 0;
+      ForIndex(n,tris.size()) {
+        if (best == uint(-1)) {
+          // nothing in the cache, resume in input order
+          while (m_Emitted[tris[cursor]]) cursor ++;
+          best = tris[cursor];
+        }
+        _order.push_back(best);
+        m_Emitted[best] = 1;
+        const NAMESPACE::TriangleMesh::t_Triangle& tri = m_Mesh->triangleAt(best);
+        // update cache (LRU, emitted vertices in front)
+        next.clear();
+        ForIndex(c,3) {
+          m_Remaining[tri[c]] --;
+          next.push_back(tri[c]);
+        }
+        ForIndex(i,cache.size()) {
+          uint v = cache[i];
+          if (v != tri[0] && v != tri[1] && v != tri[2]) {
+            next.push_back(v);
+          }
+        }
+        // evicted vertices keep being updated below
+        ForIndex(i,next.size()) {
+          m_CachePos[next[i]] = uint(i) < m_CacheSize + 3 ? int(i) : -1;
+          m_Score   [next[i]] = vertexScore(next[i]);
+        }
+        // update triangle scores, pick the best candidate
+        best      = uint(-1);
+        bestScore = -1.0f;
+        ForIndex(i,next.size()) {
+          uint v = next[i];
+          for (uint k = m_First[v] ; k < m_First[v + 1] ; k++) {
+            uint t = m_List[k];
+            if (m_Emitted[t] || m_Group[t] != g) continue;
+            const NAMESPACE::TriangleMesh::t_Triangle& nt = m_Mesh->triangleAt(t);
+            float s = m_Score[nt[0]] + m_Score[nt[1]] + m_Score[nt[2]];
+            m_TriScore[t] = s;
+            if (s > bestScore) {
+              bestScore = s;
+              best      = t;
+            }
+          }
+        }
+        if (next.size() > m_CacheSize + 3) {
+          next.resize(m_CacheSize + 3);
+        }
+        cache.swap(next);
+      }
+      ForIndex(i,cache.size()) {
+        m_CachePos[cache[i]] = -1;
+      }
+    }
+
+  };
+
+  // splits an ordered group of triangles into clusters, returns cluster starts
+  void overdrawClusters(const NAMESPACE::TriangleMesh *mesh,const vector<uint>& tris,float threshold,FifoCache& cache,vector<uint>& _starts)
+  {
+    // hard boundaries: the cache optimizer restarted (three misses)
+    vector<uint> hard;
+    cache.reset();
+    ForIndex(i,tris.size()) {
+      uint misses = 0;
+      ForIndex(c,3) { misses += cache.access(mesh->triangleAt(tris[i])[c]) ? 1 : 0; }
+      if (misses == 3 || i == 0) {
+        hard.push_back(i);
+      }
+    }
+    hard.push_back(uint(tris.size()));
+    // soft boundaries: split while the cluster ACMR stays within threshold of the hard cluster ACMR
+    ForIndex(h,hard.size() - 1) {
+      uint s = hard[h], e = hard[h + 1];
+      uint misses = 0;
+      cache.reset();
+      ForRange(i,s,e-1) {
+        ForIndex(c,3) { misses += cache.access(mesh->triangleAt(tris[i])[c]) ? 1 : 0; }
+      }
+      float limit = threshold * float(misses) / float(e - s);
+      _starts.push_back(s);
+      uint start = s;
+      misses = 0;
+      cache.reset();
+      ForRange(i,s,e-1) {
+        ForIndex(c,3) { misses += cache.access(mesh->triangleAt(tris[i])[c]) ? 1 : 0; }
+        if (uint(i) + 1 < e && float(misses) / float(i + 1 - start) <= limit) {
+          _starts.push_back(i + 1);
+          start  = i + 1;
+          misses = 0;
+          cache.reset();
+        }
+      }
+    }
+  }
+
+} // namespace
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::TriangleMesh::t_VertexCacheStats NAMESPACE::TriangleMesh::analyzeVertexCache(uint cacheSize) const
+{
+  t_VertexCacheStats stats;
+  stats.acmr = stats.atvr = stats.overfetch = 0.0f;
+  if (numTriangles() == 0) {
+    return stats;
+  }
+  FifoCache   cache(numVertices(),cacheSize);
+  Array<bool> used(numVertices());
+  used.fill(false);
+  // vertex fetch goes through a small cache of lines
+  const uint  vsz      = sizeOfVertexData();
+  uint        numLines = uint((size_t(numVertices()) * vsz + c_FetchLineSize - 1) / c_FetchLineSize);
+  FifoCache   lines(numLines,c_FetchCacheLines);
+  uint        misses   = 0;
+  uint        fetched  = 0;
+  uint        numUsed  = 0;
+  ForIndex(t,numTriangles()) {
+    ForIndex(c,3) {
+      uint v = triangleAt(t)[c];
+      if (!used[v]) {
+        used[v] = true;
+        numUsed ++;
+      }
+      if (cache.access(v)) {
+        misses ++;
+        for (size_t l = (size_t(v) * vsz) / c_FetchLineSize ; l <= (size_t(v + 1) * vsz - 1) / c_FetchLineSize ; l++) {
+          fetched += lines.access(uint(l)) ? 1 : 0;
+        }
+      }
+    }
+  }
+  stats.acmr      = float(misses) / float(numTriangles());
+  stats.atvr      = float(misses) / float(numUsed);
+  stats.overfetch = float(double(fetched) * c_FetchLineSize / (double(numUsed) * vsz));
+  return stats;
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh::optimizeVertexCache(uint cacheSize,t_VertexCacheStats *_before,t_VertexCacheStats *_after)
+{
+  if (_before != NULL) *_before = analyzeVertexCache(cacheSize);
+  vector<vector<uint> > groups;
+  groupBySurface(this,groups);
+  vector<uint> order;
+  order.reserve(numTriangles());
+  {
+    ForsythOptimizer forsyth(this,cacheSize,groups);
+    ForIndex(g,groups.size()) {
+      forsyth.optimize(g,groups[g],order);
+    }
+  }
+  reorderTriangles(this,order);
+  if (_after != NULL) *_after = analyzeVertexCache(cacheSize);
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh::optimizeOverdraw(float threshold,uint cacheSize,t_VertexCacheStats *_before,t_VertexCacheStats *_after)
+{
+  if (_before != NULL) *_before = analyzeVertexCache(cacheSize);
+  vector<vector<uint> > groups;
+  groupBySurface(this,groups);
+  FifoCache    cache(numVertices(),cacheSize);
+  vector<uint> order;
+  order.reserve(numTriangles());
+  ForIndex(g,groups.size()) {
+    const vector<uint>& tris = groups[g];
+    if (tris.empty()) continue;
+    // surfaces list triangles by increasing id, this is the order set by the cache optimizer
+    vector<uint> starts;
+    overdrawClusters(this,tris,threshold,cache,starts);
+    starts.push_back(uint(tris.size()));
+    // cluster centroids and normals, area weighted
+    uint           nc = uint(starts.size()) - 1;
+    vector<v3f>    ctr(nc,v3f(0.0f)),nrm(nc,v3f(0.0f));
+    vector<float>  area(nc,0.0f);
+    v3f            meshCtr(0.0f);
+    float          meshArea = 0.0f;
+    ForIndex(k,nc) {
+      ForRange(i,starts[k],starts[k + 1] - 1) {
+        const t_Triangle& tri = triangleAt(tris[i]);
+        v3f n = cross(posAt(tri[1]) - posAt(tri[0]),posAt(tri[2]) - posAt(tri[0]));
+        float a = length(n);
+        ctr [k] += (posAt(tri[0]) + posAt(tri[1]) + posAt(tri[2])) * (a / 3.0f);
+        nrm [k] += n;
+        area[k] += a;
+      }
+      meshCtr  += ctr[k];
+      meshArea += area[k];
+    }
+    meshCtr = meshArea > 0.0f ? meshCtr / meshArea : meshCtr;
+    // outward facing clusters first
+    vector<pair<float,uint> > keys(nc);
+    ForIndex(k,nc) {
+      v3f c = area[k] > 0.0f ? ctr[k] / area[k] : ctr[k];
+      float ln = length(nrm[k]);
+      keys[k] = make_pair(ln > 0.0f ? -dot(c - meshCtr,nrm[k] / ln) : 0.0f,k);
+    }
+    stable_sort(keys.begin(),keys.end());
+    ForIndex(k,nc) {
+      uint c = keys[k].second;
+      ForRange(i,starts[c],starts[c + 1] - 1) {
+        order.push_back(tris[i]);
+      }
+    }
+  }
+  reorderTriangles(this,order);
+  if (_after != NULL) *_after = analyzeVertexCache(cacheSize);
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh::optimizeVertexFetch(t_VertexCacheStats *_before,t_VertexCacheStats *_after)
+{
+  if (_before != NULL) *_before = analyzeVertexCache();
+  Array<uint> rank(numVertices());
+  rank.fill(uint(-1));
+  vector<uint> order;
+  order.reserve(numVertices());
+  ForIndex(t,numTriangles()) {
+    t_Triangle& tri = triangleAt(t);
+    ForIndex(c,3) {
+      if (rank[tri[c]] == uint(-1)) {
+        rank[tri[c]] = uint(order.size());
+        order.push_back(tri[c]);
+      }
+      tri[c] = rank[tri[c]];
+    }
+  }
+  Array<uint> reorder(uint(order.size()));
+  ForArray(reorder,i) {
+    reorder[i] = order[i];
+  }
+  reorderVerticesAndTruncate(reorder);
+  m_BBoxComputed = false;
+  if (_after != NULL) *_after = analyzeVertexCache();
+}
+
+//---------------------------------------------------------------------------
@@ -72,6 +72,34 @@ namespace LibSL {
     /// Forward declaration of vertex container class
     template <typename T_VertexData> class VertexContainer;
 
+    /// Strided view onto mesh storage: element i is stride bytes after element i-1
+    //  An empty view (NULL data) means the storage is not a single block
+    template <typename T>
+    class StridedView
+    {
+    protected:
+
+      uchar *m_Data;
+      uint   m_Size;
+      uint   m_Stride;
+
+    public:
+
+      StridedView() : m_Data(NULL), m_Size(0), m_Stride(0) {}
+      StridedView(const void *data,uint size,uint stride) : m_Data((uchar*)data), m_Size(size), m_Stride(stride) {}
+
+      bool empty()              const { return m_Data == NULL; }
+      uint size()               const { return m_Size;   }
+      uint stride()             const { return m_Stride; }
+      T   *data()               const { return (T*)m_Data; }
+      T&   operator[](uint i)   const { return *(T*)(m_Data + size_t(i) * m_Stride); }
+
+      //! view onto a member located offset bytes within each element
+      template <typename T_Member>
+      StridedView<T_Member> member(uint offset) const
+      { return m_Data == NULL ? StridedView<T_Member>() : StridedView<T_Member>(m_Data + offset,m_Size,m_Stride); }
+    };
+
     /// Base Triangle Mesh class
     class TriangleMesh
       //        : public LibSL::Memory::TraceLeaks::LeakProbe<TriangleMesh>
@@ -129,6 +157,41 @@ namespace LibSL {
       virtual uint                 surfaceNumTriangles(uint s)        const =0;
       virtual uint                 surfaceTriangleIdAt(uint s,uint t) const =0;
 
+      //! bulk access
+      //  views onto the vertex and index storage, empty (resp. NULL) when the mesh
+      //  does not keep it as a single block (e.g. TriangleMesh_generic<Array<uchar> >)
+      //  views are invalidated by allocate and by vertex reordering
+      virtual StridedView<uchar>        vertexBlock()               { return StridedView<uchar>(); }
+      virtual StridedView<const uchar>  vertexBlock()         const { return StridedView<const uchar>(); }
+      virtual t_Triangle               *indexBuffer()               { return NULL; }
+      virtual const t_Triangle         *indexBuffer()         const { return NULL; }
+
+      //! vertex positions
+      StridedView<v3>                   positions();
+      StridedView<const v3>             positions()           const;
+
+      //! attribute resolved from the MVF, empty if absent (or no MVF)
+      //  throws Fatal if the attribute size differs from sizeof(T)
+      template <typename T>
+      StridedView<T>                    attribute(MVF::e_Binding binding)
+      {
+        int offset = attributeOffset(binding,sizeof(T));
+        return offset < 0 ? StridedView<T>() : vertexBlock().template member<T>(uint(offset));
+      }
+      template <typename T>
+      StridedView<const T>              attribute(MVF::e_Binding binding) const
+      {
+        int offset = attributeOffset(binding,sizeof(T));
+        return offset < 0 ? StridedView<const T>() : vertexBlock().template member<const T>(uint(offset));
+      }
+
+    protected:
+
+      //! byte offset of an attribute within vertex data, -1 if absent
+      int attributeOffset(MVF::e_Binding binding,uint sizeOf) const;
+
+    public:
+
       //! return bounding box
       const LibSL::Geometry::AABox& bbox();
       LibSL::Geometry::AABox computeBBox();
@@ -155,6 +218,31 @@ namespace LibSL {
       //  only succeeds if two-manifold
       virtual void reorientTriangles();
 
+      //! vertex processing statistics of the current triangle order
+      //  acmr      : transformed vertices per triangle (FIFO post-transform cache)
+      //  atvr      : transformed vertices per referenced vertex (1 is optimal)
+      //  overfetch : vertex bytes fetched per referenced vertex byte (64 bytes cache lines)
+      typedef struct {
+        float acmr;
+        float atvr;
+        float overfetch;
+      } t_VertexCacheStats;
+      t_VertexCacheStats analyzeVertexCache(uint cacheSize=16) const;
+
+      //! reorder triangles for the post-transform vertex cache [Forsyth 2006]
+      //  triangles are grouped by surface, surface triangle ids are updated
+      //  _before and _after receive the statistics before and after the pass
+      void optimizeVertexCache(uint cacheSize=16,t_VertexCacheStats *_before=NULL,t_VertexCacheStats *_after=NULL);
+
+      //! reorder clusters of triangles so that outward facing ones are drawn first [Sander et al. 2007]
+      //  run after optimizeVertexCache; clusters are split while their ACMR stays within
+      //  threshold times the one of the input (1.05: 5% more cache misses)
+      void optimizeOverdraw(float threshold=1.05f,uint cacheSize=16,t_VertexCacheStats *_before=NULL,t_VertexCacheStats *_after=NULL);
+
+      //! reorder vertices by first use in the triangle list, unused vertices are removed
+      //  run last, after the triangle order is final
+      void optimizeVertexFetch(t_VertexCacheStats *_before=NULL,t_VertexCacheStats *_after=NULL);
+
       //! swap axes (specify a 3 character chain for reordering "yxz" ... A capital letter negates the component)
       void swapAxes(const char *swizzle="xyz");
 
@@ -389,6 +477,28 @@ namespace LibSL {
         return (m_Surfaces.size());
       }
 
+      virtual StridedView<uchar>        vertexBlock()
+      {
+        if (t_Vertex::requiresMVF || m_Vertices.empty()) {
+          return StridedView<uchar>();
+        }
+        return StridedView<uchar>(m_Vertices.raw(),m_Vertices.size(),sizeof(t_Vertex));
+      }
+
+      virtual StridedView<const uchar>  vertexBlock()    const
+      {
+        if (t_Vertex::requiresMVF || m_Vertices.empty()) {
+          return StridedView<const uchar>();
+        }
+        return StridedView<const uchar>(m_Vertices.raw(),m_Vertices.size(),sizeof(t_Vertex));
+      }
+
+      virtual t_Triangle               *indexBuffer()
+      { return (m_Triangles.empty() ? NULL : m_Triangles.raw()); }
+
+      virtual const t_Triangle         *indexBuffer()    const
+      { return (m_Triangles.empty() ? NULL : m_Triangles.raw()); }
+
       virtual std::string&      surfaceTextureName (uint s)
       {
         return (m_Surfaces[s].textureName);
@@ -428,7 +538,7 @@ namespace LibSL {
       }
 
       virtual TriangleMesh *newInstance()            const
-      { return (new TriangleMesh_generic<T_VertexData>()); }
+      { return (new TriangleMesh_generic<T_VertexData>(m_MVF)); }
 
 
       //! static cast - creates a new mesh with a different vertex format
@@ -465,6 +575,35 @@ namespace LibSL {
 
     //// Loading and saving meshes
 
+    /// Streaming triangle soup reader
+    //  Yields the triangles of a mesh file in batches, as three corner
+    //  positions per triangle, without building a TriangleMesh.
+    class TriangleSoupReader
+    {
+    public:
+      virtual ~TriangleSoupReader() {}
+      //! reads up to maxTriangles triangles, _corners receives three positions
+      //  per triangle (previous content is replaced); returns 0 once done
+      virtual uint      read(std::vector<LibSL::Math::v3f>& _corners,uint maxTriangles) =0;
+      //! number of triangles if known from the file header, -1 otherwise
+      virtual long long numTriangles() const { return -1; }
+    };
+
+    /// Helper pointer onto soup readers
+    typedef LibSL::Memory::Pointer::AutoPtr<TriangleSoupReader> TriangleSoupReader_Ptr;
+
+    /// Soup reader over a mesh in memory
+    class TriangleSoupReader_mesh : public TriangleSoupReader
+    {
+    protected:
+      TriangleMesh_Ptr m_Mesh;
+      uint             m_Next;
+    public:
+      TriangleSoupReader_mesh(TriangleMesh_Ptr mesh) : m_Mesh(mesh), m_Next(0) {}
+      uint      read(std::vector<LibSL::Math::v3f>& _corners,uint maxTriangles);
+      long long numTriangles() const { return m_Mesh->numTriangles(); }
+    };
+
     /// TriangleMesh format plugin (abstract)
     class TriangleMeshFormat_plugin
       //  : public LibSL::Memory::TraceLeaks::LeakProbe<TriangleMeshFormat_plugin>
@@ -473,6 +612,9 @@ namespace LibSL {
       virtual void          save(const char *,const TriangleMesh *) const =0;
       virtual TriangleMesh *load(const char *)                      const =0;
       virtual const char   *signature()                             const =0;
+      //! opens a streaming reader, by default the mesh is loaded and read back
+      virtual TriangleSoupReader *openSoup(const char *fname)       const
+      { return new TriangleSoupReader_mesh(TriangleMesh_Ptr(load(fname))); }
       virtual ~TriangleMeshFormat_plugin() {}
     };
 
@@ -529,6 +671,9 @@ namespace LibSL {
     /// save a mesh
     LIBSL_DLL void              saveTriangleMesh(const char *,const TriangleMesh *);
 
+    /// open a streaming triangle soup reader on a mesh file
+    LIBSL_DLL TriangleSoupReader *openTriangleSoup(const char *);
+
     // --------------------------------------------------------------
 
   } //namespace LibSL::Mesh
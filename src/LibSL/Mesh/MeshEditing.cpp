@@ -33,6 +33,7 @@ same conditions as regards security.
 The fact that you are presently reading this means that you have had
 knowledge of the CeCILL-C license and that you accept its terms.
 -------------------------------------------------------------------- */
+// -------------------------------------------------------
 #include "LibSL.precompiled.h"
 // -------------------------------------------------------
 
@@ -42,154 +43,384 @@ using namespace std;
 
 #include "MeshEditing.h"
 
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <unordered_map>
+
 #define NAMESPACE LibSL::Mesh::MeshEditing
 
 // -------------------------------------------------------
 
-typedef LibSL::Math::Tuple<float,6>   v6f;
-typedef struct
-{
-  LibSL::Math::v3f pos;
-  LibSL::Math::v3f nrm;
-  LibSL::Math::v2f uv;
-} t_VertexData;
+namespace {
 
-// -------------------------------------------------------
+  typedef unsigned long long t_Key;
 
-void NAMESPACE::cutMesh(const TriangleMesh_Ptr  mesh,
-                        const Plane<3>&         pl,
-                        TriangleMesh_Ptr&      _front,
-                        TriangleMesh_Ptr&      _back)
-{
-  sl_assert(_front.isNull());
-  sl_assert(_back .isNull());
-  vector<Tuple<v6f,3> > ftris;
-  vector<Tuple<v6f,3> > btris;
-
-  /*
-  // early rejection
-  Geometry::AAB<3> mbox = mesh->bbox();
-  if (!Intersections::Plane_AABox(pl,mbox)) {
-    if (pl.distance(mbox.center()) > 0) {
-      _front = mesh->clone();
-    } else {
-      _back  = mesh->clone();
+  inline t_Key edgeKey(uint a,uint b)     { return a < b ? (t_Key(a) << 32) | b : (t_Key(b) << 32) | a; }
+
+  // per vertex data shared by all slices
+  class SliceData
+  {
+  public:
+    const TriangleMesh  *mesh;
+    vector<float>        offsets;
+    vector<double>       h;       // height along the normal
+    vector<uint>         slab;    // number of planes below or at the vertex
+    vector<uint>         pid;     // smallest vertex index at the same position
+    vector<uint>         surf;    // triangle -> surface (or 0)
+
+    // interpolation parameter of plane k along edge (a,b), from the smallest index
+    double edgeParam(uint a,uint b,uint k) const
+    {
+      if (a > b) std::swap(a,b);
+      double dh = h[b] - h[a];
+      return dh != 0.0 ? (double(offsets[k]) - h[a]) / dh : 0.0;
     }
-  }
-  */
-  // for each mesh triangle
-  ForIndex(t,mesh->numTriangles()) {
-    // box and polygon for this triangle
-    Geometry::AAB<3>         box;
-    Geometry::Polygon<3,v6f> poly;
-    ForIndex(pt,3) {
-      t_VertexData *dta = (t_VertexData *)mesh->vertexDataAt(mesh->triangleAt(t)[pt]);
-      box.addPoint(dta->pos);
-      v6f p;
-      ForIndex(i,3) {
-        p[i  ] = dta->pos[i];
-        p[i+3] = dta->nrm[i];
-      }
-      poly.add( p );
-    }
-    // check for intersection
-    if (!Intersections::Plane_AABox(pl,box)) {
-      // none => add to correct side
-      if (pl.distance(box.center()) > 0) {
-        ftris.push_back(Tuple<v6f,3>());
-        ftris.back()[0] = poly.vertexAt(0);
-        ftris.back()[1] = poly.vertexAt(1);
-        ftris.back()[2] = poly.vertexAt(2);
-      } else {
-        btris.push_back(Tuple<v6f,3>());
-        btris.back()[0] = poly.vertexAt(0);
-        btris.back()[1] = poly.vertexAt(1);
-        btris.back()[2] = poly.vertexAt(2);
+    v3f edgePoint(uint a,uint b,uint k) const
+    {
+      if (a > b) std::swap(a,b);
+      float t = float(edgeParam(a,b,k));
+      return mesh->posAt(a) * (1.0f - t) + mesh->posAt(b) * t;
+    }
+  };
+
+  // contours of plane k from the triangles crossing it
+  void sliceContours(const SliceData& d,uint k,const uint *tris,uint num,vector<NAMESPACE::t_Contour>& _contours)
+  {
+    // one segment per triangle, from its above->below edge to its below->above edge
+    // (in position space, so that seams do not break contours)
+    vector<t_Key> starts(num),ends(num);
+    vector<v3f>   points(num);
+    unordered_map<t_Key,uint> byStart,byEnd;
+    byStart.reserve(num * 2);
+    byEnd  .reserve(num * 2);
+    ForIndex(i,num) {
+      const TriangleMesh::t_Triangle& tri = d.mesh->triangleAt(tris[i]);
+      ForIndex(c,3) {
+        uint a = tri[c],b = tri[(c + 1) % 3];
+        bool aAbove = d.slab[a] > k,bAbove = d.slab[b] > k;
+        if (aAbove && !bAbove) {
+          starts[i] = edgeKey(d.pid[a],d.pid[b]);
+          points[i] = d.edgePoint(d.pid[a],d.pid[b],k);
+        } else if (!aAbove && bAbove) {
+          ends[i]   = edgeKey(d.pid[a],d.pid[b]);
+        }
       }
-    } else {
-      if (poly.size() < 3) continue;
-      // => split
-      Geometry::Polygon<3,v6f> fpoly,bpoly;
-      switch (poly.cut(pl,fpoly,bpoly)) 
-      {
-      case LIBSL_POLYGON_FRONT:
-        // add to front
-        sl_assert(fpoly.size() > 2);
-        ForRange(i,2,fpoly.size()-1) {
-          ftris.push_back(Tuple<v6f,3>());
-          ftris.back()[0] = fpoly.vertexAt(0);
-          ftris.back()[1] = fpoly.vertexAt(i-1);
-          ftris.back()[2] = fpoly.vertexAt(i);
+      byStart[starts[i]] = i;
+      byEnd  [ends  [i]] = i;
+    }
+    vector<char> visited(num,0);
+    // open chains first, starting where no segment ends; then loops
+    ForIndex(pass,2) {
+      ForIndex(i,num) {
+        if (visited[i]) continue;
+        if (pass == 0 && byEnd.find(starts[i]) != byEnd.end()) continue;
+        _contours.push_back(NAMESPACE::t_Contour());
+        NAMESPACE::t_Contour& ctr = _contours.back();
+        ctr.closed = (pass == 1);
+        uint cur = i;
+        while (true) {
+          visited[cur] = 1;
+          ctr.points.push_back(points[cur]);
+          unordered_map<t_Key,uint>::const_iterator N = byStart.find(ends[cur]);
+          if (N == byStart.end() || visited[N->second]) {
+            if (N == byStart.end()) {
+              // open: add the last end point
+              const TriangleMesh::t_Triangle& tri = d.mesh->triangleAt(tris[cur]);
+              ForIndex(c,3) {
+                uint a = tri[c],b = tri[(c + 1) % 3];
+                if (d.slab[a] <= k && d.slab[b] > k) {
+                  ctr.points.push_back(d.edgePoint(d.pid[a],d.pid[b],k));
+                }
+              }
+            }
+            break;
+          }
+          cur = N->second;
         }
-        break;
-      case LIBSL_POLYGON_BACK:
-        // add to back
-        sl_assert(bpoly.size() > 2);
-        ForRange(i,2,bpoly.size()-1) {
-          btris.push_back(Tuple<v6f,3>());
-          btris.back()[0] = bpoly.vertexAt(0);
-          btris.back()[1] = bpoly.vertexAt(i-1);
-          btris.back()[2] = bpoly.vertexAt(i);
+        // a plane through a vertex yields the same point from both of its edges
+        ctr.points.erase(unique(ctr.points.begin(),ctr.points.end()),ctr.points.end());
+        while (ctr.closed && ctr.points.size() > 1 && ctr.points.front() == ctr.points.back()) ctr.points.pop_back();
+      }
+    }
+  }
+
+  // interpolates vertex data along an edge, all MVF attributes
+  void interpolateVertex(const TriangleMesh *mesh,uint a,uint b,float t,void *dst)
+  {
+    const uchar *da = (const uchar*)mesh->vertexDataAt(a);
+    const uchar *db = (const uchar*)mesh->vertexDataAt(b);
+    uchar       *dd = (uchar*)dst;
+    memcpy(dd,t < 0.5f ? da : db,mesh->sizeOfVertexData());
+    if (mesh->mvf().isNull()) {
+      return;
+    }
+    const MVF *mvf = mesh->mvf().raw();
+    for (int i = MVF::Position ; i <= MVF::TexCoord7 ; i++) {
+      const MVF::Attribute *attr = mvf->findAttributeByBinding(MVF::e_Binding(i));
+      if (attr == NULL) continue;
+      ForIndex(c,attr->numComponents) {
+        switch (attr->type) {
+        case MVF::Float: {
+          const float *fa = (const float*)(da + attr->offset),*fb = (const float*)(db + attr->offset);
+          ((float*)(dd + attr->offset))[c] = fa[c] * (1.0f - t) + fb[c] * t;
+          break; }
+        case MVF::Double: {
+          const double *fa = (const double*)(da + attr->offset),*fb = (const double*)(db + attr->offset);
+          ((double*)(dd + attr->offset))[c] = fa[c] * (1.0 - t) + fb[c] * t;
+          break; }
+        case MVF::Byte: {
+          const uchar *fa = da + attr->offset,*fb = db + attr->offset;
+          (dd + attr->offset)[c] = uchar(float(fa[c]) * (1.0f - t) + float(fb[c]) * t + 0.5f);
+          break; }
+        default:
+          break; // integers are not interpolated
         }
-        break;
-      case LIBSL_POLYGON_ON:
-      case LIBSL_POLYGON_CUT:
-        sl_assert(fpoly.size() > 2);
-        sl_assert(bpoly.size() > 2);
-        // add to front
-        ForRange(i,2,fpoly.size()-1) {
-          ftris.push_back(Tuple<v6f,3>());
-          ftris.back()[0] = fpoly.vertexAt(0);
-          ftris.back()[1] = fpoly.vertexAt(i-1);
-          ftris.back()[2] = fpoly.vertexAt(i);
+      }
+      if (i == MVF::Normal && attr->type == MVF::Float && attr->numComponents == 3) {
+        v3f& n = *(v3f*)(dd + attr->offset);
+        n = normalize_safe(n);
+      }
+    }
+  }
+
+  // slab s as an indexed mesh, triangles crossing its planes are clipped
+  TriangleMesh *sliceSlab(const SliceData& d,uint s,const uint *tris,uint num)
+  {
+    const TriangleMesh *mesh = d.mesh;
+    const uint          np   = uint(d.offsets.size());
+    // output vertices: original ones, then points on edges (edge, plane)
+    unordered_map<uint,uint>  vmap;
+    unordered_map<t_Key,uint> emap[2];
+    vector<uint>  vsrc;                   // original vertex
+    vector<v3u>   esrc;                   // (a,b,plane) for edge points
+    vector<v3u>   otris;
+    vector<uint>  osrc;
+    vector<uint>  poly;
+    vmap.reserve(num * 2);
+    const uint    c_EdgeBit = 0x80000000u;
+    const uint    c_None    = 0xFFFFFFFFu;
+    auto vertexOf = [&](uint v) {
+      unordered_map<uint,uint>::iterator V = vmap.find(v);
+      if (V == vmap.end()) {
+        V = vmap.insert(make_pair(v,uint(vsrc.size()))).first;
+        vsrc.push_back(v);
+      }
+      return V->second;
+    };
+    ForIndex(i,num) {
+      const TriangleMesh::t_Triangle& tri = mesh->triangleAt(tris[i]);
+      poly.clear();
+      ForIndex(c,3) {
+        uint a = tri[c],b = tri[(c + 1) % 3];
+        if (d.slab[a] == s) {
+          poly.push_back(vertexOf(a));
         }
-        // add to back
-        ForRange(i,2,bpoly.size()-1) {
-          btris.push_back(Tuple<v6f,3>());
-          btris.back()[0] = bpoly.vertexAt(0);
-          btris.back()[1] = bpoly.vertexAt(i-1);
-          btris.back()[2] = bpoly.vertexAt(i);
+        // slab boundaries crossed along a->b, in order
+        uint sa = d.slab[a],sb = d.slab[b];
+        uint lo = min(sa,sb),hi = max(sa,sb);
+        ForIndex(j,2) {
+          // going up the lower boundary (plane s-1) comes first, going down the upper one (plane s)
+          uint k    = (sa < sb) == (j == 0) ? s - 1 : s;
+          uint side = k == s ? 1 : 0;
+          if (k >= np || k < lo || k >= hi) continue; // also rejects s-1 for s == 0
+          // plane through an end point: the point is that vertex, shared by its edges
+          uint on = d.h[a] == double(d.offsets[k]) ? a : (d.h[b] == double(d.offsets[k]) ? b : c_None);
+          if (on != c_None && d.slab[on] == s) {
+            poly.push_back(vertexOf(on));
+            continue;
+          }
+          t_Key key = on != c_None ? edgeKey(on,on) : edgeKey(a,b);
+          unordered_map<t_Key,uint>::iterator E = emap[side].find(key);
+          if (E == emap[side].end()) {
+            E = emap[side].insert(make_pair(key,uint(esrc.size()))).first;
+            esrc.push_back(on != c_None ? V3U(on,on,k) : V3U(a,b,k));
+          }
+          poly.push_back(E->second | c_EdgeBit);
         }
-        break;
-      default:
-        sl_assert(false);
-        break;
+      }
+      // points on a plane are reached from both of their edges
+      poly.erase(unique(poly.begin(),poly.end()),poly.end());
+      while (poly.size() > 1 && poly.front() == poly.back()) poly.pop_back();
+      // fan, the clipped polygon is convex
+      ForRange(p,2,int(poly.size()) - 1) {
+        otris.push_back(V3U(poly[0],poly[p - 1],poly[p]));
+        osrc .push_back(tris[i]);
       }
     }
-  } // t
-  // store in meshes
-  if (!ftris.empty()) {
-    TriangleMesh_Ptr mfront = TriangleMesh_Ptr(mesh->newInstance());
-    mfront->allocate(uint(ftris.size()*3),uint(ftris.size()));
-    uint v = 0;
-    ForIndex(t,ftris.size()) {
-      ForIndex(pt,3) {
-        mfront->triangleAt(t)[pt] = v ++;
-        t_VertexData *dta = (t_VertexData *)mfront->vertexDataAt(mfront->triangleAt(t)[pt]);
-        ForIndex(i,3) {
-          dta->pos[i] = ftris[t][pt][i  ];
-          dta->nrm[i] = ftris[t][pt][i+3];
-        }
+    if (otris.empty()) {
+      return NULL;
+    }
+    // build mesh
+    TriangleMesh *slab = mesh->newInstance();
+    slab->setMvf(mesh->mvf());
+    uint nsurf = mesh->numSurfaces();
+    slab->allocate(uint(vsrc.size() + esrc.size()),uint(otris.size()),nsurf);
+    const uint vsz = mesh->sizeOfVertexData();
+    ForIndex(v,vsrc.size()) {
+      memcpy(slab->vertexDataAt(v),mesh->vertexDataAt(vsrc[v]),vsz);
+    }
+    ForIndex(e,esrc.size()) {
+      uint a = esrc[e][0],b = esrc[e][1],k = esrc[e][2];
+      if (a > b) std::swap(a,b);
+      float t = float(d.edgeParam(a,b,k));
+      interpolateVertex(mesh,a,b,t,slab->vertexDataAt(uint(vsrc.size()) + e));
+      slab->posAt(uint(vsrc.size()) + e) = d.edgePoint(a,b,k);
+    }
+    const uint nv = uint(vsrc.size());
+    ForIndex(t,otris.size()) {
+      ForIndex(c,3) {
+        uint v = otris[t][c];
+        slab->triangleAt(t)[c] = (v & c_EdgeBit) ? nv + (v & ~c_EdgeBit) : v;
       }
     }
-    _front = mfront;
+    if (nsurf > 0) {
+      vector<uint> count(nsurf,0);
+      ForIndex(t,osrc.size()) { count[d.surf[osrc[t]]] ++; }
+      ForIndex(sf,nsurf) {
+        slab->surfaceAt(sf).textureName = mesh->surfaceAt(sf).textureName;
+        slab->surfaceAt(sf).diffuse     = mesh->surfaceAt(sf).diffuse;
+        slab->surfaceAt(sf).triangleIds.allocate(count[sf]);
+        count[sf] = 0;
+      }
+      ForIndex(t,osrc.size()) {
+        uint sf = d.surf[osrc[t]];
+        slab->surfaceAt(sf).triangleIds[count[sf] ++] = t;
+      }
+    }
+    return slab;
   }
-  if (!btris.empty()) {
-    TriangleMesh_Ptr mback = TriangleMesh_Ptr(mesh->newInstance());
-    mback->allocate(uint(btris.size()*3),uint(btris.size()));
-    uint v = 0;
-    ForIndex(t,btris.size()) {
-      ForIndex(pt,3) {
-        mback->triangleAt(t)[pt] = v ++;
-        t_VertexData *dta = (t_VertexData *)mback->vertexDataAt(mback->triangleAt(t)[pt]);
-        ForIndex(i,3) {
-          dta->pos[i] = btris[t][pt][i  ];
-          dta->nrm[i] = btris[t][pt][i+3];
-        }
+
+  // bucket sort of triangles over ranges of planes or slabs
+  void buildBuckets(const vector<uint>& first,const vector<uint>& last,uint n,vector<uint>& _start,vector<uint>& _list)
+  {
+    _start.assign(n + 1,0);
+    ForIndex(t,first.size()) {
+      for (uint k = first[t] ; k < last[t] ; k++) _start[k + 1] ++;
+    }
+    ForIndex(k,n) { _start[k + 1] += _start[k]; }
+    _list.resize(_start[n]);
+    vector<uint> fill(_start.begin(),_start.end() - 1);
+    ForIndex(t,first.size()) {
+      for (uint k = first[t] ; k < last[t] ; k++) _list[fill[k] ++] = t;
+    }
+  }
+
+} // namespace
+
+// -------------------------------------------------------
+
+void NAMESPACE::sliceMesh(
+  const TriangleMesh                 *mesh,
+  const v3f&                          normal,
+  const vector<float>&                offsets,
+  vector<vector<t_Contour> >&        _contours,
+  vector<TriangleMesh_Ptr>           *_slabs)
+{
+  sl_assert(mesh != NULL);
+  ForRange(k,1,int(offsets.size()) - 1) {
+    if (offsets[k] < offsets[k - 1]) {
+      throw LibSL::Errors::Fatal("[MeshEditing::sliceMesh] - offsets must be increasing");
+    }
+  }
+  const uint nv = mesh->numVertices();
+  const uint nt = mesh->numTriangles();
+  const uint np = uint(offsets.size());
+
+  SliceData d;
+  d.mesh    = mesh;
+  d.offsets = offsets;
+  d.h   .resize(nv);
+  d.slab.resize(nv);
+  LibSL::System::Parallel::forIndex(0,int(nv),[&](int v) {
+    const v3f& p = mesh->posAt(v);
+    // rounded to float, as offsets are given
+    float h   = float(double(normal[0]) * p[0] + double(normal[1]) * p[1] + double(normal[2]) * p[2]);
+    d.h   [v] = h;
+    d.slab[v] = uint(upper_bound(offsets.begin(),offsets.end(),h) - offsets.begin());
+  },4096);
+  // position ids, contours are chained across attribute seams
+  {
+    vector<uint> order(nv);
+    ForIndex(v,nv) { order[v] = v; }
+    sort(order.begin(),order.end(),[&](uint a,uint b) {
+      const v3f& pa = mesh->posAt(a);
+      const v3f& pb = mesh->posAt(b);
+      if (pa[0] != pb[0]) return pa[0] < pb[0];
+      if (pa[1] != pb[1]) return pa[1] < pb[1];
+      if (pa[2] != pb[2]) return pa[2] < pb[2];
+      return a < b;
+    });
+    d.pid.resize(nv);
+    ForIndex(i,nv) {
+      uint v = order[i];
+      d.pid[v] = (i > 0 && mesh->posAt(order[i - 1]) == mesh->posAt(v)) ? d.pid[order[i - 1]] : v;
+    }
+  }
+  d.surf.assign(nt,0);
+  ForIndex(s,mesh->numSurfaces()) {
+    ForIndex(i,mesh->surfaceNumTriangles(s)) { d.surf[mesh->surfaceTriangleIdAt(s,i)] = s; }
+  }
+
+  // range of slabs spanned by each triangle; it crosses the planes in between
+  vector<uint> smin(nt),smax(nt);
+  LibSL::System::Parallel::forIndex(0,int(nt),[&](int t) {
+    const TriangleMesh::t_Triangle& tri = mesh->triangleAt(t);
+    smin[t] = min(d.slab[tri[0]],min(d.slab[tri[1]],d.slab[tri[2]]));
+    smax[t] = max(d.slab[tri[0]],max(d.slab[tri[1]],d.slab[tri[2]]));
+  },4096);
+
+  // contours
+  {
+    vector<uint> start,list;
+    buildBuckets(smin,smax,np,start,list);
+    _contours.clear();
+    _contours.resize(np);
+    LibSL::System::Parallel::forIndex(0,int(np),[&](int k) {
+      if (start[k + 1] > start[k]) {
+        sliceContours(d,k,&list[start[k]],start[k + 1] - start[k],_contours[k]);
       }
+    });
+  }
+
+  // slabs
+  if (_slabs != NULL) {
+    vector<uint> start,list;
+    ForIndex(t,nt) { smax[t] ++; }
+    buildBuckets(smin,smax,np + 1,start,list);
+    vector<TriangleMesh*> slabs(np + 1,(TriangleMesh*)NULL);
+    try {
+      LibSL::System::Parallel::forIndex(0,int(np + 1),[&](int s) {
+        if (start[s + 1] > start[s]) {
+          slabs[s] = sliceSlab(d,s,&list[start[s]],start[s + 1] - start[s]);
+        }
+      });
+    } catch (...) {
+      ForIndex(s,slabs.size()) { delete (slabs[s]); }
+      throw;
+    }
+    _slabs->clear();
+    ForIndex(s,slabs.size()) {
+      _slabs->push_back(TriangleMesh_Ptr(slabs[s]));
     }
-    _back = mback;
   }
 }
 
 // -------------------------------------------------------
+
+void NAMESPACE::cutMesh(const TriangleMesh_Ptr  mesh,
+                        const Plane<3>&         pl,
+                        TriangleMesh_Ptr&      _front,
+                        TriangleMesh_Ptr&      _back)
+{
+  sl_assert(_front.isNull());
+  sl_assert(_back .isNull());
+  vector<float>              offsets(1,-pl.distance(v3f(0.0f)));
+  vector<vector<t_Contour> > contours;
+  vector<TriangleMesh_Ptr>   slabs;
+  sliceMesh(mesh.raw(),pl.n(),offsets,contours,&slabs);
+  _back  = slabs[0];
+  _front = slabs[1];
+}
+
+// -------------------------------------------------------
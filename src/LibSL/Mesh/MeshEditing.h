@@ -33,22 +33,48 @@ same conditions as regards security.
 The fact that you are presently reading this means that you have had
 knowledge of the CeCILL-C license and that you accept its terms.
 -------------------------------------------------------------------- */
+#pragma once
+
 #include <LibSL/Mesh/Mesh.h>
 #include <LibSL/Math/Vertex.h>
 #include <LibSL/Math/Tuple.h>
 #include <LibSL/Math/Quaternion.h>
 #include <LibSL/Geometry/Polygon.h>
 
+#include <vector>
+
 namespace LibSL {
   namespace Mesh {
     namespace MeshEditing {
 
+      //! cuts a mesh in two, _front receives the part where pl.distance(p) >= 0
+      //  outputs are NULL when empty
       void cutMesh(
         const LibSL::Mesh::TriangleMesh_Ptr    mesh,
         const LibSL::Geometry::Plane<3>&       pl,
         LibSL::Mesh::TriangleMesh_Ptr&        _front,
         LibSL::Mesh::TriangleMesh_Ptr&        _back);
 
+      //! contour of the mesh in a slicing plane
+      //  outer contours are counter-clockwise seen from the plane normal, holes clockwise
+      //  (for consistently oriented meshes); contours are open where the mesh has borders
+      typedef struct {
+        std::vector<LibSL::Math::v3f> points;
+        bool                          closed;
+      } t_Contour;
+
+      //! slices a mesh by parallel planes dot(normal,p) = offsets[i], offsets increasing
+      //  _contours[i] receives the contours in plane i
+      //  _slabs, when given, receives offsets.size()+1 indexed meshes: slab i lies between
+      //  planes i-1 and i (NULL when empty); new vertices interpolate all vertex attributes
+      //  points exactly on a plane are considered above it
+      LIBSL_DLL void sliceMesh(
+        const LibSL::Mesh::TriangleMesh                 *mesh,
+        const LibSL::Math::v3f&                          normal,
+        const std::vector<float>&                        offsets,
+        std::vector<std::vector<t_Contour> >&           _contours,
+        std::vector<LibSL::Mesh::TriangleMesh_Ptr>      *_slabs = NULL);
+
     } // LibSL::Mesh::MeshEditing
   } // LibSL::Mesh
 } // LibSL
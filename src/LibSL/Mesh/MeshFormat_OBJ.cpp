@@ -433,6 +433,80 @@ NAMESPACE::TriangleMesh *NAMESPACE::MeshFormat_OBJ::load(const char *fname) cons
 
 //---------------------------------------------------------------------------
 
+namespace {
+
+	/// streams 'f' lines, keeps 'v' lines, ignores everything else
+	class SoupReader_OBJ : public NAMESPACE::TriangleSoupReader
+	{
+	protected:
+		LibSL::BasicParser::FileStream                             m_Stream;
+		LibSL::BasicParser::Parser<LibSL::BasicParser::FileStream> m_Parser;
+		std::vector<v3f>                                           m_Positions;
+		std::vector<v3f>                                           m_Pending;  // triangles beyond the last batch
+		uint                                                       m_Line;
+	public:
+		SoupReader_OBJ(const char *fname) : m_Stream(fname), m_Parser(m_Stream,false), m_Line(0) { }
+		uint read(std::vector<v3f>& _corners,uint maxTriangles)
+		{
+			_corners.swap(m_Pending);
+			m_Pending.clear();
+			while (_corners.size() < size_t(maxTriangles) * 3 && !m_Parser.eof()) {
+				m_Line ++;
+				const char *s = m_Parser.trim( m_Parser.readString() , " \t\r\n" );
+				if (m_Parser.eof()) break;
+				if (!strcmp(s,"v")) {
+					v3f v;
+					v[0] = m_Parser.readFloat();
+					v[1] = m_Parser.readFloat();
+					v[2] = m_Parser.readFloat();
+					m_Positions.push_back(v);
+					m_Parser.reachChar('\n');
+				} else if (!strcmp(s,"f")) {
+					// fan triangulation, only the position index of each corner is used
+					int nface = 0;
+					v3f first,prev;
+					while (true) {
+						int c = m_Parser.readChar(false);
+						if (c == '\n' || c == EOF) break;
+						int id = atoi(m_Parser.readString());
+						if (id < 0) { id = int(m_Positions.size()) + id; } // deal with negative indices
+						else        { id --; }
+						if (id < 0 || id >= int(m_Positions.size())) {
+							throw Fatal("[MeshFormat_OBJ::openSoup] - face references an undefined vertex, line %d",m_Line);
+						}
+						const v3f& p = m_Positions[id];
+						if (nface == 0) {
+							first = p;
+						} else if (nface > 1) {
+							_corners.push_back(first);
+							_corners.push_back(prev);
+							_corners.push_back(p);
+						}
+						prev = p;
+						nface ++;
+					}
+					m_Parser.reachChar('\n');
+				} else {
+					m_Parser.reachChar('\n');
+				}
+			}
+			if (_corners.size() > size_t(maxTriangles) * 3) {
+				m_Pending.assign(_corners.begin() + size_t(maxTriangles) * 3,_corners.end());
+				_corners.resize(size_t(maxTriangles) * 3);
+			}
+			return uint(_corners.size() / 3);
+		}
+	};
+
+} // namespace
+
+NAMESPACE::TriangleSoupReader *NAMESPACE::MeshFormat_OBJ::openSoup(const char *fname) const
+{
+	return new SoupReader_OBJ(fname);
+}
+
+//---------------------------------------------------------------------------
+
 void NAMESPACE::MeshFormat_OBJ::save(const char *fname,const NAMESPACE::TriangleMesh *mesh) const
 {
 
@@ -75,6 +75,9 @@ namespace LibSL {
       void            save(const char *,const TriangleMesh *) const;
       TriangleMesh   *load(const char *)                      const;
       const char     *signature()                             const {return "obj";}
+      //! streams faces (triangulated); positions seen so far are kept
+      //! in memory since faces index them
+      TriangleSoupReader *openSoup(const char *)              const;
 
     };
 
@@ -48,6 +48,12 @@ using namespace LibSL::Memory::Array;
 using namespace LibSL::Memory::Pointer;
 #include <LibSL/Math/Vertex.h>
 using namespace LibSL::Math;
+#include <LibSL/System/Parallel.h>
+
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
 //---------------------------------------------------------------------------
 
@@ -76,157 +82,747 @@ NAMESPACE::MeshFormat_mesh::MeshFormat_mesh()
 
 using namespace std;
 
+//---------------------------------------------------------------------------
+
+namespace {
+
+  typedef unsigned long long t_Offset;
+
+  const uint c_Magic     = 0x324D534C; // 'LSM2'
+  const uint c_Version   = 2;
+  const uint c_Alignment = 64;
+
+  enum e_Section  { SectionVertices = 1, SectionIndices = 2, SectionSurfaces = 3, SectionMVF = 4, SectionAdjacency = 5 };
+  enum e_Encoding { EncodingRaw = 0, EncodingDeflate = 1 };
+  enum e_Flags    { FlagBBox = 1 };
+
+  struct t_Header
+  {
+    uint  magic;
+    uint  version;
+    uint  sizeofVertex;
+    uint  numVertices;
+    uint  numTriangles;
+    uint  numSurfaces;
+    uint  numSections;
+    uint  flags;
+    float bbox[6];
+    uint  reserved[2];
+  };
+
+  struct t_Section
+  {
+    uint     type;
+    uint     encoding;
+    t_Offset offset;   // from start of file, aligned
+    t_Offset size;     // stored size
+    t_Offset rawSize;  // size once decoded
+  };
+
+  static_assert(sizeof(t_Header)  == 64,"unexpected .mesh header size");
+  static_assert(sizeof(t_Section) == 32,"unexpected .mesh section size");
+  static_assert(sizeof(NAMESPACE::TriangleMesh::t_Triangle) == 3 * sizeof(uint),"triangles are expected to be packed");
+
+  /// section content before it is written
+  struct t_Payload
+  {
+    uint                type;
+    uint                encoding;
+    t_Offset            rawSize;
+    std::vector<uchar>  bytes;
+  };
+
+  template <typename T>
+  void append(std::vector<uchar>& buf,const T& v)
+  {
+    const uchar *p = (const uchar*)&v;
+    buf.insert(buf.end(),p,p + sizeof(T));
+  }
+
+  /// reads forward in a section, throws on overflow
+  class Reader
+  {
+    const uchar *m_Ptr;
+    const uchar *m_End;
+  public:
+    Reader(const uchar *ptr,size_t size) : m_Ptr(ptr), m_End(ptr + size) {}
+    void read(void *dst,size_t size)
+    {
+      if (size > size_t(m_End - m_Ptr)) {
+        throw Fatal("[MeshFormat_mesh::load] - truncated section");
+      }
+      memcpy(dst,m_Ptr,size);
+      m_Ptr += size;
+    }
+    template <typename T> T read() { T v; read(&v,sizeof(T)); return v; }
+  };
+
+  /// deflates in independent chunks:
+  ///   numChunks, chunkSize, compressed size of each chunk, streams
+  void deflateChunks(t_Payload& p,uint chunkSize)
+  {
+    std::vector<uchar> raw;
+    raw.swap(p.bytes);
+    uint nchunks = uint((raw.size() + chunkSize - 1) / chunkSize);
+    std::vector<std::vector<uchar> > streams(nchunks);
+    LibSL::System::Parallel::forIndex(0,int(nchunks),[&](int c) {
+      size_t first = size_t(c) * chunkSize;
+      uLong  len   = uLong(min(size_t(chunkSize),raw.size() - first));
+      uLongf dlen  = compressBound(len);
+      streams[c].resize(dlen);
+      if (compress2(&streams[c][0],&dlen,&raw[first],len,Z_DEFAULT_COMPRESSION) != Z_OK) {
+        dlen = 0; // reported below
+      }
+      streams[c].resize(dlen);
+    });
+    append(p.bytes,nchunks);
+    append(p.bytes,chunkSize);
+    ForIndex(c,nchunks) {
+      if (streams[c].empty()) {
+        throw Fatal("[MeshFormat_mesh::save] - compression failed");
+      }
+      append(p.bytes,uint(streams[c].size()));
+    }
+    ForIndex(c,nchunks) {
+      p.bytes.insert(p.bytes.end(),streams[c].begin(),streams[c].end());
+    }
+    p.encoding = EncodingDeflate;
+  }
+
+  /// a chunk to be inflated
+  struct t_Chunk
+  {
+    const uchar *src;
+    uint         srcSize;
+    uchar       *dst;
+    uint         dstSize;
+  };
+
+  void listChunks(const uchar *stored,const t_Section& sec,uchar *dst,std::vector<t_Chunk>& _chunks)
+  {
+    Reader r(stored,size_t(sec.size));
+    uint nchunks   = r.read<uint>();
+    uint chunkSize = r.read<uint>();
+    if (chunkSize == 0 || t_Offset(nchunks) * chunkSize < sec.rawSize) {
+      throw Fatal("[MeshFormat_mesh::load] - invalid compressed section");
+    }
+    std::vector<uint> sizes(nchunks);
+    if (nchunks > 0) {
+      r.read(&sizes[0],nchunks * sizeof(uint));
+    }
+    t_Offset src = 8 + t_Offset(nchunks) * sizeof(uint);
+    t_Offset out = 0;
+    ForIndex(c,nchunks) {
+      if (src + sizes[c] > sec.size) {
+        throw Fatal("[MeshFormat_mesh::load] - truncated compressed section");
+      }
+      t_Chunk ch;
+      ch.src     = stored + src;
+      ch.srcSize = sizes[c];
+      ch.dst     = dst + out;
+      ch.dstSize = uint(min(t_Offset(chunkSize),sec.rawSize - out));
+      _chunks.push_back(ch);
+      src += sizes[c];
+      out += ch.dstSize;
+    }
+  }
+
+  /// neighbor across edge (i,i+1) of each triangle, uint(-1) on borders
+  /// and non-manifold edges; edges are matched by vertex index
+  void computeAdjacency(const std::vector<uint>& indices,std::vector<uint>& _adj)
+  {
+    uint nt = uint(indices.size() / 3);
+    std::vector<std::pair<unsigned long long,uint> > edges(size_t(nt) * 3);
+    LibSL::System::Parallel::forIndex(0,int(nt),[&](int t) {
+      ForIndex(k,3) {
+        unsigned long long a = indices[t * 3 + k];
+        unsigned long long b = indices[t * 3 + (k + 1) % 3];
+        edges[t * 3 + k] = std::make_pair(min(a,b) << 32 | max(a,b),uint(t * 3 + k));
+      }
+    },1024);
+    std::sort(edges.begin(),edges.end());
+    _adj.assign(size_t(nt) * 3,uint(-1));
+    size_t i = 0;
+    while (i < edges.size()) {
+      size_t j = i + 1;
+      while (j < edges.size() && edges[j].first == edges[i].first) j++;
+      if (j - i == 2) {
+        _adj[edges[i    ].second] = edges[i + 1].second / 3;
+        _adj[edges[i + 1].second] = edges[i    ].second / 3;
+      }
+      i = j;
+    }
+  }
+
+  /// vertex format assumed when a file does not provide one
+  NAMESPACE::MVF *defaultMvf(uint sizeofVertex)
+  {
+    typedef MVF3(mvf_position_3f,mvf_normal_3f,mvf_texcoord0_2f) t_StdVertexFormat;
+    if (MVF_sizeof<t_StdVertexFormat>::value != sizeofVertex) {
+      throw Fatal("[MeshFormat_mesh::load] - no vertex format given, and format does not match the default one <pos,nrm,texcoord>");
+    }
+    return NAMESPACE::MVF::make<t_StdVertexFormat>();
+  }
+
+  void checkRead(size_t nr,size_t expected,const char *fname)
+  {
+    if (nr != expected) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' is truncated",fname);
+    }
+  }
+
+  void loadVersion1(FILE *f,const char *fname,
+                    std::vector<uchar>& _vertices,std::vector<NAMESPACE::TriangleMesh::t_Triangle>& _triangles,
+                    LibSL::Memory::Array::Array<NAMESPACE::TriangleMesh::t_SurfaceNfo>& _surfaces,
+                    AutoPtr<NAMESPACE::MVF>& _mvf,uint& _sizeofVertex,uint& _numv,uint& _numt)
+  {
+    // vertices
+    uint sizeofVertex = 0;
+    checkRead(fread(&sizeofVertex,sizeof(uint),1,f),1,fname);
+    uint numv         = 0;
+    checkRead(fread(&numv,sizeof(uint),1,f),1,fname);
+    _vertices.resize(size_t(numv) * sizeofVertex);
+    if (!_vertices.empty()) {
+      checkRead(fread(&_vertices[0],sizeofVertex,numv,f),numv,fname);
+    }
+    // indices
+    uint numt         = 0;
+    checkRead(fread(&numt,sizeof(uint),1,f),1,fname);
+    _triangles.resize(numt);
+    if (numt > 0) {
+      checkRead(fread(&_triangles[0],sizeof(uint) * 3,numt,f),numt,fname);
+    }
+    // surface information (if exists)
+    uint nums = 0;
+    uint r    = uint(fread(&nums,sizeof(uint),1,f));
+    if (r == 1 && nums > 0) {
+      _surfaces.allocate(nums);
+      char buffer[1024];
+      ForIndex(s,nums) {
+        uint len = 0;
+        checkRead(fread(&len,sizeof(uint),1,f),1,fname);
+        if (len >= 1024) {
+          throw Fatal("[MeshFormat_mesh::load] - texture name is too long (file '%s')",fname);
+        }
+        checkRead(fread(buffer,1,len+1,f),len+1,fname);
+        _surfaces[s].textureName = std::string(buffer);
+        uint numst = 0;
+        checkRead(fread(&numst,sizeof(uint),1,f),1,fname);
+        _surfaces[s].triangleIds.allocate(numst);
+        if (numst > 0) {
+          checkRead(fread(_surfaces[s].triangleIds.raw(),sizeof(uint),numst,f),numst,fname);
+        }
+        checkRead(fread(&_surfaces[s].diffuse[0],sizeof(float),3,f),3,fname);
+      }
+    }
+    // dynamic MVF (if present)
+    _mvf = AutoPtr<NAMESPACE::MVF>(new NAMESPACE::MVF());
+    if (!_mvf->load(f)) {
+      _mvf = AutoPtr<NAMESPACE::MVF>(defaultMvf(sizeofVertex));
+    }
+    _sizeofVertex = sizeofVertex;
+    _numv         = numv;
+    _numt         = numt;
+  }
+
+  /// writes the version 1 layout, returns false on a write error
+  bool saveVersion1(FILE *f,const NAMESPACE::TriangleMesh *mesh)
+  {
+    bool ok = true;
+    // vertices
+    uint sizeofVertex = mesh->sizeOfVertexData();
+    uint numv         = mesh->numVertices();
+    ok = ok && fwrite(&sizeofVertex,sizeof(uint),1,f) == 1;
+    ok = ok && fwrite(&numv,sizeof(uint),1,f) == 1;
+    ForIndex(p,numv) {
+      ok = ok && fwrite(mesh->vertexDataAt(p),sizeofVertex,1,f) == 1;
+    }
+    // triangles
+    uint numt         = mesh->numTriangles();
+    ok = ok && fwrite(&numt,sizeof(uint),1,f) == 1;
+    ForIndex(t,numt) {
+      ForIndex(k,3) {
+        uint i = mesh->triangleAt(t)[k];
+        ok = ok && fwrite(&i,sizeof(uint),1,f) == 1;
+      }
+    }
+    // surfaces: name (zero terminated), triangle ids, diffuse
+    uint nums         = mesh->numSurfaces();
+    ok = ok && fwrite(&nums,sizeof(uint),1,f) == 1;
+    ForIndex(s,nums) {
+      const std::string& texName = mesh->surfaceAt(s).textureName;
+      uint len = uint(texName.length());
+      ok = ok && fwrite(&len,sizeof(uint),1,f) == 1;
+      ok = ok && fwrite(texName.c_str(),1,len + 1,f) == len + 1;
+      uint numst = mesh->surfaceNumTriangles(s);
+      ok = ok && fwrite(&numst,sizeof(uint),1,f) == 1;
+      ForIndex(st,numst) {
+        uint id = mesh->surfaceTriangleIdAt(s,st);
+        ok = ok && fwrite(&id,sizeof(uint),1,f) == 1;
+      }
+      ok = ok && fwrite(&mesh->surfaceAt(s).diffuse[0],sizeof(float),3,f) == 3;
+    }
+    // vertex format
+    if (!mesh->mvf().isNull()) {
+      mesh->mvf()->save(f);
+    }
+    return ok;
+  }
+
+  /// replaces fname by the file written aside
+  void commitFile(const std::string& tmp,const char *fname,bool ok)
+  {
+    if (!ok) {
+      remove(tmp.c_str());
+      throw Fatal("[MeshFormat_mesh::save] - cannot write file '%s'",tmp.c_str());
+    }
+    // a mesh mapping fname keeps reading the old file
+    if (!LibSL::System::File::replace(tmp.c_str(),fname)) {
+      remove(tmp.c_str());
+      throw Fatal("[MeshFormat_mesh::save] - cannot replace file '%s'",fname);
+    }
+  }
+
+  /// triangles must index existing vertices, surfaces existing triangles
+  void checkIndices(const char *fname,const NAMESPACE::TriangleMesh::t_Triangle *tris,uint numt,uint numv,
+                    const LibSL::Memory::Array::Array<NAMESPACE::TriangleMesh::t_SurfaceNfo>& surfaces)
+  {
+    std::atomic<bool> bad(false);
+    LibSL::System::Parallel::forChunks(0,int(numt),[&](int first,int last) {
+      const uint *idx = &tris[first][0];
+      uint        mx  = 0;
+      ForRange(i,0,(last - first) * 3 - 1) { mx = max(mx,idx[i]); }
+      if (mx >= numv) bad = true;
+    },1 << 16);
+    if (bad) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' has a triangle index out of range",fname);
+    }
+    ForIndex(s,surfaces.size()) {
+      const LibSL::Memory::Array::Array<uint>& ids = surfaces[s].triangleIds;
+      ForIndex(i,ids.size()) {
+        if (ids[i] >= numt) {
+          throw Fatal("[MeshFormat_mesh::load] - file '%s' has a surface triangle id out of range",fname);
+        }
+      }
+    }
+  }
+
+} // namespace
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::TriangleMesh_mapped::TriangleMesh_mapped(AutoPtr<MVF> mvf)
+  : m_MVF(mvf), m_SizeOfVertex(mvf.isNull() ? 0 : mvf->sizeOf()),
+    m_NumVertices(0), m_NumTriangles(0), m_Vertices(NULL), m_Triangles(NULL), m_Adjacency(NULL)
+{
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh_mapped::allocate(uint numvert,uint numtris,uint numsurfaces)
+{
+  m_OwnVertices .assign(size_t(numvert) * m_SizeOfVertex,0);
+  m_OwnTriangles.assign(numtris,t_Triangle(0u));
+  m_OwnAdjacency.clear();
+  m_NumVertices  = numvert;
+  m_NumTriangles = numtris;
+  m_Vertices     = m_OwnVertices .empty() ? NULL : &m_OwnVertices [0];
+  m_Triangles    = m_OwnTriangles.empty() ? NULL : &m_OwnTriangles[0];
+  m_Adjacency    = NULL;
+  m_Surfaces.erase();
+  if (numsurfaces > 0) {
+    m_Surfaces.allocate(numsurfaces);
+  }
+  m_BBoxComputed = false;
+  // nothing points into the file anymore
+  m_File = AutoPtr<LibSL::System::File::MappedFile>();
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh_mapped::truncateVertices(uint sz)
+{
+  sl_assert(sz <= m_NumVertices);
+  m_NumVertices = sz;
+  if (!m_OwnVertices.empty()) {
+    m_OwnVertices.resize(size_t(sz) * m_SizeOfVertex);
+    m_Vertices = m_OwnVertices.empty() ? NULL : &m_OwnVertices[0];
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh_mapped::reorderVerticesAndTruncate(const Array<uint>& order)
+{
+  std::vector<uchar> vertices(size_t(order.size()) * m_SizeOfVertex);
+  ForArray(order,o) {
+    memcpy(&vertices[size_t(o) * m_SizeOfVertex],vertexDataAt(order[o]),m_SizeOfVertex);
+  }
+  m_OwnVertices.swap(vertices);
+  m_NumVertices = order.size();
+  m_Vertices    = m_OwnVertices.empty() ? NULL : &m_OwnVertices[0];
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::TriangleMesh_mapped::setMvf(const AutoPtr<MVF>& mvf)
+{
+  if (!mvf.isNull() && m_NumVertices > 0 && mvf->sizeOf() != m_SizeOfVertex) {
+    throw Errors::Fatal("TriangleMesh_mapped::setMvf - size of MVF (%d) must match size of vertex data (%d)",mvf->sizeOf(),m_SizeOfVertex);
+  }
+  m_MVF = mvf;
+  if (!mvf.isNull()) {
+    m_SizeOfVertex = mvf->sizeOf();
+  }
+}
+
+//---------------------------------------------------------------------------
+
+bool NAMESPACE::TriangleMesh_mapped::isMapped() const
+{
+  return !m_File.isNull() && m_OwnVertices.empty() && m_OwnTriangles.empty();
+}
+
+//---------------------------------------------------------------------------
+
+NAMESPACE::TriangleMesh *NAMESPACE::TriangleMesh_mapped::newInstance() const
+{
+  return new TriangleMesh_mapped(m_MVF);
+}
+
+//---------------------------------------------------------------------------
+
 NAMESPACE::TriangleMesh *NAMESPACE::MeshFormat_mesh::load(const char *fname) const
 {
-	TriangleMesh_generic<Array<uchar> > *m = NULL;
-
-	size_t nr = 0;
-	LIBSL_BEGIN;
-	// open file
-	FILE *f = NULL;
-	fopen_s(&f, fname, "rb");
-	if (f == NULL) {
-		throw Fatal("[MeshFormat_mesh::load] - file '%s' not found",fname);
-	}
-	// read vertices
-	uint sizeofVertex = 0;
-	nr = fread(&sizeofVertex,sizeof(uint),1,f);
-	uint numv         = 0;
-	nr = fread(&numv,sizeof(uint),1,f);
-	Array<uchar> vertices(numv*sizeofVertex);
-	fread(vertices.raw(),sizeofVertex,numv,f);
-	// read indices
-	uint numt         = 0;
-	nr = fread(&numt,sizeof(uint),1,f);
-	uint numi         = numt*3;
-	Array<uint> indices(numi);
-	nr = fread(indices.raw(),sizeof(uint),numi,f);
-	// read surface information (if exists)
-	uint nums = 0;
-	uint r = uint(fread(&nums,sizeof(uint),1,f));
-	Array<std::string>  srfTexNames;
-	Array<Array<uint> > srfTris;
-	Array<v3f         > srfDiffuse;
-	static char buffer[1024];
-	if (r == 1 && nums > 0) {
-		LIBSL_BEGIN;    
-		srfTexNames.allocate(nums);
-		srfTris    .allocate(nums);
-		srfDiffuse .allocate(nums);
-		ForIndex(s,nums) {
-			// read texture name
-			uint len = 0;
-			nr = fread(&len,sizeof(uint),1,f);
-			if (len >= 1024) {
-				throw Fatal("[MeshFormat_mesh::load] - texture name is too long (file '%s')",fname);
-			}
-			nr = fread(buffer,1,len+1,f);
-			srfTexNames[s]  = std::string(buffer);
-			// read surface triangle ids
-			uint numst = 0;
-			nr = fread(&numst,sizeof(uint),1,f);
-			srfTris[s].allocate(numst);
-			// read ids
-			ForIndex(st,numst) {
-				nr = fread(&(srfTris[s][st]),sizeof(uint),1,f);
-			}
-			// read diffuse
-			fread(&srfDiffuse[s][0],sizeof(float),3,f);
-		}
-		LIBSL_END;
-	}
-
-	// read dynamic MVF (if present)
-	AutoPtr<MVF> mvf( new MVF() );
-	if (!mvf->load(f)) {
-		typedef MVF3(mvf_position_3f,mvf_normal_3f,mvf_texcoord0_2f) t_StdVertexFormat;
-		if (MVF_sizeof<t_StdVertexFormat>::value == sizeofVertex) {
-      mvf = AutoPtr<MVF>(MVF::make<t_StdVertexFormat>());
-		} else {
-			fclose(f);
-			throw Fatal("[MeshFormat_mesh::load] - no vertex format given, and format does not match the default one <pos,nrm,texcoord>");
-		}
-	}
-	// close file
-	fclose(f);
-
-	m = new TriangleMesh_generic<Array<uchar> >(numv,numt,nums,mvf);
-
-		// build mesh
-		LIBSL_BEGIN;
-		ForIndex(t,numt) {
-			ForIndex(k,3) {
-				m->triangleAt(t)[k] = indices[t*3+k];
-			}
-		}
-		ForIndex(s,nums) {
-			m->surfaceAt(s).textureName = srfTexNames[s];
-			m->surfaceAt(s).triangleIds = srfTris    [s];
-			m->surfaceAt(s).diffuse     = srfDiffuse [s];
-		}
-		ForIndex(p,numv) {
-			memcpy( m->vertexDataAt(p), vertices.raw()+p*sizeofVertex, sizeofVertex);
-		}
-		LIBSL_END;
-
-	// done
-	return (m);
-	LIBSL_END;
+  TriangleMesh_mapped *m = new TriangleMesh_mapped();
+  try {
+    read(fname,m);
+  } catch (...) {
+    delete m;
+    throw;
+  }
+  return m;
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::MeshFormat_mesh::read(const char *fname,TriangleMesh_mapped *m)
+{
+  LIBSL_BEGIN;
+
+  AutoPtr<LibSL::System::File::MappedFile> file(new LibSL::System::File::MappedFile(fname));
+  const uchar *data = file->data();
+  size_t       size = file->size();
+
+  t_Header hdr;
+  if (size < sizeof(t_Header) || (memcpy(&hdr,data,sizeof(t_Header)), hdr.magic != c_Magic)) {
+    // version 1, read in bulk into owned storage
+    file = AutoPtr<LibSL::System::File::MappedFile>();
+    FILE *f = NULL;
+    fopen_s(&f, fname, "rb");
+    if (f == NULL) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' not found",fname);
+    }
+    try {
+      loadVersion1(f,fname,m->m_OwnVertices,m->m_OwnTriangles,m->m_Surfaces,m->m_MVF,m->m_SizeOfVertex,m->m_NumVertices,m->m_NumTriangles);
+    } catch (...) {
+      fclose(f);
+      throw;
+    }
+    fclose(f);
+    m->m_Vertices  = m->m_OwnVertices .empty() ? NULL : &m->m_OwnVertices [0];
+    m->m_Triangles = m->m_OwnTriangles.empty() ? NULL : &m->m_OwnTriangles[0];
+    checkIndices(fname,m->m_Triangles,m->m_NumTriangles,m->m_NumVertices,m->m_Surfaces);
+    return;
+  }
+
+  if (hdr.version != c_Version) {
+    throw Fatal("[MeshFormat_mesh::load] - file '%s' has unsupported version %d",fname,hdr.version);
+  }
+  if (sizeof(t_Header) + t_Offset(hdr.numSections) * sizeof(t_Section) > size) {
+    throw Fatal("[MeshFormat_mesh::load] - file '%s' is truncated",fname);
+  }
+  std::vector<t_Section> sections(hdr.numSections);
+  if (hdr.numSections > 0) {
+    memcpy(&sections[0],data + sizeof(t_Header),hdr.numSections * sizeof(t_Section));
+  }
+
+  m->m_SizeOfVertex = hdr.sizeofVertex;
+  m->m_NumVertices  = hdr.numVertices;
+  m->m_NumTriangles = hdr.numTriangles;
+
+  // locate sections, in place when raw, decoded in parallel otherwise
+  std::vector<t_Chunk> chunks;
+  std::vector<uchar>   surfaces,mvf;
+  const uchar         *surfacesPtr = NULL,*mvfPtr = NULL;
+  size_t               surfacesSize = 0,mvfSize = 0;
+  ForIndex(s,sections.size()) {
+    const t_Section& sec = sections[s];
+    if (sec.offset + sec.size > size || sec.offset % sizeof(uint) != 0) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' has an invalid section table",fname);
+    }
+    t_Offset expected = sec.rawSize;
+    if        (sec.type == SectionVertices) {
+      expected = t_Offset(hdr.numVertices) * hdr.sizeofVertex;
+    } else if (sec.type == SectionIndices || sec.type == SectionAdjacency) {
+      expected = t_Offset(hdr.numTriangles) * 3 * sizeof(uint);
+    }
+    if (sec.rawSize != expected || (sec.encoding == EncodingRaw && sec.size != sec.rawSize)) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' has an invalid section size",fname);
+    }
+    uchar *stored = file->data() + sec.offset;
+    uchar *dst    = NULL;
+    if (sec.encoding == EncodingRaw) {
+      dst = stored;
+    } else if (sec.encoding == EncodingDeflate) {
+      switch (sec.type) {
+      case SectionVertices:  m->m_OwnVertices .resize(size_t(sec.rawSize));        dst = m->m_OwnVertices.empty()  ? NULL : &m->m_OwnVertices[0];         break;
+      case SectionIndices:   m->m_OwnTriangles.resize(hdr.numTriangles);          dst = m->m_OwnTriangles.empty() ? NULL : (uchar*)&m->m_OwnTriangles[0]; break;
+      case SectionAdjacency: m->m_OwnAdjacency.resize(size_t(hdr.numTriangles) * 3); dst = m->m_OwnAdjacency.empty() ? NULL : (uchar*)&m->m_OwnAdjacency[0]; break;
+      case SectionSurfaces:  surfaces.resize(size_t(sec.rawSize));                 dst = surfaces.empty() ? NULL : &surfaces[0]; break;
+      case SectionMVF:       mvf.resize(size_t(sec.rawSize));                      dst = mvf.empty()      ? NULL : &mvf[0];      break;
+      default: continue; // unknown sections are skipped
+      }
+      listChunks(stored,sec,dst,chunks);
+    } else {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' has an unknown section encoding",fname);
+    }
+    switch (sec.type) {
+    case SectionVertices:  m->m_Vertices  = dst;                   break;
+    case SectionIndices:   m->m_Triangles = (TriangleMesh::t_Triangle*)dst; break;
+    case SectionAdjacency: m->m_Adjacency = (const uint*)dst;      break;
+    case SectionSurfaces:  surfacesPtr = dst; surfacesSize = size_t(sec.rawSize); break;
+    case SectionMVF:       mvfPtr      = dst; mvfSize      = size_t(sec.rawSize); break;
+    default: break;
+    }
+  }
+  if ((hdr.numVertices > 0 && m->m_Vertices == NULL) || (hdr.numTriangles > 0 && m->m_Triangles == NULL)) {
+    throw Fatal("[MeshFormat_mesh::load] - file '%s' has no vertex or index section",fname);
+  }
+  std::vector<uchar> failed(chunks.size(),0);
+  LibSL::System::Parallel::forIndex(0,int(chunks.size()),[&](int c) {
+    uLongf len = chunks[c].dstSize;
+    failed[c]  = uncompress(chunks[c].dst,&len,chunks[c].src,chunks[c].srcSize) != Z_OK || len != chunks[c].dstSize;
+  });
+  ForIndex(c,failed.size()) {
+    if (failed[c]) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' has a corrupted compressed section",fname);
+    }
+  }
+
+  // surfaces
+  if (surfacesPtr != NULL) {
+    Reader r(surfacesPtr,surfacesSize);
+    uint nums = r.read<uint>();
+    if (nums != hdr.numSurfaces) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' has an invalid surface section",fname);
+    }
+    if (nums > 0) {
+      m->m_Surfaces.allocate(nums);
+    }
+    ForIndex(s,nums) {
+      TriangleMesh::t_SurfaceNfo& srf = m->m_Surfaces[s];
+      uint len = r.read<uint>();
+      std::vector<char> name(len + 1,'\0');
+      r.read(&name[0],len);
+      srf.textureName = std::string(&name[0]);
+      r.read(&srf.diffuse[0],sizeof(float) * 3);
+      uint numst = r.read<uint>();
+      srf.triangleIds.allocate(numst);
+      if (numst > 0) {
+        r.read(srf.triangleIds.raw(),numst * sizeof(uint));
+      }
+    }
+  }
+  // vertex format
+  if (mvfPtr != NULL) {
+    Reader r(mvfPtr,mvfSize);
+    int n = r.read<int>();
+    m->m_MVF = AutoPtr<MVF>(new MVF());
+    ForIndex(a,n) {
+      m->m_MVF->addAttribute(r.read<MVF::Attribute>());
+    }
+    if (m->m_MVF->sizeOf() != hdr.sizeofVertex) {
+      throw Fatal("[MeshFormat_mesh::load] - file '%s' vertex format does not match vertex size",fname);
+    }
+  } else {
+    m->m_MVF = AutoPtr<MVF>(defaultMvf(hdr.sizeofVertex));
+  }
+  checkIndices(fname,m->m_Triangles,m->m_NumTriangles,m->m_NumVertices,m->m_Surfaces);
+  // bounding box
+  if (hdr.flags & FlagBBox) {
+    m->m_BBox         = LibSL::Geometry::AABox(v3f(hdr.bbox[0],hdr.bbox[1],hdr.bbox[2]),v3f(hdr.bbox[3],hdr.bbox[4],hdr.bbox[5]));
+    m->m_BBoxComputed = true;
+  }
+
+  m->m_File = file;
+
+  LIBSL_END;
 }
 
 //---------------------------------------------------------------------------
 
 void NAMESPACE::MeshFormat_mesh::save(const char *fname,const NAMESPACE::TriangleMesh *mesh) const
 {
-  // open file
-  FILE *f;
-	fopen_s(&f, fname, "wb");
-  if (f == NULL) {
-    throw Fatal("[MeshFormat_mesh::save] - cannot create file '%s'",fname);
+  save(fname,mesh,t_SaveOptions());
+}
+
+//---------------------------------------------------------------------------
+
+void NAMESPACE::MeshFormat_mesh::save(const char *fname,const NAMESPACE::TriangleMesh *mesh,const t_SaveOptions& options)
+{
+  if (options.version != 1 && options.version != c_Version) {
+    throw Fatal("[MeshFormat_mesh::save] - unsupported version %d",options.version);
   }
-  // write vertices
+  // write aside, then replace
+  std::string tmp = std::string(fname) + ".tmp";
+  if (options.version == 1) {
+    FILE *f = NULL;
+    fopen_s(&f, tmp.c_str(), "wb");
+    if (f == NULL) {
+      throw Fatal("[MeshFormat_mesh::save] - cannot create file '%s'",tmp.c_str());
+    }
+    bool ok = saveVersion1(f,mesh);
+    ok = (fclose(f) == 0) && ok;
+    commitFile(tmp,fname,ok);
+    return;
+  }
+
   uint sizeofVertex = mesh->sizeOfVertexData();
-  fwrite(&sizeofVertex,sizeof(uint),1,f);
   uint numv         = mesh->numVertices();
-  fwrite(&numv,sizeof(uint),1,f);
-  ForIndex(p,numv) {
-    fwrite(mesh->vertexDataAt(p),sizeofVertex,1,f);
-  }
-  // write triangles
   uint numt         = mesh->numTriangles();
-  fwrite(&numt,sizeof(uint),1,f);
+  uint nums         = mesh->numSurfaces();
+
+  t_Header hdr;
+  memset(&hdr,0,sizeof(t_Header));
+  hdr.magic        = c_Magic;
+  hdr.version      = c_Version;
+  hdr.sizeofVertex = sizeofVertex;
+  hdr.numVertices  = numv;
+  hdr.numTriangles = numt;
+  hdr.numSurfaces  = nums;
+
+  std::vector<t_Payload> payloads;
+  // vertices
+  payloads.push_back(t_Payload());
+  payloads.back().type = SectionVertices;
+  payloads.back().bytes.resize(size_t(numv) * sizeofVertex);
+  {
+    std::vector<uchar>& dst = payloads.back().bytes;
+    LibSL::System::Parallel::forIndex(0,int(numv),[&](int v) {
+      memcpy(&dst[size_t(v) * sizeofVertex],mesh->vertexDataAt(v),sizeofVertex);
+    },4096);
+  }
+  // indices
+  std::vector<uint> indices(size_t(numt) * 3);
   ForIndex(t,numt) {
     ForIndex(k,3) {
-      uint i = mesh->triangleAt(t)[k];
-      fwrite(&i,sizeof(uint),1,f);
+      indices[t * 3 + k] = mesh->triangleAt(t)[k];
     }
   }
-  // write surface information
-  uint nums         = mesh->numSurfaces();
-  fwrite(&nums,sizeof(uint),1,f);
-  ForIndex(s,nums) {
-    // write texture name
-    std::string texName  = mesh->surfaceTextureName(s);
-    uint len             = uint(texName.length());
-    fwrite(&len,sizeof(uint),1,f);
-    fwrite(texName.c_str(),1,len+1,f);
-    // write number of triangles
-    uint numst      = mesh->surfaceNumTriangles(s);
-    fwrite(&numst,sizeof(uint),1,f);
-    // write ids
-    ForIndex(st,numst) {
-      uint id     = mesh->surfaceTriangleIdAt(s,st);
-      fwrite(&id,sizeof(uint),1,f);
-    }
-    // write diffuse
-    fwrite(&mesh->surfaceAt(s).diffuse[0],sizeof(float),3,f);
-  }
-  // write MVF
+  payloads.push_back(t_Payload());
+  payloads.back().type = SectionIndices;
+  if (!indices.empty()) {
+    payloads.back().bytes.assign((const uchar*)&indices[0],(const uchar*)(&indices[0] + indices.size()));
+  }
+  // surfaces
+  payloads.push_back(t_Payload());
+  payloads.back().type = SectionSurfaces;
+  {
+    std::vector<uchar>& dst = payloads.back().bytes;
+    append(dst,nums);
+    ForIndex(s,nums) {
+      const TriangleMesh::t_SurfaceNfo& srf = mesh->surfaceAt(s);
+      append(dst,uint(srf.textureName.length()));
+      dst.insert(dst.end(),srf.textureName.begin(),srf.textureName.end());
+      append(dst,srf.diffuse);
+      uint numst = mesh->surfaceNumTriangles(s);
+      append(dst,numst);
+      ForIndex(st,numst) {
+        append(dst,mesh->surfaceTriangleIdAt(s,st));
+      }
+    }
+  }
+  // vertex format
   if (!mesh->mvf().isNull()) {
-    mesh->mvf()->save(f);
+    payloads.push_back(t_Payload());
+    payloads.back().type = SectionMVF;
+    const std::vector<MVF::Attribute>& attribs = mesh->mvf()->attributes();
+    append(payloads.back().bytes,int(attribs.size()));
+    ForIndex(a,attribs.size()) {
+      append(payloads.back().bytes,attribs[a]);
+    }
+  }
+  // adjacency
+  if (options.adjacency) {
+    payloads.push_back(t_Payload());
+    payloads.back().type = SectionAdjacency;
+    std::vector<uint> adj;
+    computeAdjacency(indices,adj);
+    if (!adj.empty()) {
+      payloads.back().bytes.assign((const uchar*)&adj[0],(const uchar*)(&adj[0] + adj.size()));
+    }
+  }
+  // bounding box
+  if (numv > 0) {
+    v3f mn = mesh->posAt(0),mx = mesh->posAt(0);
+    ForIndex(v,numv) {
+      const v3f& p = mesh->posAt(v);
+      ForIndex(i,3) {
+        mn[i] = min(mn[i],p[i]);
+        mx[i] = max(mx[i],p[i]);
+      }
+    }
+    ForIndex(i,3) {
+      hdr.bbox[i]     = mn[i];
+      hdr.bbox[i + 3] = mx[i];
+    }
+    hdr.flags |= FlagBBox;
+  }
+  // encode
+  ForIndex(p,payloads.size()) {
+    payloads[p].encoding = EncodingRaw;
+    payloads[p].rawSize  = payloads[p].bytes.size();
+    bool bulk = payloads[p].type == SectionVertices || payloads[p].type == SectionIndices || payloads[p].type == SectionAdjacency;
+    if (options.compress && bulk && !payloads[p].bytes.empty()) {
+      deflateChunks(payloads[p],max(1u,options.chunkSize));
+    }
+  }
+  // layout
+  hdr.numSections = uint(payloads.size());
+  std::vector<t_Section> sections(payloads.size());
+  t_Offset offset = sizeof(t_Header) + payloads.size() * sizeof(t_Section);
+  ForIndex(p,payloads.size()) {
+    offset = (offset + c_Alignment - 1) / c_Alignment * c_Alignment;
+    sections[p].type     = payloads[p].type;
+    sections[p].encoding = payloads[p].encoding;
+    sections[p].offset   = offset;
+    sections[p].size     = payloads[p].bytes.size();
+    sections[p].rawSize  = payloads[p].rawSize;
+    offset += sections[p].size;
+  }
+
+  FILE *f = NULL;
+  fopen_s(&f, tmp.c_str(), "wb");
+  if (f == NULL) {
+    throw Fatal("[MeshFormat_mesh::save] - cannot create file '%s'",tmp.c_str());
+  }
+  static const uchar zeros[c_Alignment] = { 0 };
+  t_Offset written = 0;
+  bool     ok      = true;
+  ok = ok && fwrite(&hdr,sizeof(t_Header),1,f) == 1;
+  ok = ok && fwrite(&sections[0],sizeof(t_Section),sections.size(),f) == sections.size();
+  written = sizeof(t_Header) + sections.size() * sizeof(t_Section);
+  ForIndex(p,payloads.size()) {
+    size_t pad = size_t(sections[p].offset - written);
+    ok = ok && fwrite(zeros,1,pad,f) == pad;
+    if (!payloads[p].bytes.empty()) {
+      ok = ok && fwrite(&payloads[p].bytes[0],1,payloads[p].bytes.size(),f) == payloads[p].bytes.size();
+    }
+    written = sections[p].offset + sections[p].size;
   }
-  // close file
-  fclose(f);
+  ok = (fclose(f) == 0) && ok;
+  commitFile(tmp,fname,ok);
 }
 
 //---------------------------------------------------------------------------
@@ -38,8 +38,17 @@ knowledge of the CeCILL-C license and that you accept its terms.
 // ------------------------------------------------------
 //
 // Load/save LibSL 'mesh' file format
-// 
-// TODO: make the load process more flexible (arbitrary vertex format)
+//
+// Version 2 starts with a 64 bytes header (magic 'LSM2',
+// version, counts and bounding box) followed by a table of
+// sections: vertices, indices, surfaces, MVF and optionally
+// the triangle adjacency. Sections are 64 bytes aligned so
+// that uncompressed vertices and indices are used in place
+// from a memory mapping of the file: loading is instant.
+// Compressed sections (zlib) are split in independent
+// chunks, decoded in parallel.
+// Version 1 files (no header) are still read, and can be
+// written for older readers.
 //
 // ------------------------------------------------------
 // Sylvain Lefebvre - 2006-11-15
@@ -49,19 +58,115 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include <LibSL/Math/Vertex.h>
 #include <LibSL/Mesh/Mesh.h>
+#include <LibSL/System/System.h>
+
+#include <vector>
 
 namespace LibSL {
   namespace Mesh {
 
-    class MeshFormat_mesh : public TriangleMeshFormat_plugin
+    class TriangleMesh_mapped;
+
+    class LIBSL_DLL MeshFormat_mesh : public TriangleMeshFormat_plugin
     {
+    protected:
+
+      static void    read(const char *fname,TriangleMesh_mapped *m);
+
     public:
 
+      //! options for writing files
+      class t_SaveOptions
+      {
+      public:
+        uint version;    // 2, or 1 for older readers (other options are then ignored)
+        bool compress;   // deflate the vertex, index and adjacency sections
+        bool adjacency;  // store the triangle adjacency (see TriangleMesh_mapped::adjacency)
+        uint chunkSize;  // size of independently compressed chunks, in bytes
+        t_SaveOptions() : version(2), compress(false), adjacency(false), chunkSize(1u << 20) {}
+      };
+
       MeshFormat_mesh();
       void           save(const char *,const TriangleMesh *) const;
       TriangleMesh  *load(const char *)                      const;
       const char    *signature()                             const {return "mesh";}
 
+      //! writes a version 2 (or version 1) file
+      //  the file is written aside and renamed, so that meshes
+      //  still mapping the previous content remain valid
+      static void    save(const char *fname,const TriangleMesh *mesh,const t_SaveOptions& options);
+
+    };
+
+    //! TriangleMesh view on a version 2 file
+    //  Vertices and indices point into the (copy-on-write) mapping
+    //  of the file whenever the sections are not compressed. The
+    //  file is kept mapped for the lifetime of the mesh.
+    class LIBSL_DLL TriangleMesh_mapped : public TriangleMesh
+    {
+    protected:
+
+      LibSL::Memory::Pointer::AutoPtr<LibSL::System::File::MappedFile> m_File;
+      LibSL::Memory::Pointer::AutoPtr<MVF>       m_MVF;
+      uint                                       m_SizeOfVertex;
+      uint                                       m_NumVertices;
+      uint                                       m_NumTriangles;
+      uchar                                     *m_Vertices;
+      t_Triangle                                *m_Triangles;
+      const uint                                *m_Adjacency;
+      LibSL::Memory::Array::Array<t_SurfaceNfo>  m_Surfaces;
+      // storage when not in the mapping (decompressed or modified)
+      std::vector<uchar>                         m_OwnVertices;
+      std::vector<t_Triangle>                    m_OwnTriangles;
+      std::vector<uint>                          m_OwnAdjacency;
+
+      void truncateVertices(uint sz);
+      void reorderVerticesAndTruncate(const LibSL::Memory::Array::Array<uint>& order);
+
+      friend class MeshFormat_mesh;
+
+    public:
+
+      TriangleMesh_mapped(LibSL::Memory::Pointer::AutoPtr<MVF> mvf = LibSL::Memory::Pointer::AutoPtr<MVF>());
+
+      void                 allocate(uint numvert,uint numtris,uint numsurfaces = 0);
+
+      uint                 numVertices()        const { return m_NumVertices; }
+      const v3&            posAt(uint n)        const { return *m_MVF->pos3(m_Vertices + size_t(n) * m_SizeOfVertex); }
+      v3&                  posAt(uint n)              { return *m_MVF->pos3(m_Vertices + size_t(n) * m_SizeOfVertex); }
+      const void          *vertexDataAt(uint n) const { return m_Vertices + size_t(n) * m_SizeOfVertex; }
+      void                *vertexDataAt(uint n)       { return m_Vertices + size_t(n) * m_SizeOfVertex; }
+      uint                 sizeOfVertexData()   const { return m_SizeOfVertex; }
+
+      uint                 numTriangles()       const { return m_NumTriangles; }
+      const t_Triangle&    triangleAt(uint t)   const { return m_Triangles[t]; }
+      t_Triangle&          triangleAt(uint t)         { return m_Triangles[t]; }
+
+      const LibSL::Memory::Pointer::AutoPtr<MVF>& mvf() const { return m_MVF; }
+      void                 setMvf(const LibSL::Memory::Pointer::AutoPtr<MVF>& mvf);
+
+      uint                 numSurfaces()                      const { return m_Surfaces.size(); }
+      const t_SurfaceNfo&  surfaceAt(uint s)                  const { return m_Surfaces[s]; }
+      t_SurfaceNfo&        surfaceAt(uint s)                        { return m_Surfaces[s]; }
+      std::string&         surfaceTextureName (uint s)              { return m_Surfaces[s].textureName; }
+      const std::string&   surfaceTextureName (uint s)        const { return m_Surfaces[s].textureName; }
+      uint                 surfaceNumTriangles(uint s)        const { return m_Surfaces[s].triangleIds.size(); }
+      uint                 surfaceTriangleIdAt(uint s,uint t) const { return m_Surfaces[s].triangleIds[t]; }
+
+      StridedView<uchar>        vertexBlock()               { return StridedView<uchar>      (m_Vertices,m_NumVertices,m_SizeOfVertex); }
+      StridedView<const uchar>  vertexBlock()         const { return StridedView<const uchar>(m_Vertices,m_NumVertices,m_SizeOfVertex); }
+      t_Triangle               *indexBuffer()               { return m_Triangles; }
+      const t_Triangle         *indexBuffer()         const { return m_Triangles; }
+
+      //! adjacency stored in the file, NULL if absent
+      //  three entries per triangle: neighbor across edge (i,i+1), or uint(-1)
+      //  reflects the file content, it is dropped by allocate
+      const uint          *adjacency()          const { return m_Adjacency; }
+
+      //! true if vertices and indices are used in place from the file mapping
+      bool                 isMapped()           const;
+
+      TriangleMesh        *newInstance()        const;
     };
 
   } //namespace LibSL::Mesh
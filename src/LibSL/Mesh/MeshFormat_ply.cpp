@@ -51,6 +51,8 @@ using namespace LibSL::Math;
 
 #include "rply.h"
 #include <string>
+#include <sstream>
+#include <cctype>
 
 //---------------------------------------------------------------------------
 
@@ -90,6 +92,294 @@ NAMESPACE::TriangleMesh *NAMESPACE::MeshFormat_ply::load(const char *fname) cons
 
 //---------------------------------------------------------------------------
 
+namespace {
+
+  enum e_PlyFormat { PlyASCII, PlyBinaryLE, PlyBinaryBE };
+  enum e_PlyType   { PlyInt8, PlyUInt8, PlyInt16, PlyUInt16, PlyInt32, PlyUInt32, PlyFloat32, PlyFloat64 };
+
+  const int c_PlyTypeSize[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+  // longest list accepted, larger counts come from corrupt files
+  const int c_PlyMaxListCount = 1 << 20;
+
+  e_PlyType plyType(const std::string& name)
+  {
+    if (name == "char"   || name == "int8"   ) return PlyInt8;
+    if (name == "uchar"  || name == "uint8"  ) return PlyUInt8;
+    if (name == "short"  || name == "int16"  ) return PlyInt16;
+    if (name == "ushort" || name == "uint16" ) return PlyUInt16;
+    if (name == "int"    || name == "int32"  ) return PlyInt32;
+    if (name == "uint"   || name == "uint32" ) return PlyUInt32;
+    if (name == "float"  || name == "float32") return PlyFloat32;
+    if (name == "double" || name == "float64") return PlyFloat64;
+    throw Fatal("[MeshFormat_ply::openSoup] - unknown property type '%s'",name.c_str());
+  }
+
+  struct t_PlyProperty
+  {
+    std::string name;
+    e_PlyType   type;
+    bool        isList;
+    e_PlyType   countType;
+  };
+
+  struct t_PlyElement
+  {
+    std::string                 name;
+    long long                   count;
+    std::vector<t_PlyProperty>  props;
+  };
+
+  /// pull parser over the body of a ply file, faces are fan triangulated
+  class SoupReader_ply : public NAMESPACE::TriangleSoupReader
+  {
+  protected:
+
+    FILE                       *m_File;
+    std::vector<uchar>          m_Buffer;
+    size_t                      m_BufPos;
+    size_t                      m_BufEnd;
+    e_PlyFormat                 m_Format;
+    bool                        m_Swap;
+    std::vector<t_PlyElement>   m_Elements;
+    uint                        m_Element;   // element being read
+    long long                   m_Row;       // next row in that element
+    std::vector<v3f>            m_Positions;
+    std::vector<v3f>            m_Pending;   // triangles beyond the last batch
+    std::vector<uint>           m_Face;
+
+    int getc()
+    {
+      if (m_BufPos == m_BufEnd) {
+        m_BufPos = 0;
+        m_BufEnd = fread(&m_Buffer[0],1,m_Buffer.size(),m_File);
+        if (m_BufEnd == 0) {
+          return EOF;
+        }
+      }
+      return m_Buffer[m_BufPos ++];
+    }
+
+    std::string readLine()
+    {
+      std::string line;
+      int c;
+      while ((c = getc()) != EOF && c != '\n') {
+        if (c != '\r') line += char(c);
+      }
+      if (c == EOF && line.empty()) {
+        throw Fatal("[MeshFormat_ply::openSoup] - unexpected end of header");
+      }
+      return line;
+    }
+
+    double readValue(e_PlyType type)
+    {
+      if (m_Format == PlyASCII) {
+        char tok[64];
+        int  c,n = 0;
+        while ((c = getc()) != EOF && isspace(c)) { }
+        while (c != EOF && !isspace(c) && n < 63) { tok[n ++] = char(c); c = getc(); }
+        if (n == 0) {
+          throw Fatal("[MeshFormat_ply::openSoup] - file is truncated");
+        }
+        tok[n] = '\0';
+        return strtod(tok,NULL);
+      }
+      uchar b[8];
+      int   sz = c_PlyTypeSize[type];
+      ForIndex(i,sz) {
+        int c = getc();
+        if (c == EOF) {
+          throw Fatal("[MeshFormat_ply::openSoup] - file is truncated");
+        }
+        b[m_Swap ? sz - 1 - i : i] = uchar(c);
+      }
+      switch (type) {
+      case PlyInt8:    return *(const char  *)b;
+      case PlyUInt8:   return *(const uchar *)b;
+      case PlyInt16:   { short  v; memcpy(&v,b,2); return v; }
+      case PlyUInt16:  { ushort v; memcpy(&v,b,2); return v; }
+      case PlyInt32:   { int    v; memcpy(&v,b,4); return v; }
+      case PlyUInt32:  { uint   v; memcpy(&v,b,4); return v; }
+      case PlyFloat32: { float  v; memcpy(&v,b,4); return v; }
+      default:         { double v; memcpy(&v,b,8); return v; }
+      }
+    }
+
+    int readCount(e_PlyType type)
+    {
+      double n = readValue(type);
+      if (!(n >= 0.0 && n <= double(c_PlyMaxListCount))) {
+        throw Fatal("[MeshFormat_ply::openSoup] - invalid list count");
+      }
+      return int(n);
+    }
+
+    void readHeader(const char *fname)
+    {
+      if (readLine() != "ply") {
+        throw Fatal("[MeshFormat_ply::openSoup] - '%s' is not a ply file",fname);
+      }
+      while (true) {
+        std::istringstream line(readLine());
+        std::string key;
+        line >> key;
+        if (key == "format") {
+          std::string fmt;
+          line >> fmt;
+          if      (fmt == "ascii")                m_Format = PlyASCII;
+          else if (fmt == "binary_little_endian") m_Format = PlyBinaryLE;
+          else if (fmt == "binary_big_endian")    m_Format = PlyBinaryBE;
+          else throw Fatal("[MeshFormat_ply::openSoup] - unknown format '%s'",fmt.c_str());
+        } else if (key == "element") {
+          t_PlyElement e;
+          line >> e.name >> e.count;
+          m_Elements.push_back(e);
+        } else if (key == "property") {
+          if (m_Elements.empty()) {
+            throw Fatal("[MeshFormat_ply::openSoup] - property outside of an element");
+          }
+          t_PlyProperty p;
+          std::string t;
+          line >> t;
+          p.isList = (t == "list");
+          if (p.isList) {
+            std::string ct;
+            line >> ct >> t;
+            p.countType = plyType(ct);
+          } else {
+            p.countType = PlyUInt8;
+          }
+          p.type = plyType(t);
+          line >> p.name;
+          m_Elements.back().props.push_back(p);
+        } else if (key == "end_header") {
+          break;
+        } // comments and obj_info are ignored
+      }
+      uint one = 1;
+      bool hostLE = (*(uchar*)&one == 1);
+      m_Swap = (m_Format != PlyASCII) && ((m_Format == PlyBinaryLE) != hostLE);
+    }
+
+    void readVertex(const t_PlyElement& e)
+    {
+      v3f p = 0;
+      ForIndex(i,e.props.size()) {
+        const t_PlyProperty& prop = e.props[i];
+        if (prop.isList) {
+          int n = readCount(prop.countType);
+          ForIndex(k,n) { readValue(prop.type); }
+          continue;
+        }
+        double v = readValue(prop.type);
+        if      (prop.name == "x") p[0] = float(v);
+        else if (prop.name == "y") p[1] = float(v);
+        else if (prop.name == "z") p[2] = float(v);
+      }
+      m_Positions.push_back(p);
+    }
+
+    void readFace(const t_PlyElement& e,std::vector<v3f>& _corners)
+    {
+      bool found = false;
+      ForIndex(i,e.props.size()) {
+        const t_PlyProperty& prop = e.props[i];
+        if (!prop.isList) {
+          readValue(prop.type);
+          continue;
+        }
+        int n = readCount(prop.countType);
+        bool indices = !found && (prop.name == "vertex_indices" || prop.name == "vertex_index");
+        m_Face.resize(indices ? n : 0);
+        ForIndex(k,n) {
+          double v = readValue(prop.type);
+          if (indices) {
+            if (v < 0 || v >= double(m_Positions.size())) {
+              throw Fatal("[MeshFormat_ply::openSoup] - face references an undefined vertex");
+            }
+            m_Face[k] = uint(v);
+          }
+        }
+        if (indices) {
+          found = true;
+          ForRange(k,2,n - 1) {
+            _corners.push_back(m_Positions[m_Face[0]]);
+            _corners.push_back(m_Positions[m_Face[k - 1]]);
+            _corners.push_back(m_Positions[m_Face[k]]);
+          }
+        }
+      }
+    }
+
+    void skipRow(const t_PlyElement& e)
+    {
+      ForIndex(i,e.props.size()) {
+        const t_PlyProperty& prop = e.props[i];
+        int n = prop.isList ? readCount(prop.countType) : 1;
+        ForIndex(k,n) { readValue(prop.type); }
+      }
+    }
+
+  public:
+
+    SoupReader_ply(const char *fname)
+      : m_File(NULL), m_Buffer(1 << 20), m_BufPos(0), m_BufEnd(0), m_Format(PlyASCII), m_Swap(false), m_Element(0), m_Row(0)
+    {
+      fopen_s(&m_File, fname, "rb");
+      if (m_File == NULL) {
+        throw Fatal("[MeshFormat_ply::openSoup] - cannot open file '%s'",fname);
+      }
+      try {
+        readHeader(fname);
+      } catch (...) {
+        fclose(m_File);
+        throw;
+      }
+    }
+
+    ~SoupReader_ply() { fclose(m_File); }
+
+    uint read(std::vector<v3f>& _corners,uint maxTriangles)
+    {
+      _corners.swap(m_Pending);
+      m_Pending.clear();
+      while (_corners.size() < size_t(maxTriangles) * 3 && m_Element < m_Elements.size()) {
+        const t_PlyElement& e = m_Elements[m_Element];
+        if (m_Row == e.count) {
+          m_Element ++;
+          m_Row = 0;
+          continue;
+        }
+        if (e.name == "vertex") {
+          if (m_Row == 0) {
+            m_Positions.reserve(size_t(e.count));
+          }
+          readVertex(e);
+        } else if (e.name == "face") {
+          readFace(e,_corners);
+        } else {
+          skipRow(e);
+        }
+        m_Row ++;
+      }
+      if (_corners.size() > size_t(maxTriangles) * 3) {
+        m_Pending.assign(_corners.begin() + size_t(maxTriangles) * 3,_corners.end());
+        _corners.resize(size_t(maxTriangles) * 3);
+      }
+      return uint(_corners.size() / 3);
+    }
+  };
+
+} // namespace
+
+NAMESPACE::TriangleSoupReader *NAMESPACE::MeshFormat_ply::openSoup(const char *fname) const
+{
+  return new SoupReader_ply(fname);
+}
+
+//---------------------------------------------------------------------------
+
 void NAMESPACE::MeshFormat_ply::save(const char *fname, const NAMESPACE::TriangleMesh *mesh) const
 {
   p_ply oply = ply_create(fname, PLY_LITTLE_ENDIAN, NULL, 0, NULL);
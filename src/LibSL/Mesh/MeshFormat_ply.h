@@ -70,6 +70,9 @@ namespace LibSL {
       void           save(const char *,const TriangleMesh *) const;
       TriangleMesh  *load(const char *)                      const;
       const char    *signature()                             const {return "ply";}
+      //! streams faces (triangulated), ascii and binary; vertex
+      //! positions are kept in memory since faces index them
+      TriangleSoupReader *openSoup(const char *)             const;
 
     };
 
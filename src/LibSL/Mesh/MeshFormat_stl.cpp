@@ -48,6 +48,7 @@ using namespace LibSL::Memory::Array;
 using namespace LibSL::Memory::Pointer;
 #include <LibSL/Math/Vertex.h>
 using namespace LibSL::Math;
+#include <LibSL/Mesh/MeshNormals.h>
 
 #include <tinyxml/tinyxml.h>
 #include <string>
@@ -98,8 +99,12 @@ NAMESPACE::TriangleMesh *NAMESPACE::MeshFormat_stl::loadASCII(const char *fname)
   while (!parser.eof()) {
 	  if (parser.eof()) break;
 	  s = parser.readString();
-	  if (!strcmp(s,"endsolid")) {
-		  break;
+	  if (s[0] == '\0') {
+		  break; // trailing spaces
+	  } else if (!strcmp(s,"endsolid") || !strcmp(s,"solid")) {
+		  // files may hold several solids, their facets are concatenated (names are skipped)
+		  parser.reachChar('\n');
+		  continue;
 	  } else if (strcmp(s,"facet")) {
 		  throw Fatal("[MeshFormat_stl::loadASCII] - invalid file format ('facet' expected, got '%s')",s);
 	  }
@@ -233,20 +238,106 @@ NAMESPACE::TriangleMesh *NAMESPACE::MeshFormat_stl::load(const char *fname) cons
     } else {
        mesh = loadBinary(fname);
     }
-  // compute normals
-  ForIndex(t,mesh->numTriangles()) {
-    v3f pts[3];
-    ForIndex(i,3) {
-      pts[i] = mesh->posAt( mesh->triangleAt(t)[i] );
+  // compute normals (vertices are not shared, these are the facet normals)
+  MeshNormals::computeNormals(mesh,MeshNormals::Uniform);
+  return mesh;
+	LIBSL_END;
+}
+
+//---------------------------------------------------------------------------
+
+namespace {
+
+  /// binary facets, read in blocks
+  class SoupReader_stlBinary : public NAMESPACE::TriangleSoupReader
+  {
+  protected:
+    FILE               *m_File;
+    uint                m_NumTris;
+    uint                m_Next;
+    std::vector<uchar>  m_Buffer;
+  public:
+    SoupReader_stlBinary(const char *fname) : m_File(NULL), m_NumTris(0), m_Next(0)
+    {
+      fopen_s(&m_File, fname, "rb");
+      if (m_File == NULL) {
+        throw Fatal("[MeshFormat_stl::openSoup] - cannot open file '%s'",fname);
+      }
+      char header[80];
+      if (fread(header,sizeof(char),80,m_File) != 80 || fread(&m_NumTris,sizeof(uint),1,m_File) != 1) {
+        fclose(m_File);
+        throw Fatal("[MeshFormat_stl::openSoup] - file '%s' is truncated",fname);
+      }
     }
-    v3f nrm = normalize_safe(cross( pts[1]-pts[0] , pts[2]-pts[0] ));
-    ForIndex(i,3) {
-      t_VertexData *d = (t_VertexData *)mesh->vertexDataAt( mesh->triangleAt(t)[i] );
-      d->nrm = nrm;
+    ~SoupReader_stlBinary() { fclose(m_File); }
+    uint read(std::vector<v3f>& _corners,uint maxTriangles)
+    {
+      uint n = min(maxTriangles,m_NumTris - m_Next);
+      m_Buffer.resize(size_t(n) * 50);
+      if (n > 0 && fread(&m_Buffer[0],50,n,m_File) != n) {
+        throw Fatal("[MeshFormat_stl::openSoup] - file is truncated");
+      }
+      // normal (12 bytes), 3 corners (36 bytes), attribute (2 bytes)
+      _corners.resize(size_t(n) * 3);
+      ForIndex(t,n) {
+        memcpy(&_corners[t * 3][0],&m_Buffer[size_t(t) * 50 + 12],36);
+      }
+      m_Next += n;
+      return n;
+    }
+    long long numTriangles() const { return m_NumTris; }
+  };
+
+  /// ascii facets, only vertex lines are used
+  class SoupReader_stlASCII : public NAMESPACE::TriangleSoupReader
+  {
+  protected:
+    LibSL::BasicParser::FileStream                             m_Stream;
+    LibSL::BasicParser::Parser<LibSL::BasicParser::FileStream> m_Parser;
+  public:
+    SoupReader_stlASCII(const char *fname) : m_Stream(fname), m_Parser(m_Stream) { }
+    uint read(std::vector<v3f>& _corners,uint maxTriangles)
+    {
+      _corners.clear();
+      while (_corners.size() < size_t(maxTriangles) * 3 && !m_Parser.eof()) {
+        const char *s = m_Parser.readString();
+        if (!strcmp(s,"vertex")) {
+          v3f p;
+          p[0] = m_Parser.readFloat();
+          p[1] = m_Parser.readFloat();
+          p[2] = m_Parser.readFloat();
+          _corners.push_back(p);
+        } else if (!strcmp(s,"endsolid") || !strcmp(s,"solid")) {
+          // same as loadASCII: several solids are concatenated, names are skipped
+          m_Parser.reachChar('\n');
+        }
+      }
+      if (_corners.size() % 3 != 0) {
+        throw Fatal("[MeshFormat_stl::openSoup] - incomplete facet");
+      }
+      return uint(_corners.size() / 3);
     }
+  };
+
+} // namespace
+
+NAMESPACE::TriangleSoupReader *NAMESPACE::MeshFormat_stl::openSoup(const char *fname) const
+{
+  // same test as load: binary files have exactly the size given by their triangle count
+  FILE *f = NULL;
+  fopen_s(&f, fname, "rb");
+  if (f == NULL) {
+    throw Fatal("[MeshFormat_stl::openSoup] - cannot open file '%s'",fname);
+  }
+  char header[80];
+  uint nTris = 0;
+  bool binary = fread(header,sizeof(char),80,f) == 80 && fread(&nTris,sizeof(uint),1,f) == 1;
+  fclose(f);
+  if (binary && (long long)nTris * 50 + 84 == LibSL::System::File::size(fname)) {
+    return new SoupReader_stlBinary(fname);
+  } else {
+    return new SoupReader_stlASCII(fname);
   }
-  return mesh;
-	LIBSL_END;
 }
 
 //---------------------------------------------------------------------------
@@ -73,6 +73,8 @@ namespace LibSL {
       void           save(const char *,const TriangleMesh *) const;
       TriangleMesh  *load(const char *)                      const;
       const char    *signature()                             const {return "stl";}
+      //! streams facets, ascii or binary
+      TriangleSoupReader *openSoup(const char *)             const;
 
     };
 
@@ -0,0 +1,334 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshNormals
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include "MeshNormals.h"
+
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace std;
+using namespace LibSL::Errors;
+using namespace LibSL::Math;
+using namespace LibSL::Mesh;
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Mesh::MeshNormals
+
+// ------------------------------------------------------
+
+namespace {
+
+  const uint c_MaxBlocks = 4096;    // vertex blocks of the first counting sort pass
+  const uint c_MinChunk  = 1 << 16; // corners per chunk of the first pass
+
+  /// triangle corners around each vertex, corner c is vertex c%3 of triangle c/3
+  /// the corners of a vertex are listed by increasing id
+  class VertexCorners
+  {
+  public:
+
+    std::vector<uint> first;   // corners of v are in [first[v],first[v+1][
+    std::vector<uint> corners;
+
+    /// two counting sort passes: corners by block of vertices, then
+    /// within each block by vertex; both run in parallel without atomics
+    void build(const std::vector<uint>& indices,uint nv)
+    {
+      const uint nc = uint(indices.size());
+      uint shift    = 0;
+      while ((nv >> shift) > c_MaxBlocks) {
+        shift ++;
+      }
+      const uint nblocks = (nv >> shift) + 1;
+      const uint nchunks = max(1u,min(LibSL::System::Parallel::numThreads() * 4,nc / c_MinChunk));
+      // pass 1, per chunk histograms of blocks
+      std::vector<uint> counts(size_t(nchunks) * nblocks,0);
+      LibSL::System::Parallel::forIndex(0,int(nchunks),[&](int c) {
+        uint *cnt = &counts[size_t(c) * nblocks];
+        for (uint i = chunkBegin(nc,nchunks,c) ; i < chunkBegin(nc,nchunks,c + 1) ; i++) {
+          cnt[indices[i] >> shift] ++;
+        }
+      });
+      std::vector<uint> blockFirst(nblocks + 1);
+      uint sum = 0;
+      ForIndex(b,nblocks) {
+        blockFirst[b] = sum;
+        ForIndex(c,nchunks) {
+          uint n = counts[size_t(c) * nblocks + b];
+          counts[size_t(c) * nblocks + b] = sum;
+          sum += n;
+        }
+      }
+      blockFirst[nblocks] = sum;
+      std::vector<uint> byBlock(nc);
+      LibSL::System::Parallel::forIndex(0,int(nchunks),[&](int c) {
+        uint *pos = &counts[size_t(c) * nblocks];
+        for (uint i = chunkBegin(nc,nchunks,c) ; i < chunkBegin(nc,nchunks,c + 1) ; i++) {
+          byBlock[pos[indices[i] >> shift] ++] = i;
+        }
+      });
+      // pass 2, within blocks
+      first  .resize(size_t(nv) + 1);
+      corners.resize(nc);
+      LibSL::System::Parallel::forIndex(0,int(nblocks),[&](int b) {
+        uint v0 = min(nv,uint(b) << shift);
+        uint v1 = uint(min(size_t(nv),size_t(b + 1) << shift));
+        std::vector<uint> local(v1 - v0 + 1,0);
+        for (uint i = blockFirst[b] ; i < blockFirst[b + 1] ; i++) {
+          local[indices[byBlock[i]] - v0 + 1] ++;
+        }
+        for (uint v = v0 ; v < v1 ; v++) {
+          local[v - v0 + 1] += local[v - v0];
+          first[v]           = blockFirst[b] + local[v - v0];
+        }
+        for (uint i = blockFirst[b] ; i < blockFirst[b + 1] ; i++) {
+          corners[blockFirst[b] + local[indices[byBlock[i]] - v0] ++] = byBlock[i];
+        }
+      });
+      first[nv] = nc;
+    }
+
+  private:
+
+    static uint chunkBegin(uint n,uint nchunks,int c) { return uint(size_t(n) * c / nchunks); }
+  };
+
+  // ------------------------------------------------------
+
+  void gatherIndices(const TriangleMesh *mesh,std::vector<uint>& _indices)
+  {
+    _indices.resize(size_t(mesh->numTriangles()) * 3);
+    LibSL::System::Parallel::forIndex(0,int(mesh->numTriangles()),[&](int t) {
+      const TriangleMesh::t_Triangle& tri = mesh->triangleAt(t);
+      ForIndex(k,3) {
+        if (tri[k] >= mesh->numVertices()) {
+          throw Fatal("[MeshNormals] - triangle %d references vertex %d, out of range",t,tri[k]);
+        }
+        _indices[t * 3 + k] = tri[k];
+      }
+    },4096);
+  }
+
+  void gatherPositions(const TriangleMesh *mesh,std::vector<v3f>& _pos)
+  {
+    _pos.resize(mesh->numVertices());
+    LibSL::System::Parallel::forIndex(0,int(mesh->numVertices()),[&](int v) {
+      _pos[v] = mesh->posAt(v);
+    },4096);
+  }
+
+  /// float attribute with at least minComponents, NULL if absent
+  const MVF::Attribute *floatAttribute(const TriangleMesh *mesh,MVF::e_Binding binding,int minComponents)
+  {
+    if (mesh->mvf().isNull()) {
+      return NULL;
+    }
+    const MVF::Attribute *a = mesh->mvf()->findAttributeByBinding(binding);
+    if (a == NULL || a->type != MVF::Float || a->numComponents < minComponents) {
+      return NULL;
+    }
+    return a;
+  }
+
+  inline float angleBetween(const v3f& a,const v3f& b)
+  {
+    float la = length(a),lb = length(b);
+    if (la == 0.0f || lb == 0.0f) {
+      return 0.0f;
+    }
+    return acosf(max(-1.0f,min(1.0f,dot(a,b) / (la * lb))));
+  }
+
+  /// corner c seen from its vertex: the two other vertices in triangle order
+  inline void cornerVertices(const std::vector<uint>& indices,uint c,uint& _i0,uint& _i1,uint& _i2)
+  {
+    uint t = c / 3,k = c % 3;
+    _i0 = indices[t * 3 + k];
+    _i1 = indices[t * 3 + (k + 1) % 3];
+    _i2 = indices[t * 3 + (k + 2) % 3];
+  }
+
+  void vertexNormals(
+    const std::vector<uint>&    indices,
+    const std::vector<v3f>&     pos,
+    const VertexCorners&        vc,
+    NAMESPACE::e_Weighting      weighting,
+    const std::function<void(uint,const v3f&)>& out)
+  {
+    LibSL::System::Parallel::forIndex(0,int(pos.size()),[&](int v) {
+      v3f n(0.0f);
+      for (uint i = vc.first[v] ; i < vc.first[v + 1] ; i++) {
+        uint i0,i1,i2;
+        cornerVertices(indices,vc.corners[i],i0,i1,i2);
+        v3f   e1 = pos[i1] - pos[i0];
+        v3f   e2 = pos[i2] - pos[i0];
+        v3f   fn = cross(e1,e2);
+        float l  = length(fn);
+        if (l == 0.0f) {
+          continue;
+        }
+        switch (weighting) {
+        case NAMESPACE::Uniform: n += fn / l; break;
+        case NAMESPACE::Area:    n += fn;     break;
+        case NAMESPACE::Angle:   n += fn * (angleBetween(e1,e2) / l); break;
+        }
+      }
+      out(v,normalize_safe(n));
+    },1024);
+  }
+
+  inline void writeFloats(TriangleMesh *mesh,uint v,const MVF::Attribute *a,const float *f,int n)
+  {
+    memcpy((uchar*)mesh->vertexDataAt(v) + a->offset,f,n * sizeof(float));
+  }
+
+  inline const float *readFloats(const TriangleMesh *mesh,uint v,const MVF::Attribute *a)
+  {
+    return (const float*)((const uchar*)mesh->vertexDataAt(v) + a->offset);
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void NAMESPACE::computeNormals(TriangleMesh *mesh,e_Weighting weighting)
+{
+  const MVF::Attribute *na = floatAttribute(mesh,MVF::Normal,3);
+  if (na == NULL || na->numComponents != 3) {
+    throw Fatal("[MeshNormals::computeNormals] - mesh has no normal attribute of 3 floats");
+  }
+  std::vector<uint> indices;
+  std::vector<v3f>  pos;
+  gatherIndices  (mesh,indices);
+  gatherPositions(mesh,pos);
+  VertexCorners vc;
+  vc.build(indices,mesh->numVertices());
+  vertexNormals(indices,pos,vc,weighting,[&](uint v,const v3f& n) {
+    writeFloats(mesh,v,na,&n[0],3);
+  });
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::computeTangents(TriangleMesh *mesh,MVF::e_Binding tangent,MVF::e_Binding texcoord)
+{
+  const MVF::Attribute *ta = floatAttribute(mesh,tangent,3);
+  if (ta == NULL || ta->numComponents > 4) {
+    throw Fatal("[MeshNormals::computeTangents] - mesh has no tangent attribute of 3 or 4 floats");
+  }
+  const MVF::Attribute *uva = floatAttribute(mesh,texcoord,2);
+  if (uva == NULL) {
+    throw Fatal("[MeshNormals::computeTangents] - mesh has no texture coordinates");
+  }
+  std::vector<uint> indices;
+  std::vector<v3f>  pos;
+  gatherIndices  (mesh,indices);
+  gatherPositions(mesh,pos);
+  const uint nv = mesh->numVertices();
+  std::vector<v2f>  uvs(nv);
+  LibSL::System::Parallel::forIndex(0,int(nv),[&](int v) {
+    const float *f = readFloats(mesh,v,uva);
+    uvs[v] = v2f(f[0],f[1]);
+  },4096);
+  VertexCorners vc;
+  vc.build(indices,nv);
+  // normals from the mesh, geometric if absent
+  std::vector<v3f> nrms(nv);
+  const MVF::Attribute *na = floatAttribute(mesh,MVF::Normal,3);
+  if (na != NULL) {
+    LibSL::System::Parallel::forIndex(0,int(nv),[&](int v) {
+      const float *f = readFloats(mesh,v,na);
+      nrms[v] = normalize_safe(v3f(f[0],f[1],f[2]));
+    },4096);
+  } else {
+    vertexNormals(indices,pos,vc,Angle,[&](uint v,const v3f& n) { nrms[v] = n; });
+  }
+  LibSL::System::Parallel::forIndex(0,int(nv),[&](int v) {
+    const v3f& n    = nrms[v];
+    v3f        tsum(0.0f);
+    float      sign = 0.0f;
+    for (uint i = vc.first[v] ; i < vc.first[v + 1] ; i++) {
+      uint i0,i1,i2;
+      cornerVertices(indices,vc.corners[i],i0,i1,i2);
+      v3f   d1   = pos[i1] - pos[i0];
+      v3f   d2   = pos[i2] - pos[i0];
+      v2f   s1   = uvs[i1] - uvs[i0];
+      v2f   s2   = uvs[i2] - uvs[i0];
+      // signed area in texture space, the triangle orientation gives the bitangent sign
+      float area = s1[0] * s2[1] - s1[1] * s2[0];
+      if (area == 0.0f) {
+        continue; // degenerate mapping
+      }
+      float orient = area > 0.0f ? 1.0f : -1.0f;
+      v3f   os     = (d1 * s2[1] - d2 * s1[1]) * orient;
+      // projections in the tangent plane
+      os = os - n * dot(n,os);
+      v3f   p1 = d1 - n * dot(n,d1);
+      v3f   p2 = d2 - n * dot(n,d2);
+      float l  = length(os);
+      if (l == 0.0f) {
+        continue;
+      }
+      float w = angleBetween(p1,p2);
+      tsum += os * (w / l);
+      sign += orient * w;
+    }
+    v3f t = normalize_safe(tsum);
+    if (dot(t,t) == 0.0f) {
+      // no usable texture mapping, any direction of the tangent plane
+      t = fabs(n[0]) < 0.9f ? v3f(1,0,0) : v3f(0,1,0);
+      t = normalize_safe(t - n * dot(n,t));
+    }
+    float f[4] = { t[0],t[1],t[2],sign < 0.0f ? -1.0f : 1.0f };
+    writeFloats(mesh,v,ta,f,ta->numComponents);
+  },1024);
+}
+
+// ------------------------------------------------------
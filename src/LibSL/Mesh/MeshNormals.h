@@ -0,0 +1,95 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshNormals
+// ------------------------------------------------------
+//
+// Vertex normals and tangent frames
+//
+// Both kernels gather, for every vertex, the triangle
+// corners that reference it (a vertex to corner table built
+// by a parallel counting sort) and then process vertices in
+// parallel: no atomics, and results do not depend on the
+// number of threads. Results are written in the attribute
+// slots of the mesh MVF.
+//
+// Tangents follow MikkTSpace: per triangle tangents from
+// the texture coordinate derivatives, projected in the
+// tangent plane of the vertex normal and angle weighted,
+// with the bitangent sign in w. They match MikkTSpace when
+// vertices are already split along texture seams and hard
+// edges (MikkTSpace splits vertices itself).
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Mesh/Mesh.h>
+
+namespace LibSL {
+  namespace Mesh {
+    namespace MeshNormals {
+
+      //! weight of a triangle normal at its vertices
+      enum e_Weighting {
+        Uniform = 0, // unit normals
+        Area    = 1, // proportional to the triangle area
+        Angle   = 2  // proportional to the angle at the vertex [Thurmer and Wuthrich 1998]
+      };
+
+      //! Computes vertex normals into the MVF normal attribute (3 floats).
+      //! Throws Fatal if the mesh has no such attribute.
+      LIBSL_DLL void computeNormals(
+        TriangleMesh *mesh,
+        e_Weighting   weighting = Angle);
+
+      //! Computes vertex tangents into the attribute with binding 'tangent'.
+      //! With 4 floats, w holds the bitangent sign: bitangent = w * cross(normal,tangent).
+      //! Texture coordinates are read from the attribute with binding 'texcoord' (2 floats),
+      //! normals from the MVF normal attribute (geometric normals if absent).
+      //! Tangents are not GPU bindings in LibSL, hence a texture coordinate slot by default.
+      LIBSL_DLL void computeTangents(
+        TriangleMesh   *mesh,
+        MVF::e_Binding  tangent  = MVF::TexCoord1,
+        MVF::e_Binding  texcoord = MVF::TexCoord0);
+
+    } // LibSL::Mesh::MeshNormals
+  } // LibSL::Mesh
+} // LibSL
+
+// ------------------------------------------------------
@@ -0,0 +1,459 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshOutOfCore
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include "MeshOutOfCore.h"
+
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+using namespace std;
+using namespace LibSL::Errors;
+using namespace LibSL::Math;
+using namespace LibSL::Memory::Pointer;
+using namespace LibSL::Geometry;
+using namespace LibSL::Mesh;
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Mesh::MeshOutOfCore
+
+// ------------------------------------------------------
+
+namespace {
+
+  // estimated footprint of a tile being welded and simplified, per input triangle
+  const size_t c_BytesPerTriangle = 512;
+  // size of a triangle in tile files: three corners
+  const size_t c_TriangleSize     = 3 * sizeof(v3f);
+  // smallest write buffer of a tile while bucketing (small: the grid may have many cells)
+  const size_t c_MinTileBuffer    = 4096;
+  // a tile over budget is split at most that many times
+  const uint   c_MaxSplits        = 8;
+  // tile files kept open while bucketing
+  const size_t c_MaxOpenTiles     = 64;
+
+  typedef struct
+  {
+    v3f pos;
+  } t_TileVertex;
+
+  typedef MVF1(mvf_position_3f) t_TileVertexFormat;
+
+  /// reads back a tile file
+  class SoupReader_tile : public TriangleSoupReader
+  {
+  protected:
+    FILE *m_File;
+    uint  m_Remaining;
+  public:
+    SoupReader_tile(const NAMESPACE::TileSet::t_Tile& tile) : m_File(NULL), m_Remaining(tile.numTriangles)
+    {
+      fopen_s(&m_File, tile.fileName.c_str(), "rb");
+      if (m_File == NULL) {
+        throw Fatal("[MeshOutOfCore] - cannot open tile '%s'",tile.fileName.c_str());
+      }
+    }
+    ~SoupReader_tile() { fclose(m_File); }
+    uint read(std::vector<v3f>& _corners,uint maxTriangles)
+    {
+      uint n = min(maxTriangles,m_Remaining);
+      _corners.resize(size_t(n) * 3);
+      if (n > 0 && fread(&_corners[0],c_TriangleSize,n,m_File) != n) {
+        throw Fatal("[MeshOutOfCore] - tile file is truncated");
+      }
+      m_Remaining -= n;
+      return n;
+    }
+    long long numTriangles() const { return m_Remaining; }
+  };
+
+  /// tile files being appended to, the most recently used ones stay open
+  class TileFiles
+  {
+  protected:
+    std::vector<FILE*> m_Files;  // per cell, NULL when closed
+    std::vector<uint>  m_Open;   // open cells, least recently used first
+    void closeFile(uint c,const std::string& fname)
+    {
+      int err = fclose(m_Files[c]);
+      m_Files[c] = NULL;
+      if (err != 0) {
+        throw Fatal("[MeshOutOfCore::buildTiles] - cannot write tile '%s' (disk full?)",fname.c_str());
+      }
+    }
+  public:
+    TileFiles(uint ncells) : m_Files(ncells,(FILE*)NULL) { }
+    ~TileFiles() { ForIndex(i,m_Open.size()) { fclose(m_Files[m_Open[i]]); } }
+    /// file of cell c, created on first use
+    FILE *get(uint c,const std::vector<NAMESPACE::TileSet::t_Tile>& cells,bool create)
+    {
+      std::vector<uint>::iterator I = std::find(m_Open.begin(),m_Open.end(),c);
+      if (I != m_Open.end()) {
+        m_Open.erase(I);
+        m_Open.push_back(c);
+        return m_Files[c];
+      }
+      if (m_Open.size() >= c_MaxOpenTiles) {
+        uint lru = m_Open.front();
+        m_Open.erase(m_Open.begin());
+        closeFile(lru,cells[lru].fileName);
+      }
+      fopen_s(&m_Files[c], cells[c].fileName.c_str(), create ? "wb" : "ab");
+      if (m_Files[c] == NULL) {
+        throw Fatal("[MeshOutOfCore::buildTiles] - cannot write tile '%s'",cells[c].fileName.c_str());
+      }
+      m_Open.push_back(c);
+      return m_Files[c];
+    }
+    /// closes all files, reports write errors
+    void close(const std::vector<NAMESPACE::TileSet::t_Tile>& cells)
+    {
+      while (!m_Open.empty()) {
+        uint c = m_Open.back();
+        m_Open.pop_back();
+        closeFile(c,cells[c].fileName);
+      }
+    }
+  };
+
+  std::string tileName(const std::string& prefix,uint id)
+  {
+    char str[32];
+    snprintf(str,sizeof(str),"_%u.tile",id);
+    return prefix + str;
+  }
+
+  /// grid cell containing p
+  uint cellOf(const v3f& p,const AABox& box,const v3u& res)
+  {
+    v3f ext = box.extent();
+    uint idx[3];
+    ForIndex(k,3) {
+      float u = ext[k] > 0.0f ? (p[k] - box.minCorner()[k]) / ext[k] * float(res[k]) : 0.0f;
+      idx[k]  = (u >= 0.0f) ? min(uint(u),res[k] - 1) : 0; // also catches NaN
+    }
+    return idx[0] + res[0] * (idx[1] + res[1] * idx[2]);
+  }
+
+  AABox cellBox(const AABox& box,const v3u& res,uint c)
+  {
+    v3u idx(c % res[0],(c / res[0]) % res[1],c / (res[0] * res[1]));
+    v3f ext = box.extent();
+    v3f mn,mx;
+    ForIndex(k,3) {
+      mn[k] = box.minCorner()[k] + ext[k] * float(idx[k]    ) / float(res[k]);
+      mx[k] = box.minCorner()[k] + ext[k] * float(idx[k] + 1) / float(res[k]);
+    }
+    mx = tupleMax(mn,mx);
+    return AABox(mn,mx);
+  }
+
+  /// grid of at least numCells cells and at most maxCells, as cubic as the box allows
+  v3u gridResolution(const AABox& box,uint numCells,uint maxCells)
+  {
+    v3u res(1,1,1);
+    v3f ext = box.extent();
+    while (res[0] * res[1] * res[2] < numCells) {
+      int   a    = -1;
+      float best = 0.0f;
+      ForIndex(k,3) {
+        float s = ext[k] / float(res[k]);
+        if (s > best) { best = s; a = k; }
+      }
+      if (a < 0) break; // all triangles on a single point
+      if (size_t(res[0] * res[1] * res[2]) / res[a] * (res[a] + 1) > maxCells) break;
+      res[a] ++;
+    }
+    return res;
+  }
+
+  /// most cells whose write buffers fit in the bucketing budget (a quarter of the budget)
+  uint maxCells(const NAMESPACE::Params& params)
+  {
+    return uint(min(size_t(1u << 24),max(size_t(8),params.memoryBudget / 4 / c_MinTileBuffer)));
+  }
+
+  /// buckets a soup by triangle centroid in a grid over box, appends non empty tiles;
+  /// on failure the files created are removed
+  void bucket(TriangleSoupReader& soup,const AABox& box,const v3u& res,
+              const std::string& prefix,uint& _nextId,const NAMESPACE::Params& params,
+              std::vector<NAMESPACE::TileSet::t_Tile>& _tiles)
+  {
+    uint   ncells    = res[0] * res[1] * res[2];
+    size_t flushSize = max(c_MinTileBuffer,params.memoryBudget / 4 / ncells);
+    std::vector<NAMESPACE::TileSet::t_Tile> cells(ncells);
+    std::vector<std::vector<v3f> >          buffers(ncells);
+    try {
+      TileFiles files(ncells);
+      // appends the buffer of a cell to its file
+      auto flush = [&](uint c) {
+        if (buffers[c].empty()) return;
+        NAMESPACE::TileSet::t_Tile& tile = cells[c];
+        bool first = tile.fileName.empty();
+        if (first) {
+          tile.fileName     = tileName(prefix,_nextId ++);
+          tile.cell         = cellBox(box,res,c);
+          tile.numTriangles = 0;
+        }
+        FILE  *f = files.get(c,cells,first);
+        size_t n = buffers[c].size() / 3;
+        if (fwrite(&buffers[c][0],c_TriangleSize,n,f) != n) {
+          throw Fatal("[MeshOutOfCore::buildTiles] - cannot write tile '%s' (disk full?)",tile.fileName.c_str());
+        }
+        tile.numTriangles += uint(n);
+        buffers[c].clear();
+      };
+      std::vector<v3f> corners;
+      while (soup.read(corners,params.batchSize) > 0) {
+        for (size_t t = 0 ; t < corners.size() ; t += 3) {
+          uint c = cellOf((corners[t] + corners[t + 1] + corners[t + 2]) / 3.0f,box,res);
+          buffers[c].insert(buffers[c].end(),corners.begin() + t,corners.begin() + t + 3);
+          if (buffers[c].size() * sizeof(v3f) >= flushSize) {
+            flush(c);
+          }
+        }
+      }
+      ForIndex(c,ncells) {
+        flush(c);
+      }
+      files.close(cells);
+    } catch (...) {
+      // files are closed at this point
+      ForIndex(c,ncells) {
+        if (!cells[c].fileName.empty()) remove(cells[c].fileName.c_str());
+      }
+      throw;
+    }
+    ForIndex(c,ncells) {
+      if (!cells[c].fileName.empty()) {
+        _tiles.push_back(cells[c]);
+      }
+    }
+  }
+
+  size_t trianglesPerTile(const NAMESPACE::Params& params)
+  {
+    return max(size_t(1),params.memoryBudget / c_BytesPerTriangle);
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void NAMESPACE::TileSet::clear()
+{
+  ForIndex(t,tiles.size()) {
+    remove(tiles[t].fileName.c_str());
+  }
+  tiles.clear();
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::buildTiles(const char *fname,const char *filePrefix,const Params& params,TileSet& _tiles)
+{
+  sl_assert(params.batchSize > 0);
+  _tiles.tiles.clear();
+  // first pass: bounds
+  std::vector<v3f> corners;
+  AABox            bbox;
+  long long        numTris = 0;
+  {
+    TriangleSoupReader_Ptr soup(openTriangleSoup(fname));
+    while (soup->read(corners,params.batchSize) > 0) {
+      ForIndex(c,corners.size()) {
+        bbox.addPoint(corners[c]);
+      }
+      numTris += corners.size() / 3;
+    }
+  }
+  if (numTris == 0) {
+    _tiles.bbox = AABox(v3f(0.0f),v3f(0.0f));
+    return;
+  }
+  _tiles.bbox = bbox;
+  // second pass: bucketing, the grid is limited so that the buffers fit the budget
+  // (tiles over budget are split below)
+  size_t perTile  = trianglesPerTile(params);
+  size_t numCells = min(size_t((numTris + perTile - 1) / perTile),size_t(maxCells(params)));
+  v3u    res      = gridResolution(bbox,uint(numCells),maxCells(params));
+  uint   nextId   = 0;
+  try {
+    {
+      TriangleSoupReader_Ptr soup(openTriangleSoup(fname));
+      bucket(*soup,bbox,res,filePrefix,nextId,params,_tiles.tiles);
+    }
+    // split tiles over budget (dense areas), a tile is replaced by its first child
+    std::vector<uint> splits(_tiles.tiles.size(),0);
+    size_t t = 0;
+    while (t < _tiles.tiles.size()) {
+      if (_tiles.tiles[t].numTriangles <= perTile || splits[t] >= c_MaxSplits) {
+        t ++;
+        continue;
+      }
+      TileSet::t_Tile parent = _tiles.tiles[t];
+      std::vector<TileSet::t_Tile> children;
+      {
+        SoupReader_tile soup(parent);
+        bucket(soup,parent.cell,v3u(2,2,2),filePrefix,nextId,params,children);
+      }
+      // children are owned by the set before the parent goes
+      uint depth       = splits[t] + 1;
+      _tiles.tiles[t]  = children[0];
+      splits[t]        = depth;
+      ForRange(c,1,int(children.size()) - 1) {
+        _tiles.tiles.push_back(children[c]);
+        splits.push_back(depth);
+      }
+      remove(parent.fileName.c_str());
+    }
+  } catch (...) {
+    // no tile file is left behind
+    _tiles.clear();
+    throw;
+  }
+}
+
+// ------------------------------------------------------
+
+TriangleMesh *NAMESPACE::processTile(const TileSet& tiles,uint tile,const Params& params)
+{
+  const TileSet::t_Tile& nfo = tiles.tiles[tile];
+  uint n = nfo.numTriangles;
+  TriangleMesh_generic<t_TileVertex> *mesh =
+    new TriangleMesh_generic<t_TileVertex>(3 * n,n,0,AutoPtr<MVF>(MVF::make<t_TileVertexFormat>()));
+  try {
+    {
+      std::vector<v3f> corners;
+      SoupReader_tile soup(nfo);
+      soup.read(corners,n);
+      ForIndex(v,3 * n) {
+        mesh->vertexAt(v).pos = corners[v];
+      }
+    }
+    ForIndex(t,n) {
+      mesh->triangleAt(t) = v3u(3 * t,3 * t + 1,3 * t + 2);
+    }
+    // weld
+    mesh->mergeVertices(params.weldRadius);
+    if (params.simplifyRatio >= 1.0f) {
+      return mesh;
+    }
+    // simplify, cuts between tiles are borders: they stay in place
+    MeshSimplification::Params sp = params.simplify;
+    sp.targetTriangles = uint(float(n) * max(0.0f,params.simplifyRatio));
+    sp.lockBorders     = true;
+    TriangleMesh *simplified = MeshSimplification::simplify(mesh,sp);
+    delete mesh;
+    return simplified;
+  } catch (...) {
+    delete mesh;
+    throw;
+  }
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::processTiles(const TileSet& tiles,const Params& params,const std::function<void(uint,TriangleMesh *)>& f)
+{
+  size_t first = 0;
+  while (first < tiles.tiles.size()) {
+    // next wave: as many tiles as the budget allows, at least one
+    size_t last      = first;
+    size_t footprint = 0;
+    while (last < tiles.tiles.size()) {
+      size_t sz = size_t(tiles.tiles[last].numTriangles) * c_BytesPerTriangle;
+      if (last > first && footprint + sz > params.memoryBudget) break;
+      footprint += sz;
+      last ++;
+    }
+    LibSL::System::Parallel::forIndex(int(first),int(last),[&](int t) {
+      TriangleMesh *mesh = processTile(tiles,uint(t),params);
+      try {
+        f(uint(t),mesh);
+      } catch (...) {
+        delete mesh;
+        throw;
+      }
+      delete mesh;
+    });
+    first = last;
+  }
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::process(const char *fname,const char *outputPrefix,const Params& params,std::vector<std::string> *_outputs)
+{
+  TileSet tiles;
+  buildTiles(fname,outputPrefix,params,tiles);
+  std::vector<std::string> outputs(tiles.tiles.size());
+  try {
+    processTiles(tiles,params,[&](uint t,TriangleMesh *mesh) {
+      if (mesh == NULL) {
+        return;
+      }
+      char str[32];
+      snprintf(str,sizeof(str),"_%u.mesh",t);
+      outputs[t] = std::string(outputPrefix) + str;
+      saveTriangleMesh(outputs[t].c_str(),mesh);
+    });
+  } catch (...) {
+    tiles.clear();
+    throw;
+  }
+  tiles.clear();
+  if (_outputs != NULL) {
+    ForIndex(t,outputs.size()) {
+      if (!outputs[t].empty()) {
+        _outputs->push_back(outputs[t]);
+      }
+    }
+  }
+}
+
+// ------------------------------------------------------
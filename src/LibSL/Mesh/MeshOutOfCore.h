@@ -0,0 +1,143 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshOutOfCore
+// ------------------------------------------------------
+//
+// Out-of-core processing of meshes larger than memory
+//
+// The input is streamed as a triangle soup (see
+// openTriangleSoup) and bucketed by triangle centroid in a
+// grid of tiles, each tile being a raw file of corner
+// positions on disk. The grid is sized so that a tile can be
+// processed within the memory budget; tiles that end up too
+// large (dense areas) are split again.
+//
+// Tiles are then loaded one at a time, or several at once
+// while their footprint fits the budget, welded with
+// mergeVertices and optionally simplified. Tile borders are
+// locked during simplification: vertices along a cut keep
+// their input positions, so neighboring tiles still match.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Mesh/Mesh.h>
+#include <LibSL/Mesh/MeshSimplification.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LibSL {
+  namespace Mesh {
+    namespace MeshOutOfCore {
+
+      class Params
+      {
+      public:
+        //! memory for tile processing, in bytes (bucketing buffers use a quarter of it)
+        size_t memoryBudget;
+        //! triangles per batch read from the input
+        uint   batchSize;
+        //! vertices closer than this are welded (see TriangleMesh::mergeVertices)
+        float  weldRadius;
+        //! fraction of the triangles kept by simplification (1: no simplification)
+        float  simplifyRatio;
+        //! simplification settings, targetTriangles and lockBorders are set per tile
+        MeshSimplification::Params simplify;
+
+        Params()
+          : memoryBudget(size_t(1) << 30), batchSize(1u << 16),
+            weldRadius(1e-9f), simplifyRatio(1.0f) { }
+      };
+
+      //! Tiles on disk, produced by buildTiles
+      class TileSet
+      {
+      public:
+        class t_Tile
+        {
+        public:
+          std::string            fileName;
+          LibSL::Geometry::AABox cell;          // grid cell, triangles may extend beyond it
+          uint                   numTriangles;
+        };
+        LibSL::Geometry::AABox   bbox;          // of the whole input
+        std::vector<t_Tile>      tiles;         // non empty tiles only
+
+        //! removes the tile files
+        LIBSL_DLL void clear();
+      };
+
+      //! Streams a mesh file into tiles, written as filePrefix_<n>.tile
+      //! Reads the input twice: bounds, then bucketing.
+      LIBSL_DLL void buildTiles(
+        const char   *fname,
+        const char   *filePrefix,
+        const Params& params,
+        TileSet&     _tiles);
+
+      //! Loads a tile as a welded, and possibly simplified, mesh (NULL if nothing is left)
+      LIBSL_DLL TriangleMesh *processTile(
+        const TileSet& tiles,
+        uint           tile,
+        const Params&  params);
+
+      //! Processes all tiles, several at once while they fit the budget.
+      //! f is called concurrently from worker threads, mesh is NULL if nothing
+      //! is left and is deleted once f returns.
+      LIBSL_DLL void processTiles(
+        const TileSet& tiles,
+        const Params&  params,
+        const std::function<void(uint tile,TriangleMesh *mesh)>& f);
+
+      //! Full pipeline: one mesh file per tile, outputPrefix_<n>.mesh
+      //! Intermediate tiles are removed once done.
+      LIBSL_DLL void process(
+        const char                *fname,
+        const char                *outputPrefix,
+        const Params&              params,
+        std::vector<std::string>  *_outputs = NULL);
+
+    } // LibSL::Mesh::MeshOutOfCore
+  } // LibSL::Mesh
+} // LibSL
+
+// ------------------------------------------------------
@@ -0,0 +1,985 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshSimplification
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include "MeshSimplification.h"
+
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <queue>
+
+using namespace std;
+using namespace LibSL::Errors;
+using namespace LibSL::Math;
+using namespace LibSL::Mesh;
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Mesh::MeshSimplification
+
+// ------------------------------------------------------
+
+namespace {
+
+  enum e_Kind { e_Manifold = 0, e_Border = 1, e_Seam = 2, e_Locked = 3 };
+
+  const uint   c_None           = UINT_MAX;
+  const double c_BorderPenalty  = 1000.0;
+  // pre-pass clusters hold about prePassTriangles / c_ClustersPerPrePass triangles
+  const uint   c_ClustersPerPrePass = 8;
+  const int    c_MaxClusterGrid     = 32;
+
+  typedef unsigned long long t_Key;
+
+  inline t_Key edgeKey(uint a, uint b) { return (t_Key(a) << 32) | t_Key(b); }
+
+  // ------------------------------------------------------
+
+  // Generalized quadric in d dimensions (position then attributes), packed:
+  // upper triangle of A, then b, then c, then the accumulated area
+  class QuadricLayout
+  {
+  public:
+    uint d;
+    uint size;
+    QuadricLayout(uint d_) : d(d_), size(d_ * (d_ + 1) / 2 + d_ + 2) { }
+    uint a(uint i, uint j) const { return i * d - i * (i + 1) / 2 + j; } // i <= j
+    uint b(uint i)         const { return d * (d + 1) / 2 + i; }
+    uint c()               const { return d * (d + 1) / 2 + d; }
+    uint w()               const { return d * (d + 1) / 2 + d + 1; }
+
+    double eval(const double *q, const double *x) const
+    {
+      double r = q[c()];
+      uint k = 0;
+      for (uint i = 0; i < d; i++) {
+        r += q[k++] * x[i] * x[i];
+        for (uint j = i + 1; j < d; j++) {
+          r += 2.0 * q[k++] * x[i] * x[j];
+        }
+      }
+      for (uint i = 0; i < d; i++) {
+        r += 2.0 * q[b(i)] * x[i];
+      }
+      return r;
+    }
+
+    void add(double *q, const double *o) const
+    {
+      for (uint k = 0; k < size; k++) q[k] += o[k];
+    }
+
+    // plane through the triangle in d dimensions [Garland and Heckbert 98]
+    void addTriangle(double *q, const double *p1, const double *p2, const double *p3, double area) const
+    {
+      double e1[16], e2[16];
+      double l1 = 0, d12 = 0, l2 = 0;
+      for (uint i = 0; i < d; i++) { e1[i] = p2[i] - p1[i]; l1 += e1[i] * e1[i]; }
+      if (l1 <= 0) return;
+      l1 = sqrt(l1);
+      for (uint i = 0; i < d; i++) { e1[i] /= l1; d12 += e1[i] * (p3[i] - p1[i]); }
+      for (uint i = 0; i < d; i++) { e2[i] = p3[i] - p1[i] - d12 * e1[i]; l2 += e2[i] * e2[i]; }
+      if (l2 <= 0) return;
+      l2 = sqrt(l2);
+      double pe1 = 0, pe2 = 0, pp = 0;
+      for (uint i = 0; i < d; i++) { e2[i] /= l2; pe1 += p1[i] * e1[i]; pe2 += p1[i] * e2[i]; pp += p1[i] * p1[i]; }
+      uint k = 0;
+      for (uint i = 0; i < d; i++) {
+        for (uint j = i; j < d; j++) {
+          q[k++] += area * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+        }
+      }
+      for (uint i = 0; i < d; i++) {
+        q[b(i)] += area * (pe1 * e1[i] + pe2 * e2[i] - p1[i]);
+      }
+      q[c()] += area * (pp - pe1 * pe1 - pe2 * pe2);
+      q[w()] += area;
+    }
+
+    // squared distance to the plane m.p = dm, on positions only
+    void addPlane(double *q, const v3d& m, double dm, double weight) const
+    {
+      for (uint i = 0; i < 3; i++) {
+        for (uint j = i; j < 3; j++) {
+          q[a(i, j)] += weight * m[i] * m[j];
+        }
+        q[b(i)] -= weight * dm * m[i];
+      }
+      q[c()] += weight * dm * dm;
+    }
+  };
+
+  // ------------------------------------------------------
+
+  // Input mesh data shared by all passes (read only once built)
+  class MeshData
+  {
+  public:
+    uint                 nv;
+    uint                 dim;      // 3 + number of attribute components
+    std::vector<double>  x;        // nv * dim, normalized position then weighted attributes
+    std::vector<v3u>     tris;     // non degenerate input triangles
+    std::vector<uint>    triId;    // their index in the input mesh
+    std::vector<uint>    wedge;    // other wedge of a seam vertex, c_None otherwise
+    std::vector<uchar>   kind;
+    std::vector<uint>    pid;      // position id: smallest vertex index at the same position
+    std::vector<uint>    vtFirst;  // vertex -> triangles (CSR)
+    std::vector<uint>    vtList;
+
+    const double *at(uint v) const { return &x[size_t(v) * dim]; }
+    v3d           pos(uint v) const { const double *p = at(v); return V3D(p[0], p[1], p[2]); }
+  };
+
+  // ------------------------------------------------------
+
+  // Sequential collapse engine over a set of triangles. Vertices are local
+  // (m_Gid maps them to MeshData vertices) so that pre-pass clusters only
+  // allocate what they touch.
+  class Collapser
+  {
+  public:
+
+    typedef struct
+    {
+      double cost;
+      uint   u, v, stamp;
+    } t_Candidate;
+
+    struct CandidateOrder
+    {
+      bool operator()(const t_Candidate& a, const t_Candidate& b) const { return a.cost > b.cost; }
+    };
+
+    const MeshData&      m_D;
+    const QuadricLayout& m_L;
+    std::vector<uint>    m_Gid;     // local -> global, sorted
+    std::vector<v3u>     m_Tris;    // local indices
+    std::vector<uint>    m_TriIdx;  // index in MeshData::tris
+    std::vector<char>    m_Dead;
+    std::vector<char>    m_Locked;
+    std::vector<double>  m_Q;
+    std::vector<char>    m_Alive;
+    std::vector<uint>    m_Stamp;
+    // vertex -> live triangles: m_Size[v] entries from m_First[v], room for m_Cap[v];
+    // lists outgrowing their room move to the end of m_List
+    std::vector<uint>    m_First, m_Size, m_Cap, m_List;
+    uint                 m_NumAlive;
+    double               m_MaxError;
+    std::priority_queue<t_Candidate, std::vector<t_Candidate>, CandidateOrder> m_Heap;
+    // scratch space
+    std::vector<uint>                           m_Scratch, m_Moved;
+    std::vector<std::pair<double, uint> >       m_Ranked;
+    mutable std::vector<uint>                   m_RingU, m_RingV, m_Common;
+
+    Collapser(const MeshData& d, const QuadricLayout& l) : m_D(d), m_L(l), m_NumAlive(0), m_MaxError(0) { }
+
+    uint local(uint g) const
+    {
+      std::vector<uint>::const_iterator I = std::lower_bound(m_Gid.begin(), m_Gid.end(), g);
+      return (I != m_Gid.end() && *I == g) ? uint(I - m_Gid.begin()) : c_None;
+    }
+
+    const double *q(uint u) const    { return &m_Q[size_t(u) * m_L.size]; }
+    double       *q(uint u)          { return &m_Q[size_t(u) * m_L.size]; }
+    const double *x(uint u) const    { return m_D.at(m_Gid[u]); }
+    uint          kind(uint u) const { return m_Locked[u] ? uint(e_Locked) : uint(m_D.kind[m_Gid[u]]); }
+    uint          pid(uint u) const  { return m_D.pid[m_Gid[u]]; }
+
+    // triIdx: indices into MeshData::tris, tris: their current vertices,
+    // Q: global quadrics, locked: global flags
+    void init(const std::vector<uint>& triIdx, const std::vector<v3u>& tris, const std::vector<double>& Q, const std::vector<char>& locked)
+    {
+      m_TriIdx = triIdx;
+      m_Gid.clear();
+      ForIndex(t, tris.size()) {
+        ForIndex(c, 3) { m_Gid.push_back(tris[t][c]); }
+      }
+      std::sort(m_Gid.begin(), m_Gid.end());
+      m_Gid.erase(std::unique(m_Gid.begin(), m_Gid.end()), m_Gid.end());
+      uint nv = uint(m_Gid.size());
+      m_Tris.resize(m_TriIdx.size());
+      ForIndex(t, m_TriIdx.size()) {
+        ForIndex(c, 3) { m_Tris[t][c] = local(tris[t][c]); }
+      }
+      m_Dead  .assign(m_Tris.size(), 0);
+      m_Alive .assign(nv, 1);
+      m_Stamp .assign(nv, 0);
+      m_Locked.assign(nv, 0);
+      m_Q     .resize(size_t(nv) * m_L.size);
+      ForIndex(v, nv) {
+        m_Locked[v] = locked[m_Gid[v]];
+        memcpy(q(v), &Q[size_t(m_Gid[v]) * m_L.size], m_L.size * sizeof(double));
+      }
+      // vertex -> triangles
+      m_First.assign(nv + 1, 0);
+      ForIndex(t, m_Tris.size()) { ForIndex(c, 3) { m_First[m_Tris[t][c] + 1]++; } }
+      ForIndex(v, nv) { m_First[v + 1] += m_First[v]; }
+      m_List.resize(m_First[nv]);
+      m_Size.assign(nv, 0);
+      ForIndex(t, m_Tris.size()) { ForIndex(c, 3) { uint v = m_Tris[t][c]; m_List[m_First[v] + m_Size[v]++] = t; } }
+      m_Cap = m_Size;
+      m_First.pop_back();
+      m_NumAlive = uint(m_Tris.size());
+    }
+
+    // calls f(t) for each live triangle around u
+    template <typename T_Func>
+    void forTriangles(uint u, const T_Func& f) const
+    {
+      for (uint k = m_First[u], e = m_First[u] + m_Size[u]; k < e; k++) {
+        f(m_List[k]);
+      }
+    }
+
+    // removes t from the list of v
+    void unlink(uint v, uint t)
+    {
+      uint k = m_First[v], e = m_First[v] + m_Size[v];
+      while (k < e && m_List[k] != t) k++;
+      sl_assert(k < e);
+      m_List[k] = m_List[e - 1];
+      m_Size[v]--;
+    }
+
+    // appends triangles to the list of v
+    void link(uint v, const std::vector<uint>& tris)
+    {
+      uint n = m_Size[v] + uint(tris.size());
+      if (n > m_Cap[v]) {
+        if (m_List.size() + 2 * n > 2 * m_Tris.size() * 3) {
+          // too many abandoned ranges, pack the live lists
+          std::vector<uint> packed;
+          packed.reserve(size_t(m_NumAlive) * 3 + 2 * n);
+          ForIndex(w, m_First.size()) {
+            uint first = uint(packed.size());
+            packed.insert(packed.end(), m_List.begin() + m_First[w], m_List.begin() + m_First[w] + m_Size[w]);
+            m_First[w] = first;
+            m_Cap[w]   = m_Size[w];
+          }
+          m_List.swap(packed);
+        }
+        // move to the end, with room to grow
+        uint first = uint(m_List.size());
+        m_List.resize(first + 2 * n);
+        std::copy(m_List.begin() + m_First[v], m_List.begin() + m_First[v] + m_Size[v], m_List.begin() + first);
+        m_First[v] = first;
+        m_Cap[v]   = 2 * n;
+      }
+      std::copy(tris.begin(), tris.end(), m_List.begin() + m_First[v] + m_Size[v]);
+      m_Size[v] = n;
+    }
+
+    static bool contains(const v3u& tri, uint v) { return tri[0] == v || tri[1] == v || tri[2] == v; }
+
+    // number of live triangles around u touching the position of v
+    uint sharedTriangles(uint u, uint v) const
+    {
+      uint n = 0, pv = pid(v);
+      forTriangles(u, [&](uint t) {
+        const v3u& tri = m_Tris[t];
+        if (pid(tri[0]) == pv || pid(tri[1]) == pv || pid(tri[2]) == pv) n++;
+      });
+      return n;
+    }
+
+    // positions of the vertices around u, sorted
+    void ring(uint u, std::vector<uint>& _pids) const
+    {
+      _pids.clear();
+      forTriangles(u, [&](uint t) { ForIndex(c, 3) { _pids.push_back(pid(m_Tris[t][c])); } });
+      std::sort(_pids.begin(), _pids.end());
+      _pids.erase(std::unique(_pids.begin(), _pids.end()), _pids.end());
+    }
+
+    // link condition: u and v may only share the vertices opposite to their edge
+    bool linkOk(uint u, uint v, uint numShared) const
+    {
+      ring(u, m_RingU);
+      ring(v, m_RingV);
+      m_Common.clear();
+      std::set_intersection(m_RingU.begin(), m_RingU.end(), m_RingV.begin(), m_RingV.end(), std::back_inserter(m_Common));
+      // common includes the positions of u and v themselves
+      return m_Common.size() == numShared + 2;
+    }
+
+    // wedge of the position of v found around u, c_None if none
+    uint wedgeAround(uint u, uint v) const
+    {
+      uint r = c_None, pv = pid(v);
+      forTriangles(u, [&](uint t) {
+        ForIndex(c, 3) {
+          if (pid(m_Tris[t][c]) == pv) r = m_Tris[t][c];
+        }
+      });
+      return r;
+    }
+
+    // would moving u onto v flip a triangle?
+    bool flips(uint u, uint v) const
+    {
+      bool flip = false;
+      v3d pv = m_D.pos(m_Gid[v]);
+      forTriangles(u, [&](uint t) {
+        const v3u& tri = m_Tris[t];
+        if (flip || contains(tri, v)) return;
+        v3d p[3], n[3];
+        ForIndex(c, 3) { p[c] = m_D.pos(m_Gid[tri[c]]); n[c] = p[c]; }
+        ForIndex(c, 3) { if (tri[c] == u) n[c] = pv; }
+        v3d before = cross(p[1] - p[0], p[2] - p[0]);
+        v3d after  = cross(n[1] - n[0], n[2] - n[0]);
+        if (dot(before, after) <= 0.0) flip = true;
+      });
+      return flip;
+    }
+
+    // cost of collapsing u onto v, and the seam wedges moving along (c_None if u is not on a seam)
+    bool cost(uint u, uint v, double& _cost, uint& _up, uint& _vp) const
+    {
+      uint ku = kind(u), kv = kind(v);
+      _up = _vp = c_None;
+      if (ku == e_Locked || pid(u) == pid(v)) return false;
+      if (ku == e_Border) {
+        if (kv != e_Border && kv != e_Locked) return false;
+      } else if (ku == e_Seam) {
+        if (kv != e_Seam && kv != e_Locked)   return false;
+        _up = local(m_D.wedge[m_Gid[u]]);
+        if (_up == c_None || !m_Alive[_up])   return false;
+        _vp = wedgeAround(_up, v);
+        if (_vp == c_None || _vp == v)        return false;
+      }
+      const double *qu = q(u), *qv = q(v);
+      double c    = m_L.eval(qu, x(v)) + m_L.eval(qv, x(v));
+      double area = qu[m_L.w()] + qv[m_L.w()];
+      if (_up != c_None) {
+        c    += m_L.eval(q(_up), x(_vp)) + m_L.eval(q(_vp), x(_vp));
+        area += q(_up)[m_L.w()] + q(_vp)[m_L.w()];
+      }
+      _cost = max(0.0, c) / max(area, 1e-30);
+      return true;
+    }
+
+    // topological and geometric checks, only done for candidates that may be selected
+    bool valid(uint u, uint v, uint up, uint vp) const
+    {
+      uint ku     = kind(u);
+      uint shared = sharedTriangles(u, v);
+      if (ku == e_Manifold) {
+        if (shared != 2) return false;
+      } else {
+        // along a border, or along the seam on both sides
+        if (shared != 1) return false;
+        if (up != c_None) {
+          if (sharedTriangles(up, vp) != 1) return false;
+          shared = 2;
+        }
+      }
+      if (!linkOk(u, v, shared)) return false;
+      return !flips(u, v) && (up == c_None || !flips(up, vp));
+    }
+
+    bool evaluate(uint u, uint v, double& _cost, uint& _up, uint& _vp) const
+    {
+      return cost(u, v, _cost, _up, _vp) && valid(u, v, _up, _vp);
+    }
+
+    void updateVertex(uint u)
+    {
+      m_Stamp[u]++;
+      if (!m_Alive[u] || kind(u) == e_Locked) return;
+      // rank neighbors by cost, keep the first valid one
+      m_Scratch.clear();
+      forTriangles(u, [&](uint t) { ForIndex(c, 3) { if (m_Tris[t][c] != u) m_Scratch.push_back(m_Tris[t][c]); } });
+      std::sort(m_Scratch.begin(), m_Scratch.end());
+      m_Scratch.erase(std::unique(m_Scratch.begin(), m_Scratch.end()), m_Scratch.end());
+      m_Ranked.clear();
+      ForIndex(i, m_Scratch.size()) {
+        double c;
+        uint up, vp;
+        if (cost(u, m_Scratch[i], c, up, vp)) {
+          m_Ranked.push_back(std::make_pair(c, m_Scratch[i]));
+        }
+      }
+      std::sort(m_Ranked.begin(), m_Ranked.end());
+      ForIndex(i, m_Ranked.size()) {
+        double c;
+        uint up, vp, v = m_Ranked[i].second;
+        cost(u, v, c, up, vp);
+        if (valid(u, v, up, vp)) {
+          t_Candidate best;
+          best.cost  = c;
+          best.u     = u;
+          best.v     = v;
+          best.stamp = m_Stamp[u];
+          m_Heap.push(best);
+          return;
+        }
+      }
+    }
+
+    // triangles around u and v die, the other ones around u move over to v
+    void collapse(uint u, uint v)
+    {
+      m_Moved.clear();
+      forTriangles(u, [&](uint t) {
+        v3u& tri = m_Tris[t];
+        if (contains(tri, v)) {
+          m_Dead[t] = 1;
+          m_NumAlive--;
+          ForIndex(c, 3) { if (tri[c] != u) unlink(tri[c], t); }
+        } else {
+          ForIndex(c, 3) { if (tri[c] == u) tri[c] = v; }
+          m_Moved.push_back(t);
+        }
+      });
+      m_Size[u] = 0;
+      link(v, m_Moved);
+      m_L.add(q(v), q(u));
+      m_Alive[u] = 0;
+    }
+
+    void neighbors(uint v, std::vector<uint>& _out) const
+    {
+      forTriangles(v, [&](uint t) { ForIndex(c, 3) { _out.push_back(m_Tris[t][c]); } });
+    }
+
+    // collapses until target triangles or error; calls reached(k) each time the
+    // triangle count drops to targets[k]
+    void run(const std::vector<uint>& targets, double maxError, const std::function<void(uint)>& reached)
+    {
+      ForIndex(v, m_Alive.size()) { updateVertex(v); }
+      uint next = 0;
+      std::vector<uint> touched;
+      while (next < targets.size()) {
+        if (m_NumAlive <= targets[next]) {
+          reached(next++);
+          continue;
+        }
+        if (m_Heap.empty()) break;
+        t_Candidate cd = m_Heap.top();
+        m_Heap.pop();
+        if (!m_Alive[cd.u] || cd.stamp != m_Stamp[cd.u]) continue;
+        double cost;
+        uint up, vp;
+        if (!m_Alive[cd.v] || !evaluate(cd.u, cd.v, cost, up, vp)) {
+          // neighborhood changed without notice, reconsider
+          updateVertex(cd.u);
+          continue;
+        }
+        if (maxError >= 0 && sqrt(cost) > maxError) break;
+        m_MaxError = max(m_MaxError, sqrt(cost));
+        collapse(cd.u, cd.v);
+        if (up != c_None) collapse(up, vp);
+        touched.clear();
+        touched.push_back(cd.v);
+        neighbors(cd.v, touched);
+        if (vp != c_None) {
+          touched.push_back(vp);
+          neighbors(vp, touched);
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        ForIndex(i, touched.size()) { updateVertex(touched[i]); }
+      }
+      // unreachable targets repeat the current state
+      while (next < targets.size()) reached(next++);
+    }
+
+    // live triangles, as indices into MeshData::tris, with their current global vertices
+    void result(std::vector<uint>& _triIdx, std::vector<v3u>& _tris) const
+    {
+      _triIdx.clear();
+      _tris.clear();
+      ForIndex(t, m_Tris.size()) {
+        if (m_Dead[t]) continue;
+        _triIdx.push_back(m_TriIdx[t]);
+        _tris.push_back(V3U(m_Gid[m_Tris[t][0]], m_Gid[m_Tris[t][1]], m_Gid[m_Tris[t][2]]));
+      }
+    }
+  };
+
+  // ------------------------------------------------------
+
+  // reads a float attribute, scaled, into dst; returns the number of components
+  uint readAttribute(const TriangleMesh *mesh, MVF::e_Binding binding, uint maxComp, float weight, uint v, double *dst)
+  {
+    const MVF::Attribute *a = mesh->mvf().isNull() ? NULL : mesh->mvf()->findAttributeByBinding(binding);
+    if (a == NULL || weight <= 0.0f) return 0;
+    uint nc = min(uint(a->numComponents), maxComp);
+    if (dst == NULL) return (a->type == MVF::Float || a->type == MVF::Byte || a->type == MVF::Double) ? nc : 0;
+    const uchar *data = (const uchar*)mesh->vertexDataAt(v) + a->offset;
+    ForIndex(c, nc) {
+      double val = 0;
+      if      (a->type == MVF::Float)  val = ((const float*) data)[c];
+      else if (a->type == MVF::Double) val = ((const double*)data)[c];
+      else if (a->type == MVF::Byte)   val = data[c] / 255.0;
+      dst[c] = val * weight;
+    }
+    return nc;
+  }
+
+  // ------------------------------------------------------
+
+  void buildData(const TriangleMesh *mesh, const NAMESPACE::Params& params, MeshData& _d, std::vector<char>& _locked)
+  {
+    const uint nv = mesh->numVertices();
+    _d.nv = nv;
+
+    // attributes
+    const MVF::e_Binding bindings[3] = { MVF::Normal, MVF::TexCoord0, MVF::Color0 };
+    const uint           maxComp [3] = { 3, 2, 3 };
+    const float          weights [3] = { params.normalWeight, params.texCoordWeight, params.colorWeight };
+    uint na = 0;
+    ForIndex(b, 3) { na += readAttribute(mesh, bindings[b], maxComp[b], weights[b], 0, NULL); }
+    _d.dim = 3 + na;
+
+    // positions normalized by the bounding box diagonal
+    v3f bmin = v3f(FLT_MAX), bmax = v3f(-FLT_MAX);
+    ForIndex(v, nv) { bmin = min(bmin, mesh->posAt(v)); bmax = max(bmax, mesh->posAt(v)); }
+    double scale = length(v3d(bmax - bmin));
+    scale = scale > 0 ? 1.0 / scale : 1.0;
+    _d.x.resize(size_t(nv) * _d.dim);
+    LibSL::System::Parallel::forIndex(0, int(nv), [&](int v) {
+      double *p = &_d.x[size_t(v) * _d.dim];
+      ForIndex(c, 3) { p[c] = (double(mesh->posAt(v)[c]) - bmin[c]) * scale; }
+      uint k = 3;
+      ForIndex(b, 3) { k += readAttribute(mesh, bindings[b], maxComp[b], weights[b], v, p + k); }
+    }, 1024);
+
+    // non degenerate triangles
+    _d.tris .clear();
+    _d.triId.clear();
+    ForIndex(t, mesh->numTriangles()) {
+      v3u tri = mesh->triangleAt(t);
+      if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) continue;
+      _d.tris .push_back(tri);
+      _d.triId.push_back(t);
+    }
+
+    // position ids and wedges
+    std::vector<uint> order(nv);
+    ForIndex(v, nv) { order[v] = v; }
+    std::sort(order.begin(), order.end(), [&](uint a, uint b) {
+      const v3f& pa = mesh->posAt(a);
+      const v3f& pb = mesh->posAt(b);
+      if (pa[0] != pb[0]) return pa[0] < pb[0];
+      if (pa[1] != pb[1]) return pa[1] < pb[1];
+      if (pa[2] != pb[2]) return pa[2] < pb[2];
+      return a < b;
+    });
+    _d.pid.resize(nv);
+    ForIndex(i, nv) {
+      uint v = order[i];
+      _d.pid[v] = (i > 0 && mesh->posAt(order[i - 1]) == mesh->posAt(v)) ? _d.pid[order[i - 1]] : v;
+    }
+
+    // vertex -> triangles
+    _d.vtFirst.assign(nv + 1, 0);
+    ForIndex(t, _d.tris.size()) { ForIndex(c, 3) { _d.vtFirst[_d.tris[t][c] + 1]++; } }
+    ForIndex(v, nv) { _d.vtFirst[v + 1] += _d.vtFirst[v]; }
+    _d.vtList.resize(_d.vtFirst[nv]);
+    {
+      std::vector<uint> fill(_d.vtFirst.begin(), _d.vtFirst.end() - 1);
+      ForIndex(t, _d.tris.size()) { ForIndex(c, 3) { _d.vtList[fill[_d.tris[t][c]]++] = t; } }
+    }
+
+    // half-edges, in position and in wedge space
+    std::vector<t_Key> pedges, wedges;
+    pedges.reserve(_d.tris.size() * 3);
+    wedges.reserve(_d.tris.size() * 3);
+    ForIndex(t, _d.tris.size()) {
+      ForIndex(c, 3) {
+        uint a = _d.tris[t][c], b = _d.tris[t][(c + 1) % 3];
+        pedges.push_back(edgeKey(_d.pid[a], _d.pid[b]));
+        wedges.push_back(edgeKey(a, b));
+      }
+    }
+    std::sort(pedges.begin(), pedges.end());
+    std::sort(wedges.begin(), wedges.end());
+    std::vector<uint> openOut(nv, 0), openIn(nv, 0);   // per position id
+    std::vector<uint> wOpenOut(nv, 0), wOpenIn(nv, 0); // per wedge
+    std::vector<uint> numWedges(nv, 0);
+    std::vector<char> used(nv, 0);
+    _locked.assign(nv, 0);
+    ForIndex(t, _d.tris.size()) {
+      ForIndex(c, 3) {
+        uint a = _d.tris[t][c], b = _d.tris[t][(c + 1) % 3];
+        used[a] = 1;
+        uint pa = _d.pid[a], pb = _d.pid[b];
+        std::pair<std::vector<t_Key>::iterator, std::vector<t_Key>::iterator> same = std::equal_range(pedges.begin(), pedges.end(), edgeKey(pa, pb));
+        if (same.second - same.first > 1) {
+          // non-manifold edge
+          _locked[pa] = _locked[pb] = 1;
+        }
+        if (!std::binary_search(pedges.begin(), pedges.end(), edgeKey(pb, pa))) {
+          openOut[pa]++;
+          openIn [pb]++;
+        }
+        if (!std::binary_search(wedges.begin(), wedges.end(), edgeKey(b, a))) {
+          wOpenOut[a]++;
+          wOpenIn [b]++;
+        }
+      }
+    }
+
+    // vertices shared by several surfaces are locked
+    if (mesh->numSurfaces() > 1) {
+      std::vector<uint> surf(mesh->numTriangles(), c_None);
+      ForIndex(s, mesh->numSurfaces()) {
+        ForIndex(i, mesh->surfaceNumTriangles(s)) { surf[mesh->surfaceTriangleIdAt(s, i)] = s; }
+      }
+      std::vector<uint> vsurf(nv, c_None);
+      ForIndex(t, _d.tris.size()) {
+        uint s = surf[_d.triId[t]];
+        ForIndex(c, 3) {
+          uint p = _d.pid[_d.tris[t][c]];
+          if      (vsurf[p] == c_None) vsurf[p] = s;
+          else if (vsurf[p] != s)      _locked[p] = 1;
+        }
+      }
+    }
+
+    // wedges of each position
+    _d.wedge.assign(nv, c_None);
+    std::vector<uint> firstWedge(nv, c_None);
+    ForIndex(v, nv) {
+      if (!used[v]) continue;
+      uint p = _d.pid[v];
+      numWedges[p]++;
+      if (firstWedge[p] == c_None) {
+        firstWedge[p] = v;
+      } else {
+        _d.wedge[v] = firstWedge[p];
+        _d.wedge[firstWedge[p]] = v;
+      }
+    }
+
+    // classification
+    _d.kind.assign(nv, e_Locked);
+    ForIndex(v, nv) {
+      if (!used[v]) continue;
+      uint p = _d.pid[v];
+      if (_locked[p]) continue;
+      if (numWedges[p] == 1) {
+        if (openOut[p] == 0 && openIn[p] == 0) {
+          _d.kind[v] = e_Manifold;
+        } else if (openOut[p] == 1 && openIn[p] == 1 && !params.lockBorders) {
+          _d.kind[v] = e_Border;
+        }
+      } else if (numWedges[p] == 2 && openOut[p] == 0 && openIn[p] == 0) {
+        uint w = _d.wedge[v];
+        if (wOpenOut[v] == 1 && wOpenIn[v] == 1 && wOpenOut[w] == 1 && wOpenIn[w] == 1) {
+          _d.kind[v] = e_Seam;
+        }
+      }
+    }
+    // locks are per position, spread them to all wedges
+    ForIndex(v, nv) { _locked[v] = _locked[_d.pid[v]]; }
+    ForIndex(v, nv) { if (_d.kind[v] != e_Seam) _d.wedge[v] = c_None; }
+  }
+
+  // ------------------------------------------------------
+
+  // triangle and border quadrics, gathered per vertex in parallel
+  void buildQuadrics(const MeshData& d, const QuadricLayout& L, std::vector<double>& _Q)
+  {
+    // open edges, in wedge space: borders and seams
+    std::vector<t_Key> wedges;
+    wedges.reserve(d.tris.size() * 3);
+    ForIndex(t, d.tris.size()) { ForIndex(c, 3) { wedges.push_back(edgeKey(d.tris[t][c], d.tris[t][(c + 1) % 3])); } }
+    std::sort(wedges.begin(), wedges.end());
+
+    _Q.assign(size_t(d.nv) * L.size, 0.0);
+    LibSL::System::Parallel::forIndex(0, int(d.nv), [&](int v) {
+      double *q = &_Q[size_t(v) * L.size];
+      for (uint k = d.vtFirst[v]; k < d.vtFirst[v + 1]; k++) {
+        const v3u& tri = d.tris[d.vtList[k]];
+        v3d p0 = d.pos(tri[0]), p1 = d.pos(tri[1]), p2 = d.pos(tri[2]);
+        v3d n  = cross(p1 - p0, p2 - p0);
+        double area = length(n) * 0.5;
+        L.addTriangle(q, d.at(tri[0]), d.at(tri[1]), d.at(tri[2]), area);
+        // edges around v without a twin
+        ForIndex(c, 3) {
+          uint a = tri[c], b = tri[(c + 1) % 3];
+          if (a != uint(v) && b != uint(v)) continue;
+          if (std::binary_search(wedges.begin(), wedges.end(), edgeKey(b, a))) continue;
+          v3d pa = d.pos(a), pb = d.pos(b);
+          v3d m  = cross(pb - pa, n);
+          double lm = length(m);
+          if (lm <= 0) continue;
+          m = m / lm;
+          L.addPlane(q, m, dot(m, pa), c_BorderPenalty * sqLength(pb - pa));
+        }
+      }
+    }, 256);
+  }
+
+  // ------------------------------------------------------
+
+  // simplifies spatial clusters independently, vertices shared by clusters are locked
+  // the clusters only depend on the mesh, the result does not change with the thread count
+  void prePass(const MeshData& d, const QuadricLayout& L, double ratio, double maxError, uint clusterTriangles,
+               const std::vector<char>& locked, std::vector<double>& _Q,
+               std::vector<uint>& _triIdx, std::vector<v3u>& _tris, double& _maxError)
+  {
+    const uint nt = uint(d.tris.size());
+    // cluster grid, positions are within the unit box
+    int g = 1;
+    while (g < c_MaxClusterGrid && (long long)g * g * g * max(1u, clusterTriangles) < (long long)nt) g++;
+    std::vector<uint> cell(nt);
+    LibSL::System::Parallel::forIndex(0, int(nt), [&](int t) {
+      v3d ctr = (d.pos(d.tris[t][0]) + d.pos(d.tris[t][1]) + d.pos(d.tris[t][2])) / 3.0;
+      int c[3];
+      ForIndex(a, 3) { c[a] = min(g - 1, max(0, int(ctr[a] * g))); }
+      cell[t] = c[0] + g * (c[1] + g * c[2]);
+    }, 4096);
+    const uint ncells = uint(g * g * g);
+    std::vector<std::vector<uint> > cellTris(ncells);
+    ForIndex(t, nt) { cellTris[cell[t]].push_back(t); }
+    // positions touched by several clusters are locked
+    std::vector<char> cross(locked);
+    std::vector<uint> owner(d.nv, c_None);
+    ForIndex(t, nt) {
+      ForIndex(c, 3) {
+        uint p = d.pid[d.tris[t][c]];
+        if      (owner[p] == c_None)  owner[p] = cell[t];
+        else if (owner[p] != cell[t]) cross[p] = 1;
+      }
+    }
+    ForIndex(v, d.nv) { cross[v] = cross[d.pid[v]]; }
+
+    std::vector<std::vector<uint> > outIdx(ncells);
+    std::vector<std::vector<v3u> >  outTris(ncells);
+    std::vector<Collapser*>         collapsers(ncells, (Collapser*)NULL);
+    try {
+      LibSL::System::Parallel::forIndex(0, int(ncells), [&](int c) {
+        if (cellTris[c].empty()) return;
+        std::vector<v3u> tris(cellTris[c].size());
+        ForIndex(t, tris.size()) { tris[t] = d.tris[cellTris[c][t]]; }
+        Collapser *cl = new Collapser(d, L);
+        collapsers[c] = cl;
+        cl->init(cellTris[c], tris, _Q, cross);
+        std::vector<uint> target(1, uint(cellTris[c].size() * ratio));
+        cl->run(target, maxError, [](uint) { });
+        cl->result(outIdx[c], outTris[c]);
+      }, 1);
+    } catch (...) {
+      ForIndex(c, ncells) { delete (collapsers[c]); }
+      throw;
+    }
+    // gather quadrics: an unlocked vertex belongs to a single cluster, locked
+    // ones receive what each cluster collapsed onto them
+    std::vector<double> Q0(_Q);
+    ForIndex(c, ncells) {
+      Collapser *cl = collapsers[c];
+      if (cl == NULL) continue;
+      ForIndex(v, cl->m_Gid.size()) {
+        uint          gv = cl->m_Gid[v];
+        double       *qg = &_Q[size_t(gv) * L.size];
+        const double *ql = cl->q(v);
+        if (!cross[gv]) {
+          memcpy(qg, ql, L.size * sizeof(double));
+        } else {
+          const double *q0 = &Q0[size_t(gv) * L.size];
+          ForIndex(k, L.size) { qg[k] += ql[k] - q0[k]; }
+        }
+      }
+      _maxError = max(_maxError, cl->m_MaxError);
+      _triIdx.insert(_triIdx.end(), outIdx[c] .begin(), outIdx[c] .end());
+      _tris  .insert(_tris  .end(), outTris[c].begin(), outTris[c].end());
+      delete (cl);
+    }
+  }
+
+  // ------------------------------------------------------
+
+  // builds the output mesh from the surviving triangles, vertices keep their input order
+  TriangleMesh *buildMesh(const TriangleMesh *mesh, const MeshData& d, const std::vector<uint>& triIdx, const std::vector<v3u>& tris)
+  {
+    if (tris.empty()) {
+      return NULL;
+    }
+    std::vector<uint> remap(d.nv, c_None);
+    ForIndex(t, tris.size()) { ForIndex(c, 3) { remap[tris[t][c]] = 0; } }
+    uint nv = 0;
+    ForIndex(v, d.nv) { if (remap[v] != c_None) remap[v] = nv++; }
+
+    // triangles are grouped by surface
+    std::vector<uint> surf(mesh->numTriangles(), 0);
+    ForIndex(s, mesh->numSurfaces()) {
+      ForIndex(i, mesh->surfaceNumTriangles(s)) { surf[mesh->surfaceTriangleIdAt(s, i)] = s; }
+    }
+    uint nsurf = max(1u, mesh->numSurfaces());
+    std::vector<uint> count(nsurf, 0);
+    ForIndex(t, tris.size()) { count[surf[d.triId[triIdx[t]]]]++; }
+
+    TriangleMesh *result = mesh->newInstance();
+    result->setMvf(mesh->mvf());
+    result->allocate(nv, uint(tris.size()), mesh->numSurfaces());
+    const uint vsz = mesh->sizeOfVertexData();
+    ForIndex(v, d.nv) {
+      if (remap[v] != c_None) memcpy(result->vertexDataAt(remap[v]), mesh->vertexDataAt(v), vsz);
+    }
+    ForIndex(t, tris.size()) {
+      result->triangleAt(t) = V3U(remap[tris[t][0]], remap[tris[t][1]], remap[tris[t][2]]);
+    }
+    ForIndex(s, mesh->numSurfaces()) {
+      result->surfaceAt(s).textureName = mesh->surfaceAt(s).textureName;
+      result->surfaceAt(s).diffuse     = mesh->surfaceAt(s).diffuse;
+      result->surfaceAt(s).triangleIds.allocate(count[s]);
+    }
+    std::fill(count.begin(), count.end(), 0u);
+    if (mesh->numSurfaces() > 0) {
+      ForIndex(t, tris.size()) {
+        uint s = surf[d.triId[triIdx[t]]];
+        result->surfaceAt(s).triangleIds[count[s]++] = t;
+      }
+    }
+    return result;
+  }
+
+  // ------------------------------------------------------
+
+  // runs the simplification, levels are handed over as raw pointers
+  void simplifyLevels(const TriangleMesh *mesh, const std::vector<uint>& targets, const NAMESPACE::Params& params,
+                      std::vector<TriangleMesh*>& _lods, std::vector<float>& _errors)
+  {
+    sl_assert(mesh != NULL);
+    for (size_t k = 1; k < targets.size(); k++) {
+      if (targets[k] > targets[k - 1]) {
+        throw Fatal("[MeshSimplification] - targets must be in decreasing order");
+      }
+    }
+    if (targets.empty()) return;
+
+    MeshData          d;
+    std::vector<char> locked;
+    buildData(mesh, params, d, locked);
+    if (d.dim > 16) {
+      throw Fatal("[MeshSimplification] - too many attribute components (%d)", d.dim - 3);
+    }
+    QuadricLayout       L(d.dim);
+    std::vector<double> Q;
+    buildQuadrics(d, L, Q);
+
+    std::vector<uint> triIdx;
+    std::vector<v3u>  tris;
+    double            preError = 0.0;
+    const uint nt = uint(d.tris.size());
+    if (params.prePassTriangles > 0 && nt > params.prePassTriangles) {
+      // clusters stop well before the first target: their borders are locked,
+      // pushing them further would concentrate the error inside the clusters
+      double ratio = min(1.0, max(0.25, 2.0 * double(targets[0]) / double(nt)));
+      prePass(d, L, ratio, params.maxError, params.prePassTriangles / c_ClustersPerPrePass, locked, Q, triIdx, tris, preError);
+    } else {
+      triIdx.resize(nt);
+      ForIndex(t, nt) { triIdx[t] = t; }
+      tris = d.tris;
+    }
+
+    Collapser cl(d, L);
+    cl.init(triIdx, tris, Q, locked);
+    cl.m_MaxError = preError;
+    std::vector<uint> curIdx;
+    std::vector<v3u>  curTris;
+    std::function<void(uint)> snapshot = [&](uint) {
+      cl.result(curIdx, curTris);
+      _lods  .push_back(buildMesh(mesh, d, curIdx, curTris));
+      _errors.push_back(float(cl.m_MaxError));
+    };
+    cl.run(targets, params.maxError, snapshot);
+  }
+
+  void release(std::vector<TriangleMesh*>& _lods)
+  {
+    ForIndex(k, _lods.size()) { delete (_lods[k]); }
+    _lods.clear();
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void NAMESPACE::lodChain(
+  const TriangleMesh             *mesh,
+  const std::vector<uint>&        targets,
+  std::vector<TriangleMesh_Ptr>& _lods,
+  const Params&                   params,
+  std::vector<float>             *_errors)
+{
+  std::vector<TriangleMesh*> lods;
+  std::vector<float>         errors;
+  try {
+    simplifyLevels(mesh, targets, params, lods, errors);
+  } catch (...) {
+    release(lods);
+    throw;
+  }
+  _lods.clear();
+  ForIndex(k, lods.size()) { _lods.push_back(TriangleMesh_Ptr(lods[k])); }
+  if (_errors != NULL) *_errors = errors;
+}
+
+// ------------------------------------------------------
+
+LibSL::Mesh::TriangleMesh *NAMESPACE::simplify(const TriangleMesh *mesh, const Params& params, float *_error)
+{
+  std::vector<uint>          targets(1, params.targetTriangles);
+  std::vector<TriangleMesh*> lods;
+  std::vector<float>         errors;
+  try {
+    simplifyLevels(mesh, targets, params, lods, errors);
+  } catch (...) {
+    release(lods);
+    throw;
+  }
+  if (_error != NULL) *_error = errors[0];
+  return lods[0];
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,116 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshSimplification
+// ------------------------------------------------------
+//
+// Edge-collapse simplification with quadric error metrics
+//
+// Quadrics span position and the float attributes of the
+// mesh MVF (normal, texcoord0, color0), so that collapses
+// also account for attribute distortion. Collapses are
+// half-edge collapses: vertices are never synthesized, the
+// output only references input vertex data.
+//
+// Vertices are classified as manifold, border, seam (two
+// wedges sharing a position) or locked. Border and seam
+// vertices only slide along their border or seam, and both
+// wedges of a seam collapse together. Vertices shared by
+// several surfaces (materials) and non-manifold vertices
+// are locked.
+//
+// Meshes above a size threshold first go through a parallel
+// pre-pass: triangles are bucketed in spatial clusters that
+// are simplified independently, cluster borders locked.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Mesh/Mesh.h>
+
+#include <vector>
+
+namespace LibSL {
+  namespace Mesh {
+    namespace MeshSimplification {
+
+      class Params
+      {
+      public:
+        //! stop when the mesh has at most this many triangles (simplify only)
+        uint  targetTriangles;
+        //! stop before the first collapse with a larger error, relative to the
+        //! bounding box diagonal (negative: no limit)
+        float maxError;
+        //! attribute weights, relative to positions normalized by the bounding box diagonal
+        float normalWeight;
+        float texCoordWeight;
+        float colorWeight;
+        //! never move border vertices
+        bool  lockBorders;
+        //! meshes with more triangles go through the parallel cluster pre-pass (0 disables),
+        //! clusters hold about an eighth of this many triangles
+        uint  prePassTriangles;
+
+        Params()
+          : targetTriangles(0), maxError(-1.0f),
+            normalWeight(0.5f), texCoordWeight(1.0f), colorWeight(0.5f),
+            lockBorders(false), prePassTriangles(1u << 20) { }
+      };
+
+      //! Simplifies a mesh, returns a new mesh of the same type (NULL if nothing is left).
+      //! _error receives the largest collapse error, relative to the bounding box diagonal.
+      LIBSL_DLL TriangleMesh *simplify(
+        const TriangleMesh *mesh,
+        const Params&       params,
+        float              *_error = NULL);
+
+      //! Produces a chain of levels of detail in a single run, targets are triangle counts
+      //! in decreasing order. Later levels continue from earlier ones, reusing their quadrics.
+      //! A level that cannot be reached (see Params::maxError) repeats the coarsest mesh.
+      LIBSL_DLL void lodChain(
+        const TriangleMesh                  *mesh,
+        const std::vector<uint>&             targets,
+        std::vector<TriangleMesh_Ptr>&      _lods,
+        const Params&                        params  = Params(),
+        std::vector<float>                  *_errors = NULL);
+
+    } // LibSL::Mesh::MeshSimplification
+  } // LibSL::Mesh
+} // LibSL
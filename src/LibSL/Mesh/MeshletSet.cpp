@@ -0,0 +1,449 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshletSet
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include "MeshletSet.h"
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+using namespace LibSL::Errors;
+using namespace LibSL::Math;
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::Mesh
+
+// ------------------------------------------------------
+
+namespace {
+
+  const uint c_Magic         = 0x534c534du; // 'MSLS'
+  const uint c_Version       = 1;
+  const uint c_ChunkTris     = 16384; // fixed, so that the result does not depend on the core count
+
+  typedef unsigned long long t_Size;
+
+  // spreads 10 bits every third bit
+  uint spreadBits(uint x)
+  {
+    x = (x | (x << 16)) & 0x030000FF;
+    x = (x | (x <<  8)) & 0x0300F00F;
+    x = (x | (x <<  4)) & 0x030C30C3;
+    x = (x | (x <<  2)) & 0x09249249;
+    return x;
+  }
+
+  // meshlets of one chunk of the Morton sorted triangles
+  class ChunkBuilder
+  {
+  public:
+
+    const NAMESPACE::TriangleMesh *m_Mesh;
+    uint                           m_MaxVertices;
+    uint                           m_MaxTriangles;
+
+    std::vector<uint>              m_Gid;       // local vertex -> mesh vertex, sorted
+    std::vector<v3u>               m_Tris;      // local vertices
+    std::vector<v3f>               m_Centers;
+    std::vector<uint>              m_First;     // local vertex -> triangles (CSR)
+    std::vector<uint>              m_List;
+    std::vector<char>              m_Used;
+    std::vector<int>               m_Slot;      // local vertex -> meshlet vertex, -1 if not in
+    std::vector<uint>              m_Candidates;
+
+    std::vector<NAMESPACE::MeshletSet::t_Meshlet> m_Meshlets;
+    std::vector<uint>              m_Vertices;
+    std::vector<uchar>             m_Triangles;
+
+    ChunkBuilder(const NAMESPACE::TriangleMesh *mesh,uint maxv,uint maxt)
+      : m_Mesh(mesh), m_MaxVertices(maxv), m_MaxTriangles(maxt) { }
+
+    void init(const uint *tris,uint num)
+    {
+      ForIndex(t,num) {
+        ForIndex(c,3) { m_Gid.push_back(m_Mesh->triangleAt(tris[t])[c]); }
+      }
+      sort(m_Gid.begin(),m_Gid.end());
+      m_Gid.erase(unique(m_Gid.begin(),m_Gid.end()),m_Gid.end());
+      uint nv = uint(m_Gid.size());
+      m_Tris   .resize(num);
+      m_Centers.resize(num);
+      ForIndex(t,num) {
+        const NAMESPACE::TriangleMesh::t_Triangle& tri = m_Mesh->triangleAt(tris[t]);
+        ForIndex(c,3) {
+          m_Tris[t][c] = uint(lower_bound(m_Gid.begin(),m_Gid.end(),tri[c]) - m_Gid.begin());
+        }
+        m_Centers[t] = (m_Mesh->posAt(tri[0]) + m_Mesh->posAt(tri[1]) + m_Mesh->posAt(tri[2])) / 3.0f;
+      }
+      m_First.assign(nv + 1,0);
+      ForIndex(t,num) { ForIndex(c,3) { m_First[m_Tris[t][c] + 1] ++; } }
+      ForIndex(v,nv)  { m_First[v + 1] += m_First[v]; }
+      m_List.resize(m_First[nv]);
+      std::vector<uint> fill(m_First.begin(),m_First.end() - 1);
+      ForIndex(t,num) { ForIndex(c,3) { m_List[fill[m_Tris[t][c]] ++] = t; } }
+      m_Used.assign(num,0);
+      m_Slot.assign(nv,-1);
+    }
+
+    uint newVertices(uint t) const
+    {
+      return (m_Slot[m_Tris[t][0]] < 0 ? 1 : 0) + (m_Slot[m_Tris[t][1]] < 0 ? 1 : 0) + (m_Slot[m_Tris[t][2]] < 0 ? 1 : 0);
+    }
+
+    void build()
+    {
+      uint cursor = 0;
+      uint num    = uint(m_Tris.size());
+      uint done   = 0;
+      while (done < num) {
+        // new meshlet
+        NAMESPACE::MeshletSet::t_Meshlet m;
+        m.vertexOffset   = uint(m_Vertices .size());
+        m.triangleOffset = uint(m_Triangles.size());
+        m.numVertices    = 0;
+        m.numTriangles   = 0;
+        m_Candidates.clear();
+        v3f  center(0.0f);
+        while (m.numTriangles < m_MaxTriangles && done < num) {
+          // best candidate: fewest new vertices, then closest to the meshlet center
+          uint  best     = uint(-1);
+          uint  bestNew  = 4;
+          float bestDist = FLT_MAX;
+          uint  kept     = 0;
+          ForIndex(i,m_Candidates.size()) {
+            uint t = m_Candidates[i];
+            if (m_Used[t]) continue;
+            m_Candidates[kept ++] = t;
+            uint  n = newVertices(t);
+            if (m.numVertices + n > m_MaxVertices) continue;
+            float d = sqLength(m_Centers[t] - center);
+            if (n < bestNew || (n == bestNew && d < bestDist)) {
+              best     = t;
+              bestNew  = n;
+              bestDist = d;
+            }
+          }
+          m_Candidates.resize(kept);
+          if (best == uint(-1)) {
+            if (!m_Candidates.empty() || m.numVertices + 3 > m_MaxVertices) {
+              break; // meshlet is full
+            }
+            // disconnected, continue along the curve
+            while (m_Used[cursor]) cursor ++;
+            best = cursor;
+          }
+          // add triangle
+          m_Used[best] = 1;
+          done ++;
+          ForIndex(c,3) {
+            uint v = m_Tris[best][c];
+            if (m_Slot[v] < 0) {
+              m_Slot[v] = int(m.numVertices ++);
+              m_Vertices.push_back(m_Gid[v]);
+              for (uint k = m_First[v] ; k < m_First[v + 1] ; k++) {
+                if (!m_Used[m_List[k]]) m_Candidates.push_back(m_List[k]);
+              }
+            }
+            m_Triangles.push_back(uchar(m_Slot[v]));
+          }
+          center = (center * float(m.numTriangles) + m_Centers[best]) / float(m.numTriangles + 1);
+          m.numTriangles ++;
+        }
+        // reset slots
+        ForIndex(i,m.numVertices) {
+          uint g = m_Vertices[m.vertexOffset + i];
+          m_Slot[lower_bound(m_Gid.begin(),m_Gid.end(),g) - m_Gid.begin()] = -1;
+        }
+        m_Meshlets.push_back(m);
+      }
+    }
+
+  };
+
+  // bounding sphere [Ritter 90] and normal cone of a meshlet
+  NAMESPACE::MeshletSet::t_Bounds computeBounds(const NAMESPACE::TriangleMesh *mesh,const NAMESPACE::MeshletSet& set,uint m)
+  {
+    const NAMESPACE::MeshletSet::t_Meshlet& ml = set.meshletAt(m);
+    NAMESPACE::MeshletSet::t_Bounds b;
+    // sphere: start from the most distant pair along the axes
+    v3f pmin[3],pmax[3];
+    ForIndex(a,3) { pmin[a] = pmax[a] = mesh->posAt(set.vertexAt(m,0)); }
+    ForIndex(v,ml.numVertices) {
+      const v3f& p = mesh->posAt(set.vertexAt(m,v));
+      ForIndex(a,3) {
+        if (p[a] < pmin[a][a]) pmin[a] = p;
+        if (p[a] > pmax[a][a]) pmax[a] = p;
+      }
+    }
+    int   axis  = 0;
+    float span  = -1.0f;
+    ForIndex(a,3) {
+      float d = sqLength(pmax[a] - pmin[a]);
+      if (d > span) { span = d; axis = a; }
+    }
+    v3f   ctr = (pmin[axis] + pmax[axis]) * 0.5f;
+    float rad = sqrtf(span) * 0.5f;
+    ForIndex(v,ml.numVertices) {
+      const v3f& p = mesh->posAt(set.vertexAt(m,v));
+      float d = length(p - ctr);
+      if (d > rad) {
+        // grow to include p
+        float nr = (rad + d) * 0.5f;
+        ctr = ctr + (p - ctr) * ((nr - rad) / d);
+        rad = nr;
+      }
+    }
+    b.center = ctr;
+    b.radius = rad;
+    // normal cone
+    std::vector<v3f> nrms(ml.numTriangles);
+    v3f  avg(0.0f);
+    ForIndex(t,ml.numTriangles) {
+      v3u tri = set.triangleAt(m,t);
+      v3f p0 = mesh->posAt(set.vertexAt(m,tri[0]));
+      v3f n  = cross(mesh->posAt(set.vertexAt(m,tri[1])) - p0,mesh->posAt(set.vertexAt(m,tri[2])) - p0);
+      float l = length(n);
+      nrms[t] = l > 0.0f ? n / l : v3f(0.0f);
+      avg    += nrms[t];
+    }
+    float la = length(avg);
+    b.coneAxis   = la > 0.0f ? avg / la : V3F(1,0,0);
+    b.coneApex   = b.center;
+    b.coneCutoff = 1.0f;
+    float mindp = 1.0f;
+    ForIndex(t,ml.numTriangles) {
+      mindp = min(mindp,dot(nrms[t],b.coneAxis));
+    }
+    if (la == 0.0f || mindp <= 0.1f) {
+      return b; // too wide, never culled
+    }
+    // apex: the axis moved back so that the cone contains all triangle planes
+    float maxt = 0.0f;
+    ForIndex(t,ml.numTriangles) {
+      v3u   tri = set.triangleAt(m,t);
+      v3f   p0  = mesh->posAt(set.vertexAt(m,tri[0]));
+      float dc  = dot(b.center - p0,nrms[t]);
+      float dn  = dot(b.coneAxis,nrms[t]);
+      maxt      = max(maxt,dc / dn);
+    }
+    b.coneApex   = b.center - b.coneAxis * maxt;
+    b.coneCutoff = sqrtf(1.0f - mindp * mindp);
+    return b;
+  }
+
+  template <typename T>
+  void writeVector(FILE *f,const std::vector<T>& v)
+  {
+    uint n = uint(v.size());
+    fwrite(&n,sizeof(uint),1,f);
+    if (n > 0) fwrite(&v[0],sizeof(T),n,f);
+  }
+
+  // fsize bounds the count, a corrupt one must not trigger a huge allocation
+  template <typename T>
+  bool readVector(FILE *f,long fsize,std::vector<T>& _v)
+  {
+    uint n = 0;
+    if (fread(&n,sizeof(uint),1,f) != 1) return false;
+    long pos = ftell(f);
+    if (pos < 0 || t_Size(n) * sizeof(T) > t_Size(fsize - pos)) return false;
+    _v.resize(n);
+    return n == 0 || fread(&_v[0],sizeof(T),n,f) == n;
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void NAMESPACE::MeshletSet::build(const TriangleMesh *mesh,uint maxVertices,uint maxTriangles)
+{
+  sl_assert(mesh != NULL);
+  if (maxVertices < 3 || maxVertices > 256 || maxTriangles < 1 || maxTriangles > 512) {
+    throw Fatal("[MeshletSet::build] - invalid limits (%d vertices, %d triangles)",maxVertices,maxTriangles);
+  }
+  m_MaxVertices  = maxVertices;
+  m_MaxTriangles = maxTriangles;
+  m_Meshlets .clear();
+  m_Bounds   .clear();
+  m_Vertices .clear();
+  m_Triangles.clear();
+  const uint nt = mesh->numTriangles();
+  if (nt == 0) {
+    return;
+  }
+
+  // sort triangles along a Morton curve
+  AABox box;
+  ForIndex(v,mesh->numVertices()) {
+    box.addPoint(mesh->posAt(v));
+  }
+  v3f ext = box.extent();
+  ForIndex(a,3) { ext[a] = ext[a] > 0.0f ? 1023.0f / ext[a] : 0.0f; }
+  std::vector<std::pair<uint,uint> > order(nt);
+  LibSL::System::Parallel::forIndex(0,int(nt),[&](int t) {
+    const TriangleMesh::t_Triangle& tri = mesh->triangleAt(t);
+    v3f c = (mesh->posAt(tri[0]) + mesh->posAt(tri[1]) + mesh->posAt(tri[2])) / 3.0f;
+    uint code = 0;
+    ForIndex(a,3) {
+      uint q = uint(clamp((c[a] - box.minCorner()[a]) * ext[a],0.0f,1023.0f));
+      code  |= spreadBits(q) << a;
+    }
+    order[t] = std::make_pair(code,uint(t));
+  },4096);
+  sort(order.begin(),order.end());
+  std::vector<uint> sorted(nt);
+  ForIndex(t,nt) { sorted[t] = order[t].second; }
+
+  // chunks along the curve are processed in parallel
+  uint nchunks = max(1u,nt / c_ChunkTris);
+  std::vector<ChunkBuilder*> chunks(nchunks,(ChunkBuilder*)NULL);
+  try {
+    LibSL::System::Parallel::forIndex(0,int(nchunks),[&](int c) {
+      uint first = uint(size_t(nt) *  c      / nchunks);
+      uint last  = uint(size_t(nt) * (c + 1) / nchunks);
+      chunks[c]  = new ChunkBuilder(mesh,maxVertices,maxTriangles);
+      chunks[c]->init(&sorted[first],last - first);
+      chunks[c]->build();
+    });
+    // concatenate
+    ForIndex(c,nchunks) {
+      ChunkBuilder *cb = chunks[c];
+      uint voffs = uint(m_Vertices .size());
+      uint toffs = uint(m_Triangles.size());
+      ForIndex(m,cb->m_Meshlets.size()) {
+        t_Meshlet ml       = cb->m_Meshlets[m];
+        ml.vertexOffset   += voffs;
+        ml.triangleOffset += toffs;
+        m_Meshlets.push_back(ml);
+      }
+      m_Vertices .insert(m_Vertices .end(),cb->m_Vertices .begin(),cb->m_Vertices .end());
+      m_Triangles.insert(m_Triangles.end(),cb->m_Triangles.begin(),cb->m_Triangles.end());
+      delete (cb);
+      chunks[c] = NULL;
+    }
+  } catch (...) {
+    ForIndex(c,nchunks) { delete (chunks[c]); }
+    throw;
+  }
+
+  // bounds
+  m_Bounds.resize(m_Meshlets.size());
+  LibSL::System::Parallel::forIndex(0,int(m_Meshlets.size()),[&](int m) {
+    m_Bounds[m] = computeBounds(mesh,*this,m);
+  },64);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::MeshletSet::save(const char *fname) const
+{
+  FILE *f = NULL;
+  fopen_s(&f,fname,"wb");
+  if (f == NULL) {
+    throw Fatal("[MeshletSet::save] - cannot create file '%s'",fname);
+  }
+  fwrite(&c_Magic,sizeof(uint),1,f);
+  fwrite(&c_Version,sizeof(uint),1,f);
+  fwrite(&m_MaxVertices,sizeof(uint),1,f);
+  fwrite(&m_MaxTriangles,sizeof(uint),1,f);
+  writeVector(f,m_Meshlets);
+  writeVector(f,m_Bounds);
+  writeVector(f,m_Vertices);
+  writeVector(f,m_Triangles);
+  fclose(f);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::MeshletSet::load(const char *fname)
+{
+  FILE *f = NULL;
+  fopen_s(&f,fname,"rb");
+  if (f == NULL) {
+    throw Fatal("[MeshletSet::load] - file '%s' not found",fname);
+  }
+  fseek(f,0,SEEK_END);
+  long fsize = ftell(f);
+  fseek(f,0,SEEK_SET);
+  // read into locals, the set is left untouched unless the whole file is valid
+  uint magic = 0,version = 0,maxVertices = 0,maxTriangles = 0;
+  std::vector<t_Meshlet> meshlets;
+  std::vector<t_Bounds>  bounds;
+  std::vector<uint>      vertices;
+  std::vector<uchar>     triangles;
+  bool ok = fread(&magic,sizeof(uint),1,f) == 1 && fread(&version,sizeof(uint),1,f) == 1
+         && magic == c_Magic && version == c_Version;
+  ok = ok && fread(&maxVertices,sizeof(uint),1,f) == 1 && fread(&maxTriangles,sizeof(uint),1,f) == 1;
+  ok = ok && readVector(f,fsize,meshlets) && readVector(f,fsize,bounds) && readVector(f,fsize,vertices) && readVector(f,fsize,triangles);
+  fclose(f);
+  ok = ok && maxVertices >= 3 && maxVertices <= 256 && maxTriangles >= 1 && maxTriangles <= 512;
+  ok = ok && bounds.size() == meshlets.size();
+  // every meshlet within the limits and the packed buffers
+  for (size_t m = 0 ; ok && m < meshlets.size() ; m++) {
+    const t_Meshlet& ml = meshlets[m];
+    ok = ml.numVertices <= maxVertices && ml.numTriangles <= maxTriangles
+      && t_Size(ml.vertexOffset) + ml.numVertices <= vertices.size()
+      && t_Size(ml.triangleOffset) + t_Size(ml.numTriangles) * 3 <= triangles.size();
+    for (uint i = 0 ; ok && i < ml.numTriangles * 3 ; i++) {
+      ok = triangles[ml.triangleOffset + i] < ml.numVertices;
+    }
+  }
+  if (!ok) {
+    throw Fatal("[MeshletSet::load] - file '%s' is not a valid meshlet file",fname);
+  }
+  m_MaxVertices  = maxVertices;
+  m_MaxTriangles = maxTriangles;
+  m_Meshlets .swap(meshlets);
+  m_Bounds   .swap(bounds);
+  m_Vertices .swap(vertices);
+  m_Triangles.swap(triangles);
+}
+
+// ------------------------------------------------------
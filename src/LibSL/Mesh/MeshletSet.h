@@ -0,0 +1,142 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::Mesh::MeshletSet
+// ------------------------------------------------------
+//
+// Partition of a TriangleMesh in small clusters (meshlets)
+// for GPU-driven rendering and culling.
+//
+// Each meshlet references at most maxVertices mesh vertices
+// and maxTriangles triangles. Triangles are stored as local
+// byte indices into the meshlet vertex list. Each meshlet
+// has a bounding sphere and a normal cone for backface
+// culling of the whole cluster.
+//
+// Meshlets are grown greedily from triangles sorted along a
+// Morton curve, favoring triangles that add few vertices.
+// The curve is split in chunks processed in parallel.
+//
+// Meshlet sets are stored in a '.meshlets' file alongside
+// the '.mesh' file they were built from.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/Math/Vertex.h>
+#include <LibSL/Mesh/Mesh.h>
+
+#include <vector>
+
+namespace LibSL {
+  namespace Mesh {
+
+    class LIBSL_DLL MeshletSet
+    {
+    public:
+
+      typedef struct
+      {
+        uint vertexOffset;    // first entry in vertices()
+        uint triangleOffset;  // first byte in triangles(), three bytes per triangle
+        uint numVertices;
+        uint numTriangles;
+      } t_Meshlet;
+
+      typedef struct
+      {
+        LibSL::Math::v3f center;      // bounding sphere
+        float            radius;
+        LibSL::Math::v3f coneApex;    // normal cone, see isBackfacing
+        LibSL::Math::v3f coneAxis;
+        float            coneCutoff;  // 1 when the cone is too wide to ever cull
+      } t_Bounds;
+
+    protected:
+
+      uint                   m_MaxVertices;
+      uint                   m_MaxTriangles;
+      std::vector<t_Meshlet> m_Meshlets;
+      std::vector<t_Bounds>  m_Bounds;
+      std::vector<uint>      m_Vertices;
+      std::vector<uchar>     m_Triangles;
+
+    public:
+
+      MeshletSet() : m_MaxVertices(0), m_MaxTriangles(0) { }
+
+      //! builds meshlets, maxVertices is at most 256 and maxTriangles at most 512
+      void build(const TriangleMesh *mesh,uint maxVertices = 64,uint maxTriangles = 124);
+
+      uint                       numMeshlets()            const { return uint(m_Meshlets.size()); }
+      uint                       maxVertices()            const { return m_MaxVertices; }
+      uint                       maxTriangles()           const { return m_MaxTriangles; }
+      const t_Meshlet&           meshletAt(uint m)        const { return m_Meshlets[m]; }
+      const t_Bounds&            boundsAt(uint m)         const { return m_Bounds[m]; }
+      //! mesh vertex referenced by local vertex v of meshlet m
+      uint                       vertexAt(uint m,uint v)  const { return m_Vertices[m_Meshlets[m].vertexOffset + v]; }
+      //! local vertices of triangle t of meshlet m
+      LibSL::Math::v3u           triangleAt(uint m,uint t) const
+      {
+        const uchar *tri = &m_Triangles[m_Meshlets[m].triangleOffset + t * 3];
+        return LibSL::Math::V3U(tri[0],tri[1],tri[2]);
+      }
+
+      //! packed buffers, ready for upload
+      const std::vector<uint>&   vertices()               const { return m_Vertices; }
+      const std::vector<uchar>&  triangles()              const { return m_Triangles; }
+
+      //! true if all triangles of the meshlet face away from eye
+      static bool isBackfacing(const t_Bounds& b,const LibSL::Math::v3f& eye)
+      {
+        LibSL::Math::v3f d = b.coneApex - eye;
+        float            l = LibSL::Math::length(d);
+        return l > 0.0f && LibSL::Math::dot(d,b.coneAxis) >= b.coneCutoff * l;
+      }
+
+      //! load/save, meant for a '.meshlets' file next to the '.mesh' file
+      void save(const char *fname) const;
+      void load(const char *fname);
+
+    };
+
+  } //namespace LibSL::Mesh
+} //namespace LibSL
+
+// ------------------------------------------------------
@@ -0,0 +1,325 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/System/HalfConvert.h>
+#include <LibSL/System/Parallel.h>
+
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HALF_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#define HALF_F16C
+#include <immintrin.h>
+#include <intrin.h>
+#define HALF_F16C_TARGET
+#elif (defined(__GNUC__) && !defined(__INTEL_COMPILER) && !defined(EMSCRIPTEN)) && (defined(__x86_64__) || defined(__i386__))
+#define HALF_F16C
+#include <immintrin.h>
+#define HALF_F16C_TARGET __attribute__((target("avx,f16c")))
+#endif
+#endif
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::System
+
+// ------------------------------------------------------
+
+// buffers larger than this are split across the worker pool
+#define HALF_PARALLEL_GRAIN (1 << 16)
+
+static_assert(sizeof(half) == sizeof(ushort),"half is expected to be 16 bits");
+
+// ------------------------------------------------------
+
+namespace {
+
+  inline uint floatBits(float f)   { uint u; memcpy(&u,&f,4); return u; }
+  inline float bitsFloat(uint u)   { float f; memcpy(&f,&u,4); return f; }
+
+  // scalar reference, same results as the SIMD paths
+
+  inline float toFloat(ushort h)
+  {
+    const uint  shifted_exp = 0x7c00u << 13;
+    uint        o           = (h & 0x7fffu) << 13;
+    uint        exp         = shifted_exp & o;
+    o += (127 - 15) << 23;
+    if (exp == shifted_exp) {        // Inf / NaN
+      o += (128 - 16) << 23;
+    } else if (exp == 0) {           // zero / denormal
+      o += 1 << 23;
+      o  = floatBits(bitsFloat(o) - bitsFloat(113u << 23));
+    }
+    return bitsFloat(o | ((h & 0x8000u) << 16));
+  }
+
+  inline ushort toHalf(float f)
+  {
+    const uint f32infty     = 255u << 23;
+    const uint f16max       = (127u + 16u) << 23;
+    const uint denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+    uint x    = floatBits(f);
+    uint sign = x & 0x80000000u;
+    x        ^= sign;
+    uint o;
+    if (x >= f16max) {               // overflow, Inf or NaN
+      o = (x > f32infty) ? 0x7e00u : 0x7c00u;
+    } else if (x < (113u << 23)) {   // denormal or zero, let the FPU round
+      o = floatBits(bitsFloat(x) + bitsFloat(denorm_magic)) - denorm_magic;
+    } else {                         // normal, round to nearest even
+      uint mant_odd = (x >> 13) & 1;
+      x += ((15u - 127u) << 23) + 0xfffu;
+      x += mant_odd;
+      o  = x >> 13;
+    }
+    return ushort(o | (sign >> 16));
+  }
+
+  void toFloatScalar(const ushort *src,float *dst,size_t n)
+  {
+    for (size_t i = 0 ; i < n ; i++) {
+      dst[i] = toFloat(src[i]);
+    }
+  }
+
+  void toHalfScalar(const float *src,ushort *dst,size_t n)
+  {
+    for (size_t i = 0 ; i < n ; i++) {
+      dst[i] = toHalf(src[i]);
+    }
+  }
+
+#ifdef HALF_SSE2
+
+  void toFloatSSE2(const ushort *src,float *dst,size_t n)
+  {
+    const __m128i mask_nosign = _mm_set1_epi32(0x7fff);
+    const __m128i shifted_exp = _mm_set1_epi32(0x7c00 << 13);
+    const __m128i exp_adjust  = _mm_set1_epi32((127 - 15) << 23);
+    const __m128i infnan_adj  = _mm_set1_epi32((128 - 16) << 23);
+    const __m128i denorm_adj  = _mm_set1_epi32(1 << 23);
+    const __m128  magic       = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+    const __m128i zero        = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 4 <= n ; i += 4) {
+      __m128i h      = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)),zero);
+      __m128i o      = _mm_slli_epi32(_mm_and_si128(h,mask_nosign),13);
+      __m128i exp    = _mm_and_si128(o,shifted_exp);
+      o              = _mm_add_epi32(o,exp_adjust);
+      __m128i infnan = _mm_cmpeq_epi32(exp,shifted_exp);
+      __m128i denorm = _mm_cmpeq_epi32(exp,zero);
+      o              = _mm_add_epi32(o,_mm_and_si128(infnan,infnan_adj));
+      __m128i od     = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o,denorm_adj)),magic));
+      o              = _mm_or_si128(_mm_and_si128(denorm,od),_mm_andnot_si128(denorm,o));
+      o              = _mm_or_si128(o,_mm_slli_epi32(_mm_srli_epi32(h,15),31));
+      _mm_storeu_ps(dst + i,_mm_castsi128_ps(o));
+    }
+    toFloatScalar(src + i,dst + i,n - i);
+  }
+
+  void toHalfSSE2(const float *src,ushort *dst,size_t n)
+  {
+    const __m128i sign_mask    = _mm_set1_epi32(int(0x80000000u));
+    const __m128i f32infty     = _mm_set1_epi32(255 << 23);
+    const __m128i f16max       = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i min_normal   = _mm_set1_epi32(113 << 23);
+    const __m128i denorm_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i rebias       = _mm_set1_epi32(int(((15u - 127u) << 23) + 0xfffu));
+    const __m128i one          = _mm_set1_epi32(1);
+    const __m128i h_inf        = _mm_set1_epi32(0x7c00);
+    const __m128i h_nan        = _mm_set1_epi32(0x7e00);
+    size_t i = 0;
+    for ( ; i + 8 <= n ; i += 8) {
+      __m128i r[2];
+      for (int k = 0 ; k < 2 ; k++) {
+        __m128i x      = _mm_castps_si128(_mm_loadu_ps(src + i + k * 4));
+        __m128i sign   = _mm_and_si128(x,sign_mask);
+        x              = _mm_xor_si128(x,sign);
+        // all comparisons are on positive values, signed compares are fine
+        __m128i isbig  = _mm_cmpgt_epi32(x,_mm_sub_epi32(f16max,one));
+        __m128i isnan  = _mm_cmpgt_epi32(x,f32infty);
+        __m128i issub  = _mm_cmplt_epi32(x,min_normal);
+        __m128i big    = _mm_or_si128(_mm_and_si128(isnan,h_nan),_mm_andnot_si128(isnan,h_inf));
+        __m128i sub    = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(x),_mm_castsi128_ps(denorm_magic))),denorm_magic);
+        __m128i odd    = _mm_and_si128(_mm_srli_epi32(x,13),one);
+        __m128i nrm    = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x,rebias),odd),13);
+        __m128i o      = _mm_or_si128(_mm_and_si128(issub,sub),_mm_andnot_si128(issub,nrm));
+        o              = _mm_or_si128(_mm_and_si128(isbig,big),_mm_andnot_si128(isbig,o));
+        o              = _mm_or_si128(o,_mm_srli_epi32(sign,16));
+        // sign extend so that the saturating pack keeps the 16 bits untouched
+        r[k]           = _mm_srai_epi32(_mm_slli_epi32(o,16),16);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),_mm_packs_epi32(r[0],r[1]));
+    }
+    toHalfScalar(src + i,dst + i,n - i);
+  }
+
+#endif
+
+#ifdef HALF_F16C
+
+  bool detectF16C()
+  {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info,1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    bool f16c    = (info[2] & (1 << 29)) != 0;
+    if (!(osxsave && avx && f16c)) {
+      return false;
+    }
+    return ((_xgetbv(0) & 6) == 6); // OS saves the ymm registers
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+  }
+
+  HALF_F16C_TARGET void toFloatF16C(const ushort *src,float *dst,size_t n)
+  {
+    size_t i = 0;
+    for ( ; i + 8 <= n ; i += 8) {
+      __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      _mm256_storeu_ps(dst + i,_mm256_cvtph_ps(h));
+    }
+    toFloatScalar(src + i,dst + i,n - i);
+  }
+
+  HALF_F16C_TARGET void toHalfF16C(const float *src,ushort *dst,size_t n)
+  {
+    size_t i = 0;
+    for ( ; i + 8 <= n ; i += 8) {
+      __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),_MM_FROUND_TO_NEAREST_INT);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),h);
+    }
+    toHalfScalar(src + i,dst + i,n - i);
+  }
+
+  const bool s_HasF16C = detectF16C();
+
+#endif
+
+  typedef void (*t_ToFloat)(const ushort*,float*,size_t);
+  typedef void (*t_ToHalf) (const float*,ushort*,size_t);
+
+  t_ToFloat selectToFloat()
+  {
+#ifdef HALF_F16C
+    if (s_HasF16C) {
+      return toFloatF16C;
+    }
+#endif
+#ifdef HALF_SSE2
+    return toFloatSSE2;
+#else
+    return toFloatScalar;
+#endif
+  }
+
+  t_ToHalf selectToHalf()
+  {
+#ifdef HALF_F16C
+    if (s_HasF16C) {
+      return toHalfF16C;
+    }
+#endif
+#ifdef HALF_SSE2
+    return toHalfSSE2;
+#else
+    return toHalfScalar;
+#endif
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+bool NAMESPACE::halfConvertUsesF16C()
+{
+#ifdef HALF_F16C
+  return s_HasF16C;
+#else
+  return false;
+#endif
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::halfToFloat(const half *src,float *_dst,size_t n)
+{
+  t_ToFloat     kernel = selectToFloat();
+  const ushort *s      = reinterpret_cast<const ushort*>(src);
+  if (n < 2 * HALF_PARALLEL_GRAIN) {
+    kernel(s,_dst,n);
+    return;
+  }
+  // chunks of HALF_PARALLEL_GRAIN elements
+  int numChunks = int((n + HALF_PARALLEL_GRAIN - 1) / HALF_PARALLEL_GRAIN);
+  Parallel::forChunks(0,numChunks,[&](int first,int last) {
+    size_t b = size_t(first) * HALF_PARALLEL_GRAIN;
+    size_t e = std::min(n,size_t(last) * HALF_PARALLEL_GRAIN);
+    kernel(s + b,_dst + b,e - b);
+  });
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::floatToHalf(const float *src,half *_dst,size_t n)
+{
+  t_ToHalf kernel = selectToHalf();
+  ushort  *d      = reinterpret_cast<ushort*>(_dst);
+  if (n < 2 * HALF_PARALLEL_GRAIN) {
+    kernel(src,d,n);
+    return;
+  }
+  int numChunks = int((n + HALF_PARALLEL_GRAIN - 1) / HALF_PARALLEL_GRAIN);
+  Parallel::forChunks(0,numChunks,[&](int first,int last) {
+    size_t b = size_t(first) * HALF_PARALLEL_GRAIN;
+    size_t e = std::min(n,size_t(last) * HALF_PARALLEL_GRAIN);
+    kernel(src + b,d + b,e - b);
+  });
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,78 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::System::HalfConvert
+// ------------------------------------------------------
+//
+// Bulk conversions between half and float arrays
+//
+// Uses F16C instructions when the CPU supports them
+// (detected at runtime), an SSE2 bit-manipulation path
+// otherwise, and splits large buffers across the worker
+// pool (see System/Parallel.h).
+//
+// Rounding is to nearest even, as done by hardware. This
+// may differ from half(float) on exact ties, which rounds
+// away from zero, and -0 keeps its sign.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/LibSL.common.h>
+#include <LibSL/System/Types.h>
+
+#include <cstddef>
+
+// ------------------------------------------------------
+
+namespace LibSL  {
+  namespace System {
+
+    //! converts n halves to floats
+    LIBSL_DLL void halfToFloat(const half  *src,float *_dst,size_t n);
+    //! converts n floats to halves
+    LIBSL_DLL void floatToHalf(const float *src,half  *_dst,size_t n);
+
+    //! true if the F16C path is used on this CPU
+    LIBSL_DLL bool halfConvertUsesF16C();
+
+  } //namespace LibSL::System
+} //namespace LibSL
+
+// ------------------------------------------------------
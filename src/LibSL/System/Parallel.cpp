@@ -0,0 +1,358 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/CppHelpers/CppHelpers.h>
+
+#include <LibSL/System/Parallel.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(USE_CXX11) || defined(USE_CXX14) || defined(USE_CXX17)
+#define LIBSL_PARALLEL_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <vector>
+#else
+#pragma message ("Parallel loops compiled without multithread support")
+#endif
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::System::Parallel
+
+// ------------------------------------------------------
+
+#ifdef LIBSL_PARALLEL_THREADS
+
+namespace {
+
+  uint defaultNumThreads()
+  {
+    const char *env = getenv("LIBSL_NUM_THREADS");
+    if (env != NULL) {
+      int n = atoi(env);
+      if (n > 0) {
+        return uint(n);
+      }
+    }
+    uint n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+  }
+
+  thread_local uint t_WorkerId = 0;
+  thread_local bool t_InLoop   = false;
+
+  // ------------------------------------------------------
+
+  class WorkerPool
+  {
+  private:
+
+    std::vector<std::thread>          m_Threads;
+    std::mutex                        m_Mutex;
+    std::condition_variable           m_WakeUp;
+    std::condition_variable           m_Done;
+    const std::function<void(uint)>  *m_Job;
+    unsigned long long                m_Generation;
+    uint                              m_Pending;
+    bool                              m_Quit;
+    std::exception_ptr                m_Error;
+
+    void worker(uint id)
+    {
+      t_WorkerId = id;
+      t_InLoop   = true;
+      unsigned long long seen = 0;
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      while (true) {
+        m_WakeUp.wait(lock, [&] { return m_Quit || m_Generation != seen; });
+        if (m_Quit) {
+          return;
+        }
+        seen = m_Generation;
+        const std::function<void(uint)> *job = m_Job;
+        lock.unlock();
+        try {
+          (*job)(id);
+        } catch (...) {
+          lock.lock();
+          if (!m_Error) {
+            m_Error = std::current_exception();
+          }
+          lock.unlock();
+        }
+        lock.lock();
+        if (--m_Pending == 0) {
+          m_Done.notify_all();
+        }
+      }
+    }
+
+  public:
+
+    //! held by the thread currently running a job on the pool
+    std::mutex m_Owner;
+
+    WorkerPool(uint n) : m_Job(NULL), m_Generation(0), m_Pending(0), m_Quit(false)
+    {
+      // the calling thread is worker 0
+      for (uint i = 1; i < n; i++) {
+        m_Threads.push_back(std::thread(&WorkerPool::worker, this, i));
+      }
+    }
+
+    ~WorkerPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+      }
+      m_WakeUp.notify_all();
+      for (size_t i = 0; i < m_Threads.size(); i++) {
+        m_Threads[i].join();
+      }
+    }
+
+    uint size() const { return uint(m_Threads.size()) + 1; }
+
+    void run(const std::function<void(uint)>& job)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Job     = &job;
+        m_Pending = uint(m_Threads.size());
+        m_Error   = std::exception_ptr();
+        m_Generation++;
+      }
+      m_WakeUp.notify_all();
+      std::exception_ptr err;
+      t_WorkerId = 0;
+      t_InLoop   = true;
+      try {
+        job(0);
+      } catch (...) {
+        err = std::current_exception();
+      }
+      t_InLoop   = false;
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Done.wait(lock, [this] { return m_Pending == 0; });
+        m_Job = NULL;
+        if (!err) {
+          err = m_Error;
+        }
+      }
+      if (err) {
+        std::rethrow_exception(err);
+      }
+    }
+  };
+
+  // ------------------------------------------------------
+
+  std::mutex  g_PoolLock;
+  WorkerPool *g_Pool       = NULL;
+  uint        g_NumThreads = 0;
+
+  struct PoolCleanup
+  {
+    ~PoolCleanup() { LIBSL_SAFE_DELETE(g_Pool); }
+  } g_PoolCleanup;
+
+  //! returns the pool, owned by the caller, or NULL if the loop has to run serially
+  WorkerPool *acquirePool()
+  {
+    if (t_InLoop) {
+      return NULL;
+    }
+    std::lock_guard<std::mutex> lock(g_PoolLock);
+    if (g_NumThreads == 0) {
+      g_NumThreads = defaultNumThreads();
+    }
+    if (g_NumThreads < 2) {
+      return NULL;
+    }
+    if (g_Pool == NULL) {
+      g_Pool = new WorkerPool(g_NumThreads);
+    }
+    if (!g_Pool->m_Owner.try_lock()) {
+      return NULL;
+    }
+    return g_Pool;
+  }
+
+  void releasePool(WorkerPool *pool)
+  {
+    pool->m_Owner.unlock();
+  }
+
+} // namespace
+
+#endif
+
+// ------------------------------------------------------
+
+uint NAMESPACE::numThreads()
+{
+#ifdef LIBSL_PARALLEL_THREADS
+  std::lock_guard<std::mutex> lock(g_PoolLock);
+  if (g_NumThreads == 0) {
+    g_NumThreads = defaultNumThreads();
+  }
+  return g_NumThreads;
+#else
+  return 1;
+#endif
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::setNumThreads(uint n)
+{
+#ifdef LIBSL_PARALLEL_THREADS
+  WorkerPool *old = NULL;
+  {
+    std::lock_guard<std::mutex> lock(g_PoolLock);
+    old          = g_Pool;
+    g_Pool       = NULL;
+    g_NumThreads = (n == 0) ? defaultNumThreads() : n;
+  }
+  if (old != NULL) {
+    // wait for any running loop to terminate
+    old->m_Owner.lock();
+    old->m_Owner.unlock();
+    delete (old);
+  }
+#endif
+}
+
+// ------------------------------------------------------
+
+uint NAMESPACE::workerId()
+{
+#ifdef LIBSL_PARALLEL_THREADS
+  return t_WorkerId;
+#else
+  return 0;
+#endif
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::forChunks(int begin,int end,const std::function<void(int,int)>& f,int grain)
+{
+  if (end <= begin) {
+    return;
+  }
+  grain = std::max(grain,1);
+#ifdef LIBSL_PARALLEL_THREADS
+  long long num = (long long)end - (long long)begin;
+  if (num > grain) {
+    WorkerPool *pool = acquirePool();
+    if (pool != NULL) {
+      // a few chunks per thread for load balancing
+      long long chunk = std::max((long long)grain, num / (long long)(pool->size() * 4));
+      std::atomic<long long> next(begin);
+      std::function<void(uint)> job = [&](uint) {
+        while (true) {
+          long long first = next.fetch_add(chunk);
+          if (first >= end) {
+            break;
+          }
+          f(int(first), int(std::min((long long)end, first + chunk)));
+        }
+      };
+      try {
+        pool->run(job);
+      } catch (...) {
+        releasePool(pool);
+        throw;
+      }
+      releasePool(pool);
+      return;
+    }
+  }
+#endif
+  f(begin,end);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::forEachWorker(const std::function<void(uint)>& f)
+{
+#ifdef LIBSL_PARALLEL_THREADS
+  WorkerPool *pool = acquirePool();
+  if (pool != NULL) {
+    try {
+      pool->run(f);
+    } catch (...) {
+      releasePool(pool);
+      throw;
+    }
+    releasePool(pool);
+    return;
+  }
+  // serial: call once per worker slot
+  uint n    = numThreads();
+  uint prev = t_WorkerId;
+  bool in   = t_InLoop;
+  t_InLoop  = true;
+  for (uint w = 0; w < n; w++) {
+    t_WorkerId = w;
+    try {
+      f(w);
+    } catch (...) {
+      t_WorkerId = prev;
+      t_InLoop   = in;
+      throw;
+    }
+  }
+  t_WorkerId = prev;
+  t_InLoop   = in;
+#else
+  f(0);
+#endif
+}
+
+// ------------------------------------------------------
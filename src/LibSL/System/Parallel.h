@@ -0,0 +1,95 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::System::Parallel
+// ------------------------------------------------------
+//
+// Minimal worker pool and parallel loops
+//
+// A single pool of worker threads is shared by the whole
+// library. Loops started from within a worker, or while
+// another thread owns the pool, run serially on the caller.
+// Without C++11 support everything runs serially.
+//
+// The number of threads defaults to the hardware concurrency
+// and can be set with the LIBSL_NUM_THREADS environment
+// variable or setNumThreads().
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/LibSL.common.h>
+#include <LibSL/System/Types.h>
+
+#include <functional>
+
+// ------------------------------------------------------
+
+namespace LibSL  {
+  namespace System {
+    namespace Parallel {
+
+      //! number of threads used by parallel loops (including the caller)
+      LIBSL_DLL uint numThreads();
+      //! set the number of threads, 1 disables parallelism, 0 restores the default
+      LIBSL_DLL void setNumThreads(uint n);
+      //! index of the calling thread within the running loop, in [0,numThreads()[
+      LIBSL_DLL uint workerId();
+
+      //! calls f(first,last) on contiguous chunks [first,last[ covering [begin,end[
+      //! chunks are never smaller than grain (but for the last one)
+      LIBSL_DLL void forChunks(int begin,int end,const std::function<void(int,int)>& f,int grain = 1);
+
+      //! calls f(worker) once on every thread of the pool, worker in [0,numThreads()[
+      LIBSL_DLL void forEachWorker(const std::function<void(uint)>& f);
+
+      //! calls f(i) for all i in [begin,end[
+      template <typename T_Func>
+      void forIndex(int begin,int end,const T_Func& f,int grain = 1)
+      {
+        forChunks(begin,end,[&f](int first,int last) {
+          for (int i = first ; i < last ; i++) { f(i); }
+        },grain);
+      }
+
+    } //namespace LibSL::System::Parallel
+  } //namespace LibSL::System
+} //namespace LibSL
+
+// ------------------------------------------------------
@@ -0,0 +1,581 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::System::Profiling
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+#include "LibSL.precompiled.h"
+// ------------------------------------------------------
+
+#include <LibSL/Errors/Errors.h>
+#include <LibSL/CppHelpers/CppHelpers.h>
+
+#include <LibSL/System/Profiling.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <iomanip>
+
+#if defined(USE_CXX11) || defined(USE_CXX14) || defined(USE_CXX17)
+#define LIBSL_PROFILING_THREADS
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#else
+#pragma message ("Profiling compiled without multithread support")
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+// ------------------------------------------------------
+
+#define NAMESPACE LibSL::System::Profiling
+
+using namespace LibSL::Errors;
+
+// ------------------------------------------------------
+
+#ifdef LIBSL_PROFILING_THREADS
+
+namespace {
+
+  const uint   c_RingSize   = 1 << 14; // measures per thread between two drains
+  const uint   c_SampleSize = 4096;    // measures kept per call path, for percentiles
+  const size_t c_TraceMax   = 1 << 21; // measures kept in the trace
+
+  struct Measure
+  {
+    uint      path;
+    long long begin;
+    long long end;
+  };
+
+  //! single producer (the owning thread), single consumer (under the registry lock)
+  struct ThreadBuffer
+  {
+    uint                                          tid;
+    std::vector<Measure>                          ring;
+    std::atomic<unsigned long long>               head;
+    std::atomic<unsigned long long>               tail;
+    // only accessed by the owning thread
+    std::vector<uint>                             stack;
+    std::vector<long long>                        stackBegin;
+    std::unordered_map<unsigned long long,uint>   paths;
+    unsigned long long                            lastKey;  // most recent lookup
+    uint                                          lastPath;
+  };
+
+  //! node of the call path tree
+  struct PathStats
+  {
+    NAMESPACE::t_Zone   zone;
+    uint                parent;
+    long long           count;
+    long long           total;
+    long long           min;
+    long long           max;
+    std::vector<float>  sample;
+    unsigned long long  rng;
+  };
+
+  struct TraceMeasure
+  {
+    uint      path;
+    uint      tid;
+    long long begin;
+    long long end;
+  };
+
+  // ------------------------------------------------------
+
+  class Registry
+  {
+  public:
+
+    std::mutex                                    lock;
+    std::atomic<bool>                             enabled;
+    std::chrono::steady_clock::time_point         epoch;
+    std::vector<std::string>                      zoneNames;
+    std::map<std::string,NAMESPACE::t_Zone>       zoneIds;
+    std::vector<PathStats>                        paths;
+    std::map<unsigned long long,uint>             pathIds;
+    std::vector<ThreadBuffer*>                    threads;
+    uint                                          nextTid;
+    std::vector<TraceMeasure>                     trace;
+    long long                                     traceDropped;
+
+    Registry() : nextTid(0), traceDropped(0)
+    {
+      epoch = std::chrono::steady_clock::now();
+      const char *env = getenv("LIBSL_PROFILE");
+      enabled = !(env != NULL && std::string(env) == "0");
+      // root of the call path tree
+      PathStats root;
+      root.zone   = uint(-1);
+      root.parent = uint(-1);
+      paths.push_back(root);
+      resetLocked();
+    }
+
+    void resetLocked()
+    {
+      for (size_t i = 0 ; i < paths.size() ; i++) {
+        PathStats& p = paths[i];
+        p.count = 0;
+        p.total = 0;
+        p.min   = 0;
+        p.max   = 0;
+        p.rng   = 0x9E3779B97F4A7C15ull + i;
+        p.sample.clear();
+      }
+      trace.clear();
+      traceDropped = 0;
+    }
+
+    uint pathLocked(uint parent,NAMESPACE::t_Zone z)
+    {
+      unsigned long long key = (static_cast<unsigned long long>(parent) << 32) | z;
+      std::map<unsigned long long,uint>::const_iterator P = pathIds.find(key);
+      if (P != pathIds.end()) {
+        return P->second;
+      }
+      uint id = uint(paths.size());
+      PathStats p;
+      p.zone   = z;
+      p.parent = parent;
+      p.count  = p.total = p.min = p.max = 0;
+      p.rng    = 0x9E3779B97F4A7C15ull + id;
+      paths.push_back(p);
+      pathIds[key] = id;
+      return id;
+    }
+
+    void accumulateLocked(const Measure& m,uint tid)
+    {
+      PathStats& p = paths[m.path];
+      long long  d = m.end - m.begin;
+      if (p.count == 0) {
+        p.min = p.max = d;
+      } else {
+        p.min = std::min(p.min, d);
+        p.max = std::max(p.max, d);
+      }
+      p.count ++;
+      p.total += d;
+      // reservoir sampling
+      if (p.sample.size() < c_SampleSize) {
+        p.sample.push_back(float(d));
+      } else {
+        p.rng ^= p.rng << 13; p.rng ^= p.rng >> 7; p.rng ^= p.rng << 17;
+        unsigned long long r = p.rng % static_cast<unsigned long long>(p.count);
+        if (r < c_SampleSize) {
+          p.sample[size_t(r)] = float(d);
+        }
+      }
+      if (trace.size() < c_TraceMax) {
+        TraceMeasure t;
+        t.path  = m.path;
+        t.tid   = tid;
+        t.begin = m.begin;
+        t.end   = m.end;
+        trace.push_back(t);
+      } else {
+        traceDropped ++;
+      }
+    }
+
+    void drainLocked(ThreadBuffer *b)
+    {
+      unsigned long long t = b->tail.load(std::memory_order_relaxed);
+      unsigned long long h = b->head.load(std::memory_order_acquire);
+      for ( ; t < h ; t++) {
+        accumulateLocked(b->ring[size_t(t % c_RingSize)], b->tid);
+      }
+      b->tail.store(h, std::memory_order_release);
+    }
+
+  };
+
+  Registry& registry()
+  {
+    // never destroyed, threads may still report during exit
+    static Registry *r = new Registry();
+    return *r;
+  }
+
+  // ------------------------------------------------------
+
+  //! unregisters the buffer of a thread when it exits
+  class ThreadBufferOwner
+  {
+  public:
+    ThreadBuffer *buffer;
+    ThreadBufferOwner() : buffer(NULL) { }
+    ~ThreadBufferOwner()
+    {
+      if (buffer == NULL) {
+        return;
+      }
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.lock);
+      r.drainLocked(buffer);
+      r.threads.erase(std::find(r.threads.begin(), r.threads.end(), buffer));
+      delete (buffer);
+    }
+  };
+
+  thread_local ThreadBufferOwner t_Owner;
+
+  ThreadBuffer *threadBuffer()
+  {
+    ThreadBuffer *b = t_Owner.buffer;
+    if (b == NULL) {
+      b = new ThreadBuffer();
+      b->ring.resize(c_RingSize);
+      b->head     = 0;
+      b->tail     = 0;
+      b->lastKey  = ~0ull;
+      b->lastPath = 0;
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.lock);
+      b->tid = r.nextTid ++;
+      r.threads.push_back(b);
+      t_Owner.buffer = b;
+    }
+    return b;
+  }
+
+  uint childPath(ThreadBuffer *b,NAMESPACE::t_Zone z)
+  {
+    uint parent = b->stack.empty() ? 0 : b->stack.back();
+    unsigned long long key = (static_cast<unsigned long long>(parent) << 32) | z;
+    if (key == b->lastKey) {
+      return b->lastPath;
+    }
+    std::unordered_map<unsigned long long,uint>::const_iterator P = b->paths.find(key);
+    if (P != b->paths.end()) {
+      b->lastKey  = key;
+      b->lastPath = P->second;
+      return P->second;
+    }
+    Registry& r = registry();
+    uint id;
+    {
+      std::lock_guard<std::mutex> lock(r.lock);
+      id = r.pathLocked(parent, z);
+    }
+    b->paths[key] = id;
+    return id;
+  }
+
+  void push(ThreadBuffer *b,uint path,long long beginNs,long long endNs)
+  {
+    unsigned long long h = b->head.load(std::memory_order_relaxed);
+    if (h - b->tail.load(std::memory_order_acquire) >= c_RingSize) {
+      // full, drain it ourselves
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.lock);
+      r.drainLocked(b);
+    }
+    Measure& m = b->ring[size_t(h % c_RingSize)];
+    m.path     = path;
+    m.begin    = beginNs;
+    m.end      = endNs;
+    b->head.store(h + 1, std::memory_order_release);
+  }
+
+  double percentile(std::vector<float> sample,double q)
+  {
+    if (sample.empty()) {
+      return 0;
+    }
+    size_t k = std::min(sample.size() - 1, size_t(q * double(sample.size() - 1) + 0.5));
+    std::nth_element(sample.begin(), sample.begin() + k, sample.end());
+    return sample[k];
+  }
+
+  void writeJsonString(FILE *f,const std::string& s)
+  {
+    fputc('"', f);
+    for (size_t i = 0 ; i < s.size() ; i++) {
+      unsigned char c = s[i];
+      if (c == '"' || c == '\\') {
+        fputc('\\', f);
+        fputc(c, f);
+      } else if (c < 0x20) {
+        fprintf(f, "\\u%04x", c);
+      } else {
+        fputc(c, f);
+      }
+    }
+    fputc('"', f);
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+NAMESPACE::t_Zone NAMESPACE::zone(const char *name)
+{
+  Registry& r = registry();
+  std::string n(name != NULL ? name : "");
+  std::lock_guard<std::mutex> lock(r.lock);
+  std::map<std::string,t_Zone>::const_iterator Z = r.zoneIds.find(n);
+  if (Z != r.zoneIds.end()) {
+    return Z->second;
+  }
+  t_Zone z = t_Zone(r.zoneNames.size());
+  r.zoneNames.push_back(n);
+  r.zoneIds[n] = z;
+  return z;
+}
+
+// ------------------------------------------------------
+
+long long NAMESPACE::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+// ------------------------------------------------------
+
+bool NAMESPACE::enabled()
+{
+  return registry().enabled.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::setEnabled(bool e)
+{
+  registry().enabled = e;
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::begin(t_Zone z)
+{
+  ThreadBuffer *b = threadBuffer();
+  uint path       = childPath(b, z);
+  b->stack.push_back(path);
+  b->stackBegin.push_back(now());
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::end()
+{
+  long long     tm = now();
+  ThreadBuffer *b  = threadBuffer();
+  sl_assert(!b->stack.empty());
+  push(b, b->stack.back(), b->stackBegin.back(), tm);
+  b->stack.pop_back();
+  b->stackBegin.pop_back();
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::record(t_Zone z,long long beginNs,long long endNs)
+{
+  if (!enabled()) {
+    return;
+  }
+  ThreadBuffer *b = threadBuffer();
+  push(b, childPath(b, z), beginNs, endNs);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::flush()
+{
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.lock);
+  for (size_t t = 0 ; t < r.threads.size() ; t++) {
+    r.drainLocked(r.threads[t]);
+  }
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::statistics(std::vector<ZoneStats>& _stats)
+{
+  flush();
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.lock);
+  _stats.clear();
+  // children lists
+  std::vector<std::vector<uint> > children(r.paths.size());
+  for (uint p = 1 ; p < uint(r.paths.size()) ; p++) {
+    children[r.paths[p].parent].push_back(p);
+  }
+  // depth-first traversal, skipping paths never measured
+  std::vector<std::pair<uint,uint> > todo; // path, depth
+  std::vector<std::string>           prefix(r.paths.size());
+  for (size_t c = children[0].size() ; c > 0 ; c--) {
+    todo.push_back(std::make_pair(children[0][c - 1], 0u));
+  }
+  while (!todo.empty()) {
+    uint p     = todo.back().first;
+    uint depth = todo.back().second;
+    todo.pop_back();
+    const PathStats& s = r.paths[p];
+    const std::string& name = r.zoneNames[s.zone];
+    prefix[p] = (s.parent == 0) ? name : prefix[s.parent] + "/" + name;
+    if (s.count > 0) {
+      ZoneStats z;
+      z.name  = name;
+      z.path  = prefix[p];
+      z.depth = depth;
+      z.count = s.count;
+      z.total = double(s.total) * 1e-6;
+      z.min   = double(s.min)   * 1e-6;
+      z.max   = double(s.max)   * 1e-6;
+      z.p99   = percentile(s.sample, 0.99) * 1e-6;
+      _stats.push_back(z);
+    }
+    for (size_t c = children[p].size() ; c > 0 ; c--) {
+      todo.push_back(std::make_pair(children[p][c - 1], depth + 1));
+    }
+  }
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::saveChromeTrace(const char *fname)
+{
+  flush();
+  Registry& r = registry();
+  FILE *f = NULL;
+  fopen_s(&f, fname, "wb");
+  if (f == NULL) {
+    throw Fatal("[Profiling::saveChromeTrace] - cannot open file '%s'", fname);
+  }
+  std::lock_guard<std::mutex> lock(r.lock);
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (size_t i = 0 ; i < r.trace.size() ; i++) {
+    const TraceMeasure& m = r.trace[i];
+    fprintf(f, "{\"name\":");
+    writeJsonString(f, r.zoneNames[r.paths[m.path].zone]);
+    fprintf(f, ",\"cat\":\"LibSL\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}%s\n",
+      double(m.begin) * 1e-3, double(m.end - m.begin) * 1e-3, m.tid,
+      (i + 1 < r.trace.size()) ? "," : "");
+  }
+  fprintf(f, "],\"otherData\":{\"dropped\":%lld}}\n", r.traceDropped);
+  fclose(f);
+}
+
+// ------------------------------------------------------
+
+void NAMESPACE::reset()
+{
+  flush();
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.lock);
+  r.resetLocked();
+}
+
+// ------------------------------------------------------
+
+#else // no threads: profiling is disabled
+
+NAMESPACE::t_Zone NAMESPACE::zone(const char *)                 { return 0; }
+bool              NAMESPACE::enabled()                          { return false; }
+void              NAMESPACE::setEnabled(bool)                   { }
+void              NAMESPACE::begin(t_Zone)                      { }
+void              NAMESPACE::end()                              { }
+void              NAMESPACE::record(t_Zone,long long,long long) { }
+void              NAMESPACE::flush()                            { }
+void              NAMESPACE::statistics(std::vector<ZoneStats>& _stats) { _stats.clear(); }
+void              NAMESPACE::saveChromeTrace(const char *)      { }
+void              NAMESPACE::reset()                            { }
+
+// ------------------------------------------------------
+
+// zones are not recorded, but the clock is still needed by timers
+long long NAMESPACE::now()
+{
+#if defined(_WIN32) || defined(_WIN64)
+  static LARGE_INTEGER freq = { 0 };
+  if (freq.QuadPart == 0) {
+    QueryPerformanceFrequency(&freq);
+  }
+  LARGE_INTEGER c;
+  QueryPerformanceCounter(&c);
+  // split to avoid overflowing the product
+  return (c.QuadPart / freq.QuadPart) * 1000000000LL + (c.QuadPart % freq.QuadPart) * 1000000000LL / freq.QuadPart;
+#elif defined(__APPLE__)
+  static mach_timebase_info_data_t tb = { 0, 0 };
+  if (tb.denom == 0) {
+    mach_timebase_info(&tb);
+  }
+  return (long long)(mach_absolute_time() * tb.numer / tb.denom);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (long long)ts.tv_sec * 1000000000LL + (long long)ts.tv_nsec;
+#endif
+}
+
+#endif
+
+// ------------------------------------------------------
+
+void NAMESPACE::report(std::ostream& out)
+{
+  std::vector<ZoneStats> stats;
+  statistics(stats);
+  out << LibSL::CppHelpers::sprint("%-40s %10s %12s %10s %10s %10s %10s\n",
+    "zone", "count", "total ms", "mean ms", "min ms", "max ms", "p99 ms");
+  for (size_t i = 0 ; i < stats.size() ; i++) {
+    const ZoneStats& z = stats[i];
+    std::string name   = std::string(2 * z.depth, ' ') + z.name;
+    out << LibSL::CppHelpers::sprint("%-40s %10lld %12.3f %10.3f %10.3f %10.3f %10.3f\n",
+      name.c_str(), z.count, z.total, z.total / double(z.count), z.min, z.max, z.p99);
+  }
+}
+
+// ------------------------------------------------------
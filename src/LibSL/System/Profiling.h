@@ -0,0 +1,149 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// LibSL::System::Profiling
+// ------------------------------------------------------
+//
+// Headless CPU profiling
+//
+// Zones are named code regions, timed with scopes:
+//
+//   void smooth() {
+//     LIBSL_PROFILE_SCOPE("smooth");
+//     ...
+//   }
+//
+// Each thread appends its measures to its own ring buffer,
+// without locking. Buffers are drained when full and on
+// flush(). Measures are aggregated per call path (count,
+// total, min, max, 99th percentile) and kept as a trace
+// that can be saved in the Chrome trace format (to be
+// opened in chrome://tracing or Perfetto).
+//
+// Time::Timer, Time::Timings and the GPUHelpers::Profiler
+// timers report their measures as zones.
+//
+// Profiling is enabled by default, it can be disabled
+// with setEnabled() or the LIBSL_PROFILE=0 environment
+// variable.
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/LibSL.common.h>
+#include <LibSL/System/Types.h>
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+// ------------------------------------------------------
+
+namespace LibSL  {
+  namespace System {
+    namespace Profiling {
+
+      typedef uint t_Zone;
+
+      //! returns the zone of a given name, created on first call
+      LIBSL_DLL t_Zone    zone(const char *name);
+
+      //! current time in nanoseconds (monotonic clock)
+      LIBSL_DLL long long now();
+
+      LIBSL_DLL bool      enabled();
+      LIBSL_DLL void      setEnabled(bool e);
+
+      //! opens a zone on the calling thread, must be balanced by end()
+      LIBSL_DLL void      begin(t_Zone z);
+      //! closes the last zone opened on the calling thread
+      LIBSL_DLL void      end();
+      //! records a measure taken elsewhere, as a child of the currently opened zone
+      LIBSL_DLL void      record(t_Zone z,long long beginNs,long long endNs);
+
+      //! times its lifetime
+      class Scope
+      {
+      protected:
+        bool m_Active;
+      public:
+        Scope(t_Zone z) : m_Active(enabled()) { if (m_Active) { begin(z); } }
+        ~Scope()                               { if (m_Active) { end();    } }
+      };
+
+      //! statistics of a call path, times in milliseconds
+      class ZoneStats
+      {
+      public:
+        std::string name;
+        std::string path;  //!< zone names from the root, separated by '/'
+        uint        depth;
+        long long   count;
+        double      total;
+        double      min;
+        double      max;
+        double      p99;   //!< estimated from a sample of the measures
+      };
+
+      //! drains the buffers of all threads
+      LIBSL_DLL void      flush();
+      //! statistics of all call paths, in depth-first order
+      LIBSL_DLL void      statistics(std::vector<ZoneStats>& _stats);
+      //! prints statistics as an indented table
+      LIBSL_DLL void      report(std::ostream& out = std::cerr);
+      //! saves the recorded trace in the Chrome trace event format (json)
+      LIBSL_DLL void      saveChromeTrace(const char *fname);
+      //! clears statistics and trace (zones and call paths are kept)
+      LIBSL_DLL void      reset();
+
+    } //namespace LibSL::System::Profiling
+  } //namespace LibSL::System
+} //namespace LibSL
+
+// ------------------------------------------------------
+
+#define LIBSL_PROFILE_CAT_(A,B) A##B
+#define LIBSL_PROFILE_CAT(A,B)  LIBSL_PROFILE_CAT_(A,B)
+
+//! times the enclosing scope, name must be a constant string
+#define LIBSL_PROFILE_SCOPE(name) \
+  static const LibSL::System::Profiling::t_Zone LIBSL_PROFILE_CAT(__libsl_zone_,__LINE__) = LibSL::System::Profiling::zone(name); \
+  LibSL::System::Profiling::Scope LIBSL_PROFILE_CAT(__libsl_scope_,__LINE__)(LIBSL_PROFILE_CAT(__libsl_zone_,__LINE__));
+
+// ------------------------------------------------------
@@ -41,6 +41,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 #include <LibSL/CppHelpers/CppHelpers.h>
 
 #include <LibSL/System/System.h>
+#include <LibSL/System/Profiling.h>
 
 // ------------------------------------------------------
 
@@ -59,6 +60,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 # include <fcntl.h>
 # include <dirent.h>
 # include <unistd.h>
+# include <sys/mman.h>
 #endif
 
 // ------------------------------------------------------
@@ -93,13 +95,19 @@ bool NAMESPACE::File::exists(const char *fname)
 
 // ------------------------------------------------------
 
-long NAMESPACE::File::size(const char *path)
+long long NAMESPACE::File::size(const char *path)
 {
   FILE *f = NULL;
 	fopen_s(&f, path, "rb");
   sl_assert(f != NULL);
-  fseek(f,0,SEEK_END);
-  long fsize = ftell(f);
+  // 64 bits offsets, long is 32 bits on Windows
+#if defined(_WIN32) || defined(_WIN64)
+  _fseeki64(f,0,SEEK_END);
+  long long fsize = _ftelli64(f);
+#else
+  fseeko(f,0,SEEK_END);
+  long long fsize = (long long)ftello(f);
+#endif
   fclose(f);
   return fsize;
 }
@@ -259,6 +267,75 @@ NAMESPACE::File::t_FileTime NAMESPACE::File::timestamp(const char *path)
 
 // ------------------------------------------------------
 
+bool NAMESPACE::File::replace(const char *src,const char *dst)
+{
+#if defined(_WIN32) || defined(_WIN64)
+  // succeeds over a file mapped by MappedFile (opened with FILE_SHARE_DELETE)
+  return MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  // atomic, processes mapping dst keep the old file
+  return rename(src, dst) == 0;
+#endif
+}
+
+// ------------------------------------------------------
+
+NAMESPACE::File::MappedFile::MappedFile(const char *path) : m_Data(NULL), m_Size(0), m_Handle(NULL)
+{
+#if defined(_WIN32) || defined(_WIN64)
+  // share delete: the file may be replaced while mapped, see File::replace
+  HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (f == INVALID_HANDLE_VALUE) {
+    throw LibSL::Errors::Fatal("[MappedFile] - cannot open '%s'", path);
+  }
+  LARGE_INTEGER sz;
+  GetFileSizeEx(f, &sz);
+  m_Size = size_t(sz.QuadPart);
+  if (m_Size > 0) {
+    HANDLE mapping = CreateFileMappingA(f, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (mapping != NULL) {
+      m_Data   = (unsigned char*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+      m_Handle = mapping;
+    }
+  }
+  CloseHandle(f);
+  if (m_Size > 0 && m_Data == NULL) {
+    if (m_Handle != NULL) CloseHandle((HANDLE)m_Handle);
+    throw LibSL::Errors::Fatal("[MappedFile] - cannot map '%s'", path);
+  }
+#else
+  int fh = open(path, O_RDONLY);
+  if (fh < 0) {
+    throw LibSL::Errors::Fatal("[MappedFile] - cannot open '%s'", path);
+  }
+  struct stat st;
+  fstat(fh, &st);
+  m_Size = size_t(st.st_size);
+  if (m_Size > 0) {
+    void *ptr = mmap(NULL, m_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fh, 0);
+    m_Data    = ptr == MAP_FAILED ? NULL : (unsigned char*)ptr;
+  }
+  close(fh);
+  if (m_Size > 0 && m_Data == NULL) {
+    throw LibSL::Errors::Fatal("[MappedFile] - cannot map '%s'", path);
+  }
+#endif
+}
+
+// ------------------------------------------------------
+
+NAMESPACE::File::MappedFile::~MappedFile()
+{
+#if defined(_WIN32) || defined(_WIN64)
+  if (m_Data   != NULL) UnmapViewOfFile(m_Data);
+  if (m_Handle != NULL) CloseHandle((HANDLE)m_Handle);
+#else
+  if (m_Data != NULL) munmap(m_Data, m_Size);
+#endif
+}
+
+// ------------------------------------------------------
+
 bool operator<(const NAMESPACE::File::t_FileTime& a, const NAMESPACE::File::t_FileTime& b)
 {
   return a.dwHighDateTime < b.dwHighDateTime || (a.dwHighDateTime == b.dwHighDateTime && a.dwLowDateTime < b.dwLowDateTime);
@@ -483,6 +560,8 @@ NAMESPACE::Time::Timer::Timer(const char *name, bool autostart)
 {
   m_Name    = name;
   m_TmAccum = 0;
+  m_Zone    = 0;
+  m_HasZone = false;
   m_Active = false;
   if (autostart) {
     start();
@@ -501,8 +580,9 @@ NAMESPACE::Time::Timer::~Timer()
 
 void NAMESPACE::Time::Timer::start()
 {
-  m_TmStart = milliseconds();
-  m_Active  = true;
+  m_TmStart    = milliseconds();
+  m_TraceStart = Profiling::now();
+  m_Active     = true;
 }
 
 // ------------------------------------------------------
@@ -526,6 +606,13 @@ NAMESPACE::Time::t_time NAMESPACE::Time::Timer::stop()
     t_time tm = elapsed();
     m_TmAccum += tm;
     m_Active = false;
+    if (Profiling::enabled()) {
+      if (!m_HasZone) {
+        m_Zone    = Profiling::zone(m_Name ? m_Name : "[Timer] ");
+        m_HasZone = true;
+      }
+      Profiling::record(m_Zone, m_TraceStart, Profiling::now());
+    }
     return (tm);
   } else {
     return (0);
@@ -545,13 +632,27 @@ NAMESPACE::Time::t_time NAMESPACE::Time::Timer::elapsed()
 
 NAMESPACE::Time::Timings::Timings(const char *name)
 {
-  m_Name    = name;
-  m_TmStart = milliseconds();
-  m_TmLast  = m_TmStart;
+  m_Name      = name;
+  m_TmStart   = milliseconds();
+  m_TmLast    = m_TmStart;
+  m_TraceLast = Profiling::now();
 }
 
 // ------------------------------------------------------
 
+uint NAMESPACE::Time::Timings::zoneOf(const char *name)
+{
+  // few distinct names per object, compared by content as they may be temporary strings
+  ForIndex(z, m_Zones.size()) {
+    if (m_Zones[z].first == name) {
+      return m_Zones[z].second;
+    }
+  }
+  m_Zones.push_back(std::make_pair(std::string(name), uint(Profiling::zone(name))));
+  return m_Zones.back().second;
+}
+
+// ------------------------------------------------------
 
 NAMESPACE::Time::t_time NAMESPACE::Time::Timings::measure(const char *name)
 {
@@ -563,6 +664,12 @@ NAMESPACE::Time::t_time NAMESPACE::Time::Timings::measure(const char *name)
   t_time ms  = tm % 1000;
   std::cerr << LibSL::CppHelpers::sprint("%s:(%s) %2d hours %2d min %2ds %4d ms (+ %4d ms)\n",m_Name,name,(int)h,(int)m,(int)s,(int)ms,uint(now - m_TmLast));
   m_TmLast = now;
+  // reports the time since the last measure
+  long long trace = Profiling::now();
+  if (Profiling::enabled()) {
+    Profiling::record(zoneOf(name), m_TraceLast, trace);
+  }
+  m_TraceLast = trace;
   return tm;
 }
 
@@ -49,6 +49,8 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include <cstdio>
 #include <vector>
+#include <string>
+#include <utility>
 
 #include <LibSL/LibSL.common.h>
 
@@ -78,12 +80,31 @@ namespace LibSL  {
       LIBSL_DLL void __fopen_s(FILE **pf,const char *path, const char *mode);
 
       LIBSL_DLL bool        exists         (const char *path);
-      LIBSL_DLL long        size           (const char *path);
+      LIBSL_DLL long long   size           (const char *path);
       LIBSL_DLL void        listFiles      (const char *path,std::vector<std::string>&);
       LIBSL_DLL void        listDirectories(const char *path,std::vector<std::string>&);
       LIBSL_DLL void        createDirectory(const char *path);
       LIBSL_DLL const char *adaptPath      (const char *path);
       LIBSL_DLL t_FileTime  timestamp      (const char *path);
+      //! moves src over dst in one step, an existing dst is replaced (false on failure)
+      LIBSL_DLL bool        replace        (const char *src,const char *dst);
+
+      //! whole file mapped in memory, pages are copy-on-write:
+      //! writes stay private to the process and never reach the file
+      class LIBSL_DLL MappedFile
+      {
+      protected:
+        unsigned char *m_Data;
+        size_t         m_Size;
+        void          *m_Handle;
+      public:
+        //! throws Fatal if the file cannot be mapped
+        MappedFile(const char *path);
+        ~MappedFile();
+        unsigned char       *data()       { return m_Data; }
+        const unsigned char *data() const { return m_Data; }
+        size_t               size() const { return m_Size; }
+      };
 
 
     } //namespace LibSL::System::File
@@ -102,6 +123,9 @@ namespace LibSL  {
         const char *m_Name;
         t_time      m_TmStart;
         t_time      m_TmAccum;
+        long long   m_TraceStart;
+        uint        m_Zone;      // profiling zone (Profiling::t_Zone), resolved on first use
+        bool        m_HasZone;
         bool        m_Active;
         void   display();
       public:
@@ -150,6 +174,9 @@ namespace LibSL  {
         const char *m_Name;
         t_time      m_TmStart;
         t_time      m_TmLast;
+        long long   m_TraceLast;
+        std::vector<std::pair<std::string,uint> > m_Zones; // profiling zones of the measure names
+        uint   zoneOf(const char *name);
       public:
         Timings(const char *name="[Timings] ");
         ~Timings() {}
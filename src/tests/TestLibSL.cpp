@@ -68,6 +68,29 @@ int main(int argc, char* argv[])
     if (0) LIBSL_CATCH_ANY(test_contour(););
     */
     if (1) LIBSL_CATCH_ANY(test_memory(););
+    if (1) LIBSL_CATCH_ANY(test_half(););
+    if (1) LIBSL_CATCH_ANY(test_bcn(););
+    if (1) LIBSL_CATCH_ANY(test_triangulation(););
+    if (1) LIBSL_CATCH_ANY(test_simplification(););
+    if (1) LIBSL_CATCH_ANY(test_vertexcache(););
+    if (1) LIBSL_CATCH_ANY(test_meshlets(););
+    if (1) LIBSL_CATCH_ANY(test_graph(););
+    if (1) LIBSL_CATCH_ANY(test_components(););
+    if (1) LIBSL_CATCH_ANY(test_morpho(););
+    if (1) LIBSL_CATCH_ANY(test_resize(););
+    if (1) LIBSL_CATCH_ANY(test_imageformats(););
+    if (1) LIBSL_CATCH_ANY(test_lineartree(););
+    if (1) LIBSL_CATCH_ANY(test_statichierarchy(););
+    if (1) LIBSL_CATCH_ANY(test_occupancymap(););
+    if (1) LIBSL_CATCH_ANY(test_progress(););
+    if (1) LIBSL_CATCH_ANY(test_profiling(););
+    if (1) LIBSL_CATCH_ANY(test_convexhull(););
+    if (1) LIBSL_CATCH_ANY(test_implicitshape(););
+    if (1) LIBSL_CATCH_ANY(test_slicing(););
+    if (1) LIBSL_CATCH_ANY(test_meshformat(););
+    if (1) LIBSL_CATCH_ANY(test_meshnormals(););
+    if (1) LIBSL_CATCH_ANY(test_meshviews(););
+    if (1) LIBSL_CATCH_ANY(test_meshsoup(););
 
   } catch (LibSL::Errors::Fatal& err) {
     cerr << Console::red;
@@ -49,5 +49,27 @@ void test_brush();
 void test_hermitcurve();
 void test_bezierpatch();
 void test_graph();
+void test_half();
+void test_bcn();
+void test_triangulation();
+void test_simplification();
+void test_vertexcache();
+void test_meshlets();
+void test_components();
+void test_morpho();
+void test_resize();
+void test_imageformats();
+void test_lineartree();
+void test_statichierarchy();
+void test_occupancymap();
+void test_progress();
+void test_profiling();
+void test_convexhull();
+void test_implicitshape();
+void test_slicing();
+void test_meshformat();
+void test_meshnormals();
+void test_meshviews();
+void test_meshsoup();
 void test_mesh();
 void test_contour();
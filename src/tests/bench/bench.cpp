@@ -0,0 +1,182 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - harness and entry point
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <LibSL/System/Parallel.h>
+#include <LibSL/System/Profiling.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+LIBSL_FILE_FORMATS
+
+// ------------------------------------------------------
+
+namespace {
+
+  double median(std::vector<double> v)
+  {
+    sl_assert(!v.empty());
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return (n & 1) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+Bench::Harness& Bench::harness()
+{
+  static Harness h;
+  return h;
+}
+
+// ------------------------------------------------------
+
+bool Bench::Harness::selected(const std::string& name) const
+{
+  return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+// ------------------------------------------------------
+
+void Bench::Harness::run(const std::string& name,const std::function<void()>& f,
+                         double items,const std::function<void()>& setup)
+{
+  if (!selected(name)) {
+    return;
+  }
+  ForIndex(w, warmup) {
+    if (setup) { setup(); }
+    f();
+  }
+  std::vector<double> times;
+  ForIndex(r, std::max(1u, repetitions)) {
+    if (setup) { setup(); }
+    // timed directly, independently of the profiler configuration
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    f();
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double,std::milli>(t1 - t0).count());
+  }
+  Result res;
+  res.name        = name;
+  res.repetitions = uint(times.size());
+  res.median      = median(times);
+  res.min         = *std::min_element(times.begin(), times.end());
+  std::vector<double> dev(times.size());
+  ForIndex(i, times.size()) {
+    dev[i] = fabs(times[i] - res.median);
+  }
+  res.mad         = median(dev);
+  res.items       = items;
+  results.push_back(res);
+  cout << LibSL::CppHelpers::sprint("%-44s %10.3f ms  +- %8.3f  (min %10.3f)", name.c_str(), res.median, res.mad, res.min);
+  if (items > 0 && res.median > 0) {
+    cout << LibSL::CppHelpers::sprint("  %10.2f Mitems/s", items / (res.median * 1e3));
+  }
+  cout << endl;
+}
+
+// ------------------------------------------------------
+
+void Bench::Harness::saveJSON(const char *fname) const
+{
+  FILE *f = NULL;
+  fopen_s(&f, fname, "wb");
+  if (f == NULL) {
+    throw LibSL::Errors::Fatal("libsl_bench - cannot write '%s'", fname);
+  }
+  fprintf(f, "{\n  \"threads\": %u,\n  \"warmup\": %u,\n  \"quick\": %s,\n  \"results\": [\n",
+    LibSL::System::Parallel::numThreads(), warmup, quick ? "true" : "false");
+  ForIndex(i, results.size()) {
+    const Result& r = results[i];
+    fprintf(f, "    {\"name\": \"%s\", \"repetitions\": %u, \"median_ms\": %.6f, \"mad_ms\": %.6f, \"min_ms\": %.6f, \"items\": %.0f}%s\n",
+      r.name.c_str(), r.repetitions, r.median, r.mad, r.min, r.items, (i + 1 < int(results.size())) ? "," : "");
+  }
+  fprintf(f, "  ]\n}\n");
+  fclose(f);
+}
+
+// ------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  Bench::Harness& h = Bench::harness();
+  for (int a = 1; a < argc; a++) {
+    if      (!strcmp(argv[a], "-filter") && a + 1 < argc) { h.filter      = argv[++a]; }
+    else if (!strcmp(argv[a], "-reps")   && a + 1 < argc) { h.repetitions = uint(atoi(argv[++a])); }
+    else if (!strcmp(argv[a], "-warmup") && a + 1 < argc) { h.warmup      = uint(atoi(argv[++a])); }
+    else if (!strcmp(argv[a], "-json")   && a + 1 < argc) { h.json        = argv[++a]; }
+    else if (!strcmp(argv[a], "-quick"))                  { h.quick       = true; }
+    else {
+      cerr << "usage: " << argv[0] << " [-filter <substr>] [-reps <n>] [-warmup <n>] [-json <file>] [-quick]" << endl;
+      return -1;
+    }
+  }
+  // benchmarks time themselves, keep instrumentation out of the way
+  LibSL::System::Profiling::setEnabled(false);
+  LibSL::CppHelpers::Console::progressSetMode(LibSL::CppHelpers::Console::ProgressSilent);
+  try {
+    bench_memory();
+    bench_image();
+    bench_mesh();
+    bench_geometry();
+    bench_math();
+    bench_datastructures();
+    if (!h.json.empty()) {
+      h.saveJSON(h.json.c_str());
+    }
+  } catch (LibSL::Errors::Fatal& err) {
+    cerr << "libsl_bench - " << err.message() << endl;
+    return -1;
+  }
+  return 0;
+}
+
+// ------------------------------------------------------
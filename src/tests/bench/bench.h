@@ -0,0 +1,132 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench
+// ------------------------------------------------------
+//
+// Micro-benchmarks of LibSL hot paths
+//
+// Each benchmark runs a few warmup iterations, then a
+// number of timed repetitions. The median and the median
+// absolute deviation (MAD) are reported, robust to the
+// occasional outlier. Inputs are synthetic and seeded so
+// that runs can be compared between releases.
+//
+// Usage: libsl_bench [-filter <substr>] [-reps <n>] [-warmup <n>]
+//                    [-json <file>] [-quick]
+//
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#pragma once
+
+#include <LibSL/LibSL.h>
+
+#include <string>
+#include <vector>
+#include <functional>
+
+// ------------------------------------------------------
+
+namespace Bench {
+
+  class Result
+  {
+  public:
+    std::string name;
+    uint        repetitions;
+    double      median;   // ms
+    double      mad;      // ms
+    double      min;      // ms
+    double      items;    // items processed per repetition (0 if not meaningful)
+  };
+
+  class Harness
+  {
+  public:
+    uint                warmup;
+    uint                repetitions;
+    std::string         filter;
+    std::string         json;
+    bool                quick;     // smaller inputs, for smoke testing
+    std::vector<Result> results;
+
+    Harness() : warmup(1), repetitions(7), quick(false) { }
+
+    //! true if a benchmark of this name is to be run
+    bool selected(const std::string& name) const;
+    //! times f, setup is called before each repetition but not timed
+    void run(const std::string& name,const std::function<void()>& f,
+             double items = 0,const std::function<void()>& setup = std::function<void()>());
+    void saveJSON(const char *fname) const;
+  };
+
+  Harness& harness();
+
+  //! scales an input size down in quick mode
+  inline uint size(uint n) { return harness().quick ? LibSL::Math::max(1u,n / 4) : n; }
+
+  //! deterministic pseudo-random numbers
+  class Random
+  {
+  protected:
+    unsigned long long m_State;
+  public:
+    Random(unsigned long long seed = 42) : m_State(seed * 2654435761ull + 1) { }
+    uint  next()   { m_State ^= m_State << 13; m_State ^= m_State >> 7; m_State ^= m_State << 17; return uint(m_State >> 16); }
+    float unit()   { return float(next() & 0xFFFFFF) / float(0x1000000); }
+  };
+
+  //! deterministic torus with nu x nv quads (2 x nu x nv triangles),
+  //! vertices in the MeshFormat_OBJ vertex format
+  LibSL::Mesh::TriangleMesh *syntheticTorus(uint nu,uint nv);
+
+  //! prevents the compiler from optimizing away a result
+  template <typename T> void keep(const T& v) { static volatile T s_Sink; s_Sink = v; (void)s_Sink; }
+
+} // namespace Bench
+
+// ------------------------------------------------------
+
+void bench_memory();
+void bench_image();
+void bench_mesh();
+void bench_geometry();
+void bench_math();
+void bench_datastructures();
+
+// ------------------------------------------------------
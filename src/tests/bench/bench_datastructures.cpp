@@ -0,0 +1,211 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - Caches, graphs and hierarchies
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <LibSL/Memory/Cache.h>
+#include <LibSL/DataStructures/Graph.h>
+#include <LibSL/DataStructures/GraphAlgorithms.h>
+#include <LibSL/DataStructures/CompactGraphAlgorithms.h>
+#include <LibSL/DataStructures/Hierarchy.h>
+#include <LibSL/Math/Matrix4x4.h>
+#include <LibSL/Math/Quaternion.h>
+
+using namespace LibSL::Memory;
+using namespace LibSL::Memory::Array;
+using namespace LibSL::DataStructures;
+using namespace LibSL::Math;
+
+// ------------------------------------------------------
+
+namespace {
+
+  class EdgeData
+  {
+  public:
+    float m_Cost;
+    EdgeData()        { m_Cost = 1.0f; }
+    EdgeData(float c) { m_Cost = c; }
+  };
+
+  class NodeData { };
+
+  typedef Graph<NodeData,EdgeData,true> t_Graph;
+
+  class EdgeCost
+  {
+  public:
+    float operator()(const t_Graph& graph,t_NodeId,t_EdgeId edge) const
+    {
+      return graph.edges()[edge].data().m_Cost;
+    }
+  };
+
+  //! 4-connected grid with random costs and a few walls
+  void gridGraph(uint n,t_Graph& _g)
+  {
+    Bench::Random rnd(13);
+    ForIndex(i,n*n) {
+      _g.addNode(NodeData());
+    }
+    ForIndex(j,n) {
+      ForIndex(i,n) {
+        bool wall = (i % 64 == 32) && (j % 64 != 0);
+        if (wall) continue;
+        if (i + 1 < int(n)) {
+          float c = 1.0f + rnd.unit();
+          _g.addEdge(i + j * n,(i + 1) + j * n,EdgeData(c));
+          _g.addEdge((i + 1) + j * n,i + j * n,EdgeData(c));
+        }
+        if (j + 1 < int(n)) {
+          float c = 1.0f + rnd.unit();
+          _g.addEdge(i + j * n,i + (j + 1) * n,EdgeData(c));
+          _g.addEdge(i + (j + 1) * n,i + j * n,EdgeData(c));
+        }
+      }
+    }
+  }
+
+  typedef Hierarchy<m4x4f> t_TransformHierarchy;
+
+  //! random hierarchy of local transforms, every node is attached to a random previous one
+  t_TransformHierarchy::t_Pointer transformHierarchy(uint numNodes)
+  {
+    Bench::Random rnd(42);
+    std::vector<t_TransformHierarchy::t_Pointer> nodes;
+    nodes.push_back(t_TransformHierarchy::t_Pointer(new t_TransformHierarchy(m4x4f::identity())));
+    for (uint i = 1 ; i < numNodes ; i++) {
+      m4x4f local = translationMatrix(V3F(float(rnd.next() % 10),0,0)) * quatf(V3F(0,0,1),float(rnd.next() % 100) / 100.0f).toMatrix();
+      nodes.push_back(nodes[rnd.next() % nodes.size()]->addChild(local));
+    }
+    return nodes[0];
+  }
+
+  void propagateTransforms(t_TransformHierarchy::t_Pointer h,const m4x4f& parent,std::vector<m4x4f>& _global)
+  {
+    _global.push_back(parent * h->data());
+    m4x4f g = _global.back();
+    for (t_TransformHierarchy::ChildrenIterator I = h->children() ; !I.end() ; I.next()) {
+      propagateTransforms(I.current(),g,_global);
+    }
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void bench_datastructures()
+{
+  Bench::Harness& h = Bench::harness();
+
+  // LRU cache, skewed access pattern
+  {
+    const uint NQ = Bench::size(1 << 20);
+    std::vector<uint> keys(NQ);
+    Bench::Random rnd(17);
+    ForIndex(q,NQ) {
+      // product of uniforms favors small keys
+      keys[q] = uint(65536.0f * rnd.unit() * rnd.unit());
+    }
+    h.run("datastructures/lrucache", [&] {
+      LRUCache<uint,uint> cache(4096);
+      uint *v = NULL;
+      ForIndex(q,NQ) {
+        if (!cache.contains(keys[q],v)) {
+          cache.add(keys[q],keys[q]);
+        }
+      }
+    }, double(NQ));
+  }
+
+  // shortest paths on a grid
+  {
+    const uint N = Bench::size(512);
+    t_Graph g;
+    gridGraph(N,g);
+    std::vector<v2i> path;
+    GraphAlgorithms::ShortestPaths<t_Graph,EdgeCost> sp;
+    h.run("datastructures/graph/dijkstraToTarget", [&] {
+      path.clear();
+      Bench::keep(sp.dijkstraToTarget<GraphAlgorithms::TargetStopCondition<t_Graph> >(g,0,int(N * N - 1),path));
+    }, double(N) * N);
+    CompactGraph cg;
+    cg.build(g,EdgeCost());
+    GraphAlgorithms::CompactShortestPaths csp;
+    std::vector<t_NodeId> sources;
+    sources.push_back(0);
+    sources.push_back(N * N - 1);
+    LibSL::Memory::Array::Array<float> dist;
+    LibSL::Memory::Array::Array<v2i>   prev;
+    h.run("datastructures/compactgraph/dijkstraToTarget", [&] {
+      path.clear();
+      Bench::keep(csp.dijkstraToTarget(cg,0,int(N * N - 1),path));
+    }, double(N) * N);
+    h.run("datastructures/compactgraph/dijkstraFromSources", [&] { csp.dijkstraFromSources(cg,sources,dist,prev); }, double(N) * N);
+    h.run("datastructures/compactgraph/deltaStepping",       [&] { csp.deltaStepping      (cg,sources,dist,prev); }, double(N) * N);
+  }
+
+  // local to global transforms, pointer hierarchy against the static layouts
+  {
+    const uint N = Bench::size(1 << 20);
+    t_TransformHierarchy::t_Pointer root = transformHierarchy(N);
+    std::vector<m4x4f> global;
+    global.reserve(N);
+    h.run("datastructures/hierarchy/propagate", [&] {
+      global.clear();
+      propagateTransforms(root,m4x4f::identity(),global);
+      Bench::keep(global.back().at(0,3));
+    }, double(N));
+    StaticHierarchy<m4x4f> df(root,StaticHierarchy<m4x4f>::DepthFirst);
+    StaticHierarchy<m4x4f> bf(root,StaticHierarchy<m4x4f>::BreadthFirst);
+    std::vector<m4x4f> sglobal;
+    h.run("datastructures/statichierarchy/propagate/depthFirst", [&] {
+      df.propagate(sglobal,[](const m4x4f& g,const m4x4f& local) { return g * local; });
+      Bench::keep(sglobal.back().at(0,3));
+    }, double(N));
+    h.run("datastructures/statichierarchy/propagate/breadthFirst", [&] {
+      bf.propagate(sglobal,[](const m4x4f& g,const m4x4f& local) { return g * local; });
+      Bench::keep(sglobal.back().at(0,3));
+    }, double(N));
+  }
+}
+
+// ------------------------------------------------------
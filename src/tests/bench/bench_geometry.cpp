@@ -0,0 +1,172 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - Iso-surfaces and voxelization
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <LibSL/Geometry/ConvexHull.h>
+#include <LibSL/Geometry/ImplicitShape.h>
+#include <LibSL/Geometry/MarchingCubes.h>
+#include <LibSL/Geometry/Triangulation.h>
+#include <LibSL/Geometry/Voxelizer.h>
+
+#include <cmath>
+
+using namespace LibSL::Geometry;
+using namespace LibSL::Mesh;
+using namespace LibSL::Math;
+
+// ------------------------------------------------------
+
+namespace {
+
+  /// keeps voxels along the surface only
+  class SurfaceVoxel : public Voxel
+  {
+  public:
+    bool shouldSubdivide()            { return !m_Triangles.empty(); }
+    bool shouldDeleteAfterSubdivide() { return true; }
+    bool shouldKeepChild()            { return !m_Triangles.empty(); }
+  };
+
+  /// bumpy sphere, a distance up to the bumps
+  class BumpySphere : public ImplicitShape::ImplicitFunction
+  {
+  public:
+    float operator()(const v3f& p) const { return length(p - v3f(0.5f)) + 0.01f * sinf(40.0f * p[0]); }
+    float lipschitz()              const { return 1.4f; }
+    bool  threadSafe()             const { return true; }
+  };
+
+} // namespace
+
+// ------------------------------------------------------
+
+void bench_geometry()
+{
+  Bench::Harness& h = Bench::harness();
+
+  // marching cubes on a few blended spheres
+  {
+    const int N = int(Bench::size(128));
+    MarchingCubes::MarchingCubes mc;
+    mc.set_resolution(N,N,N);
+    mc.init_all();
+    Bench::Random rnd(5);
+    v3f   ctr[8];
+    ForIndex(s,8) { ctr[s] = V3F(rnd.unit(),rnd.unit(),rnd.unit()) * 0.6f + V3F(0.2f,0.2f,0.2f); }
+    ForIndex(k,N) {
+      ForIndex(j,N) {
+        ForIndex(i,N) {
+          v3f p = V3F(float(i),float(j),float(k)) / float(N - 1);
+          float f = 0;
+          ForIndex(s,8) { f += 0.01f / (sqLength(p - ctr[s]) + 1e-4f); }
+          mc.set_data(f - 1.0f,i,j,k);
+        }
+      }
+    }
+    h.run("geometry/marchingcubes", [&] { mc.run(0.0f); Bench::keep(mc.ntrigs()); }, double(N) * N * N, [&] { mc.restart(); });
+    mc.clean_temps();
+    mc.clean_all();
+  }
+
+  // implicit surface, blocks away from the surface are pruned
+  {
+    const int N = int(Bench::size(512));
+    BumpySphere f;
+    h.run("geometry/implicitshape", [&] {
+      ImplicitShape shape(f,N);
+      TriangleMesh_Ptr m(shape.generateShape(0.35f));
+      Bench::keep(m->numTriangles());
+    }, double(N) * N * N);
+  }
+
+  // voxelization of a torus
+  {
+    TriangleMesh_Ptr mesh(Bench::syntheticTorus(Bench::size(256),Bench::size(128)));
+    Voxelizer<SurfaceVoxel,false> voxelizer;
+    const uint res = Bench::size(128);
+    h.run("geometry/voxelizer", [&] {
+      Voxelizer<SurfaceVoxel,false>::t_Voxelization voxels;
+      voxelizer.voxelize(mesh,8,res,true,voxels);
+      Bench::keep(uint(voxels.back().size()));
+    }, double(mesh->numTriangles()));
+  }
+
+  // batch of small convex hulls (convex decomposition parts)
+  {
+    const uint NH = Bench::size(2000);
+    Bench::Random rnd;
+    std::vector< std::vector<v3d> > parts(NH);
+    ForIndex(i,NH) {
+      parts[i].resize(32 + rnd.next() % 224);
+      ForIndex(p,parts[i].size()) {
+        parts[i][p] = v3d(rnd.unit(),rnd.unit(),rnd.unit());
+      }
+    }
+    std::vector< ConvexHullEngine<3> > hulls;
+    h.run("geometry/convexhull/batch", [&] { Bench::keep(computeHulls<3>(parts,hulls)); }, double(NH));
+  }
+
+  // wavy disk with a grid of holes
+  {
+    const uint NV = Bench::size(20000);
+    std::vector<std::vector<v2d> > rings(1);
+    ForIndex(i,NV) {
+      double t = 2.0 * M_PI * i / NV;
+      double r = 100.0 + 5.0 * sin(37.0 * t);
+      rings[0].push_back(v2d(r * cos(t),r * sin(t)));
+    }
+    ForIndex(hy,5) {
+      ForIndex(hx,10) {
+        std::vector<v2d> hole;
+        ForIndex(i,40) {
+          double t = 2.0 * M_PI * i / 40.0;
+          hole.push_back(v2d(-60.0 + hx * 13.0 + 4.0 * cos(t),-30.0 + hy * 13.0 + 4.0 * sin(t)));
+        }
+        rings.push_back(hole);
+      }
+    }
+    std::vector<v3u> tris;
+    h.run("geometry/triangulate/polygon_holes", [&] { Triangulation::triangulate(rings,tris); Bench::keep(uint(tris.size())); }, double(NV));
+  }
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,128 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - Image filters, resampling, distance fields
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <LibSL/Image/Filter.h>
+#include <LibSL/Image/Resize.h>
+#include <LibSL/Image/DistanceField.h>
+#include <LibSL/Image/BCn.h>
+
+#include <cmath>
+
+using namespace LibSL::Image;
+using namespace LibSL::Math;
+using namespace LibSL::Memory::Array;
+
+// ------------------------------------------------------
+
+namespace {
+
+  //! smooth pattern with some noise, resembles natural images
+  ImageRGBA *syntheticImage(uint w,uint h)
+  {
+    Bench::Random rnd(7);
+    ImageRGBA *img = new ImageRGBA(w,h);
+    ForImage(img,i,j) {
+      float u = float(i) / float(w), v = float(j) / float(h);
+      img->pixel(i,j)[0] = uchar(LibSL::Math::clamp(128.0f + 100.0f * sinf(u * 17.0f + v * 3.0f) + float(rnd.next() % 16),0.0f,255.0f));
+      img->pixel(i,j)[1] = uchar(LibSL::Math::clamp(128.0f + 100.0f * cosf(v * 11.0f)           + float(rnd.next() % 16),0.0f,255.0f));
+      img->pixel(i,j)[2] = uchar((i ^ j) & 255);
+      img->pixel(i,j)[3] = uchar(255 * u);
+    }
+    return img;
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+void bench_image()
+{
+  Bench::Harness& h = Bench::harness();
+
+  const uint N = Bench::size(1024);
+
+  ImageRGBA_Ptr img(syntheticImage(N,N));
+
+  // separable filters
+  {
+    Array2D<float> src(N,N), dst;
+    ForImage(img,i,j) { src.at(i,j) = float(img->pixel(i,j)[0]); }
+    LibSL::Filter::GaussianFilter2D<Array2D<float>,9> gauss;
+    LibSL::Filter::BoxFilter2D<Array2D<float>,5>      box;
+    h.run("image/filter/gaussian9", [&] { gauss.filter(src,dst); }, double(N) * N);
+    h.run("image/filter/box5",      [&] { box  .filter(src,dst); }, double(N) * N);
+  }
+
+  // resampling
+  {
+    h.run("image/resize/lanczos3_half",  [&] { ImageRGBA_Ptr r(resize(img.raw(),N/2,N/2,ResizeLanczos3)); }, double(N) * N);
+    h.run("image/resize/lanczos3_x1.5",  [&] { ImageRGBA_Ptr r(resize(img.raw(),N*3/2,N*3/2,ResizeLanczos3)); }, double(N) * N * 9 / 4);
+    h.run("image/resize/box_quarter",    [&] { ImageRGBA_Ptr r(resize(img.raw(),N/4,N/4,ResizeBox)); }, double(N) * N);
+    h.run("image/resize/lanczos3_srgb",  [&] { ImageRGBA_Ptr r(resize(img.raw(),N/2,N/2,ResizeLanczos3,true)); }, double(N) * N);
+  }
+
+  // distance field, from sparse seeds
+  {
+    Array2D<v2i> dist(N,N);
+    auto setup = [&] {
+      Bench::Random rnd(3);
+      const int far = 1 << 14;
+      dist.fill(V2I(far,far));
+      ForIndex(s,256) {
+        dist.at(rnd.next() % N, rnd.next() % N) = V2I(0,0);
+      }
+    };
+    h.run("image/distancefield/euclidean", [&] { computeEuclidianDistanceField(dist); }, double(N) * N, setup);
+  }
+
+  // block compression
+  {
+    std::vector<uchar> blocks(bcnSurfaceBytes(BC3,N,N));
+    h.run("image/bcn/bc1_normal", [&] { encodeBCn(BC1,img->raw(),N,N,&blocks[0],BCnNormal); }, double(N) * N);
+    h.run("image/bcn/bc3_fast",   [&] { encodeBCn(BC3,img->raw(),N,N,&blocks[0],BCnFast);   }, double(N) * N);
+    std::vector<uchar> pixels(size_t(N) * N * 4);
+    h.run("image/bcn/bc1_decode", [&] { decodeBCn(BC1,&blocks[0],N,N,&pixels[0]); }, double(N) * N);
+  }
+}
+
+// ------------------------------------------------------
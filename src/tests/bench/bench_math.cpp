@@ -0,0 +1,72 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - Clustering
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <LibSL/Math/LloydClustering.h>
+
+using namespace LibSL::Math;
+
+// ------------------------------------------------------
+
+void bench_math()
+{
+  Bench::Harness& h = Bench::harness();
+
+  // points around a few anisotropic blobs
+  const uint N = Bench::size(20000);
+  std::vector<Tuple<float,3> > samples(N);
+  Bench::Random rnd(9);
+  ForIndex(i,N) {
+    uint  blob = rnd.next() % 12;
+    float s    = 0.05f + 0.01f * float(blob);
+    samples[i] = V3F(float(blob % 3),float(blob / 3),float(blob % 5)) + V3F(rnd.unit(),rnd.unit() * 2.0f,rnd.unit()) * s;
+  }
+
+  h.run("math/lloyd/16clusters", [&] {
+    LloydClustering<Tuple<float,3> > clustering;
+    ForIndex(i,N) { clustering.addSample(samples[i]); }
+    clustering.computeForNumClusters(16);
+    Bench::keep(clustering.numClusters());
+  }, double(N));
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,141 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - Memory::Array access policies
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <vector>
+
+using namespace LibSL::Memory::Array;
+
+// ------------------------------------------------------
+
+namespace {
+
+  template <class T_Array>
+  int stencil1D(T_Array& data,int n,int steps)
+  {
+    for (int s = 0; s < steps; s++) {
+      for (int i = 1; i <= n; i++) {
+        data[i] = (data[i-1] + data[i+1]) / 2;
+      }
+    }
+    return data[n / 2];
+  }
+
+  template <class T_Array2D>
+  int stencil2D(T_Array2D& data,int n,int steps)
+  {
+    for (int s = 0; s < steps; s++) {
+      for (int j = 1; j <= n; j++) {
+        for (int i = 1; i <= n; i++) {
+          data.set(i,j) = (data.get(i-1,j) + data.get(i+1,j) + data.get(i,j-1) + data.get(i,j+1)) / 4;
+        }
+      }
+    }
+    return data.get(n / 2, n / 2);
+  }
+
+  template <class T_Array>
+  void fill1D(T_Array& data,int n)
+  {
+    Bench::Random rnd;
+    for (int i = 0; i < n + 2; i++) {
+      data[i] = int(rnd.next() & 0xFFFF);
+    }
+  }
+
+  template <class T_Array2D>
+  void fill2D(T_Array2D& data,int n)
+  {
+    Bench::Random rnd;
+    for (int j = 0; j < n + 2; j++) {
+      for (int i = 0; i < n + 2; i++) {
+        data.set(i,j) = int(rnd.next() & 0xFFFF);
+      }
+    }
+  }
+
+  /// 2D access on a plain vector, as reference
+  class Raw2D
+  {
+  public:
+    std::vector<int> m_Data;
+    int              m_W;
+    Raw2D(int w,int h) : m_Data(size_t(w) * h), m_W(w) { }
+    int&       set(int i,int j)       { return m_Data[i + j * m_W]; }
+    const int& get(int i,int j) const { return m_Data[i + j * m_W]; }
+  };
+
+} // namespace
+
+// ------------------------------------------------------
+
+void bench_memory()
+{
+  Bench::Harness& h = Bench::harness();
+
+  const int N1     = 4096;
+  const int STEPS1 = int(Bench::size(2000));
+  const int N2     = int(Bench::size(512));
+  const int STEPS2 = 20;
+
+  {
+    std::vector<int> data(N1 + 2);
+    h.run("memory/stencil1D/raw",           [&] { Bench::keep(stencil1D(data, N1, STEPS1)); }, double(N1) * STEPS1, [&] { fill1D(data, N1); });
+  } {
+    LibSL::Memory::Array::Array<int, InitNop, LibSL::Memory::Array::CheckNop> data(N1 + 2);
+    h.run("memory/stencil1D/Array_CheckNop", [&] { Bench::keep(stencil1D(data, N1, STEPS1)); }, double(N1) * STEPS1, [&] { fill1D(data, N1); });
+  } {
+    LibSL::Memory::Array::Array<int, InitNop, CheckAll> data(N1 + 2);
+    h.run("memory/stencil1D/Array_CheckAll", [&] { Bench::keep(stencil1D(data, N1, STEPS1)); }, double(N1) * STEPS1, [&] { fill1D(data, N1); });
+  } {
+    Raw2D data(N2 + 2, N2 + 2);
+    h.run("memory/stencil2D/raw",             [&] { Bench::keep(stencil2D(data, N2, STEPS2)); }, double(N2) * N2 * STEPS2, [&] { fill2D(data, N2); });
+  } {
+    Array2D<int, InitNop, LibSL::Memory::Array::CheckNop> data(N2 + 2, N2 + 2);
+    h.run("memory/stencil2D/Array2D_CheckNop", [&] { Bench::keep(stencil2D(data, N2, STEPS2)); }, double(N2) * N2 * STEPS2, [&] { fill2D(data, N2); });
+  } {
+    Array2D<int, InitNop, CheckAll> data(N2 + 2, N2 + 2);
+    h.run("memory/stencil2D/Array2D_CheckAll", [&] { Bench::keep(stencil2D(data, N2, STEPS2)); }, double(N2) * N2 * STEPS2, [&] { fill2D(data, N2); });
+  }
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,255 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// ------------------------------------------------------
+// libsl_bench - Mesh loading and processing
+// ------------------------------------------------------
+// Sylvain Lefebvre - 2026-10-19
+// ------------------------------------------------------
+
+#include "bench.h"
+
+#include <LibSL/Mesh/MeshEditing.h>
+#include <LibSL/Mesh/MeshFormat_mesh.h>
+#include <LibSL/Mesh/MeshletSet.h>
+#include <LibSL/Mesh/MeshNormals.h>
+#include <LibSL/Mesh/MeshOutOfCore.h>
+#include <LibSL/Mesh/MeshSimplification.h>
+
+#include <cstdio>
+#include <cmath>
+
+using namespace LibSL::Mesh;
+using namespace LibSL::Math;
+using namespace LibSL::Memory::Pointer;
+
+// ------------------------------------------------------
+
+namespace {
+
+  /// vertex with a tangent frame, tangents in texcoord1
+  typedef struct {
+    v3f pos;
+    v3f nrm;
+    v2f uv;
+    v4f tan;
+  } t_TangentVertex;
+
+  typedef MVF4(mvf_position_3f,mvf_normal_3f,mvf_texcoord0_2f,mvf_texcoord1_4f) t_TangentFormat;
+
+  template <class T_VertexData,class T_VertexFormat>
+  TriangleMesh_generic<T_VertexData> *torus(uint nu,uint nv)
+  {
+    TriangleMesh_generic<T_VertexData> *mesh = new TriangleMesh_generic<T_VertexData>(
+      nu * nv, 2 * nu * nv, 0, AutoPtr<MVF>(MVF::make<T_VertexFormat>()));
+    Bench::Random rnd(11);
+    ForIndex(j,nv) {
+      ForIndex(i,nu) {
+        float u = float(i) * 2.0f * float(M_PI) / float(nu);
+        float v = float(j) * 2.0f * float(M_PI) / float(nv);
+        // small deterministic bumps, avoids a perfectly regular input
+        float r = 0.3f + 0.01f * rnd.unit();
+        T_VertexData& d = mesh->vertexAt(i + j * nu);
+        d.nrm = 0;
+        d.uv  = 0;
+        d.pos = V3F((1.0f + r * cosf(v)) * cosf(u),(1.0f + r * cosf(v)) * sinf(u),r * sinf(v));
+      }
+    }
+    ForIndex(j,nv) {
+      ForIndex(i,nu) {
+        uint a = i + j * nu;
+        uint b = (i + 1) % nu + j * nu;
+        uint c = (i + 1) % nu + ((j + 1) % nv) * nu;
+        uint d = i + ((j + 1) % nv) * nu;
+        mesh->triangleAt(2 * a    ) = V3U(a,b,c);
+        mesh->triangleAt(2 * a + 1) = V3U(a,c,d);
+      }
+    }
+    return mesh;
+  }
+
+} // namespace
+
+// ------------------------------------------------------
+
+TriangleMesh *Bench::syntheticTorus(uint nu,uint nv)
+{
+  return torus<MeshFormat_OBJ::t_VertexData,MeshFormat_OBJ::t_VertexFormat>(nu,nv);
+}
+
+// ------------------------------------------------------
+
+void bench_mesh()
+{
+  Bench::Harness& h = Bench::harness();
+
+  const uint NU = Bench::size(512), NV = Bench::size(256);
+
+  TriangleMesh_Ptr mesh(Bench::syntheticTorus(NU,NV));
+  const double ntris = double(mesh->numTriangles());
+
+  // loading, per format
+  {
+    // (ply is write-only in MeshFormat_ply)
+    const char *formats[] = { "mesh", "obj", "stl", "off" };
+    ForIndex(f,sizeof(formats) / sizeof(formats[0])) {
+      std::string fname = std::string("libsl_bench_tmp.") + formats[f];
+      std::string name  = std::string("mesh/load/") + formats[f];
+      if (!h.selected(name)) {
+        continue;
+      }
+      saveTriangleMesh(fname.c_str(),mesh.raw());
+      h.run(name, [&] { TriangleMesh_Ptr m(loadTriangleMesh(fname.c_str())); }, ntris);
+      remove(fname.c_str());
+    }
+    // .mesh with deflated sections, decoded in parallel
+    if (h.selected("mesh/load/mesh_deflate")) {
+      MeshFormat_mesh::t_SaveOptions options;
+      options.compress = true;
+      MeshFormat_mesh::save("libsl_bench_tmp.mesh",mesh.raw(),options);
+      h.run("mesh/load/mesh_deflate", [&] { TriangleMesh_Ptr m(loadTriangleMesh("libsl_bench_tmp.mesh")); }, ntris);
+      remove("libsl_bench_tmp.mesh");
+    }
+  }
+
+  // vertex welding
+  {
+    TriangleMesh_Ptr split(mesh->splitTriangles());
+    TriangleMesh_Ptr work;
+    auto setup = [&] { work = TriangleMesh_Ptr(split->clone()); };
+    h.run("mesh/mergeVertices",      [&] { work->mergeVertices(1e-6f); }, ntris, setup);
+    h.run("mesh/mergeVerticesExact", [&] { work->mergeVerticesExact();  }, ntris, setup);
+  }
+
+  // misc. operators
+  {
+    h.run("mesh/clone",        [&] { TriangleMesh_Ptr c(mesh->clone()); }, ntris);
+    h.run("mesh/computeBBox",  [&] { Bench::keep(mesh->computeBBox().minCorner()[0]); }, double(mesh->numVertices()));
+    m4x4f rot = quatf(V3F(0,0,1),0.1f).toMatrix();
+    h.run("mesh/applyTransform", [&] { mesh->applyTransform(rot); }, double(mesh->numVertices()));
+  }
+
+  // index buffer optimization, from a shuffled triangle order
+  {
+    TriangleMesh_Ptr work;
+    auto shuffled = [&] {
+      work = TriangleMesh_Ptr(mesh->clone());
+      Bench::Random rnd(3);
+      for (uint t = work->numTriangles() - 1 ; t > 0 ; t--) {
+        std::swap(work->triangleAt(t),work->triangleAt(rnd.next() % (t + 1)));
+      }
+    };
+    h.run("mesh/optimizeVertexCache", [&] { work->optimizeVertexCache(); }, ntris, shuffled);
+    h.run("mesh/optimizeOverdraw",    [&] { work->optimizeOverdraw();    }, ntris, [&] { shuffled(); work->optimizeVertexCache(); });
+    h.run("mesh/optimizeVertexFetch", [&] { work->optimizeVertexFetch(); }, ntris, [&] { shuffled(); work->optimizeVertexCache(); });
+  }
+
+  // slicing by 256 planes across the torus thickness
+  {
+    std::vector<float> offsets;
+    ForIndex(k,256) { offsets.push_back(-0.3f + 0.6f * (k + 0.5f) / 256.0f); }
+    std::vector<std::vector<MeshEditing::t_Contour> > contours;
+    std::vector<TriangleMesh_Ptr>                     slabs;
+    h.run("mesh/slice/contours", [&] { MeshEditing::sliceMesh(mesh.raw(),V3F(0,0,1),offsets,contours);        Bench::keep(uint(contours.size())); }, ntris);
+    h.run("mesh/slice/slabs",    [&] { MeshEditing::sliceMesh(mesh.raw(),V3F(0,0,1),offsets,contours,&slabs); Bench::keep(uint(slabs.size()));    }, ntris);
+  }
+
+  // meshlets
+  {
+    MeshletSet meshlets;
+    h.run("mesh/meshlets", [&] { meshlets.build(mesh.raw()); Bench::keep(meshlets.numMeshlets()); }, ntris);
+  }
+
+  // quadric simplification to 5% of the input
+  {
+    MeshSimplification::Params params;
+    params.targetTriangles = mesh->numTriangles() / 20;
+    h.run("mesh/simplify", [&] { TriangleMesh_Ptr s(MeshSimplification::simplify(mesh.raw(),params)); Bench::keep(s->numTriangles()); }, ntris);
+  }
+
+  // vertex normals and tangents on a 20M triangles torus
+  if (h.selected("mesh/normals/area") || h.selected("mesh/normals/angle") || h.selected("mesh/tangents")) {
+    const uint BU = Bench::size(4096), BV = Bench::size(2560);
+    AutoPtr<TriangleMesh_generic<t_TangentVertex> > big(torus<t_TangentVertex,t_TangentFormat>(BU,BV));
+    ForIndex(j,BV) {
+      ForIndex(i,BU) {
+        big->vertexAt(i + j * BU).uv  = V2F(float(i) * 8.0f / float(BU),float(j) * 2.0f / float(BV));
+        big->vertexAt(i + j * BU).tan = 0;
+      }
+    }
+    const double nbig = double(big->numTriangles());
+    h.run("mesh/normals/area",  [&] { MeshNormals::computeNormals(big.raw(),MeshNormals::Area);  }, nbig);
+    h.run("mesh/normals/angle", [&] { MeshNormals::computeNormals(big.raw(),MeshNormals::Angle); }, nbig);
+    h.run("mesh/tangents",      [&] { MeshNormals::computeTangents(big.raw());                   }, nbig);
+  }
+
+  // streaming triangle soups, per format
+  {
+    const char *formats[] = { "mesh", "obj", "stl", "ply" };
+    ForIndex(f,sizeof(formats) / sizeof(formats[0])) {
+      std::string fname = std::string("libsl_bench_tmp.") + formats[f];
+      std::string name  = std::string("mesh/soup/") + formats[f];
+      if (!h.selected(name)) {
+        continue;
+      }
+      saveTriangleMesh(fname.c_str(),mesh.raw());
+      h.run(name, [&] {
+        TriangleSoupReader_Ptr soup(openTriangleSoup(fname.c_str()));
+        std::vector<v3f> corners;
+        uint n = 0;
+        while (uint read = soup->read(corners,1u << 16)) { n += read; }
+        Bench::keep(n);
+      }, ntris);
+      remove(fname.c_str());
+    }
+  }
+
+  // out-of-core weld and simplification, budget of about 16 tiles
+  if (h.selected("mesh/outofcore")) {
+    saveTriangleMesh("libsl_bench_tmp.stl",mesh.raw());
+    MeshOutOfCore::Params params;
+    params.memoryBudget  = size_t(mesh->numTriangles() / 16) * 512;
+    params.simplifyRatio = 0.25f;
+    h.run("mesh/outofcore", [&] {
+      std::vector<std::string> outputs;
+      MeshOutOfCore::process("libsl_bench_tmp.stl","libsl_bench_tmp_ooc",params,&outputs);
+      ForIndex(o,outputs.size()) { remove(outputs[o].c_str()); }
+      Bench::keep(uint(outputs.size()));
+    }, ntris);
+    remove("libsl_bench_tmp.stl");
+  }
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,173 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Image/BCn.h>
+#include <LibSL/Image/ImageFormat_dds.h>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+using namespace std;
+
+// -----------
+
+// smooth ramps with a few sharp edges, size not a multiple of 4
+static void makePixels(uint w,uint h,uint nc,vector<uchar>& _px)
+{
+  _px.resize(size_t(w) * h * nc);
+  ForIndex(j,h) {
+    ForIndex(i,w) {
+      ForIndex(c,nc) {
+        float v = 127.5f + 100.0f * sinf(float(i) * (0.05f + 0.02f * c) + float(j) * 0.03f);
+        if (((i / 16) + (j / 16) + c) % 5 == 0) {
+          v = 255.0f - v;
+        }
+        _px[(size_t(j) * w + i) * nc + c] = uchar(v);
+      }
+    }
+  }
+}
+
+static double rmse(const vector<uchar>& a,const vector<uchar>& b)
+{
+  sl_assert(a.size() == b.size());
+  double err = 0.0;
+  ForIndex(i,a.size()) {
+    double d = double(a[i]) - double(b[i]);
+    err += d * d;
+  }
+  return sqrt(err / double(a.size()));
+}
+
+// -----------
+
+static void checkCodec()
+{
+  const uint        w = 70, h = 37;
+  const e_BCnFormat formats[4]  = { BC1, BC3, BC4, BC5 };
+  const char       *names[4]    = { "BC1", "BC3", "BC4", "BC5" };
+  // bounds on the rmse for the fast / normal / high qualities
+  const double      bounds[4][3] = { { 5.5, 3.0, 3.0 }, { 5.5, 3.0, 3.0 }, { 1.0, 1.0, 1.0 }, { 1.2, 1.2, 1.0 } };
+  const e_BCnQuality qualities[3] = { BCnFast, BCnNormal, BCnHigh };
+  ForIndex(f,4) {
+    uint          nc = bcnNumComp(formats[f]);
+    vector<uchar> src;
+    makePixels(w,h,nc,src);
+    if (formats[f] == BC1) {
+      // opaque
+      ForIndex(p,w*h) { src[p * 4 + 3] = 255; }
+    }
+    double prev = 1e30;
+    ForIndex(q,3) {
+      vector<uchar> blocks(bcnSurfaceBytes(formats[f],w,h));
+      vector<uchar> dec(src.size());
+      encodeBCn(formats[f],&src[0],w,h,&blocks[0],qualities[q]);
+      decodeBCn(formats[f],&blocks[0],w,h,&dec[0]);
+      double e = rmse(src,dec);
+      cerr << sprint("%s quality %d: rmse %.2f",names[f],q,e) << endl;
+      sl_assert(e <= bounds[f][q]);
+      // higher qualities do not do worse
+      sl_assert(e <= prev + 1e-3);
+      prev = e;
+    }
+  }
+  // constant blocks of single channel formats are exact
+  vector<uchar> flat(8 * 8,173);
+  vector<uchar> blocks(bcnSurfaceBytes(BC4,8,8));
+  vector<uchar> dec(flat.size());
+  encodeBCn(BC4,&flat[0],8,8,&blocks[0]);
+  decodeBCn(BC4,&blocks[0],8,8,&dec[0]);
+  sl_assert(dec == flat);
+}
+
+// -----------
+
+static void checkDDSRoundtrip()
+{
+  const uint w = 45, h = 30;
+  // compressed, with mip chain: the file gives back the very same blocks
+  ImageRGBA img(w,h);
+  vector<uchar> px;
+  makePixels(w,h,4,px);
+  memcpy(img.raw(),&px[0],px.size());
+  DDSTexture tex;
+  tex.create(BC3);
+  tex.addFace(&img);
+  ImageFormat_dds::saveTexture("test_bcn.dds",tex);
+  DDSTexture back;
+  ImageFormat_dds::loadTexture("test_bcn.dds",back);
+  sl_assert(back.compressed && back.bcFormat == BC3);
+  sl_assert(back.width == w && back.height == h);
+  sl_assert(back.numMips == tex.numMips && back.numMips == 6);
+  sl_assert(back.surfaces == tex.surfaces);
+  // load() decodes the first level, within the BC3 bound
+  Image_Ptr dec(loadImage("test_bcn.dds"));
+  sl_assert(dec->w() == w && dec->h() == h && dec->numComp() == 4);
+  vector<uchar> decpx(dec->raw(),dec->raw() + px.size());
+  sl_assert(rmse(px,decpx) <= 3.0);
+  // uncompressed is lossless
+  ImageRGB rgb(w,h);
+  makePixels(w,h,3,px);
+  memcpy(rgb.raw(),&px[0],px.size());
+  DDSTexture raw;
+  raw.createUncompressed(3);
+  raw.addFace(&rgb,false);
+  ImageFormat_dds::saveTexture("test_bcn.dds",raw);
+  ImageFormat_dds::loadTexture("test_bcn.dds",back);
+  sl_assert(!back.compressed && back.numMips == 1);
+  Image_Ptr decraw(back.decode());
+  sl_assert(decraw->numComp() == 3 && memcmp(decraw->raw(),&px[0],px.size()) == 0);
+  remove("test_bcn.dds");
+}
+
+// -----------
+
+void test_bcn()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " BCn codec and DDS files " << endl;
+  cerr << "---------------------------" << endl;
+
+  checkCodec();
+  checkDDSRoundtrip();
+  cerr << "ok" << endl;
+}
+
+// -----------
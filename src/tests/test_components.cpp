@@ -0,0 +1,182 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Geometry/Components.h>
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+using namespace LibSL::Geometry;
+
+// -----------
+
+// Serial flood fill of a (xs,ys,zs) mask, components numbered by their first cell in memory
+// neighbors are offsets with at most maxNonZero non-zero coordinates (1: 4/6, 2: 8/18, 3: 26)
+static int floodFill(const uchar *mask,int xs,int ys,int zs,int maxNonZero,
+                     vector<int>& _labels,vector<Components::ComponentInfo>& _infos)
+{
+  _labels.assign(size_t(xs) * ys * zs,-1);
+  _infos.clear();
+  vector<v3i> stack;
+  int num = 0;
+  ForIndex(z,zs) { ForIndex(y,ys) { ForIndex(x,xs) {
+    size_t idx = (size_t(z) * ys + y) * xs + x;
+    if (mask[idx] == 0 || _labels[idx] >= 0) continue;
+    Components::ComponentInfo nfo;
+    nfo.area     = 0;
+    nfo.bboxMin  = V3I(x,y,z);
+    nfo.bboxMax  = V3I(x,y,z);
+    v3d sum      = V3D(0,0,0);
+    _labels[idx] = num;
+    stack.push_back(V3I(x,y,z));
+    while (!stack.empty()) {
+      v3i c = stack.back();
+      stack.pop_back();
+      nfo.area ++;
+      nfo.bboxMin = tupleMin(nfo.bboxMin,c);
+      nfo.bboxMax = tupleMax(nfo.bboxMax,c);
+      sum = sum + v3d(c);
+      for (int dz = -1 ; dz <= 1 ; dz++) { for (int dy = -1 ; dy <= 1 ; dy++) { for (int dx = -1 ; dx <= 1 ; dx++) {
+        int n = abs(dx) + abs(dy) + abs(dz);
+        if (n == 0 || n > maxNonZero) continue;
+        v3i p = c + V3I(dx,dy,dz);
+        if (p[0] < 0 || p[0] >= xs || p[1] < 0 || p[1] >= ys || p[2] < 0 || p[2] >= zs) continue;
+        size_t pidx = (size_t(p[2]) * ys + p[1]) * xs + p[0];
+        if (mask[pidx] == 0 || _labels[pidx] >= 0) continue;
+        _labels[pidx] = num;
+        stack.push_back(p);
+      } } }
+    }
+    nfo.centroid = sum / double(nfo.area);
+    _infos.push_back(nfo);
+    num ++;
+  } } }
+  return num;
+}
+
+static void checkInfos(const vector<Components::ComponentInfo>& infos,const vector<Components::ComponentInfo>& ref)
+{
+  sl_assert(infos.size() == ref.size());
+  ForIndex(c,ref.size()) {
+    sl_assert(infos[c].area    == ref[c].area);
+    sl_assert(infos[c].bboxMin == ref[c].bboxMin);
+    sl_assert(infos[c].bboxMax == ref[c].bboxMax);
+    sl_assert(length(infos[c].centroid - ref[c].centroid) < 1e-6 * (1.0 + length(ref[c].centroid)));
+  }
+}
+
+// random cells, with a few long diagonal/vertical lines crossing every slab
+static void randomMask(uchar *mask,int xs,int ys,int zs,float density)
+{
+  ForIndex(i,xs * ys * zs) {
+    mask[i] = (float(rand()) / float(RAND_MAX) < density) ? 1 : 0;
+  }
+  ForIndex(k,zs) { ForIndex(j,ys) {
+    mask[(size_t(k) * ys + j) * xs + (j + k) % xs] = 1; // diagonal staircase
+    mask[(size_t(k) * ys + j) * xs + xs / 2]      = 1; // straight line along y/z
+  } }
+}
+
+static void check2D(int xs,int ys,float density)
+{
+  Array2D<uchar> mask(xs,ys);
+  randomMask(mask.raw(),xs,ys,1,density);
+  for (int conn = 0 ; conn < 2 ; conn++) {
+    Components::e_Connectivity c = conn == 0 ? Components::Connect4 : Components::Connect8;
+    vector<int> ref;
+    vector<Components::ComponentInfo> refInfos;
+    int num = floodFill(mask.raw(),xs,ys,1,conn == 0 ? 1 : 2,ref,refInfos);
+    Array2D<int> labels;
+    vector<Components::ComponentInfo> infos;
+    int n = Components::labelComponents(mask,c,labels,&infos);
+    sl_assert(n == num);
+    ForIndex(j,ys) { ForIndex(i,xs) {
+      sl_assert(labels.at(i,j) == ref[size_t(j) * xs + i]);
+    } }
+    checkInfos(infos,refInfos);
+  }
+}
+
+static void check3D(int xs,int ys,int zs,float density)
+{
+  Array3D<uchar> mask(xs,ys,zs);
+  randomMask(mask.raw(),xs,ys,zs,density);
+  const int conns[3] = { 6, 18, 26 };
+  ForIndex(c,3) {
+    vector<int> ref;
+    vector<Components::ComponentInfo> refInfos;
+    int num = floodFill(mask.raw(),xs,ys,zs,c + 1,ref,refInfos);
+    Array3D<int> labels;
+    vector<Components::ComponentInfo> infos;
+    int n = Components::labelComponents(mask,Components::e_Connectivity(conns[c]),labels,&infos);
+    sl_assert(n == num);
+    ForIndex(k,zs) { ForIndex(j,ys) { ForIndex(i,xs) {
+      sl_assert(labels.at(i,j,k) == ref[(size_t(k) * ys + j) * xs + i]);
+    } } }
+    checkInfos(infos,refInfos);
+  }
+}
+
+// -----------
+
+void test_components()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::Geometry::Components " << endl;
+  cerr << "---------------------------" << endl;
+
+  srand(31);
+  // one thread (single slab), then several slabs so that components cross slab borders
+  const uint threads[2] = { 1, 4 };
+  ForIndex(t,2) {
+    LibSL::System::Parallel::setNumThreads(threads[t]);
+    check2D(97,131,0.45f);
+    check2D(64,200,0.6f);
+    check2D(1,50,0.5f);
+    check3D(23,17,41,0.3f);
+    check3D(16,16,64,0.2f);
+    cerr << "labels match flood fill with " << threads[t] << " thread(s)" << endl;
+  }
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
+
+// -----------
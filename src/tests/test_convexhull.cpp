@@ -0,0 +1,160 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Geometry/ConvexHull.h>
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+using namespace std;
+using namespace LibSL::Geometry;
+
+// -----------
+
+typedef Tuple<double,2> v2d_;
+typedef Tuple<double,3> v3d_;
+
+static double urnd() { return double(rand()) / double(RAND_MAX); }
+
+// point sets of varied sizes, every 10th is degenerate (flat or too small)
+static void makeBatch(std::vector<std::vector<v3d_> >& _batch,int num)
+{
+  _batch.resize(num);
+  ForIndex(i,num) {
+    int n = 4 + rand() % 300;
+    ForIndex(p,n) {
+      v3d_ q;
+      if (i % 3 == 0) {
+        // on a sphere: most points are hull vertices
+        q = v3d_(urnd() - 0.5,urnd() - 0.5,urnd() - 0.5);
+        double l = sqrt(dot(q,q));
+        q = q / (l > 0.0 ? l : 1.0);
+      } else {
+        q = v3d_(urnd(),urnd(),urnd());
+      }
+      if (i % 10 == 5) q[2] = 0.0;
+      _batch[i].push_back(q);
+    }
+    if (i % 10 == 7) _batch[i].resize(3);
+  }
+}
+
+static void makeBatch(std::vector<std::vector<v2d_> >& _batch,int num)
+{
+  _batch.resize(num);
+  ForIndex(i,num) {
+    int n = 3 + rand() % 200;
+    ForIndex(p,n) {
+      v2d_ q(urnd(),urnd());
+      if (i % 10 == 5) q[1] = q[0]; // collinear
+      _batch[i].push_back(q);
+    }
+    if (i % 10 == 7) _batch[i].resize(2);
+  }
+}
+
+template <int Dim>
+static bool sameHull(const ConvexHullEngine<Dim>& a,const ConvexHullEngine<Dim>& b)
+{
+  return a.getVertices() == b.getVertices()
+      && a.getFaces()    == b.getFaces()
+      && a.getIndexMap() == b.getIndexMap();
+}
+
+// batch against one run() per set, in order; returns the number of rejected sets
+template <int Dim>
+static int checkBatch(const std::vector<std::vector<Tuple<double,Dim> > >& batch)
+{
+  std::vector<ConvexHullEngine<Dim> > hulls;
+  int num_rejected = computeHulls<Dim>(batch,hulls);
+  sl_assert(hulls.size() == batch.size());
+  int num_expected = 0;
+  ForIndex(i,batch.size()) {
+    ConvexHullEngine<Dim> seq;
+    bool rejected = false;
+    try {
+      seq.run(batch[i]);
+    } catch (LibSL::Errors::Fatal&) {
+      rejected = true;
+    }
+    if (rejected) {
+      num_expected++;
+      sl_assert(hulls[i].getVertices().empty());
+      sl_assert(hulls[i].getFaces()   .empty());
+    } else {
+      sl_assert(!seq.getFaces().empty());
+      sl_assert(sameHull(hulls[i],seq));
+    }
+  }
+  sl_assert(num_rejected == num_expected);
+  return num_rejected;
+}
+
+// -----------
+
+void test_convexhull()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::Geometry::ConvexHull " << endl;
+  cerr << "---------------------------" << endl;
+
+  srand(39);
+  LibSL::System::Parallel::setNumThreads(4);
+
+  std::vector<std::vector<v3d_> > batch3;
+  makeBatch(batch3,60);
+  int rejected3 = checkBatch<3>(batch3);
+  // flat sets and sets of 3 points
+  sl_assert(rejected3 == 12);
+  cerr << "3D batch matches sequential runs, " << rejected3 << " sets rejected" << endl;
+
+  std::vector<std::vector<v2d_> > batch2;
+  makeBatch(batch2,60);
+  int rejected2 = checkBatch<2>(batch2);
+  sl_assert(rejected2 == 12);
+  cerr << "2D batch matches sequential runs, " << rejected2 << " sets rejected" << endl;
+
+  // empty batch
+  std::vector<ConvexHullEngine<3> > none;
+  sl_assert(computeHulls<3>(std::vector<std::vector<v3d_> >(),none) == 0);
+  sl_assert(none.empty());
+
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
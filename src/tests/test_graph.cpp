@@ -37,6 +37,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include <LibSL/LibSL.h>
 #include <LibSL/DataStructures/GraphRndCut.h>
+#include <LibSL/DataStructures/CompactGraphAlgorithms.h>
 
 // -----------
 
@@ -45,6 +46,14 @@ using namespace std;
 
 // -----------
 
+// the algorithms sum costs in different orders
+static bool sameDistance(float a,float b)
+{
+  return fabs(a - b) <= 1e-5f * max(1.0f, max(fabs(a), fabs(b)));
+}
+
+// -----------
+
 class EdgeData
 {
 public:
@@ -62,7 +71,7 @@ typedef Graph<NodeData,EdgeData,true> t_Graph;
 class MyEdgeCost
 {
 public:
-  float operator()(const t_Graph& graph,t_NodeId current,t_EdgeId edge) const 
+  float operator()(const t_Graph& graph,t_NodeId /*current*/,t_EdgeId edge) const 
   { 
     return graph.edges()[edge].data().m_Cost;
   }
@@ -70,13 +79,87 @@ public:
 
 // -----------
 
+// random oriented graph, costs in [0.1,10]
+static void randomGraph(t_Graph& _g,uint numNodes,uint numEdges,uint seed)
+{
+  srand(seed);
+  ForIndex(n,numNodes) {
+    _g.addNode(NodeData());
+  }
+  ForIndex(e,numEdges) {
+    uint a = uint(rand()) % numNodes;
+    uint b = uint(rand()) % numNodes;
+    if (a != b) {
+      _g.addEdge(a,b,EdgeData(0.1f + 9.9f * float(rand()) / float(RAND_MAX)));
+    }
+  }
+}
+
+// the radix-heap Dijkstra and delta-stepping give the distances of the pointer graph Dijkstra
+static void checkCompactSolvers()
+{
+  t_Graph g;
+  randomGraph(g,4000,16000,17);
+  vector<t_NodeId> sources;
+  sources.push_back(0);
+  sources.push_back(1234);
+  sources.push_back(3999);
+  // reference: one run per source, the distance is the smallest
+  GraphAlgorithms::ShortestPaths<t_Graph,MyEdgeCost> sp;
+  Array<float> ref;
+  ForIndex(s,sources.size()) {
+    Array<float> dist;
+    Array<v2i>   prev;
+    sp.dijkstraToAll(g,sources[s],dist,prev);
+    if (s == 0) {
+      ref = dist;
+    } else {
+      ForArray(ref,n) { ref[n] = min(ref[n],dist[n]); }
+    }
+  }
+  CompactGraph cg;
+  cg.build(g,MyEdgeCost());
+  GraphAlgorithms::CompactShortestPaths csp;
+  Array<float> dist,ddist,single;
+  Array<v2i>   prev,dprev,sprev;
+  csp.dijkstraFromSources(cg,sources,dist,prev);
+  csp.deltaStepping      (cg,sources,ddist,dprev);
+  uint reached = 0;
+  ForArray(ref,n) {
+    sl_assert(dist[n]  == ref[n] || sameDistance(dist[n], ref[n]));
+    sl_assert(ddist[n] == ref[n] || sameDistance(ddist[n],ref[n]));
+    // predecessors are consistent with the distances
+    if (dprev[n][0] >= 0) {
+      sl_assert(sameDistance(ddist[dprev[n][0]] + g.edges()[dprev[n][1]].data().m_Cost,ddist[n]));
+    }
+    reached += (ref[n] < Infinity) ? 1 : 0;
+  }
+  // single source, against the pointer graph
+  Array<v2i> rprev;
+  sp.dijkstraToAll(g,sources[1],ref,rprev);
+  csp.dijkstraToAll(cg,sources[1],single,sprev);
+  ForArray(ref,n) {
+    sl_assert(single[n] == ref[n] || sameDistance(single[n],ref[n]));
+  }
+  cerr << "random graph: " << reached << " of " << ref.size() << " nodes reached, solvers agree" << endl;
+}
+
+// -----------
+
 void test_graph()
 {
   cerr << "---------------------------" << endl;
   cerr << " LibSL::DataStructures::Graph " << endl;
   cerr << "---------------------------" << endl;
 
-  ImageRGB_Ptr img = loadImage<ImageRGB>("media/map.png");
+  // serial, then with parallel relaxation
+  LibSL::System::Parallel::setNumThreads(1);
+  checkCompactSolvers();
+  LibSL::System::Parallel::setNumThreads(4);
+  checkCompactSolvers();
+  LibSL::System::Parallel::setNumThreads(0);
+
+  ImageRGB_Ptr img(loadImage<ImageRGB>("map.png"));
 
   t_Graph g;
   ForImage(img,i,j) {
@@ -101,63 +184,47 @@ void test_graph()
   uint y = img->h()-2;
 
   GraphAlgorithms::ShortestPaths<t_Graph,MyEdgeCost> sp;
-  float cost = sp.dijkstraToTarget( g,0,x+y*img->w(), path );
+  float cost = sp.dijkstraToTarget<GraphAlgorithms::TargetStopCondition<t_Graph> >( g,0,x+y*img->w(), path );
 
   cerr << "path is " << path.size() << " node(s) long, cost = " << cost << endl;
 
-  ForIndex(n,path.size()) {
-    uint i = path[n][0] % img->w();
-    uint j = path[n][0] / img->w();
-    img->pixel(i,j)[0] = 0;
-    img->pixel(i,j)[1] = 255;
-    img->pixel(i,j)[2] = 0;
+  //// compact graph
+
+  CompactGraph cg;
+  cg.build( g, MyEdgeCost() );
+  GraphAlgorithms::CompactShortestPaths csp;
+  vector<v2i> cpath;
+  float ccost = csp.dijkstraToTarget( cg,0,x+y*img->w(), cpath );
+  cerr << "compact path is " << cpath.size() << " node(s) long, cost = " << ccost << endl;
+  sl_assert( sameDistance( ccost, cost ) );
+
+  Array<float> dist,ddist;
+  Array<v2i>   prev,dprev;
+  vector<t_NodeId> sources;
+  sources.push_back( 0 );
+  sources.push_back( x+y*img->w() );
+  csp.dijkstraFromSources( cg, sources, dist,  prev  );
+  csp.deltaStepping      ( cg, sources, ddist, dprev );
+  ForArray(dist,n) {
+    sl_assert( dist[n] == ddist[n] || sameDistance( dist[n], ddist[n] ) );
   }
-  saveImage("path.png",img);
 
   //// cut
 
   GraphAlgorithms::RndCut<t_Graph,MyEdgeCost> ct;
   Histogram h;
-  int N = 200;
-  cerr << "Running " << N << " randomized cuts ";
-  { 
-    Timer tm("[all cuts]"); 
-    Console::progressBarInit(N);
-    double best     = (1<<30);
-    ForIndex(n,N) {
-      Console::progressBarUpdate();
-      time_t seed = milliseconds();
-      srand( (uint)seed );
-      Array<int> sides;
-      ct.cut( g, 0,x+y*img->w(), sides);
-      double ccost = ct.cutCost();
-      h << (int)ccost;
-      if (ccost < best) {
-        best = ccost;
-        // produce cut image
-        img  = loadImage<ImageRGB>("media/map.png");
-        ForImage(img,i,j) {
-          t_NodeId n = i+j*img->w();
-          if (sides[n] == GraphAlgorithms::Source) {
-            img->pixel(i,j)[0] = 0;
-            img->pixel(i,j)[1] = 255;
-            img->pixel(i,j)[2] = 0;
-          } else if (sides[n] == GraphAlgorithms::Disconnected) {
-            img->pixel(i,j)[0] = 255;
-            img->pixel(i,j)[1] = 0;
-            img->pixel(i,j)[2] = 0;
-          }
-        }
-        saveImage("cut.png",img);
-      }
-    }
-    Console::progressBarEnd();
+  int N = 20;
+  cerr << "Running " << N << " randomized cuts " << endl;
+  srand( 1 );
+  ForIndex(n,N) {
+    Array<int> sides;
+    ct.cut( g, 0,x+y*img->w(), sides);
+    h << (int)ct.cutCost();
+    sl_assert( sides[0] == GraphAlgorithms::Source );
   }
-  cerr << endl;
   h.print();
 
-  cerr << "---------------------------" << endl;
-
+  cerr << "ok" << endl;
 }
 
 // -----------
@@ -0,0 +1,123 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/System/HalfConvert.h>
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+using namespace std;
+
+// -----------
+
+static void checkHalfConversions()
+{
+  // every half converts to the same float as the table
+  vector<half>  all(1 << 16);
+  vector<float> f  (1 << 16);
+  ForIndex(i,1 << 16) {
+    all[i].setBits(ushort(i));
+  }
+  LibSL::System::halfToFloat(&all[0],&f[0],all.size());
+  ForIndex(i,1 << 16) {
+    float ref = float(all[i]);
+    sl_assert(memcmp(&ref,&f[i],sizeof(float)) == 0 || (all[i].isNan() && f[i] != f[i]));
+  }
+  // and back, all values but NaNs round trip
+  vector<half> back(1 << 16);
+  LibSL::System::floatToHalf(&f[0],&back[0],f.size());
+  ForIndex(i,1 << 16) {
+    sl_assert(all[i].isNan() ? back[i].isNan() : back[i].bits() == all[i].bits());
+  }
+  // away from ties the rounding matches half(float)
+  srand(42);
+  vector<float> v(100000);
+  vector<half>  h(v.size());
+  ForIndex(i,v.size()) {
+    v[i] = (float(rand()) / float(RAND_MAX) - 0.5f) * 2.0f * float(1 << (rand() % 20)) / 1024.0f;
+  }
+  LibSL::System::floatToHalf(&v[0],&h[0],v.size());
+  ForIndex(i,v.size()) {
+    uint bits;
+    memcpy(&bits,&v[i],sizeof(uint));
+    if ((bits & 0x1fff) != 0x1000 && v[i] != 0.0f && fabs(v[i]) > HALF_NRM_MIN) {
+      sl_assert(h[i].bits() == half(v[i]).bits());
+    }
+  }
+}
+
+// -----------
+
+void test_half()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Half conversions " << endl;
+  cerr << "---------------------------" << endl;
+
+  checkHalfConversions();
+  cerr << "F16C: " << (LibSL::System::halfConvertUsesF16C() ? "yes" : "no") << endl;
+
+  const size_t  N    = 1 << 24;
+  const int     reps = 8;
+  vector<float> f(N);
+  vector<half>  h(N);
+  ForIndex(i,N) {
+    f[i] = float(i % 4096) / 64.0f - 32.0f;
+  }
+
+  float checksum = 0.0f;
+  {
+    Timer tm("[table path] float to half");
+    ForIndex(r,reps) { ForIndex(i,N) { h[i] = half(f[i]); } }
+  }
+  {
+    Timer tm("[table path] half to float");
+    ForIndex(r,reps) { ForIndex(i,N) { f[i] = float(h[i]); } checksum += f[r]; }
+  }
+  {
+    Timer tm("[bulk] float to half");
+    ForIndex(r,reps) { LibSL::System::floatToHalf(&f[0],&h[0],N); }
+  }
+  {
+    Timer tm("[bulk] half to float");
+    ForIndex(r,reps) { LibSL::System::halfToFloat(&h[0],&f[0],N); checksum += f[r]; }
+  }
+  cerr << "(" << reps << " x " << N << " values, checksum " << checksum << ")" << endl;
+}
+
+// -----------
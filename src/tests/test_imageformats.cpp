@@ -0,0 +1,140 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Image/ImageFormat_JPG.h>
+#include <LibSL/Image/ImageFormat_PNG.h>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+// -----------
+
+// pixel (i,j) of _full at (x+i,y+j), the region is clipped by the caller
+static bool sameAsCrop(const Image *region,const Image *full,uint x,uint y,uint w,uint h)
+{
+  const ImageRGB *r = dynamic_cast<const ImageRGB*>(region);
+  const ImageRGB *f = dynamic_cast<const ImageRGB*>(full);
+  sl_assert(r != NULL && f != NULL);
+  if (r->w() != w || r->h() != h) return false;
+  ForImage(r,i,j) {
+    if (r->pixel(i,j) != f->pixel(x + i,y + j)) return false;
+  }
+  return true;
+}
+
+// load(x,y,w,h) decodes a region of the image scaled by 1/scale
+template <class T_Load>
+static void checkRegions(const T_Load& load,const Image *full,uint scale)
+{
+  const int regions[4][4] = {
+    { 0,   0,  16,  16 }, // top left corner
+    { 37,  21, 50,  33 }, // unaligned
+    { 5,   60, 500, 9  }, // clipped on the right
+    { 150, 70, 20,  200 } // clipped at the bottom
+  };
+  ForIndex(r,4) {
+    uint x = regions[r][0] / scale, y = regions[r][1] / scale;
+    uint w = regions[r][2], h = regions[r][3];
+    Image_Ptr reg(load(x,y,w,h));
+    uint cw = min(w,uint(full->w()) - x), ch = min(h,uint(full->h()) - y);
+    sl_assert(sameAsCrop(reg.raw(),full,x,y,cw,ch));
+  }
+}
+
+// -----------
+
+void test_imageformats()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::Image JPG/PNG " << endl;
+  cerr << "---------------------------" << endl;
+
+  // sizes not multiple of the JPG blocks
+  ImageRGB_Ptr img(new ImageRGB(203,157));
+  srand(30);
+  ForImage(img,i,j) {
+    img->pixel(i,j) = V3B(uchar(i),uchar(j + i / 2),uchar((i * j) / 64 + rand() % 16));
+  }
+  saveImage("test_imageformats.png",img);
+  saveImage("test_imageformats.jpg",img);
+
+  // region decoding gives the crop of the full decode
+  ImageFormat_PNG png;
+  Image_Ptr fullPng(png.load("test_imageformats.png"));
+  checkRegions([&](uint x,uint y,uint w,uint h) { return png.loadRegion("test_imageformats.png",x,y,w,h); },fullPng.raw(),1);
+  sl_assert(sameAsCrop(fullPng.raw(),img.raw(),0,0,img->w(),img->h()));
+  ImageFormat_JPG jpg;
+  Image_Ptr fullJpg(jpg.load("test_imageformats.jpg"));
+  checkRegions([&](uint x,uint y,uint w,uint h) { return jpg.loadRegion("test_imageformats.jpg",x,y,w,h); },fullJpg.raw(),1);
+  Image_Ptr halfJpg(jpg.loadScaled("test_imageformats.jpg",2));
+  sl_assert(halfJpg->w() == (img->w() + 1) / 2 && halfJpg->h() == (img->h() + 1) / 2);
+  checkRegions([&](uint x,uint y,uint w,uint h) { return jpg.loadRegion("test_imageformats.jpg",x,y,w,h,2); },halfJpg.raw(),2);
+  cerr << "region decoding matches the cropped full decode" << endl;
+
+  // concurrent loading, a missing file does not prevent loading the others
+  LibSL::System::Parallel::setNumThreads(4);
+  vector<string> fnames;
+  fnames.push_back("test_imageformats.png");
+  fnames.push_back("test_imageformats_missing.png");
+  fnames.push_back("test_imageformats.jpg");
+  fnames.push_back("test_imageformats.png");
+  vector<Image*> images;
+  vector<string> errors;
+  loadImages(fnames,images,1,&errors);
+  LibSL::System::Parallel::setNumThreads(0);
+  sl_assert(images.size() == fnames.size() && errors.size() == fnames.size());
+  sl_assert(images[1] == NULL && !errors[1].empty());
+  sl_assert(images[0] != NULL && errors[0].empty() && sameAsCrop(images[0],fullPng.raw(),0,0,img->w(),img->h()));
+  sl_assert(images[2] != NULL && errors[2].empty() && sameAsCrop(images[2],fullJpg.raw(),0,0,img->w(),img->h()));
+  sl_assert(images[3] != NULL && errors[3].empty() && sameAsCrop(images[3],fullPng.raw(),0,0,img->w(),img->h()));
+  ForIndex(i,images.size()) {
+    delete (images[i]);
+  }
+  cerr << "missing file reported: " << errors[1] << endl;
+
+  remove("test_imageformats.png");
+  remove("test_imageformats.jpg");
+
+  cerr << "ok" << endl;
+}
+
+// -----------
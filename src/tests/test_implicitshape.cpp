@@ -0,0 +1,190 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Geometry/ImplicitShape.h>
+#include <LibSL/Geometry/MarchingCubes.h>
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <atomic>
+using namespace std;
+using namespace LibSL::Geometry;
+
+// -----------
+
+static const v3f   c_Center = V3F(0.52f,0.47f,0.5f);
+static const float c_Radius = 0.3f;
+
+// sphere distance, counts evaluations and concurrent callers
+class Sphere : public ImplicitShape::ImplicitFunction
+{
+public:
+  bool                     m_ThreadSafe;
+  mutable std::atomic<int> m_Calls;
+  mutable std::atomic<int> m_Inside;
+  mutable std::atomic<int> m_MaxInside;
+
+  Sphere(bool threadSafe) : m_ThreadSafe(threadSafe), m_Calls(0), m_Inside(0), m_MaxInside(0) { }
+
+  float operator()(const v3f& p) const
+  {
+    int in = ++m_Inside;
+    int mx = m_MaxInside;
+    while (in > mx && !m_MaxInside.compare_exchange_weak(mx,in)) { }
+    m_Calls++;
+    float d = length(p - c_Center) - c_Radius;
+    m_Inside--;
+    return d;
+  }
+  float lipschitz()  const { return 1.0f; }
+  bool  threadSafe() const { return m_ThreadSafe; }
+};
+
+// reference: dense serial sampling and a single marching cubes
+static void denseSurface(const Sphere& f,int res,float iso,std::vector<v3f>& _verts,int& _numTris)
+{
+  MarchingCubes::MarchingCubes mc;
+  mc.set_resolution(res,res,res);
+  mc.init_all();
+  ForIndex(k,res) { ForIndex(j,res) { ForIndex(i,res) {
+    mc.set_data(f(V3F(float(i),float(j),float(k)) / float(res - 1)),i,j,k);
+  } } }
+  mc.run(iso);
+  _verts.resize(mc.nverts());
+  ForIndex(i,mc.nverts()) {
+    const MarchingCubes::Vertex& v = mc.vertices()[i];
+    _verts[i] = V3F(v.x,v.y,v.z) / float(res - 1);
+  }
+  _numTris = mc.ntrigs();
+  mc.clean_temps();
+  mc.clean_all();
+}
+
+// every reference vertex has a counterpart in the mesh
+static float maxVertexDistance(const std::vector<v3f>& ref,const ImplicitShape::t_Mesh *mesh)
+{
+  float worst = 0.0f;
+  ForIndex(i,ref.size()) {
+    float best = 1e30f;
+    ForIndex(v,mesh->numVertices()) {
+      best = min(best,sqLength(mesh->vertexAt(v).pos - ref[i]));
+    }
+    worst = max(worst,best);
+  }
+  return sqrt(worst);
+}
+
+// every edge is shared by exactly two triangles, in opposite directions
+static bool watertight(const ImplicitShape::t_Mesh *mesh)
+{
+  std::map<std::pair<uint,uint>,int> edges;
+  ForIndex(t,mesh->numTriangles()) {
+    ForIndex(e,3) {
+      uint a = mesh->triangleAt(t)[e], b = mesh->triangleAt(t)[(e + 1) % 3];
+      edges[std::make_pair(a,b)]++;
+    }
+  }
+  for (std::map<std::pair<uint,uint>,int>::const_iterator E = edges.begin(); E != edges.end(); E++) {
+    if (E->second != 1) return false;
+    std::map<std::pair<uint,uint>,int>::const_iterator O = edges.find(std::make_pair(E->first.second,E->first.first));
+    if (O == edges.end() || O->second != 1) return false;
+  }
+  return true;
+}
+
+// -----------
+
+void test_implicitshape()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::Geometry::ImplicitShape " << endl;
+  cerr << "---------------------------" << endl;
+
+  LibSL::System::Parallel::setNumThreads(4);
+
+  // not a multiple of the block size: last blocks are partial
+  const int   res = 70;
+  const float iso = 0.0f;
+
+  Sphere ref(true);
+  std::vector<v3f> refVerts;
+  int              refTris = 0;
+  denseSurface(ref,res,iso,refVerts,refTris);
+  sl_assert(refTris > 0);
+
+  // thread safe function: octree pruned, blocks sampled in parallel
+  Sphere fs(true);
+  {
+    ImplicitShape shape(fs,res);
+    AutoPtr<ImplicitShape::t_Mesh> mesh(shape.generateShape(iso));
+    sl_assert(!mesh.isNull());
+    sl_assert(int(mesh->numTriangles()) == refTris);
+    sl_assert(mesh->numVertices() == refVerts.size());
+    sl_assert(maxVertexDistance(refVerts,mesh.raw()) < 1e-5f);
+    sl_assert(watertight(mesh.raw()));
+  }
+  // pruned blocks are never sampled
+  sl_assert(fs.m_Calls < res * res * res);
+  cerr << "pruned blocks match dense sampling (" << refTris << " triangles, "
+       << fs.m_Calls << " evaluations, " << fs.m_MaxInside << " concurrent callers)" << endl;
+
+  // not thread safe: same surface, never more than one caller
+  Sphere fu(false);
+  {
+    ImplicitShape shape(fu,res);
+    AutoPtr<ImplicitShape::t_Mesh> mesh(shape.generateShape(iso));
+    sl_assert(!mesh.isNull());
+    sl_assert(int(mesh->numTriangles()) == refTris);
+    sl_assert(mesh->numVertices() == refVerts.size());
+    sl_assert(maxVertexDistance(refVerts,mesh.raw()) < 1e-5f);
+  }
+  sl_assert(fu.m_MaxInside == 1);
+  sl_assert(fu.m_Calls == fs.m_Calls);
+  cerr << "serial fallback matches, single caller" << endl;
+
+  // iso value outside of the function range
+  {
+    ImplicitShape shape(fs,res);
+    sl_assert(shape.generateShape(10.0f) == NULL);
+  }
+
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
@@ -0,0 +1,208 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/DataStructures/LinearPow2Tree.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <set>
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+using namespace LibSL::DataStructures;
+
+// -----------
+
+typedef LinearQuadTree<uint> t_LinearQuadTree;
+typedef LinearOcTree<uint>   t_LinearOcTree;
+
+// leaves sorted in Morton order, with their data
+template <class T_Tree>
+static void sortLeaves(std::vector<typename T_Tree::t_Key>& _keys,std::vector<uint>& _values)
+{
+  std::vector<uint> order(_keys.size());
+  ForIndex(i,order.size()) { order[i] = i; }
+  std::sort(order.begin(),order.end(),[&](uint a,uint b) { return T_Tree::mortonLess(_keys[a],_keys[b]); });
+  std::vector<typename T_Tree::t_Key> keys;
+  std::vector<uint>                   values;
+  ForIndex(i,order.size()) { keys.push_back(_keys[order[i]]); values.push_back(_values[order[i]]); }
+  _keys.swap(keys);
+  _values.swap(values);
+}
+
+// parents, children, levels and keys agree
+template <class T_Tree>
+static void checkStructure(const T_Tree& tree)
+{
+  ForIndex(l,tree.numLevels()) {
+    for (uint i = tree.levelBegin(l) ; i < tree.levelEnd(l) ; i++) {
+      sl_assert(tree.level(i) == uint(l));
+      sl_assert(i == tree.levelBegin(l) || tree.key(i - 1) < tree.key(i));
+      sl_assert(tree.find(tree.key(i)) == i);
+    }
+  }
+  ForIndex(i,tree.numNodes()) {
+    uint n = 0;
+    for (typename T_Tree::ChildrenIterator I = tree.children(i) ; !I.end() ; I.next()) {
+      sl_assert(tree.parent(I.current()) == uint(i));
+      sl_assert(T_Tree::parentKey(tree.key(I.current())) == tree.key(i));
+      n ++;
+    }
+    sl_assert(n == tree.numChildren(i));
+  }
+}
+
+// -----------
+
+// the quadtree of test_datastructures, built from its leaves
+static void checkQuadtree()
+{
+  std::vector<t_LinearQuadTree::t_Key> leaves;
+  std::vector<uint>                    values;
+  leaves.push_back(t_LinearQuadTree::encode(V2U(0,0),1)); values.push_back(1);
+  leaves.push_back(t_LinearQuadTree::encode(V2U(1,0),1)); values.push_back(2);
+  leaves.push_back(t_LinearQuadTree::encode(V2U(0,2),2)); values.push_back(41);
+  leaves.push_back(t_LinearQuadTree::encode(V2U(1,3),2)); values.push_back(44);
+  leaves.push_back(t_LinearQuadTree::encode(V2U(2,3),2)); values.push_back(33);
+  leaves.push_back(t_LinearQuadTree::encode(V2U(7,5),3)); values.push_back(94);
+  sortLeaves<t_LinearQuadTree>(leaves,values);
+  t_LinearQuadTree ltree;
+  ltree.build(leaves,values,[](uint& p,const uint& c) { p = LibSL::Math::max(p,c); });
+  cerr << "number of nodes  = " << ltree.numNodes() << endl;
+  cerr << "number of leaves = " << ltree.numLeaves() << endl;
+  cerr << "tree height      = " << ltree.height() << endl;
+  cerr << "max value        = " << ltree.data(ltree.root()) << endl;
+  sl_assert(ltree.numNodes() == 10 && ltree.numLeaves() == 6 && ltree.height() == 3);
+  sl_assert(ltree.data(ltree.root()) == 94);
+  checkStructure(ltree);
+  uint n94 = ltree.locate(V2U(7,5),3);
+  sl_assert(ltree.data(n94) == 94);
+  sl_assert(ltree.neighbor(ltree.parent(n94),Pair(-1,1)) == ltree.find(t_LinearQuadTree::encode(V2U(2,3),2)));
+  // a cell below a leaf is located in the leaf
+  sl_assert(ltree.data(ltree.locate(V2U(3,1),3)) == 1);
+}
+
+// random octree leaves at the deepest level
+static void randomOctree(uint level,uint numCells,t_LinearOcTree& _tree)
+{
+  std::set<t_LinearOcTree::t_Key> cells;
+  while (cells.size() < numCells) {
+    uint r = 1u << level;
+    cells.insert(t_LinearOcTree::encode(V3U(uint(rand()) % r,uint(rand()) % r,uint(rand()) % r),level));
+  }
+  std::vector<t_LinearOcTree::t_Key> leaves(cells.begin(),cells.end());
+  std::vector<uint>                   values(leaves.size(),1);
+  sortLeaves<t_LinearOcTree>(leaves,values);
+  // inner nodes count their leaves
+  _tree.build(leaves,values,[](uint& p,const uint& c) { p += c; });
+}
+
+static void checkOctree()
+{
+  const uint level = 6, numCells = 20000;
+  // serial and parallel builds are identical
+  LibSL::System::Parallel::setNumThreads(1);
+  srand(31);
+  t_LinearOcTree serial;
+  randomOctree(level,numCells,serial);
+  LibSL::System::Parallel::setNumThreads(4);
+  srand(31);
+  t_LinearOcTree tree;
+  randomOctree(level,numCells,tree);
+  LibSL::System::Parallel::setNumThreads(0);
+  sl_assert(tree.numNodes() == serial.numNodes() && tree.numLevels() == serial.numLevels());
+  ForIndex(i,tree.numNodes()) {
+    sl_assert(tree.key(i) == serial.key(i) && tree.data(i) == serial.data(i) && tree.parent(i) == serial.parent(i));
+  }
+  sl_assert(tree.numLeaves() == numCells && tree.height() == level);
+  sl_assert(tree.data(tree.root()) == numCells);
+  checkStructure(tree);
+  // every leaf is located, codes decode to their cell
+  for (uint i = tree.levelBegin(level) ; i < tree.levelEnd(level) ; i++) {
+    v3u  p;
+    uint l;
+    tree.cell(i,p,l);
+    sl_assert(l == level && t_LinearOcTree::encode(p,l) == tree.key(i));
+    sl_assert(tree.locate(p,level) == i);
+  }
+  // save / load, a truncated file is rejected
+  tree.save("test_lineartree.bin");
+  t_LinearOcTree back;
+  back.load("test_lineartree.bin");
+  sl_assert(back.numNodes() == tree.numNodes());
+  ForIndex(i,tree.numNodes()) {
+    sl_assert(back.key(i) == tree.key(i) && back.data(i) == tree.data(i) && back.firstChild(i) == tree.firstChild(i));
+  }
+  long long sz = LibSL::System::File::size("test_lineartree.bin");
+  {
+    FILE *f = NULL;
+    fopen_s(&f,"test_lineartree.bin","rb");
+    std::vector<char> bytes(size_t(sz / 2));
+    sl_assert(fread(&bytes[0],1,bytes.size(),f) == bytes.size());
+    fclose(f);
+    fopen_s(&f,"test_lineartree.bin","wb");
+    fwrite(&bytes[0],1,bytes.size(),f);
+    fclose(f);
+  }
+  bool thrown = false;
+  try {
+    back.load("test_lineartree.bin");
+  } catch (Fatal&) {
+    thrown = true;
+  }
+  sl_assert(thrown && back.numNodes() == 0);
+  remove("test_lineartree.bin");
+  cerr << "octree: " << tree.numNodes() << " nodes, " << tree.numLeaves() << " leaves" << endl;
+}
+
+// -----------
+
+void test_lineartree()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::DataStructures::LinearPow2Tree " << endl;
+  cerr << "---------------------------" << endl;
+
+  checkQuadtree();
+  checkOctree();
+
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,271 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshFormat_mesh.h>
+
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+using namespace std;
+using namespace LibSL::Mesh;
+
+// -----------
+
+typedef struct { v3f pos; v3f nrm; v2f uv; } t_Vertex;
+typedef MVF3(mvf_position_3f,mvf_normal_3f,mvf_texcoord0_2f) t_Format;
+typedef TriangleMesh_generic<t_Vertex> t_Mesh;
+
+// torus, two surfaces sharing the triangles
+static t_Mesh *makeTorus(uint nu,uint nv)
+{
+  t_Mesh *mesh = new t_Mesh(nu * nv,2 * nu * nv,2,AutoPtr<MVF>(MVF::make<t_Format>()));
+  ForIndex(j,nv) {
+    ForIndex(i,nu) {
+      float a = 2.0f * float(M_PI) * float(i) / float(nu),b = 2.0f * float(M_PI) * float(j) / float(nv);
+      t_Vertex& v = mesh->vertexAt(i + j * nu);
+      v.nrm = V3F(cosf(b) * cosf(a),cosf(b) * sinf(a),sinf(b));
+      v.pos = V3F(cosf(a),sinf(a),0.0f) + v.nrm * 0.3f;
+      v.uv  = V2F(float(i) / float(nu),float(j) / float(nv));
+    }
+  }
+  ForIndex(j,nv) {
+    ForIndex(i,nu) {
+      uint a = i + j * nu,b = (i + 1) % nu + j * nu,c = (i + 1) % nu + ((j + 1) % nv) * nu,d = i + ((j + 1) % nv) * nu;
+      mesh->triangleAt(2 * (i + j * nu)    ) = V3U(a,b,c);
+      mesh->triangleAt(2 * (i + j * nu) + 1) = V3U(a,c,d);
+    }
+  }
+  uint half = mesh->numTriangles() / 2;
+  ForIndex(s,2) {
+    mesh->surfaceAt(s).textureName = s == 0 ? "first.png" : "second.png";
+    mesh->surfaceAt(s).diffuse     = V3F(0.25f * float(s + 1),0.5f,1.0f);
+    mesh->surfaceAt(s).triangleIds.allocate(half);
+    ForIndex(t,half) { mesh->surfaceAt(s).triangleIds[t] = t + s * half; }
+  }
+  return mesh;
+}
+
+static bool sameMesh(const TriangleMesh *a,const TriangleMesh *b)
+{
+  if (a->numVertices() != b->numVertices() || a->numTriangles() != b->numTriangles() || a->numSurfaces() != b->numSurfaces()) return false;
+  if (a->sizeOfVertexData() != b->sizeOfVertexData() || b->mvf().isNull()) return false;
+  ForIndex(v,a->numVertices()) {
+    if (memcmp(a->vertexDataAt(v),b->vertexDataAt(v),a->sizeOfVertexData())) return false;
+  }
+  ForIndex(t,a->numTriangles()) {
+    if (a->triangleAt(t) != b->triangleAt(t)) return false;
+  }
+  ForIndex(s,a->numSurfaces()) {
+    if (a->surfaceAt(s).textureName != b->surfaceAt(s).textureName) return false;
+    if (a->surfaceAt(s).diffuse     != b->surfaceAt(s).diffuse)     return false;
+    if (a->surfaceNumTriangles(s)   != b->surfaceNumTriangles(s))   return false;
+    ForIndex(t,a->surfaceNumTriangles(s)) {
+      if (a->surfaceTriangleIdAt(s,t) != b->surfaceTriangleIdAt(s,t)) return false;
+    }
+  }
+  return true;
+}
+
+static vector<uchar> readFile(const char *fname)
+{
+  vector<uchar> bytes;
+  FILE *f = fopen(fname,"rb");
+  sl_assert(f != NULL);
+  fseek(f,0,SEEK_END);
+  bytes.resize(size_t(ftell(f)));
+  fseek(f,0,SEEK_SET);
+  sl_assert(fread(&bytes[0],1,bytes.size(),f) == bytes.size());
+  fclose(f);
+  return bytes;
+}
+
+static void writeFile(const char *fname,const vector<uchar>& bytes)
+{
+  FILE *f = fopen(fname,"wb");
+  sl_assert(f != NULL);
+  sl_assert(fwrite(&bytes[0],1,bytes.size(),f) == bytes.size());
+  fclose(f);
+}
+
+static bool loadFails(const char *fname)
+{
+  try {
+    TriangleMesh_Ptr m(loadTriangleMesh(fname));
+  } catch (Fatal&) {
+    return true;
+  }
+  return false;
+}
+
+// v2 layout: 64 bytes header, then 32 bytes per section (type, encoding, offset, size, raw size)
+static const size_t c_HeaderSize  = 64;
+static const size_t c_SectionSize = 32;
+
+static uint sectionAt(const vector<uchar>& bytes,uint type)
+{
+  uint num;
+  memcpy(&num,&bytes[24],sizeof(uint));
+  ForIndex(s,num) {
+    uint t;
+    memcpy(&t,&bytes[c_HeaderSize + s * c_SectionSize],sizeof(uint));
+    if (t == type) return s;
+  }
+  return uint(-1);
+}
+
+// -----------
+
+void test_meshformat()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh::MeshFormat_mesh " << endl;
+  cerr << "---------------------------" << endl;
+
+  LibSL::System::Parallel::setNumThreads(4);
+
+  AutoPtr<t_Mesh> torus(makeTorus(64,32));
+  const char *fname = "test_meshformat.mesh";
+
+  // version 1, read by the current reader
+  {
+    MeshFormat_mesh::t_SaveOptions opts;
+    opts.version = 1;
+    MeshFormat_mesh::save(fname,torus.raw(),opts);
+    vector<uchar> bytes = readFile(fname);
+    uint first;
+    memcpy(&first,&bytes[0],sizeof(uint));
+    sl_assert(first == torus->sizeOfVertexData());
+    TriangleMesh_Ptr m(loadTriangleMesh(fname));
+    sl_assert(sameMesh(torus.raw(),m.raw()));
+    sl_assert(!dynamic_cast<TriangleMesh_mapped*>(m.raw())->isMapped());
+  }
+  cerr << "version 1 round trip" << endl;
+
+  // version 2, raw sections are mapped
+  {
+    MeshFormat_mesh::save(fname,torus.raw(),MeshFormat_mesh::t_SaveOptions());
+    TriangleMesh_Ptr m(loadTriangleMesh(fname));
+    sl_assert(sameMesh(torus.raw(),m.raw()));
+    TriangleMesh_mapped *mm = dynamic_cast<TriangleMesh_mapped*>(m.raw());
+    sl_assert(mm->isMapped());
+    sl_assert(mm->adjacency() == NULL);
+  }
+  // version 2, compressed in several chunks, with adjacency
+  {
+    MeshFormat_mesh::t_SaveOptions opts;
+    opts.compress  = true;
+    opts.adjacency = true;
+    opts.chunkSize = 1000;
+    MeshFormat_mesh::save(fname,torus.raw(),opts);
+    TriangleMesh_Ptr m(loadTriangleMesh(fname));
+    sl_assert(sameMesh(torus.raw(),m.raw()));
+    TriangleMesh_mapped *mm = dynamic_cast<TriangleMesh_mapped*>(m.raw());
+    sl_assert(!mm->isMapped());
+    // closed manifold: every neighbor shares the edge, reversed
+    const uint *adj = mm->adjacency();
+    sl_assert(adj != NULL);
+    ForIndex(t,m->numTriangles()) {
+      ForIndex(k,3) {
+        uint n = adj[t * 3 + k];
+        sl_assert(n < m->numTriangles());
+        uint a = m->triangleAt(t)[k],b = m->triangleAt(t)[(k + 1) % 3];
+        bool found = false;
+        ForIndex(l,3) { found = found || (m->triangleAt(n)[l] == b && m->triangleAt(n)[(l + 1) % 3] == a); }
+        sl_assert(found);
+      }
+    }
+  }
+  cerr << "version 2 round trips (raw and compressed)" << endl;
+
+  // truncated and corrupted files are rejected
+  {
+    const char *bad = "test_meshformat_bad.mesh";
+    vector<uchar> bytes = readFile(fname);
+    // cut in the section table, then in the sections
+    writeFile(bad,vector<uchar>(bytes.begin(),bytes.begin() + c_HeaderSize + c_SectionSize / 2));
+    sl_assert(loadFails(bad));
+    writeFile(bad,vector<uchar>(bytes.begin(),bytes.begin() + bytes.size() / 2));
+    sl_assert(loadFails(bad));
+    // section past the end of the file
+    uint sv = sectionAt(bytes,1);
+    sl_assert(sv != uint(-1));
+    vector<uchar> b = bytes;
+    unsigned long long far = bytes.size();
+    memcpy(&b[c_HeaderSize + sv * c_SectionSize + 8],&far,sizeof(far));
+    writeFile(bad,b);
+    sl_assert(loadFails(bad));
+    // wrong decoded size
+    b = bytes;
+    b[c_HeaderSize + sv * c_SectionSize + 24] ^= 4;
+    writeFile(bad,b);
+    sl_assert(loadFails(bad));
+    // damaged compressed stream
+    b = bytes;
+    unsigned long long off;
+    memcpy(&off,&b[c_HeaderSize + sv * c_SectionSize + 8],sizeof(off));
+    uint nchunks;
+    memcpy(&nchunks,&b[size_t(off)],sizeof(uint));
+    ForIndex(i,16) { b[size_t(off) + 8 + nchunks * 4 + 10 + i] ^= 0x5A; }
+    writeFile(bad,b);
+    sl_assert(loadFails(bad));
+    remove(bad);
+  }
+  cerr << "truncated and corrupted files rejected" << endl;
+
+  // indices out of range, in both versions
+  ForRange(version,1,2) {
+    MeshFormat_mesh::t_SaveOptions opts;
+    opts.version = uint(version);
+    AutoPtr<t_Mesh> m(makeTorus(8,4));
+    m->triangleAt(5)[1] = m->numVertices();
+    MeshFormat_mesh::save(fname,m.raw(),opts);
+    sl_assert(loadFails(fname));
+    m->triangleAt(5)[1] = 0;
+    m->surfaceAt(1).triangleIds[3] = m->numTriangles();
+    MeshFormat_mesh::save(fname,m.raw(),opts);
+    sl_assert(loadFails(fname));
+  }
+  cerr << "out of range indices rejected" << endl;
+
+  remove(fname);
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
@@ -0,0 +1,155 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshletSet.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+using namespace std;
+
+// -----------
+
+typedef struct { v3f pos; } t_PosVertex;
+typedef MVF1(mvf_position_3f)  t_PosFormat;
+typedef TriangleMesh_generic<t_PosVertex> t_PosMesh;
+
+static t_PosMesh *makeTorus(uint nu,uint nv)
+{
+  t_PosMesh *mesh = new t_PosMesh(nu * nv,2 * nu * nv,0,AutoPtr<MVF>(MVF::make<t_PosFormat>()));
+  ForIndex(j,nv) {
+    ForIndex(i,nu) {
+      float a = float(i) * 2.0f * float(M_PI) / float(nu), b = float(j) * 2.0f * float(M_PI) / float(nv);
+      mesh->vertexAt(i + j * nu).pos = V3F((1.0f + 0.3f * cosf(b)) * cosf(a),(1.0f + 0.3f * cosf(b)) * sinf(a),0.3f * sinf(b));
+    }
+  }
+  ForIndex(j,nv) {
+    ForIndex(i,nu) {
+      uint a = i + j * nu, b = (i + 1) % nu + j * nu;
+      uint c = (i + 1) % nu + ((j + 1) % nv) * nu, d = i + ((j + 1) % nv) * nu;
+      mesh->triangleAt(2 * a    ) = V3U(a,b,c);
+      mesh->triangleAt(2 * a + 1) = V3U(a,c,d);
+    }
+  }
+  return mesh;
+}
+
+// triangle rotated so that its smallest vertex comes first
+static v3u canonical(v3u t)
+{
+  while (t[0] > t[1] || t[0] > t[2]) {
+    t = V3U(t[1],t[2],t[0]);
+  }
+  return t;
+}
+
+// limits hold and every mesh triangle is in exactly one meshlet
+static void checkCover(const TriangleMesh *mesh,const MeshletSet& ms,uint maxVertices,uint maxTriangles)
+{
+  sl_assert(ms.maxVertices() == maxVertices && ms.maxTriangles() == maxTriangles);
+  vector<v3u> tris;
+  ForIndex(m,ms.numMeshlets()) {
+    const MeshletSet::t_Meshlet& ml = ms.meshletAt(m);
+    sl_assert(ml.numVertices  > 0 && ml.numVertices  <= maxVertices);
+    sl_assert(ml.numTriangles > 0 && ml.numTriangles <= maxTriangles);
+    ForIndex(t,ml.numTriangles) {
+      v3u loc = ms.triangleAt(m,t);
+      ForIndex(c,3) { sl_assert(loc[c] < ml.numVertices); }
+      tris.push_back(canonical(V3U(ms.vertexAt(m,loc[0]),ms.vertexAt(m,loc[1]),ms.vertexAt(m,loc[2]))));
+    }
+  }
+  vector<v3u> ref;
+  ForIndex(t,mesh->numTriangles()) { ref.push_back(canonical(mesh->triangleAt(t))); }
+  sort(tris.begin(),tris.end());
+  sort(ref.begin(),ref.end());
+  sl_assert(tris == ref);
+}
+
+// -----------
+
+void test_meshlets()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh::MeshletSet " << endl;
+  cerr << "---------------------------" << endl;
+
+  // several chunks
+  AutoPtr<t_PosMesh> torus(makeTorus(160,128));
+  MeshletSet ms;
+  ms.build(torus.raw());
+  cerr << sprint("%d triangles, %d meshlets",torus->numTriangles(),ms.numMeshlets()) << endl;
+  checkCover(torus.raw(),ms,64,124);
+  // rebuilding gives the same result
+  MeshletSet again;
+  again.build(torus.raw());
+  sl_assert(again.numMeshlets() == ms.numMeshlets() && again.vertices() == ms.vertices() && again.triangles() == ms.triangles());
+  // other limits
+  MeshletSet small;
+  small.build(torus.raw(),32,16);
+  checkCover(torus.raw(),small,32,16);
+
+  // save / load
+  ms.save("test_meshlets.meshlets");
+  MeshletSet back;
+  back.load("test_meshlets.meshlets");
+  checkCover(torus.raw(),back,64,124);
+  // an offset out of range is rejected, the set is left as it was
+  {
+    FILE *f = NULL;
+    fopen_s(&f,"test_meshlets.meshlets","r+b");
+    sl_assert(f != NULL);
+    uint bad = 0xFFFFFF00u;
+    fseek(f,5 * sizeof(uint),SEEK_SET); // magic, version, limits, count, then the first vertexOffset
+    fwrite(&bad,sizeof(uint),1,f);
+    fclose(f);
+    bool thrown = false;
+    try {
+      back.load("test_meshlets.meshlets");
+    } catch (Fatal&) {
+      thrown = true;
+    }
+    sl_assert(thrown);
+    checkCover(torus.raw(),back,64,124);
+  }
+  remove("test_meshlets.meshlets");
+  cerr << "ok" << endl;
+}
+
+// -----------
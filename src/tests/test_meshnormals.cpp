@@ -0,0 +1,181 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshNormals.h>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+using namespace std;
+using namespace LibSL::Mesh;
+
+// -----------
+
+typedef struct { v3f pos; v3f nrm; v2f uv; v4f tan; } t_TangentVertex;
+typedef MVF4(mvf_position_3f,mvf_normal_3f,mvf_texcoord0_2f,mvf_texcoord1_4f) t_TangentFormat;
+typedef TriangleMesh_generic<t_TangentVertex> t_TangentMesh;
+
+static t_TangentMesh *makeMesh(const v3f *pos,uint nv,const v3u *tris,uint nt)
+{
+  t_TangentMesh *mesh = new t_TangentMesh(nv,nt,0,AutoPtr<MVF>(MVF::make<t_TangentFormat>()));
+  ForIndex(v,nv) {
+    mesh->vertexAt(v).pos = pos[v];
+    mesh->vertexAt(v).nrm = 0;
+    mesh->vertexAt(v).uv  = 0;
+    mesh->vertexAt(v).tan = 0;
+  }
+  ForIndex(t,nt) { mesh->triangleAt(t) = tris[t]; }
+  return mesh;
+}
+
+// corner of the unit cube: three faces in the axis planes and a slanted one
+static t_TangentMesh *makeTetrahedron()
+{
+  const v3f pos[4]  = { V3F(0,0,0),V3F(1,0,0),V3F(0,1,0),V3F(0,0,1) };
+  const v3u tris[4] = { V3U(0,2,1),V3U(0,1,3),V3U(0,3,2),V3U(1,2,3) };
+  return makeMesh(pos,4,tris,4);
+}
+
+// unit cube with shared corners, faces split along different diagonals
+static t_TangentMesh *makeCube()
+{
+  v3f pos[8];
+  ForIndex(v,8) { pos[v] = V3F(float(v & 1),float((v >> 1) & 1),float((v >> 2) & 1)); }
+  const v3u tris[12] = {
+    V3U(0,2,3),V3U(0,3,1), V3U(4,5,7),V3U(4,7,6),   // z = 0, z = 1
+    V3U(0,1,5),V3U(0,5,4), V3U(2,6,7),V3U(2,7,3),   // y = 0, y = 1
+    V3U(0,4,6),V3U(0,6,2), V3U(1,3,7),V3U(1,7,5) }; // x = 0, x = 1
+  return makeMesh(pos,8,tris,12);
+}
+
+// reference: weighted sum of face normals, one vertex at a time
+static v3f referenceNormal(const TriangleMesh *mesh,uint v,MeshNormals::e_Weighting w)
+{
+  v3f sum = 0;
+  ForIndex(t,mesh->numTriangles()) {
+    v3u tri = mesh->triangleAt(t);
+    ForIndex(c,3) {
+      if (tri[c] != v) continue;
+      v3f p0 = mesh->posAt(tri[c]),p1 = mesh->posAt(tri[(c + 1) % 3]),p2 = mesh->posAt(tri[(c + 2) % 3]);
+      v3f n  = cross(p1 - p0,p2 - p0);
+      float weight = 1.0f;
+      if      (w == MeshNormals::Area)  weight = 0.5f * length(n);
+      else if (w == MeshNormals::Angle) weight = acosf(dot(normalize(p1 - p0),normalize(p2 - p0)));
+      sum = sum + normalize(n) * weight;
+    }
+  }
+  return normalize(sum);
+}
+
+static float maxNormalError(const t_TangentMesh *mesh,MeshNormals::e_Weighting w)
+{
+  float err = 0.0f;
+  ForIndex(v,mesh->numVertices()) {
+    float e = length(mesh->vertexAt(v).nrm - referenceNormal(mesh,v,w));
+    if (!(e <= err)) err = e; // NaN propagates
+  }
+  return err;
+}
+
+// -----------
+
+void test_meshnormals()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh::MeshNormals " << endl;
+  cerr << "---------------------------" << endl;
+
+  // tetrahedron, the three weightings against the reference
+  {
+    AutoPtr<t_TangentMesh> tet(makeTetrahedron());
+    MeshNormals::computeNormals(tet.raw(),MeshNormals::Uniform);
+    sl_assert(maxNormalError(tet.raw(),MeshNormals::Uniform) < 1e-5f);
+    MeshNormals::computeNormals(tet.raw(),MeshNormals::Area);
+    sl_assert(maxNormalError(tet.raw(),MeshNormals::Area) < 1e-5f);
+    // area weighted: the axis faces cancel the slanted one but along x
+    sl_assert(length(tet->vertexAt(1).nrm - V3F(1,0,0)) < 1e-5f);
+    MeshNormals::computeNormals(tet.raw(),MeshNormals::Angle);
+    sl_assert(maxNormalError(tet.raw(),MeshNormals::Angle) < 1e-5f);
+    // all weightings agree at the right angled corner
+    sl_assert(length(tet->vertexAt(0).nrm - normalize(V3F(-1,-1,-1))) < 1e-5f);
+  }
+  cerr << "tetrahedron normals match the reference" << endl;
+
+  // cube, angle weighting does not depend on the triangulation
+  {
+    AutoPtr<t_TangentMesh> cube(makeCube());
+    MeshNormals::computeNormals(cube.raw(),MeshNormals::Angle);
+    ForIndex(v,8) {
+      v3f expected = normalize(cube->vertexAt(v).pos * 2.0f - V3F(1,1,1));
+      sl_assert(length(cube->vertexAt(v).nrm - expected) < 1e-5f);
+    }
+    MeshNormals::computeNormals(cube.raw(),MeshNormals::Uniform);
+    sl_assert(maxNormalError(cube.raw(),MeshNormals::Uniform) < 1e-5f);
+    MeshNormals::computeNormals(cube.raw(),MeshNormals::Area);
+    sl_assert(maxNormalError(cube.raw(),MeshNormals::Area) < 1e-5f);
+  }
+  cerr << "cube corner normals along the diagonals" << endl;
+
+  // uv-mapped quad in a tilted plane, u along e0 and v along e1
+  ForIndex(mirror,2) {
+    const v3f e0 = normalize(V3F(1,0,1)),e1 = V3F(0,1,0);
+    const v3f pos[4]  = { V3F(0,0,0),e0 * 2.0f,e0 * 2.0f + e1,e1 };
+    const v3u tris[2] = { V3U(0,1,2),V3U(0,2,3) };
+    AutoPtr<t_TangentMesh> quad(makeMesh(pos,4,tris,2));
+    ForIndex(v,4) {
+      float u = dot(pos[v],e0) / 2.0f,w = dot(pos[v],e1);
+      quad->vertexAt(v).uv = V2F(mirror ? 1.0f - u : u,w);
+    }
+    MeshNormals::computeNormals(quad.raw(),MeshNormals::Angle);
+    MeshNormals::computeTangents(quad.raw());
+    const v3f n = normalize(cross(e0,e1));
+    ForIndex(v,4) {
+      const t_TangentVertex& vx = quad->vertexAt(v);
+      v3f t = V3F(vx.tan[0],vx.tan[1],vx.tan[2]);
+      sl_assert(length(vx.nrm - n) < 1e-5f);
+      sl_assert(fabs(dot(t,vx.nrm)) < 1e-5f);
+      sl_assert(fabs(length(t) - 1.0f) < 1e-5f);
+      // tangent follows increasing u, the bitangent increasing v
+      sl_assert(length(t - (mirror ? -e0 : e0)) < 1e-5f);
+      sl_assert(length(cross(vx.nrm,t) * vx.tan[3] - e1) < 1e-5f);
+    }
+  }
+  cerr << "tangents orthogonal to normals, handedness kept" << endl;
+
+  cerr << "ok" << endl;
+}
@@ -0,0 +1,272 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshOutOfCore.h>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+using namespace std;
+using namespace LibSL::Mesh;
+
+// -----------
+
+// height field over a n x n grid of quads, split along the same diagonal as face fans
+static void makeGrid(uint n,vector<v3f>& _pos,vector<v4u>& _quads)
+{
+  _pos.clear();
+  _quads.clear();
+  ForIndex(j,n + 1) {
+    ForIndex(i,n + 1) {
+      _pos.push_back(V3F(float(i),float(j),0.25f * float(i * j % 7)));
+    }
+  }
+  ForIndex(j,n) {
+    ForIndex(i,n) {
+      uint v = i + j * (n + 1);
+      _quads.push_back(V4U(v,v + 1,v + n + 2,v + n + 1));
+    }
+  }
+}
+
+static void triangulate(const vector<v3f>& pos,const vector<v4u>& quads,vector<v3f>& _corners)
+{
+  _corners.clear();
+  ForIndex(q,quads.size()) {
+    const uint fan[6] = { 0,1,2, 0,2,3 };
+    ForIndex(c,6) {
+      _corners.push_back(pos[quads[q][fan[c]]]);
+    }
+  }
+}
+
+static FILE *create(const char *fname)
+{
+  FILE *f = NULL;
+  fopen_s(&f,fname,"wb");
+  sl_assert(f != NULL);
+  return f;
+}
+
+static void writeOBJ(const char *fname,const vector<v3f>& pos,const vector<v4u>& quads)
+{
+  FILE *f = create(fname);
+  fprintf(f,"# grid\n");
+  ForIndex(v,pos.size()) {
+    fprintf(f,"v %g %g %g\n",pos[v][0],pos[v][1],pos[v][2]);
+  }
+  ForIndex(q,quads.size()) {
+    fprintf(f,"f %u %u %u %u\n",quads[q][0] + 1,quads[q][1] + 1,quads[q][2] + 1,quads[q][3] + 1);
+  }
+  fclose(f);
+}
+
+static void writePLY(const char *fname,const vector<v3f>& pos,const vector<v4u>& quads)
+{
+  FILE *f = create(fname);
+  fprintf(f,"ply\nformat ascii 1.0\ncomment grid\n");
+  fprintf(f,"element vertex %u\nproperty float x\nproperty float y\nproperty float z\n",uint(pos.size()));
+  fprintf(f,"element face %u\nproperty list uchar int vertex_indices\nend_header\n",uint(quads.size()));
+  ForIndex(v,pos.size()) {
+    fprintf(f,"%g %g %g\n",pos[v][0],pos[v][1],pos[v][2]);
+  }
+  ForIndex(q,quads.size()) {
+    fprintf(f,"4 %u %u %u %u\n",quads[q][0],quads[q][1],quads[q][2],quads[q][3]);
+  }
+  fclose(f);
+}
+
+// two solids, the second one unnamed
+static void writeSTLASCII(const char *fname,const vector<v3f>& corners)
+{
+  FILE *f = create(fname);
+  uint ntris  = uint(corners.size() / 3);
+  uint nfirst = ntris / 2;
+  ForIndex(t,ntris) {
+    if (t == 0)      fprintf(f,"solid first part\n");
+    if (uint(t) == nfirst) fprintf(f,"endsolid first part\nsolid\n");
+    fprintf(f,"  facet normal 0 0 1\n    outer loop\n");
+    ForIndex(c,3) {
+      const v3f& p = corners[t * 3 + c];
+      fprintf(f,"      vertex %g %g %g\n",p[0],p[1],p[2]);
+    }
+    fprintf(f,"    endloop\n  endfacet\n");
+  }
+  fprintf(f,"endsolid\n");
+  fclose(f);
+}
+
+static void writeSTLBinary(const char *fname,const vector<v3f>& corners)
+{
+  FILE *f = create(fname);
+  char header[80] = "grid";
+  fwrite(header,1,80,f);
+  uint ntris = uint(corners.size() / 3);
+  fwrite(&ntris,sizeof(uint),1,f);
+  ForIndex(t,ntris) {
+    v3f    nrm  = V3F(0,0,1);
+    ushort attr = 0;
+    fwrite(&nrm,sizeof(v3f),1,f);
+    fwrite(&corners[t * 3],sizeof(v3f),3,f);
+    fwrite(&attr,sizeof(ushort),1,f);
+  }
+  fclose(f);
+}
+
+// reads a whole soup in small batches
+static void readSoup(const char *fname,vector<v3f>& _corners)
+{
+  _corners.clear();
+  TriangleSoupReader_Ptr soup(openTriangleSoup(fname));
+  vector<v3f> batch;
+  while (soup->read(batch,5) > 0) {
+    sl_assert(batch.size() % 3 == 0 && batch.size() <= 15);
+    _corners.insert(_corners.end(),batch.begin(),batch.end());
+  }
+}
+
+static void meshCorners(const TriangleMesh *mesh,vector<v3f>& _corners)
+{
+  _corners.clear();
+  ForIndex(t,mesh->numTriangles()) {
+    ForIndex(c,3) {
+      _corners.push_back(mesh->posAt(mesh->triangleAt(t)[c]));
+    }
+  }
+}
+
+static void checkSoup(const char *fname,const vector<v3f>& expected,bool hasLoader)
+{
+  vector<v3f> corners;
+  readSoup(fname,corners);
+  cerr << "  " << fname << ": " << corners.size() / 3 << " triangles" << endl;
+  sl_assert(corners == expected);
+  if (hasLoader) {
+    TriangleMesh_Ptr mesh(loadTriangleMesh(fname));
+    meshCorners(mesh.raw(),corners);
+    sl_assert(corners == expected);
+  }
+}
+
+// -----------
+
+void test_meshsoup()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh soups and tiles " << endl;
+  cerr << "---------------------------" << endl;
+
+  vector<v3f> pos,expected;
+  vector<v4u> quads;
+  makeGrid(3,pos,quads);
+  triangulate(pos,quads,expected);
+
+  // soups against the expected triangles and the loaders (there is no ply loader)
+  writeOBJ      ("soup_test.obj",pos,quads);
+  writePLY      ("soup_test.ply",pos,quads);
+  writeSTLASCII ("soup_test_ascii.stl",expected);
+  writeSTLBinary("soup_test_binary.stl",expected);
+  checkSoup("soup_test.obj",       expected,true);
+  checkSoup("soup_test.ply",       expected,false);
+  checkSoup("soup_test_ascii.stl", expected,true);
+  checkSoup("soup_test_binary.stl",expected,true);
+
+  // radius 0 welds exact duplicates only
+  {
+    TriangleMesh_Ptr mesh(loadTriangleMesh("soup_test_binary.stl"));
+    sl_assert(mesh->numVertices() == expected.size());
+    mesh->mergeVertices(0.0f);
+    cerr << "  welded " << expected.size() << " corners into " << mesh->numVertices() << " vertices" << endl;
+    sl_assert(mesh->numVertices() == pos.size());
+    vector<v3f> corners;
+    meshCorners(mesh.raw(),corners);
+    sl_assert(corners == expected);
+  }
+
+  // tiles of a larger grid, with a budget forcing splits
+  {
+    vector<v3f> gpos,gcorners;
+    vector<v4u> gquads;
+    makeGrid(64,gpos,gquads);
+    triangulate(gpos,gquads,gcorners);
+    writeSTLBinary("soup_test_grid.stl",gcorners);
+
+    MeshOutOfCore::Params params;
+    params.memoryBudget = 512 * 256; // 256 triangles per tile
+    params.batchSize    = 1000;
+    MeshOutOfCore::TileSet tiles;
+    MeshOutOfCore::buildTiles("soup_test_grid.stl","soup_test_grid",params,tiles);
+    cerr << "  " << gcorners.size() / 3 << " triangles in " << tiles.tiles.size() << " tiles" << endl;
+    sl_assert(tiles.tiles.size() > 8);
+    size_t total = 0;
+    ForIndex(t,tiles.tiles.size()) {
+      const MeshOutOfCore::TileSet::t_Tile& tile = tiles.tiles[t];
+      sl_assert(tile.numTriangles > 0 && tile.numTriangles <= 256);
+      sl_assert(LibSL::System::File::size(tile.fileName.c_str()) == (long long)tile.numTriangles * 3 * (long long)sizeof(v3f));
+      total += tile.numTriangles;
+    }
+    sl_assert(total == gcorners.size() / 3);
+
+    // welded tiles give back all the triangles
+    size_t welded = 0;
+    ForIndex(t,tiles.tiles.size()) {
+      TriangleMesh_Ptr mesh(MeshOutOfCore::processTile(tiles,t,params));
+      welded += mesh.isNull() ? 0 : mesh->numTriangles();
+    }
+    sl_assert(welded == total);
+
+    vector<string> files;
+    ForIndex(t,tiles.tiles.size()) {
+      files.push_back(tiles.tiles[t].fileName);
+    }
+    tiles.clear();
+    sl_assert(tiles.tiles.empty());
+    ForIndex(f,files.size()) {
+      sl_assert(!LibSL::System::File::exists(files[f].c_str()));
+    }
+    remove("soup_test_grid.stl");
+  }
+
+  remove("soup_test.obj");
+  remove("soup_test.ply");
+  remove("soup_test_ascii.stl");
+  remove("soup_test_binary.stl");
+
+  cerr << "ok" << endl;
+}
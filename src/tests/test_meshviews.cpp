@@ -0,0 +1,182 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+using namespace LibSL::Mesh;
+
+// -----------
+
+// position not first and followed by a guard, stride not a multiple of 16
+typedef struct { v3f nrm; v3f pos; float guard; } t_ViewVertex;
+typedef MVF3(mvf_normal_3f,mvf_position_3f,mvf_texcoord0_1f) t_ViewFormat;
+typedef TriangleMesh_generic<t_ViewVertex> t_ViewMesh;
+
+static float urnd() { return float(rand()) / float(RAND_MAX); }
+
+static t_ViewMesh *makeMesh(uint nv)
+{
+  t_ViewMesh *mesh = new t_ViewMesh(nv,1,0,AutoPtr<MVF>(MVF::make<t_ViewFormat>()));
+  ForIndex(v,nv) {
+    mesh->vertexAt(v).nrm   = V3F(float(v),-1.0f,2.0f);
+    mesh->vertexAt(v).pos   = V3F(urnd(),urnd(),urnd()) * 200.0f - V3F(100.0f,50.0f,150.0f);
+    mesh->vertexAt(v).guard = -float(v);
+  }
+  mesh->triangleAt(0) = V3U(0,nv / 2,nv - 1);
+  return mesh;
+}
+
+// scalar reference, NaN are ignored
+static void refBBox(const vector<v3f>& pts,v3f& _mn,v3f& _mx)
+{
+  _mn = v3f( 1e20f);
+  _mx = v3f(-1e20f);
+  ForIndex(i,pts.size()) {
+    ForIndex(c,3) {
+      if (pts[i][c] < _mn[c]) _mn[c] = pts[i][c];
+      if (pts[i][c] > _mx[c]) _mx[c] = pts[i][c];
+    }
+  }
+}
+
+static bool sameBox(const AABox& bx,const v3f& mn,const v3f& mx)
+{
+  ForIndex(c,3) {
+    if (bx.minCorner()[c] != mn[c] || bx.maxCorner()[c] != mx[c]) return false;
+  }
+  return true;
+}
+
+static float maxError(const vector<v3f>& a,const vector<v3f>& b)
+{
+  float err = 0.0f;
+  ForIndex(i,a.size()) {
+    ForIndex(c,3) {
+      float e = fabs(a[i][c] - b[i][c]) / max(1.0f,fabs(b[i][c]));
+      if (!(e <= err)) err = e; // propagates NaN
+    }
+  }
+  return err;
+}
+
+static void checkCount(uint nv)
+{
+  AutoPtr<t_ViewMesh> mesh(makeMesh(nv));
+  sl_assert(mesh->positions().size() == nv);
+
+  // strided, block parallel kernels against a plain loop
+  vector<v3f> pts(nv);
+  ForIndex(v,nv) { pts[v] = mesh->vertexAt(v).pos; }
+  v3f mn,mx;
+  refBBox(pts,mn,mx);
+  sl_assert(sameBox(mesh->computeBBox(),mn,mx));
+
+  // per-vertex fallback, no contiguous positions
+  AutoPtr<MVF> mvf(MVF::make<t_ViewFormat>());
+  AutoPtr<TriangleMesh_generic<Array<float> > > dyn(mesh->dynamicCast<Array<float> >(mvf.raw(),mvf.raw()));
+  sl_assert(dyn->positions().empty());
+  sl_assert(sameBox(dyn->computeBBox(),mn,mx));
+
+  m4x4f trsf = translationMatrix(V3F(3.0f,-7.0f,11.0f))
+             * quatf(V3F(1.0f,2.0f,3.0f),0.7f).toMatrix()
+             * scaleMatrix(V3F(2.0f,0.5f,1.5f));
+  trsf.at(0,1) += 0.25f; // shear, no symmetric terms
+  vector<v3f> ref(nv);
+  ForIndex(v,nv) { ref[v] = trsf.mulPoint(pts[v]); }
+
+  mesh->applyTransform(trsf);
+  dyn ->applyTransform(trsf);
+  vector<v3f> got(nv),gotDyn(nv);
+  ForIndex(v,nv) {
+    got   [v] = mesh->vertexAt(v).pos;
+    gotDyn[v] = dyn ->posAt(v);
+  }
+  float err    = maxError(got,ref);
+  float errDyn = maxError(gotDyn,ref);
+  cerr << "  " << nv << " vertices, transform error " << err << " / " << errDyn << endl;
+  sl_assert(err    < 1e-6f);
+  sl_assert(errDyn < 1e-6f);
+
+  // neighbouring attributes are left alone
+  ForIndex(v,nv) {
+    sl_assert(mesh->vertexAt(v).nrm   == V3F(float(v),-1.0f,2.0f));
+    sl_assert(mesh->vertexAt(v).guard == -float(v));
+  }
+
+  // box of the transformed positions, cache invalidated by applyTransform
+  refBBox(got,mn,mx);
+  sl_assert(sameBox(mesh->bbox(),mn,mx));
+}
+
+// -----------
+
+void test_meshviews()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh position kernels " << endl;
+  cerr << "---------------------------" << endl;
+
+  LibSL::System::Parallel::setNumThreads(4);
+
+  srand(41);
+  // counts off the SIMD width, and spanning several parallel blocks
+  const uint counts[] = { 1,2,3,5,7,13,(1u << 14) + 3,(2u << 14) + 5 };
+  ForIndex(i,sizeof(counts) / sizeof(counts[0])) {
+    checkCount(counts[i]);
+  }
+
+  // NaN positions do not reach the box
+  {
+    AutoPtr<t_ViewMesh> mesh(makeMesh(7));
+    vector<v3f> pts(7);
+    ForIndex(v,7) { pts[v] = mesh->vertexAt(v).pos; }
+    mesh->vertexAt(3).pos[1] = sqrtf(-1.0f);
+    pts[3][1] = mesh->vertexAt(3).pos[1];
+    v3f mn,mx;
+    refBBox(pts,mn,mx);
+    sl_assert(sameBox(mesh->computeBBox(),mn,mx));
+  }
+
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
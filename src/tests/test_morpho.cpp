@@ -0,0 +1,155 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Geometry/Morpho.h>
+
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+using namespace LibSL::Geometry;
+
+// -----------
+
+static void randomArray(Array2D<bool>& _a,int xs,int ys,float density)
+{
+  _a.allocate(xs,ys);
+  ForArray2D(_a,i,j) {
+    _a.at(i,j) = (float(rand()) / float(RAND_MAX) < density);
+  }
+}
+
+static bool sameAsArray(const Morpho::BitMask& m,const Array2D<bool>& a)
+{
+  Array2D<bool> b;
+  m.toArray(b);
+  if (b.xsize() != a.xsize() || b.ysize() != a.ysize()) return false;
+  ForArray2D(a,i,j) {
+    if (b.at(i,j) != a.at(i,j)) return false;
+  }
+  // padding bits of the last word stay clear
+  ForIndex(j,m.ysize()) {
+    if (m.row(j)[m.wordsPerRow() - 1] & ~m.lastWordMask()) return false;
+  }
+  return true;
+}
+
+// word-parallel operators give the results of the Array2D<bool> ones
+static void checkWidth(int xs,int ys)
+{
+  Morpho::Morpho morpho;
+  // the byte versions use a propagated distance field which is not always exact
+  // (e.g. at radius 2.9 it may miss the (2,2) offsets), the radii avoid these cases
+  const float radii[4] = { 1.0f, 1.5f, 2.5f, 4.3f };
+  const float densities[2] = { 0.2f, 0.8f };
+  ForIndex(d,2) {
+    ForIndex(r,4) {
+      Array2D<bool> a;
+      randomArray(a,xs,ys,densities[d]);
+      Morpho::BitMask m(a);
+      sl_assert(sameAsArray(m,a));
+      // dilate
+      Array2D<bool> ad = a;
+      Morpho::BitMask md = m;
+      morpho.dilate(ad,radii[r]);
+      morpho.dilate(md,radii[r]);
+      sl_assert(sameAsArray(md,ad));
+      // erode
+      Array2D<bool> ae = a;
+      Morpho::BitMask me = m;
+      morpho.erode(ae,radii[r]);
+      morpho.erode(me,radii[r]);
+      sl_assert(sameAsArray(me,ae));
+      // open / close
+      Array2D<bool> ao = a, ac = a;
+      Morpho::BitMask mo = m, mc = m;
+      morpho.open (ao,radii[r]); morpho.open (mo,radii[r]);
+      morpho.close(ac,radii[r]); morpho.close(mc,radii[r]);
+      sl_assert(sameAsArray(mo,ao));
+      sl_assert(sameAsArray(mc,ac));
+    }
+    // set operations and negation
+    Array2D<bool> a,b,u,n,x;
+    randomArray(a,xs,ys,densities[d]);
+    randomArray(b,xs,ys,0.5f);
+    u.allocate(xs,ys);
+    x.allocate(xs,ys);
+    morpho.Union(a,b,u);
+    morpho.Intersection(a,b,x);
+    n = a;
+    morpho.negate(n);
+    Morpho::BitMask ma(a),mb(b),mu,mx,mn(a);
+    morpho.Union(ma,mb,mu);
+    morpho.Intersection(ma,mb,mx);
+    morpho.negate(mn);
+    sl_assert(sameAsArray(mu,u));
+    sl_assert(sameAsArray(mx,x));
+    sl_assert(sameAsArray(mn,n));
+    // hit and miss
+    int8_t kernel[3][3] = { { 0, 0, 0 }, { -1, 1, -1 }, { 1, 1, 1 } };
+    Array2D<bool> h = a;
+    Morpho::BitMask mh(a);
+    morpho.hit_and_miss(h,kernel);
+    morpho.hit_and_miss(mh,kernel);
+    sl_assert(sameAsArray(mh,h));
+  }
+}
+
+// -----------
+
+void test_morpho()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::Geometry::Morpho " << endl;
+  cerr << "---------------------------" << endl;
+
+  srand(28);
+  // widths around a word boundary, one and several row bands
+  const uint threads[2] = { 1, 4 };
+  ForIndex(t,2) {
+    LibSL::System::Parallel::setNumThreads(threads[t]);
+    checkWidth(63,47);
+    checkWidth(64,53);
+    checkWidth(65,61);
+    cerr << "bit masks match byte masks with " << threads[t] << " thread(s)" << endl;
+  }
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
+
+// -----------
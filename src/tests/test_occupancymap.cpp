@@ -0,0 +1,201 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/DataStructures/OccupancyMap.h>
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <cstdlib>
+using namespace std;
+using namespace LibSL::DataStructures;
+
+// -----------
+
+// The former dense grid of sets, for reference
+class SetGrid : public OccupancyMapGrid
+{
+public:
+  Array3D<std::set<uint> > m_Map;
+
+  SetGrid(const v3i& size,const v3f& scale) : OccupancyMapGrid(size,scale) { m_Map.allocate(size[0],size[1],size[2]); }
+
+  void insert(const v3f& pos,float radius,uint key)
+  {
+    Tuple<v3i,2> minmax = occupancyBox(pos,radius);
+    ForRange(x,minmax[0][0],minmax[1][0]) { ForRange(y,minmax[0][1],minmax[1][1]) { ForRange(z,minmax[0][2],minmax[1][2]) {
+      m_Map.at(x,y,z).insert(key);
+    } } }
+  }
+
+  void remove(const v3f& pos,float radius,uint key)
+  {
+    Tuple<v3i,2> minmax = occupancyBox(pos,radius);
+    ForRange(x,minmax[0][0],minmax[1][0]) { ForRange(y,minmax[0][1],minmax[1][1]) { ForRange(z,minmax[0][2],minmax[1][2]) {
+      m_Map.at(x,y,z).erase(key);
+    } } }
+  }
+
+  void getProximitySet(const v3f& pos,float radius,std::set<uint>& _set) const
+  {
+    Tuple<v3i,2> minmax = occupancyBox(pos,radius);
+    ForRange(x,minmax[0][0],minmax[1][0]) { ForRange(y,minmax[0][1],minmax[1][1]) { ForRange(z,minmax[0][2],minmax[1][2]) {
+      _set.insert(m_Map.at(x,y,z).begin(),m_Map.at(x,y,z).end());
+    } } }
+  }
+};
+
+static const v3i c_Size  = V3I(16,12,10);
+static const v3f c_Scale = V3F(1.0f,1.0f,0.5f);
+
+// positions partly outside the grid, to exercise clamping
+static v3f randomPos()
+{
+  return V3F(-3.0f + 22.0f * rnd(),-3.0f + 18.0f * rnd(),-6.0f + 32.0f * rnd());
+}
+
+template <class T_Map>
+static bool sameCells(const T_Map& m,const SetGrid& ref)
+{
+  ForIndex(z,c_Size[2]) { ForIndex(y,c_Size[1]) { ForIndex(x,c_Size[0]) {
+    typename T_Map::t_Range r = m.cell(V3I(x,y,z));
+    if (std::set<uint>(r.begin(),r.end()) != ref.m_Map.at(x,y,z)) return false;
+  } } }
+  return true;
+}
+
+static bool sameMap(const Array3D<std::set<uint> >& m,const SetGrid& ref)
+{
+  ForIndex(z,c_Size[2]) { ForIndex(y,c_Size[1]) { ForIndex(x,c_Size[0]) {
+    if (m.at(x,y,z) != ref.m_Map.at(x,y,z)) return false;
+  } } }
+  return true;
+}
+
+template <class T_Map>
+static bool sameQueries(const T_Map& m,const SetGrid& ref)
+{
+  ForIndex(q,200) {
+    v3f   p = randomPos();
+    float r = 3.0f * rnd();
+    std::set<uint> expected;
+    ref.getProximitySet(p,r,expected);
+    std::vector<uint> items;
+    m.getProximity(p,r,items);
+    if (std::vector<uint>(expected.begin(),expected.end()) != items) return false;
+  }
+  return true;
+}
+
+// -----------
+
+void test_occupancymap()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::DataStructures::OccupancyMap " << endl;
+  cerr << "---------------------------" << endl;
+
+  srand(33);
+  LibSL::System::Parallel::setNumThreads(4);
+
+  // elements, some keys are inserted twice at the same place
+  std::vector<v3f>   pos;
+  std::vector<float> radius;
+  std::vector<uint>  keys;
+  ForIndex(i,600) {
+    pos   .push_back(randomPos());
+    radius.push_back(2.5f * rnd());
+    keys  .push_back(uint(i));
+    if (i % 7 == 0) {
+      pos.push_back(pos.back()); radius.push_back(radius.back()); keys.push_back(keys.back());
+    }
+  }
+  SetGrid ref(c_Size,c_Scale);
+  ForIndex(i,keys.size()) {
+    ref.insert(pos[i],radius[i],keys[i]);
+  }
+
+  // static CSR map
+  StaticOccupancyMap<uint> smap(c_Size,c_Scale);
+  smap.build(pos,radius,keys);
+  sl_assert(sameCells(smap,ref));
+  sl_assert(sameQueries(smap,ref));
+
+  // hashed map, one by one and in parallel
+  HashedOccupancyMap<uint> hmap(c_Size,c_Scale);
+  ForIndex(i,keys.size() / 2) {
+    hmap.insert(pos[i],radius[i],keys[i]);
+  }
+  uint half = uint(keys.size() / 2);
+  hmap.insert(uint(keys.size()) - half,&pos[half],&radius[half],&keys[half]);
+  sl_assert(sameCells(hmap,ref));
+  sl_assert(sameQueries(hmap,ref));
+
+  // dense snapshot, cached until modified
+  OccupancyMap<uint> omap(c_Size,c_Scale);
+  omap.insert(pos,radius,keys);
+  const Array3D<std::set<uint> > *snapshot = &omap.map();
+  sl_assert(sameMap(*snapshot,ref));
+  sl_assert(&omap.map() == snapshot);
+  cerr << "static, hashed and dense maps agree with the set grid" << endl;
+
+  // removals, a single remove erases a key inserted twice
+  ForIndex(i,keys.size()) {
+    if (i % 3 == 0) {
+      ref .remove(pos[i],radius[i],keys[i]);
+      hmap.remove(pos[i],radius[i],keys[i]);
+      omap.remove(pos[i],radius[i],keys[i]);
+    }
+  }
+  sl_assert(sameCells(hmap,ref));
+  sl_assert(sameQueries(hmap,ref));
+  sl_assert(sameMap(omap.map(),ref));
+  // insertion after a snapshot
+  ref .insert(V3F(4,4,4),1.0f,1000);
+  omap.insert(V3F(4,4,4),1.0f,1000);
+  sl_assert(sameMap(omap.map(),ref));
+  omap.clear();
+  sl_assert(omap.map().at(4,4,8).empty());
+  cerr << "removals and snapshot invalidation checked" << endl;
+
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,179 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/System/Profiling.h>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+using namespace LibSL::System;
+
+// -----------
+
+static const Profiling::ZoneStats *findPath(const vector<Profiling::ZoneStats>& stats,const char *path)
+{
+  ForIndex(s,stats.size()) {
+    if (stats[s].path == path) return &stats[s];
+  }
+  return NULL;
+}
+
+static long long countPath(const char *path)
+{
+  vector<Profiling::ZoneStats> stats;
+  Profiling::statistics(stats);
+  const Profiling::ZoneStats *z = findPath(stats,path);
+  return z != NULL ? z->count : 0;
+}
+
+// -----------
+
+void test_profiling()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::System::Profiling " << endl;
+  cerr << "---------------------------" << endl;
+
+  bool enabled = Profiling::enabled();
+  Profiling::setEnabled(true);
+  Profiling::reset();
+
+  // registry
+  Profiling::t_Zone outer = Profiling::zone("test_outer");
+  Profiling::t_Zone inner = Profiling::zone("test_inner");
+  sl_assert(outer != inner);
+  sl_assert(Profiling::zone("test_outer") == outer);
+  sl_assert(Profiling::zone(std::string("test_inner").c_str()) == inner);
+
+  // nested scopes are aggregated per call path
+  ForIndex(i,10) {
+    Profiling::Scope so(outer);
+    ForIndex(j,3) {
+      Profiling::Scope si(inner);
+    }
+  }
+  {
+    Profiling::Scope si(inner);
+  }
+  vector<Profiling::ZoneStats> stats;
+  Profiling::statistics(stats);
+  const Profiling::ZoneStats *o  = findPath(stats,"test_outer");
+  const Profiling::ZoneStats *oi = findPath(stats,"test_outer/test_inner");
+  const Profiling::ZoneStats *i  = findPath(stats,"test_inner");
+  sl_assert(o != NULL && oi != NULL && i != NULL);
+  sl_assert(o->count == 10 && o->depth == 0);
+  sl_assert(oi->count == 30 && oi->depth == 1);
+  sl_assert(i->count == 1);
+  sl_assert(oi->min <= oi->p99 && oi->p99 <= oi->max && o->total >= oi->total);
+  cerr << "nested scopes aggregated" << endl;
+
+  // rings overflow several times, on several threads, without losing measures
+  const int N = 100000;
+  Profiling::t_Zone ovf = Profiling::zone("test_overflow");
+  Parallel::setNumThreads(4);
+  Parallel::forIndex(0,N,[&](int) {
+    Profiling::Scope s(ovf);
+  },1024);
+  Parallel::setNumThreads(0);
+  sl_assert(countPath("test_overflow") == N);
+  cerr << N << " measures recorded across ring drains" << endl;
+
+  // timers report as zones, nothing is recorded while disabled
+  {
+    Time::Timer tm("test_timer",false);
+    ForIndex(n,5) {
+      tm.start();
+      tm.stop();
+    }
+    Time::Timings tms("test_timings");
+    tms.measure("test_measure_a");
+    tms.measure("test_measure_b");
+    tms.measure(sprint("test_measure_%c",'a'));
+    Profiling::setEnabled(false);
+    tm.start();
+    tm.stop();
+    tms.measure("test_measure_b");
+    Profiling::setEnabled(true);
+  }
+  sl_assert(countPath("test_timer") == 5);
+  sl_assert(countPath("test_measure_a") == 2);
+  sl_assert(countPath("test_measure_b") == 1);
+  cerr << "timers and timings recorded" << endl;
+
+  // Chrome trace: one complete event per measure, names escaped
+  {
+    Profiling::Scope s(Profiling::zone("test_\"quoted\\"));
+  }
+  Profiling::statistics(stats);
+  long long total = 0;
+  ForIndex(z,stats.size()) {
+    total += stats[z].count;
+  }
+  Profiling::saveChromeTrace("test_profiling.json");
+  FILE *f = NULL;
+  fopen_s(&f,"test_profiling.json","rb");
+  sl_assert(f != NULL);
+  string json;
+  char   buf[4096];
+  size_t n;
+  while ((n = fread(buf,1,sizeof(buf),f)) > 0) {
+    json.append(buf,n);
+  }
+  fclose(f);
+  remove("test_profiling.json");
+  const char *head = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  sl_assert(json.compare(0,strlen(head),head) == 0);
+  sl_assert(json.find("],\"otherData\":{\"dropped\":0}}") != string::npos);
+  long long events = 0;
+  for (size_t at = json.find("\"ph\":\"X\"") ; at != string::npos ; at = json.find("\"ph\":\"X\"",at + 1)) {
+    events ++;
+  }
+  sl_assert(events == total);
+  sl_assert(json.find("\"name\":\"test_\\\"quoted\\\\\"") != string::npos);
+  cerr << "trace holds " << events << " events" << endl;
+
+  Profiling::reset();
+  Profiling::setEnabled(enabled);
+
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,114 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+
+#include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+using namespace LibSL::CppHelpers;
+
+// -----------
+
+// parallel loop reporting its progress from every worker
+static long long progressLoop(uint n)
+{
+  std::atomic<long long> sum(0);
+  Console::progressBarInit(n);
+  LibSL::System::Parallel::forIndex(0,int(n),[&](int i) {
+    sum.fetch_add(i,std::memory_order_relaxed);
+    Console::progressBarUpdate();
+  },64);
+  Console::progressBarEnd();
+  Console::progressTextInit(n);
+  LibSL::System::Parallel::forChunks(0,int(n),[&](int first,int last) {
+    Console::progressTextAdvance(uint(last - first));
+  },256);
+  Console::progressTextEnd();
+  return sum.load();
+}
+
+// -----------
+
+void test_progress()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::CppHelpers::Console progress " << endl;
+  cerr << "---------------------------" << endl;
+
+  Console::e_ProgressMode mode = Console::progressMode();
+  LibSL::System::Parallel::setNumThreads(4);
+  const uint N = 200000;
+
+  // silent, as selected by LIBSL_PROGRESS=silent
+  Console::progressSetMode(Console::ProgressSilent);
+  sl_assert(progressLoop(N) == (long long)N * (N - 1) / 2);
+  // the reporter was started, it joins, and restarts with the next progress
+  sl_assert(Console::progressShutdown());
+  sl_assert(!Console::progressShutdown());
+  sl_assert(progressLoop(N) == (long long)N * (N - 1) / 2);
+  sl_assert(Console::progressShutdown());
+  cerr << "silent progress completed, reporter joined" << endl;
+
+  // machine output: the final line holds the updates of all workers
+  FILE *out = tmpfile();
+  sl_assert(out != NULL);
+  Console::progressSetMode(Console::ProgressMachine,out);
+  progressLoop(N);
+  Console::progressSetMode(mode);
+  sl_assert(Console::progressShutdown());
+  rewind(out);
+  char line[512];
+  int  numDone = 0;
+  while (fgets(line,sizeof(line),out) != NULL) {
+    if (strstr(line,"\"done\":true") != NULL) {
+      sl_assert(strstr(line,sprint("\"value\":%u,\"max\":%u",N,N)) != NULL);
+      numDone ++;
+    }
+  }
+  fclose(out);
+  sl_assert(numDone == 2);
+  cerr << "machine progress reports every update" << endl;
+
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,108 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Image/Resize.h>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+using namespace std;
+
+// -----------
+
+// Hard edge: black on the left half, white on the right half
+template <typename T_Type>
+static vector<T_Type> edge(uint w,uint h,uint numComp,T_Type black,T_Type white)
+{
+  vector<T_Type> img(size_t(w) * h * numComp);
+  ForIndex(j,h) { ForIndex(i,w) { ForIndex(c,numComp) {
+    img[(size_t(j) * w + i) * numComp + c] = (uint(i) < w / 2) ? black : white;
+  } } }
+  return img;
+}
+
+// Filters with negative lobes overshoot on both sides of the edge, the result
+// must saturate instead of wrapping around, and match the rounded float result
+template <typename T_Type>
+static void checkEdge(uint sw,uint dw,uint numComp,e_ResizeFilter filter,T_Type black,T_Type white)
+{
+  const uint h = 4;
+  vector<T_Type> src = edge<T_Type>(sw,h,numComp,black,white);
+  vector<T_Type> dst(size_t(dw) * h * numComp);
+  resizeRaw(&src[0],sw,h,&dst[0],dw,h,numComp,filter);
+  vector<float> fsrc(src.begin(),src.end());
+  vector<float> fdst(dst.size());
+  resizeRaw(&fsrc[0],sw,h,&fdst[0],dw,h,numComp,filter);
+  float mid = (float(black) + float(white)) / 2.0f;
+  bool overshoot = false;
+  ForIndex(n,dst.size()) {
+    uint i = uint(n / numComp) % dw;
+    float f = fdst[n];
+    overshoot = overshoot || f < float(black) || f > float(white);
+    // left of the edge stays dark, right of the edge stays bright
+    if (float(i) + 0.5f < float(dw) * 0.5f - 0.5f * float(dw) / float(sw) - 3.0f) sl_assert(float(dst[n]) < mid);
+    if (float(i) + 0.5f > float(dw) * 0.5f + 0.5f * float(dw) / float(sw) + 3.0f) sl_assert(float(dst[n]) > mid);
+    float expected = min(float(white),max(float(black),floor(f + 0.5f)));
+    sl_assert(fabs(float(dst[n]) - expected) <= 1.0f);
+  }
+  sl_assert(overshoot);
+}
+
+// -----------
+
+void test_resize()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::Image::Resize " << endl;
+  cerr << "---------------------------" << endl;
+
+  const e_ResizeFilter filters[2] = { ResizeLanczos3, ResizeMitchell };
+  ForIndex(f,2) {
+    // uchar (SSE kernels) and ushort (through floats), up and down
+    checkEdge<uchar> (64,150,1,filters[f],uchar(0),uchar(255));
+    checkEdge<uchar> (64,23 ,4,filters[f],uchar(0),uchar(255));
+    checkEdge<ushort>(64,150,1,filters[f],ushort(0),ushort(65535));
+    checkEdge<ushort>(64,23 ,3,filters[f],ushort(0),ushort(65535));
+    checkEdge<short> (40,97 ,2,filters[f],short(-32768),short(32767));
+  }
+  cerr << "hard edges saturate" << endl;
+
+  cerr << "ok" << endl;
+}
+
+// -----------
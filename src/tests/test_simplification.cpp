@@ -0,0 +1,204 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshSimplification.h>
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+// -----------
+
+typedef struct { v3f pos; } t_PosVertex;
+typedef MVF1(mvf_position_3f)  t_PosFormat;
+typedef TriangleMesh_generic<t_PosVertex> t_PosMesh;
+
+// nu x nv quads on a torus (closed) or a plane (open)
+static t_PosMesh *makeGrid(uint nu,uint nv,bool closed)
+{
+  uint vu = closed ? nu : nu + 1, vv = closed ? nv : nv + 1;
+  t_PosMesh *mesh = new t_PosMesh(vu * vv,2 * nu * nv,0,AutoPtr<MVF>(MVF::make<t_PosFormat>()));
+  ForIndex(j,vv) {
+    ForIndex(i,vu) {
+      float u = float(i) / float(nu), v = float(j) / float(nv);
+      // small bumps so that the quadrics are not all flat
+      float h = 0.02f * sinf(u * 37.0f) * cosf(v * 23.0f);
+      if (closed) {
+        float a = u * 2.0f * float(M_PI), b = v * 2.0f * float(M_PI), r = 0.3f + h;
+        mesh->vertexAt(i + j * vu).pos = V3F((1.0f + r * cosf(b)) * cosf(a),(1.0f + r * cosf(b)) * sinf(a),r * sinf(b));
+      } else {
+        mesh->vertexAt(i + j * vu).pos = V3F(u,v,h);
+      }
+    }
+  }
+  ForIndex(j,nv) {
+    ForIndex(i,nu) {
+      uint a = i + j * vu;
+      uint b = (i + 1) % vu + j * vu;
+      uint c = (i + 1) % vu + ((j + 1) % vv) * vu;
+      uint d = i + ((j + 1) % vv) * vu;
+      mesh->triangleAt(2 * (i + j * nu)    ) = V3U(a,b,c);
+      mesh->triangleAt(2 * (i + j * nu) + 1) = V3U(a,c,d);
+    }
+  }
+  return mesh;
+}
+
+// no degenerate triangle, every directed edge used once, and on a closed
+// mesh every edge has its twin: the surface is a consistently oriented manifold
+static void checkManifold(const TriangleMesh *mesh,bool closed)
+{
+  map<pair<uint,uint>,uint> edges;
+  ForIndex(t,mesh->numTriangles()) {
+    v3u tri = mesh->triangleAt(t);
+    sl_assert(tri[0] != tri[1] && tri[1] != tri[2] && tri[2] != tri[0]);
+    ForIndex(c,3) {
+      sl_assert(tri[c] < mesh->numVertices());
+      edges[make_pair(tri[c],tri[(c + 1) % 3])]++;
+    }
+  }
+  for (map<pair<uint,uint>,uint>::const_iterator E = edges.begin(); E != edges.end(); E++) {
+    sl_assert(E->second == 1);
+    if (closed) {
+      sl_assert(edges.find(make_pair(E->first.second,E->first.first)) != edges.end());
+    }
+  }
+}
+
+// number of border vertices of the open grid found, at the same position, in the mesh
+static uint numBorderKept(const TriangleMesh *mesh,uint n)
+{
+  vector<v3f> pos;
+  ForIndex(v,mesh->numVertices()) { pos.push_back(mesh->posAt(v)); }
+  uint kept = 0;
+  ForIndex(j,n + 1) {
+    ForIndex(i,n + 1) {
+      if (i != 0 && j != 0 && uint(i) != n && uint(j) != n) continue;
+      v3f p = V3F(float(i) / float(n),float(j) / float(n),0.0f);
+      ForIndex(v,pos.size()) {
+        if (fabs(pos[v][0] - p[0]) < 1e-6f && fabs(pos[v][1] - p[1]) < 1e-6f) { kept++; break; }
+      }
+    }
+  }
+  return kept;
+}
+
+// same vertices, in the same order, and same triangles
+static bool sameMesh(const TriangleMesh *a,const TriangleMesh *b)
+{
+  if (a->numVertices() != b->numVertices() || a->numTriangles() != b->numTriangles()) return false;
+  ForIndex(v,a->numVertices()) {
+    if (a->posAt(v) != b->posAt(v)) return false;
+  }
+  ForIndex(t,a->numTriangles()) {
+    if (a->triangleAt(t) != b->triangleAt(t)) return false;
+  }
+  return true;
+}
+
+// -----------
+
+void test_simplification()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh::MeshSimplification " << endl;
+  cerr << "---------------------------" << endl;
+
+  // closed: reaches the target and stays manifold
+  {
+    AutoPtr<t_PosMesh> torus(makeGrid(64,32,true));
+    MeshSimplification::Params params;
+    params.targetTriangles = torus->numTriangles() / 20;
+    TriangleMesh_Ptr s(MeshSimplification::simplify(torus.raw(),params));
+    cerr << sprint("torus %d -> %d triangles",torus->numTriangles(),s->numTriangles()) << endl;
+    sl_assert(s->numTriangles() <= params.targetTriangles && s->numTriangles() >= params.targetTriangles - 2);
+    checkManifold(s.raw(),true);
+    // the chain goes down in order, through the same kind of surfaces
+    vector<uint> targets;
+    targets.push_back(2048); targets.push_back(1024); targets.push_back(256);
+    vector<TriangleMesh_Ptr> lods;
+    MeshSimplification::lodChain(torus.raw(),targets,lods,params);
+    sl_assert(lods.size() == targets.size());
+    ForIndex(k,lods.size()) {
+      sl_assert(lods[k]->numTriangles() <= targets[k]);
+      checkManifold(lods[k].raw(),true);
+    }
+  }
+  // open: borders move unless locked
+  {
+    const uint n = 32;
+    AutoPtr<t_PosMesh> grid(makeGrid(n,n,false));
+    MeshSimplification::Params params;
+    params.targetTriangles = 64;
+    TriangleMesh_Ptr free(MeshSimplification::simplify(grid.raw(),params));
+    checkManifold(free.raw(),false);
+    sl_assert(free->numTriangles() <= params.targetTriangles);
+    params.lockBorders = true;
+    TriangleMesh_Ptr locked(MeshSimplification::simplify(grid.raw(),params));
+    checkManifold(locked.raw(),false);
+    uint nfree = numBorderKept(free.raw(),n), nlocked = numBorderKept(locked.raw(),n);
+    cerr << sprint("grid border vertices kept: %d free, %d locked (of %d)",nfree,nlocked,4 * n) << endl;
+    sl_assert(nlocked == 4 * n);
+    sl_assert(nfree < 4 * n);
+  }
+  // cluster pre-pass: the result does not depend on the number of threads
+  {
+    AutoPtr<t_PosMesh> torus(makeGrid(128,64,true));
+    MeshSimplification::Params params;
+    params.targetTriangles  = torus->numTriangles() / 10;
+    params.prePassTriangles = torus->numTriangles() / 4;
+    LibSL::System::Parallel::setNumThreads(1);
+    TriangleMesh_Ptr s1(MeshSimplification::simplify(torus.raw(),params));
+    LibSL::System::Parallel::setNumThreads(4);
+    TriangleMesh_Ptr s4(MeshSimplification::simplify(torus.raw(),params));
+    LibSL::System::Parallel::setNumThreads(0);
+    checkManifold(s1.raw(),true);
+    sl_assert(sameMesh(s1.raw(),s4.raw()));
+    // the pre-pass also runs on a single thread
+    params.prePassTriangles = 0;
+    TriangleMesh_Ptr s0(MeshSimplification::simplify(torus.raw(),params));
+    sl_assert(!sameMesh(s0.raw(),s1.raw()));
+    cerr << sprint("pre-pass: %d triangles with 1 and 4 threads",s1->numTriangles()) << endl;
+  }
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,246 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshEditing.h>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+using namespace std;
+using namespace LibSL::Mesh;
+
+// -----------
+
+typedef struct { v3f pos; v3f nrm; v2f uv; } t_Vertex;
+typedef MVF3(mvf_position_3f,mvf_normal_3f,mvf_texcoord0_2f) t_Format;
+typedef TriangleMesh_generic<t_Vertex> t_Mesh;
+
+// unit sphere, normals are the positions and uvs their (x,y): both are
+// linear in the position, interpolated values are known at cut vertices
+static t_Mesh *makeSphere(uint nu,uint nv)
+{
+  uint nverts = nu * (nv - 1) + 2;
+  t_Mesh *mesh = new t_Mesh(nverts,2 * nu * (nv - 1),0,AutoPtr<MVF>(MVF::make<t_Format>()));
+  ForIndex(j,nv - 1) {
+    float b = float(M_PI) * float(j + 1) / float(nv);
+    ForIndex(i,nu) {
+      float a = 2.0f * float(M_PI) * float(i) / float(nu);
+      mesh->vertexAt(i + j * nu).pos = V3F(sinf(b) * cosf(a),sinf(b) * sinf(a),cosf(b));
+    }
+  }
+  uint north = nverts - 2,south = nverts - 1;
+  mesh->vertexAt(north).pos = V3F(0,0, 1);
+  mesh->vertexAt(south).pos = V3F(0,0,-1);
+  ForIndex(v,nverts) {
+    mesh->vertexAt(v).nrm = mesh->vertexAt(v).pos;
+    mesh->vertexAt(v).uv  = V2F(mesh->vertexAt(v).pos[0],mesh->vertexAt(v).pos[1]);
+  }
+  uint t = 0;
+  ForIndex(i,nu) {
+    uint i1 = (i + 1) % nu;
+    mesh->triangleAt(t++) = V3U(north,i,i1);
+    mesh->triangleAt(t++) = V3U(south,i1 + (nv - 2) * nu,i + (nv - 2) * nu);
+    ForIndex(j,nv - 2) {
+      uint a = i + j * nu,b = i1 + j * nu,c = i1 + (j + 1) * nu,d = i + (j + 1) * nu;
+      mesh->triangleAt(t++) = V3U(a,d,c);
+      mesh->triangleAt(t++) = V3U(a,c,b);
+    }
+  }
+  return mesh;
+}
+
+// unit cube [0,1]^3, every face an n x n grid (faces do not share vertices)
+static t_Mesh *makeCube(uint n)
+{
+  uint vf = (n + 1) * (n + 1);
+  t_Mesh *mesh = new t_Mesh(6 * vf,6 * 2 * n * n,0,AutoPtr<MVF>(MVF::make<t_Format>()));
+  uint t = 0;
+  ForIndex(f,6) {
+    int   axis = f / 2;
+    float side = float(f % 2);
+    v3f   u = 0,v = 0,w = 0;
+    u[(axis + 1) % 3] = 1.0f;
+    v[(axis + 2) % 3] = 1.0f;
+    w[axis]           = side;
+    ForIndex(j,n + 1) {
+      ForIndex(i,n + 1) {
+        t_Vertex& vx = mesh->vertexAt(f * vf + i + j * (n + 1));
+        vx.pos = w + u * float(i) / float(n) + v * float(j) / float(n);
+        vx.nrm = 0; vx.nrm[axis] = side * 2.0f - 1.0f;
+        vx.uv  = V2F(float(i) / float(n),float(j) / float(n));
+      }
+    }
+    ForIndex(j,n) {
+      ForIndex(i,n) {
+        uint a = f * vf + i + j * (n + 1),b = a + 1,c = b + n + 1,d = a + n + 1;
+        // outward facing on both sides
+        if (f % 2) { mesh->triangleAt(t++) = V3U(a,b,c); mesh->triangleAt(t++) = V3U(a,c,d); }
+        else       { mesh->triangleAt(t++) = V3U(a,c,b); mesh->triangleAt(t++) = V3U(a,d,c); }
+      }
+    }
+  }
+  return mesh;
+}
+
+static double meshArea(const TriangleMesh *mesh)
+{
+  double area = 0.0;
+  ForIndex(t,mesh->numTriangles()) {
+    v3u tri = mesh->triangleAt(t);
+    v3f p0 = mesh->posAt(tri[0]),p1 = mesh->posAt(tri[1]),p2 = mesh->posAt(tri[2]);
+    area += 0.5 * double(length(cross(p1 - p0,p2 - p0)));
+  }
+  return area;
+}
+
+static uint numDegenerate(const TriangleMesh *mesh)
+{
+  uint num = 0;
+  ForIndex(t,mesh->numTriangles()) {
+    v3u tri = mesh->triangleAt(t);
+    v3f p0 = mesh->posAt(tri[0]),p1 = mesh->posAt(tri[1]),p2 = mesh->posAt(tri[2]);
+    if (sqLength(cross(p1 - p0,p2 - p0)) == 0.0f) num++;
+  }
+  return num;
+}
+
+// signed area of a contour of plane z = cst, seen from +z
+static float signedArea(const vector<v3f>& pts)
+{
+  float a = 0.0f;
+  ForIndex(i,pts.size()) {
+    const v3f& p = pts[i];
+    const v3f& q = pts[(i + 1) % pts.size()];
+    a += p[0] * q[1] - q[0] * p[1];
+  }
+  return 0.5f * a;
+}
+
+// -----------
+
+void test_slicing()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh::MeshEditing slicing " << endl;
+  cerr << "---------------------------" << endl;
+
+  // sphere, planes between the vertex rings
+  {
+    TriangleMesh_Ptr sphere(makeSphere(48,24));
+    vector<float> offsets;
+    offsets.push_back(-0.55f); offsets.push_back(0.1f); offsets.push_back(0.6f);
+    vector<vector<MeshEditing::t_Contour> > contours;
+    vector<TriangleMesh_Ptr>                slabs;
+    MeshEditing::sliceMesh(sphere.raw(),V3F(0,0,1),offsets,contours,&slabs);
+    sl_assert(contours.size() == offsets.size());
+    ForIndex(k,offsets.size()) {
+      // a single closed, counter-clockwise circle
+      sl_assert(contours[k].size() == 1);
+      const MeshEditing::t_Contour& c = contours[k][0];
+      sl_assert(c.closed);
+      sl_assert(c.points.size() == 2 * 48);
+      float r = sqrt(1.0f - offsets[k] * offsets[k]);
+      ForIndex(i,c.points.size()) {
+        sl_assert(fabs(c.points[i][2] - offsets[k]) < 1e-6f);
+        sl_assert(length(c.points[i]) <= 1.0f + 1e-6f && length(V2F(c.points[i][0],c.points[i][1])) > 0.99f * r);
+      }
+      sl_assert(signedArea(c.points) > 0.9f * float(M_PI) * r * r);
+    }
+    // slabs cover the sphere
+    sl_assert(slabs.size() == offsets.size() + 1);
+    double area = 0.0;
+    ForIndex(s,slabs.size()) {
+      sl_assert(!slabs[s].isNull());
+      area += meshArea(slabs[s].raw());
+    }
+    double ref = meshArea(sphere.raw());
+    sl_assert(fabs(area - ref) < 1e-5 * ref);
+    // cut vertices interpolate normals and uvs
+    uint numCut = 0;
+    ForIndex(s,slabs.size()) {
+      const t_Mesh *slab = dynamic_cast<const t_Mesh*>(slabs[s].raw());
+      sl_assert(slab != NULL);
+      ForIndex(v,slab->numVertices()) {
+        const t_Vertex& vx = slab->vertexAt(v);
+        bool cut = false;
+        ForIndex(k,offsets.size()) { cut = cut || vx.pos[2] == offsets[k]; }
+        if (!cut) continue;
+        numCut++;
+        sl_assert(length(vx.nrm - normalize(vx.pos)) < 1e-5f);
+        sl_assert(length(vx.uv  - V2F(vx.pos[0],vx.pos[1])) < 1e-5f);
+      }
+    }
+    // each cut edge appears in the slabs on both sides
+    sl_assert(numCut == 2 * 2 * 48 * offsets.size());
+    cerr << sprint("sphere: %d slabs, area %.6f (input %.6f), %d cut vertices",slabs.size(),area,ref,numCut) << endl;
+  }
+
+  // cube, plane through a row of vertices
+  {
+    const uint n = 4;
+    TriangleMesh_Ptr cube(makeCube(n));
+    TriangleMesh_Ptr front,back;
+    MeshEditing::cutMesh(cube,Plane<3>(V3F(0,0,0.5f),V3F(0,0,1)),front,back);
+    sl_assert(!front.isNull() && !back.isNull());
+    cerr << sprint("cube: front %d triangles, back %d triangles",front->numTriangles(),back->numTriangles()) << endl;
+    // top face and the upper half of the sides, the same below
+    const uint half = 2 * n * n + 4 * (n / 2) * 2 * n;
+    sl_assert(front->numTriangles() == half);
+    sl_assert(back ->numTriangles() == half);
+    sl_assert(numDegenerate(front.raw()) == 0);
+    sl_assert(numDegenerate(back .raw()) == 0);
+    sl_assert(fabs(meshArea(front.raw()) - 3.0) < 1e-5);
+    sl_assert(fabs(meshArea(back .raw()) - 3.0) < 1e-5);
+    ForIndex(v,front->numVertices()) { sl_assert(front->posAt(v)[2] >= 0.5f); }
+    ForIndex(v,back ->numVertices()) { sl_assert(back ->posAt(v)[2] <= 0.5f); }
+    // the contour goes through the vertices, once each
+    vector<vector<MeshEditing::t_Contour> > contours;
+    MeshEditing::sliceMesh(cube.raw(),V3F(0,0,1),vector<float>(1,0.5f),contours);
+    sl_assert(contours[0].size() == 1);
+    sl_assert(contours[0][0].closed);
+    sl_assert(contours[0][0].points.size() == 4 * n);
+    sl_assert(fabs(signedArea(contours[0][0].points) - 1.0f) < 1e-6f);
+    // away from the cube
+    TriangleMesh_Ptr all,none;
+    MeshEditing::cutMesh(cube,Plane<3>(V3F(0,0,-1.0f),V3F(0,0,1)),all,none);
+    sl_assert(none.isNull());
+    sl_assert(all->numTriangles() == cube->numTriangles());
+  }
+
+  cerr << "ok" << endl;
+}
@@ -0,0 +1,193 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/DataStructures/Hierarchy.h>
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cstdlib>
+using namespace std;
+using namespace LibSL::DataStructures;
+
+// -----------
+
+typedef Hierarchy<uint>       t_Hierarchy;
+typedef StaticHierarchy<uint> t_StaticHierarchy;
+
+// random hierarchy, node data is the creation index
+static t_Hierarchy::t_Pointer randomHierarchy(uint numNodes)
+{
+  srand(32);
+  vector<t_Hierarchy::t_Pointer> nodes;
+  nodes.push_back(t_Hierarchy::t_Pointer(new t_Hierarchy(0)));
+  for (uint i = 1 ; i < numNodes ; i++) {
+    // favor recent nodes to get deep subtrees as well as wide ones
+    uint p = (rand() % 2) ? uint(rand()) % nodes.size() : uint(nodes.size()) - 1 - uint(rand()) % min(uint(nodes.size()),8u);
+    nodes.push_back(nodes[p]->addChild(i));
+  }
+  return nodes[0];
+}
+
+// pointer hierarchy traversals, data and depth of nodes
+static void depthFirst(t_Hierarchy::t_Pointer h,uint depth,vector<uint>& _order,vector<uint>& _depth)
+{
+  _order.push_back(h->data());
+  _depth.push_back(depth);
+  for (t_Hierarchy::ChildrenIterator I = h->children() ; !I.end() ; I.next()) {
+    depthFirst(I.current(),depth + 1,_order,_depth);
+  }
+}
+
+static void breadthFirst(t_Hierarchy::t_Pointer h,vector<uint>& _order,vector<uint>& _depth)
+{
+  deque<pair<t_Hierarchy::t_Pointer,uint> > queue;
+  queue.push_back(make_pair(h,0u));
+  while (!queue.empty()) {
+    t_Hierarchy::t_Pointer n = queue.front().first;
+    uint                   d = queue.front().second;
+    queue.pop_front();
+    _order.push_back(n->data());
+    _depth.push_back(d);
+    for (t_Hierarchy::ChildrenIterator I = n->children() ; !I.end() ; I.next()) {
+      queue.push_back(make_pair(I.current(),d + 1));
+    }
+  }
+}
+
+// links are consistent, children follow their parent
+static void checkLinks(const t_StaticHierarchy& sh)
+{
+  sl_assert(sh.parent(sh.root()) == t_StaticHierarchy::npos);
+  ForIndex(i,sh.numNodes()) {
+    uint n = 0;
+    for (t_StaticHierarchy::ChildrenIterator I = sh.children(i) ; !I.end() ; I.next()) {
+      sl_assert(I.current() > uint(i) && sh.parent(I.current()) == uint(i));
+      sl_assert(sh.depth(I.current()) == sh.depth(i) + 1);
+      n ++;
+    }
+    sl_assert(n == sh.numChildren(i) && sh.isLeaf(i) == (n == 0));
+  }
+}
+
+// propagate and reduce give the results of a serial sweep
+static void checkSweeps(const t_StaticHierarchy& sh)
+{
+  vector<uint> ones(sh.numNodes(),1),depth;
+  sh.propagate(ones,depth,[](const uint& g,const uint& l) { return g + l; });
+  ForIndex(i,sh.numNodes()) {
+    sl_assert(depth[i] == sh.depth(i) + 1);
+  }
+  vector<uint> size(sh.numNodes(),1);
+  sh.reduce(&size[0],[](uint& p,const uint& c) { p += c; });
+  sl_assert(size[sh.root()] == sh.numNodes());
+  vector<uint> sum(sh.numNodes(),0);
+  ForIndex(i,sh.numNodes()) {
+    for (t_StaticHierarchy::ChildrenIterator I = sh.children(i) ; !I.end() ; I.next()) {
+      sum[i] += size[I.current()];
+    }
+    sl_assert(size[i] == sum[i] + 1);
+    if (sh.layout() == t_StaticHierarchy::DepthFirst) {
+      sl_assert(size[i] == sh.subtreeSize(i));
+    }
+  }
+}
+
+static void checkLayouts(uint numNodes)
+{
+  t_Hierarchy::t_Pointer h = randomHierarchy(numNodes);
+  vector<uint> order,depth;
+  // depth-first: pre-order, subtrees are index ranges
+  depthFirst(h,0,order,depth);
+  t_StaticHierarchy df(h,t_StaticHierarchy::DepthFirst);
+  sl_assert(df.numNodes() == numNodes);
+  ForIndex(i,numNodes) {
+    sl_assert(df.data(i) == order[i] && df.depth(i) == depth[i]);
+    sl_assert(df.subtreeEnd(i) > uint(i) && df.subtreeEnd(i) <= numNodes);
+    // descendants are exactly the nodes of the range
+    for (uint d = i + 1 ; d < df.subtreeEnd(i) ; d++) {
+      sl_assert(df.depth(d) > df.depth(i));
+    }
+    sl_assert(df.subtreeEnd(i) == numNodes || df.depth(df.subtreeEnd(i)) <= df.depth(i));
+  }
+  checkLinks(df);
+  checkSweeps(df);
+  // breadth-first: levels and siblings are contiguous
+  order.clear();
+  depth.clear();
+  breadthFirst(h,order,depth);
+  t_StaticHierarchy bf(h,t_StaticHierarchy::BreadthFirst);
+  sl_assert(bf.numNodes() == numNodes);
+  ForIndex(i,numNodes) {
+    sl_assert(bf.data(i) == order[i] && bf.depth(i) == depth[i]);
+    if (bf.nextSibling(i) != t_StaticHierarchy::npos) {
+      sl_assert(bf.nextSibling(i) == uint(i) + 1);
+    }
+  }
+  sl_assert(bf.numLevels() == depth.back() + 1);
+  ForIndex(l,bf.numLevels()) {
+    for (uint i = bf.levelBegin(l) ; i < bf.levelEnd(l) ; i++) {
+      sl_assert(bf.depth(i) == uint(l));
+    }
+  }
+  checkLinks(bf);
+  checkSweeps(bf);
+}
+
+// -----------
+
+void test_statichierarchy()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " LibSL::DataStructures::StaticHierarchy " << endl;
+  cerr << "---------------------------" << endl;
+
+  // small hierarchies are swept serially, large ones in parallel
+  const uint threads[2] = { 1, 4 };
+  ForIndex(t,2) {
+    LibSL::System::Parallel::setNumThreads(threads[t]);
+    checkLayouts(100);
+    checkLayouts(50000);
+    cerr << "layouts and sweeps checked with " << threads[t] << " thread(s)" << endl;
+  }
+  LibSL::System::Parallel::setNumThreads(0);
+
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,168 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+                  Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Geometry/Triangulation.h>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+using namespace std;
+
+// -----------
+
+typedef vector<vector<v2d> > t_Polygon;
+
+static void addRing(t_Polygon& _poly,const double *xy,uint n)
+{
+  _poly.push_back(vector<v2d>());
+  ForIndex(i,n) {
+    _poly.back().push_back(v2d(xy[2 * i],xy[2 * i + 1]));
+  }
+}
+
+// triangulates, checks the number of triangles and the covered area;
+// every triangle must be counter-clockwise
+static void check(const char *name,const t_Polygon& poly,uint numTris,double area)
+{
+  vector<v2d> pts;
+  ForIndex(r,poly.size()) {
+    pts.insert(pts.end(),poly[r].begin(),poly[r].end());
+  }
+  vector<v3u> tris;
+  Triangulation::triangulate(poly,tris);
+  double total = 0.0;
+  ForIndex(t,tris.size()) {
+    ForIndex(k,3) {
+      sl_assert(tris[t][k] < pts.size());
+    }
+    v2d a = pts[tris[t][0]], b = pts[tris[t][1]], c = pts[tris[t][2]];
+    double s = 0.5 * ((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]));
+    sl_assert(s > 0.0);
+    total += s;
+  }
+  cerr << sprint("%-12s %3d triangles, area %.4f",name,int(tris.size()),total) << endl;
+  sl_assert(tris.size() == numTris);
+  sl_assert(fabs(total - area) <= 1e-9 * max(1.0,area));
+}
+
+// -----------
+
+void test_triangulation()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Geometry::Triangulation " << endl;
+  cerr << "---------------------------" << endl;
+
+  // square, clockwise: orientation does not matter
+  {
+    const double sq[] = { 0,0, 0,1, 1,1, 1,0 };
+    t_Polygon p; addRing(p,sq,4);
+    check("square",p,2,1.0);
+  }
+  // concave: an L and a star
+  {
+    const double l[] = { 0,0, 3,0, 3,1, 1,1, 1,3, 0,3 };
+    t_Polygon p; addRing(p,l,6);
+    check("L",p,4,5.0);
+    t_Polygon star(1);
+    ForIndex(i,10) {
+      double r = (i & 1) ? 0.4 : 1.0;
+      double a = 2.0 * M_PI * i / 10.0;
+      star[0].push_back(v2d(r * cos(a),r * sin(a)));
+    }
+    // 5 kites (0,0)-outer-inner-outer
+    double area = 5.0 * 2.0 * 0.5 * 1.0 * 0.4 * sin(2.0 * M_PI / 10.0);
+    check("star",star,8,area);
+  }
+  // holes: n + 2 h - 2 triangles
+  {
+    const double outer[] = { 0,0, 10,0, 10,10, 0,10 };
+    const double hole0[] = { 2,2, 2,4, 4,4, 4,2 };
+    const double hole1[] = { 6,6, 8,6, 8,8, 6,8 };
+    t_Polygon p; addRing(p,outer,4); addRing(p,hole0,4);
+    check("one hole",p,8,96.0);
+    addRing(p,hole1,4);
+    check("two holes",p,14,92.0);
+  }
+  // collinear points yield no flat triangle
+  {
+    const double sq[] = { 0,0, 1,0, 2,0, 2,1, 2,2, 1,2, 0,2, 0,1 };
+    t_Polygon p; addRing(p,sq,8);
+    check("collinear",p,6,4.0);
+  }
+  // degenerate polygons give no triangle
+  {
+    const double line[] = { 0,0, 1,1, 2,2, 3,3 };
+    t_Polygon p; addRing(p,line,4);
+    check("flat",p,0,0.0);
+    const double two[]  = { 0,0, 1,0 };
+    t_Polygon q; addRing(q,two,2);
+    check("two points",q,0,0.0);
+    t_Polygon e(1);
+    check("empty",e,0,0.0);
+  }
+  // a closed ring repeating its first point is the same polygon
+  {
+    const double sq[] = { 0,0, 1,0, 1,1, 0,1, 0,0 };
+    t_Polygon p; addRing(p,sq,5);
+    check("closed",p,2,1.0);
+  }
+  // batch triangulation gives the same result as one by one
+  {
+    vector<t_Polygon> polys;
+    ForIndex(n,16) {
+      t_Polygon p(1);
+      ForIndex(i,3 + n) {
+        double a = 2.0 * M_PI * i / double(3 + n);
+        p[0].push_back(v2d(cos(a),sin(a)));
+      }
+      polys.push_back(p);
+    }
+    vector<vector<v3u> > batch;
+    Triangulation::triangulate(polys,batch);
+    sl_assert(batch.size() == polys.size());
+    ForIndex(n,polys.size()) {
+      vector<v3u> single;
+      Triangulation::triangulate(polys[n],single);
+      sl_assert(single.size() == uint(1 + n) && batch[n] == single);
+    }
+  }
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -0,0 +1,157 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+#include "precompiled.h"
+
+#include <LibSL/LibSL.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+// -----------
+
+typedef struct { v3f pos; } t_PosVertex;
+typedef MVF1(mvf_position_3f)  t_PosFormat;
+typedef TriangleMesh_generic<t_PosVertex> t_PosMesh;
+
+// n x n quads in shuffled order, left and right halves in two surfaces
+static t_PosMesh *makeShuffledGrid(uint n)
+{
+  vector<v3u> tris;
+  ForIndex(j,n) {
+    ForIndex(i,n) {
+      uint a = i + j * (n + 1), b = a + 1, c = b + n + 1, d = a + n + 1;
+      tris.push_back(V3U(a,b,c));
+      tris.push_back(V3U(a,c,d));
+    }
+  }
+  uint seed = 7;
+  for (uint i = uint(tris.size()) - 1 ; i > 0 ; i--) {
+    seed = seed * 1664525u + 1013904223u;
+    swap(tris[i],tris[(seed >> 8) % (i + 1)]);
+  }
+  t_PosMesh *mesh = new t_PosMesh((n + 1) * (n + 1),uint(tris.size()),2,AutoPtr<MVF>(MVF::make<t_PosFormat>()));
+  ForIndex(j,n + 1) {
+    ForIndex(i,n + 1) {
+      mesh->vertexAt(i + j * (n + 1)).pos = V3F(float(i),float(j),0.0f);
+    }
+  }
+  vector<uint> ids[2];
+  ForIndex(t,tris.size()) {
+    mesh->triangleAt(t) = tris[t];
+    ids[(tris[t][0] % (n + 1)) < n / 2 ? 0 : 1].push_back(t);
+  }
+  ForIndex(s,2) {
+    mesh->surfaceAt(s).triangleIds.allocate(uint(ids[s].size()));
+    ForIndex(i,ids[s].size()) { mesh->surfaceAt(s).triangleIds[i] = ids[s][i]; }
+  }
+  return mesh;
+}
+
+// triangles of a surface as corner positions, starting from the smallest corner (keeps the orientation)
+static vector<vector<float> > surfaceTriangles(const TriangleMesh *mesh,uint s)
+{
+  vector<vector<float> > r;
+  ForIndex(i,mesh->surfaceNumTriangles(s)) {
+    v3u tri = mesh->triangleAt(mesh->surfaceTriangleIdAt(s,i));
+    vector<float> key;
+    ForIndex(c,3) {
+      v3f p = mesh->posAt(tri[c]);
+      key.push_back(p[0]); key.push_back(p[1]); key.push_back(p[2]);
+    }
+    vector<float> best = key;
+    ForIndex(c,2) {
+      rotate(key.begin(),key.begin() + 3,key.end());
+      best = min(best,key);
+    }
+    r.push_back(best);
+  }
+  sort(r.begin(),r.end());
+  return r;
+}
+
+// -----------
+
+void test_vertexcache()
+{
+  cerr << "---------------------------" << endl;
+  cerr << " Mesh vertex cache " << endl;
+  cerr << "---------------------------" << endl;
+
+  AutoPtr<t_PosMesh> mesh(makeShuffledGrid(64));
+  const uint nv = mesh->numVertices(), nt = mesh->numTriangles();
+  vector<vector<float> > before[2];
+  ForIndex(s,2) { before[s] = surfaceTriangles(mesh.raw(),s); }
+
+  // cache order: far fewer transforms, same triangles in the same surfaces
+  TriangleMesh::t_VertexCacheStats s0,s1;
+  mesh->optimizeVertexCache(16,&s0,&s1);
+  cerr << sprint("acmr %.3f -> %.3f",s0.acmr,s1.acmr) << endl;
+  sl_assert(s1.acmr < s0.acmr);
+  sl_assert(s1.acmr < 0.8f);
+  TriangleMesh::t_VertexCacheStats check = mesh->analyzeVertexCache(16);
+  sl_assert(check.acmr == s1.acmr);
+  sl_assert(mesh->numTriangles() == nt);
+  ForIndex(s,2) { sl_assert(surfaceTriangles(mesh.raw(),s) == before[s]); }
+  // optimizing again does not make it worse
+  TriangleMesh::t_VertexCacheStats s2;
+  mesh->optimizeVertexCache(16,NULL,&s2);
+  sl_assert(s2.acmr <= s1.acmr + 0.01f);
+
+  // fetch order: vertices renumbered by first use, the geometry is unchanged
+  vector<v3f> corners;
+  ForIndex(t,nt) { ForIndex(c,3) { corners.push_back(mesh->posAt(mesh->triangleAt(t)[c])); } }
+  TriangleMesh::t_VertexCacheStats f0,f1;
+  mesh->optimizeVertexFetch(&f0,&f1);
+  cerr << sprint("overfetch %.3f -> %.3f",f0.overfetch,f1.overfetch) << endl;
+  sl_assert(f1.overfetch <= f0.overfetch);
+  sl_assert(f1.acmr == f0.acmr);
+  sl_assert(mesh->numVertices() == nv && mesh->numTriangles() == nt);
+  uint next = 0;
+  ForIndex(t,nt) {
+    ForIndex(c,3) {
+      uint v = mesh->triangleAt(t)[c];
+      sl_assert(v <= next);
+      if (v == next) next ++;
+      sl_assert(mesh->posAt(v) == corners[t * 3 + c]);
+    }
+  }
+  ForIndex(s,2) { sl_assert(surfaceTriangles(mesh.raw(),s) == before[s]); }
+  cerr << "ok" << endl;
+}
+
+// -----------
@@ -43,6 +43,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 
 #include <LibSL/LibSL.h>
 #include <LibSL/LibSL_linalg.h>
+#include <LibSL/Image/Resize.h>
 
 using namespace std;
 
@@ -186,13 +187,14 @@ uint do_rand(AutoPtr<LibSL::Image::Image> image,
 
 /* -------------------------------------------------------- */
 
-/*
 class ResizeData
 {
 public:
   LibSL::Image::Image *image;
-  uint          w,h;
-  const char   *outname;
+  uint                 w,h;
+  e_ResizeFilter       filter;
+  bool                 srgb;
+  const char          *outname;
 };
 
 template <class T> class Resize
@@ -202,17 +204,8 @@ public:
   {
     T *image = dynamic_cast<T *>(d.image);
     if (image != NULL) {
-      AutoPtr<T> filtered = new T(*image);
-      if (d.w < d.image->w() || d.h < d.image->h()) {
-        GaussianFilter<T> filter;
-        filter.setSamplingFrequency( float(Math::min(d.w,d.h)) / float(Math::max(d.image->w(),d.image->h())) );
-        filtered = filter.filter(filtered);
-      }
-      AutoPtr<T> resized = new T(d.w,d.h);
-      ForImage(resized,i,j) {
-        resized->pixel(i,j) = filtered->bilinear((i+0.5f)/float(d.w),(j+0.5f)/float(d.h));
-      }
-      saveImage(d.outname,resized);
+      AutoPtr<T> resized = AutoPtr<T>(resize(image,d.w,d.h,d.filter,d.srgb));
+      saveImage(d.outname,resized.raw());
     }
   }
 };
@@ -223,17 +216,38 @@ uint do_resize(AutoPtr<LibSL::Image::Image> image,
              const char **argv,
              const char *outname)
 {
-  // <width> <height>
+  // <width> <height> [box|triangle|mitchell|lanczos3] [srgb]
   sl_assert(firstarg+2 <= argc);
   ResizeData nfo;
-  nfo.image = image;
-  nfo.w = atoi(argv[firstarg+0]);
-  nfo.h = atoi(argv[firstarg+1]);
+  nfo.image   = image.raw();
+  nfo.w       = atoi(argv[firstarg+0]);
+  nfo.h       = atoi(argv[firstarg+1]);
+  nfo.filter  = ResizeLanczos3;
+  nfo.srgb    = false;
   nfo.outname = outname;
+  uint arg = firstarg+2;
+  while (arg < argc && argv[arg][0] != '-') {
+    if        (!strcmp(argv[arg],"box")) {
+      nfo.filter = ResizeBox;
+    } else if (!strcmp(argv[arg],"triangle")) {
+      nfo.filter = ResizeTriangle;
+    } else if (!strcmp(argv[arg],"mitchell")) {
+      nfo.filter = ResizeMitchell;
+    } else if (!strcmp(argv[arg],"lanczos3")) {
+      nfo.filter = ResizeLanczos3;
+    } else if (!strcmp(argv[arg],"srgb")) {
+      nfo.srgb   = true;
+    } else {
+      throw Fatal("-resize: unknown option '%s'",argv[arg]);
+    }
+    arg ++;
+  }
+  if (nfo.w == 0 || nfo.h == 0) {
+    throw Fatal("-resize: invalid size %dx%d",nfo.w,nfo.h);
+  }
   ExecuteOnTypeList<AllImageTypes,Resize,ResizeData> rsz(nfo);
-  return (firstarg+2);
+  return (arg);
 }
-*/
 
 /* -------------------------------------------------------- */
 
@@ -826,8 +840,8 @@ int main(int argc, const char **argv)
         arg = do_grid      (image,arg+1,argc,argv,argv[2]);
       } else if (!strcmp(argv[arg],"-crop")) {
         arg = do_crop      (image,arg+1,argc,argv,argv[2]);
-      //} else if (!strcmp(argv[arg],"-resize")) {
-      //  arg = do_resize(image,arg+1,argc,argv,argv[2]);
+      } else if (!strcmp(argv[arg],"-resize")) {
+        arg = do_resize    (image,arg+1,argc,argv,argv[2]);
       } else if (!strcmp(argv[arg],"-convert")) {
         arg = do_convert   (image,arg+1,argc,argv,argv[2]);
       } else if (!strcmp(argv[arg],"-resizecanvas")) {
@@ -0,0 +1,432 @@
+/* --------------------------------------------------------------------
+Author: Sylvain Lefebvre    sylvain.lefebvre@sophia.inria.fr
+
+Simple Library for Graphics (LibSL)
+
+This software is a computer program whose purpose is to offer a set of
+tools to simplify programming real-time computer graphics applications
+under OpenGL and DirectX.
+
+This software is governed by the CeCILL-C license under French law and
+abiding by the rules of distribution of free software.  You can  use,
+modify and/ or redistribute the software under the terms of the CeCILL-C
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and,  more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-C license and that you accept its terms.
+-------------------------------------------------------------------- */
+// --------------------------------------------------------------
+// meshconvert - batch conversion of meshes
+//
+// Loads every input mesh, optionally welds, recomputes normals
+// and simplifies, then saves in the output format. Files are
+// processed by a pool of workers; the files in flight are
+// bounded by a memory budget, estimated from triangle counts
+// when the file header gives them, from file sizes otherwise.
+// --------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <cmath>
+#include <cctype>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+
+// --------------------------------------------------------------
+
+#include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshNormals.h>
+#include <LibSL/Mesh/MeshSimplification.h>
+#include <LibSL/System/Parallel.h>
+
+// --------------------------------------------------------------
+
+using namespace std;
+
+// --------------------------------------------------------------
+
+LIBSL_WIN32_FIX
+
+// --------------------------------------------------------------
+
+/// in-memory size of a mesh being processed, relative to its file size
+const double c_MemoryPerFileByte = 4.0;
+/// in-memory size of a mesh being processed, per triangle (indices, about
+/// half a vertex, and the working data of welding and simplification)
+const double c_MemoryPerTriangle = 128.0;
+
+class Options
+{
+public:
+  string outDir;
+  string outExt;
+  float  weld;          // relative to bbox diagonal, 0 welds exact duplicates, <0 disables
+  bool   normals;
+  float  simplify;      // ratio of triangles kept, >= 1 disables
+  bool   recurse;
+  uint   threads;
+  double budgetMB;
+  bool   force;         // allows outputs to replace their input
+  Options() : outExt("mesh"), weld(-1.0f), normals(false), simplify(1.0f), recurse(false), threads(0), budgetMB(1024.0), force(false) { }
+};
+
+/// memory budget shared by the workers
+class Budget
+{
+  mutex              m_Lock;
+  condition_variable m_Released;
+  double             m_Available;
+  uint               m_InFlight;
+public:
+  Budget(double bytes) : m_Available(bytes), m_InFlight(0) { }
+  /// waits until the budget allows bytes more, a file larger than the
+  /// whole budget waits for all others to complete and runs alone
+  void acquire(double bytes)
+  {
+    unique_lock<mutex> lock(m_Lock);
+    m_Released.wait(lock,[&] { return m_InFlight == 0 || bytes <= m_Available; });
+    m_Available -= bytes;
+    m_InFlight  ++;
+  }
+  void release(double bytes)
+  {
+    {
+      lock_guard<mutex> lock(m_Lock);
+      m_Available += bytes;
+      m_InFlight  --;
+    }
+    m_Released.notify_all();
+  }
+};
+
+/// an input and where its result goes
+class Job
+{
+public:
+  string input;
+  string output;
+  Job(const string& i,const string& o) : input(i), output(o) { }
+};
+
+class Result
+{
+public:
+  bool   ok;
+  string error;
+  uint   trisIn,trisOut;
+  double bytesIn,bytesOut;
+  double msLoad,msProcess,msSave;
+  Result() : ok(false), trisIn(0), trisOut(0), bytesIn(0), bytesOut(0), msLoad(0), msProcess(0), msSave(0) { }
+};
+
+mutex g_PrintLock;
+
+/* -------------------------------------------------------- */
+
+bool hasLoader(const string& fname)
+{
+  string ext = extractExtension(fname);
+  return !ext.empty() && MESH_FORMAT_MANAGER.hasPlugin(ext.c_str());
+}
+
+string withSlash(const string& dir)
+{
+  if (dir.empty() || dir[dir.length() - 1] == '/' || dir[dir.length() - 1] == '\\') {
+    return dir;
+  }
+  return dir + "/";
+}
+
+/// output next to the input, or in the output directory
+/// under the same path relative to the input directory
+string outputName(const string& input,const string& relDir,const Options& opts)
+{
+  string dir = opts.outDir.empty() ? extractPath(input) : withSlash(opts.outDir) + relDir;
+  return withSlash(dir) + removeExtensionFromFileName(extractFileName(input)) + "." + opts.outExt;
+}
+
+/// same path, ignoring case (extensions may only differ by case)
+bool samePath(const string& a,const string& b)
+{
+  if (a.length() != b.length()) {
+    return false;
+  }
+  ForIndex(i,a.length()) {
+    if (tolower(uchar(a[i])) != tolower(uchar(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void addDirectory(const string& root,const string& relDir,const Options& opts,vector<Job>& _jobs)
+{
+  string dir = withSlash(withSlash(root) + relDir);
+  if (!opts.outDir.empty()) {
+    LibSL::System::File::createDirectory((withSlash(opts.outDir) + relDir).c_str());
+  }
+  vector<string> files;
+  LibSL::System::File::listFiles(dir.c_str(),files);
+  sort(files.begin(),files.end());
+  ForIndex(f,files.size()) {
+    if (hasLoader(files[f])) {
+      _jobs.push_back(Job(dir + files[f],outputName(dir + files[f],relDir,opts)));
+    }
+  }
+  if (opts.recurse) {
+    vector<string> dirs;
+    LibSL::System::File::listDirectories(dir.c_str(),dirs);
+    sort(dirs.begin(),dirs.end());
+    ForIndex(d,dirs.size()) {
+      if (dirs[d] != "." && dirs[d] != "..") {
+        addDirectory(root,withSlash(relDir + dirs[d]),opts,_jobs);
+      }
+    }
+  }
+}
+
+/* -------------------------------------------------------- */
+
+/// approximate memory needed to process a file; the triangle count is only
+/// asked to formats with a streaming reader (others would load the mesh)
+double memoryEstimate(const string& fname)
+{
+  string ext = extractExtension(fname);
+  if (ext == "stl" || ext == "ply" || ext == "obj") {
+    try {
+      TriangleSoupReader_Ptr soup(openTriangleSoup(fname.c_str()));
+      if (soup->numTriangles() >= 0) {
+        return c_MemoryPerTriangle * double(soup->numTriangles());
+      }
+    } catch (Fatal&) {
+      // reported when converting
+    }
+  }
+  return c_MemoryPerFileByte * double(max(0LL,LibSL::System::File::size(fname.c_str())));
+}
+
+/* -------------------------------------------------------- */
+
+void recomputeNormals(TriangleMesh *mesh)
+{
+  const MVF::Attribute *a = mesh->mvf().isNull() ? NULL : mesh->mvf()->findAttributeByBinding(MVF::Normal);
+  if (a == NULL || a->type != MVF::Float || a->numComponents != 3) {
+    return; // no normal slot to fill
+  }
+  MeshNormals::computeNormals(mesh,MeshNormals::Angle);
+}
+
+/* -------------------------------------------------------- */
+
+Result convert(const Job& job,const Options& opts)
+{
+  Result r;
+  try {
+    LibSL::System::Time::t_time t0 = LibSL::System::Time::milliseconds();
+    TriangleMesh_Ptr mesh(loadTriangleMesh(job.input.c_str()));
+    LibSL::System::Time::t_time t1 = LibSL::System::Time::milliseconds();
+    r.trisIn  = mesh->numTriangles();
+    if (opts.weld >= 0.0f) {
+      if (opts.weld == 0.0f) {
+        mesh->mergeVerticesExact();
+      } else {
+        mesh->mergeVertices(opts.weld * length(mesh->bbox().extent()));
+      }
+    }
+    if (opts.normals) {
+      recomputeNormals(mesh.raw());
+    }
+    if (opts.simplify < 1.0f) {
+      MeshSimplification::Params params;
+      params.targetTriangles = uint(double(mesh->numTriangles()) * max(0.0f,opts.simplify));
+      TriangleMesh *s = MeshSimplification::simplify(mesh.raw(),params);
+      if (s == NULL) {
+        throw Fatal("nothing left after simplification");
+      }
+      mesh = TriangleMesh_Ptr(s);
+    }
+    LibSL::System::Time::t_time t2 = LibSL::System::Time::milliseconds();
+    saveTriangleMesh(job.output.c_str(),mesh.raw());
+    LibSL::System::Time::t_time t3 = LibSL::System::Time::milliseconds();
+    r.trisOut   = mesh->numTriangles();
+    r.bytesIn   = double(LibSL::System::File::size(job.input.c_str()));
+    r.bytesOut  = double(LibSL::System::File::size(job.output.c_str()));
+    r.msLoad    = double(t1 - t0);
+    r.msProcess = double(t2 - t1);
+    r.msSave    = double(t3 - t2);
+    r.ok        = true;
+  } catch (Fatal& e) {
+    r.error = e.message();
+  } catch (std::bad_alloc&) {
+    r.error = "out of memory";
+  } catch (std::exception& e) {
+    r.error = e.what();
+  } catch (...) {
+    r.error = "unknown error";
+  }
+  return r;
+}
+
+/* -------------------------------------------------------- */
+
+void usage()
+{
+  cerr << "Usage: meshconvert [options] <file|directory|@list> ..." << endl;
+  cerr << "  @list            text file with one input per line" << endl;
+  cerr << "  -o <dir>         output directory, mirrors input directories (default: next to the input)" << endl;
+  cerr << "  -ext <ext>       output format (default: mesh)" << endl;
+  cerr << "  -r               recurse into directories" << endl;
+  cerr << "  -weld <eps>      weld vertices closer than eps, relative to the bbox diagonal (0: exact duplicates)" << endl;
+  cerr << "  -normals         recompute vertex normals, angle weighted" << endl;
+  cerr << "  -simplify <r>    simplify to ratio r of the triangles" << endl;
+  cerr << "  -threads <n>     number of workers (default: all cores)" << endl;
+  cerr << "  -budget <MB>     memory budget of the files in flight (default: 1024)," << endl;
+  cerr << "                   approximate: estimated from triangle counts or file sizes" << endl;
+  cerr << "  -force           allow outputs to overwrite their input (same format, no -o)" << endl;
+}
+
+int main(int argc, char **argv)
+{
+  try {
+
+    Options        opts;
+    vector<string> inputs;
+    for (int a = 1 ; a < argc ; a++) {
+      string arg  = argv[a];
+      bool   more = a + 1 < argc;
+      if        (arg == "-o"        && more) { opts.outDir   = argv[++a];
+      } else if (arg == "-ext"      && more) { opts.outExt   = argv[++a];
+      } else if (arg == "-weld"     && more) { opts.weld     = float(atof(argv[++a]));
+      } else if (arg == "-simplify" && more) { opts.simplify = float(atof(argv[++a]));
+      } else if (arg == "-threads"  && more) { opts.threads  = uint(atoi(argv[++a]));
+      } else if (arg == "-budget"   && more) { opts.budgetMB = atof(argv[++a]);
+      } else if (arg == "-normals")          { opts.normals  = true;
+      } else if (arg == "-r")                { opts.recurse  = true;
+      } else if (arg == "-force")            { opts.force    = true;
+      } else if (arg[0] == '-') {
+        usage();
+        return (-1);
+      } else if (arg[0] == '@') {
+        ifstream list(arg.substr(1).c_str());
+        if (!list) {
+          throw Fatal("cannot open list '%s'",arg.substr(1).c_str());
+        }
+        string line;
+        while (getline(list,line)) {
+          if (!line.empty() && line[line.length() - 1] == '\r') {
+            line.erase(line.length() - 1);
+          }
+          if (!line.empty()) {
+            inputs.push_back(line);
+          }
+        }
+      } else {
+        inputs.push_back(arg);
+      }
+    }
+    if (!MESH_FORMAT_MANAGER.hasPlugin(opts.outExt.c_str())) {
+      throw Fatal("no mesh format for extension '%s'",opts.outExt.c_str());
+    }
+    if (!opts.outDir.empty()) {
+      LibSL::System::File::createDirectory(opts.outDir.c_str());
+    }
+    // inputs are files or directories
+    vector<Job> jobs;
+    ForIndex(i,inputs.size()) {
+      if (hasLoader(inputs[i])) {
+        jobs.push_back(Job(inputs[i],outputName(inputs[i],"",opts)));
+      } else {
+        addDirectory(inputs[i],"",opts,jobs);
+      }
+    }
+    if (jobs.empty()) {
+      usage();
+      return (-1);
+    }
+    // two inputs differing only by their extension would overwrite each other,
+    // an input converted to its own format would be overwritten
+    map<string,uint> outputs;
+    vector<Result>   results(jobs.size());
+    ForIndex(j,jobs.size()) {
+      if (!opts.force && samePath(jobs[j].input,jobs[j].output)) {
+        results[j].error = "output would overwrite the input, use -force";
+      } else if (outputs.find(jobs[j].output) != outputs.end()) {
+        results[j].error = "output '" + jobs[j].output + "' already written by '" + jobs[outputs[jobs[j].output]].input + "'";
+      } else {
+        outputs[jobs[j].output] = j;
+      }
+    }
+    if (opts.threads > 0) {
+      LibSL::System::Parallel::setNumThreads(opts.threads);
+    }
+
+    cerr << sprint("Converting %d files with %d workers, budget %.0f MB\n",
+                   int(jobs.size()),int(LibSL::System::Parallel::numThreads()),opts.budgetMB);
+
+    // files in flight run on the pool, operations on each file run serially
+    Budget                      budget(opts.budgetMB * 1024.0 * 1024.0);
+    LibSL::System::Time::t_time start = LibSL::System::Time::milliseconds();
+    LibSL::System::Parallel::forIndex(0,int(jobs.size()),[&](int f) {
+      if (results[f].error.empty()) {
+        double estimate = memoryEstimate(jobs[f].input);
+        budget.acquire(estimate);
+        results[f] = convert(jobs[f],opts);
+        budget.release(estimate);
+      }
+      const Result& r = results[f];
+      lock_guard<mutex> lock(g_PrintLock);
+      if (r.ok) {
+        double ms = r.msLoad + r.msProcess + r.msSave;
+        cerr << sprint("[OK]     %s  %d -> %d tris  load %.1f ms  process %.1f ms  save %.1f ms  %.2f MB/s\n",
+                       jobs[f].input.c_str(),r.trisIn,r.trisOut,r.msLoad,r.msProcess,r.msSave,
+                       r.bytesIn / (1024.0 * 1024.0) / max(1e-3,ms / 1000.0));
+      } else {
+        cerr << Console::red << sprint("[FAILED] %s  %s\n",jobs[f].input.c_str(),r.error.c_str()) << Console::gray;
+      }
+    });
+    double seconds = max(1e-3,double(LibSL::System::Time::milliseconds() - start) / 1000.0);
+
+    // aggregate
+    uint   numOk = 0;
+    double tris = 0,bytesIn = 0,bytesOut = 0;
+    ForIndex(f,results.size()) {
+      if (results[f].ok) {
+        numOk    ++;
+        tris     += results[f].trisIn;
+        bytesIn  += results[f].bytesIn;
+        bytesOut += results[f].bytesOut;
+      }
+    }
+    cerr << sprint("Done: %d converted, %d failed in %.2f s\n",numOk,int(results.size()) - numOk,seconds);
+    cerr << sprint("      %.1f files/s  %.2f Mtris/s  %.2f MB/s in  %.2f MB/s out\n",
+                   numOk / seconds,tris / 1e6 / seconds,bytesIn / (1024.0 * 1024.0) / seconds,bytesOut / (1024.0 * 1024.0) / seconds);
+    return (numOk == results.size() ? 0 : -1);
+
+  } catch (Fatal& e) {
+    cerr << Console::red << e.message() << Console::gray << endl;
+    return (-1);
+  }
+  return (0);
+}
+
+/* -------------------------------------------------------- */
@@ -42,6 +42,7 @@ knowledge of the CeCILL-C license and that you accept its terms.
 // --------------------------------------------------------------
 
 #include <LibSL/LibSL.h>
+#include <LibSL/Mesh/MeshNormals.h>
 
 // --------------------------------------------------------------
 
@@ -84,23 +85,7 @@ int main(int argc, char **argv)
     cerr << "Smoothing         ";
 	  v3f ex = g_Mesh->bbox().extent();
 	  g_Mesh->mergeVertices( 0.001f * tupleMax(ex) );
-    Array<v3f> nrms;
-    nrms.allocate( g_Mesh->numVertices() );
-    nrms.fill( 0 );
-    ForIndex(t, g_Mesh->numTriangles() ) {
-      v3u tri = g_Mesh->triangleAt(t);
-      v3f pts[3];
-      ForIndex(i,3) {
-        pts[i] = g_Mesh->posAt(tri[i]);
-      }
-      v3f n = cross( pts[1]-pts[0] , pts[2]-pts[0] );
-      ForIndex(i,3) {
-        nrms[ tri[i] ] += n;
-      }
-    }
-    ForIndex(v,nrms.size()) {
-      ((t_VertexData*)g_Mesh->vertexDataAt(v))->nrm = normalize_safe( nrms[v] );
-    }
+    MeshNormals::computeNormals(g_Mesh.raw(),MeshNormals::Area);
 
     cerr << "[OK]" << endl;
 
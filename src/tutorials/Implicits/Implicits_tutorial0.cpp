@@ -57,6 +57,16 @@ public:
   {
     return length(p - v3f(0.5f));
   }
+  // a distance: blocks away from the surface are never sampled
+  virtual float lipschitz() const
+  {
+    return 1.0f;
+  }
+  // no state: may be evaluated from several threads
+  virtual bool threadSafe() const
+  {
+    return true;
+  }
 };
 
 /* -------------------------------------------------------- */
@@ -66,7 +76,8 @@ int main(int argc, char **argv)
   try {
 
     AutoPtr<ImplicitShape::t_Mesh> mesh;
-    ImplicitShape                  impl(f(),64);
+    f                              sphere;
+    ImplicitShape                  impl(sphere,64);
     
     mesh = impl.generateShape( 0.3f );
 